@@ -0,0 +1,196 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC developers
+ *			Copyright (c) GPAC developers 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - AES backends micro-benchmark
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/crypt.h>
+
+//payload size, in bytes
+#define CB_SIZE	(4*1024*1024)
+//subsample sizes are drawn in [16, CB_MAX_SUB]
+#define CB_MAX_SUB	20000
+
+static u8 cb_key[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+static u8 cb_iv[16] = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0};
+
+//FIPS-197 appendix C.1
+static u8 kat_pt[16] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+static u8 kat_ct[16] = {0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a};
+
+static u32 *cb_subs = NULL;
+static u32 cb_nb_subs = 0;
+
+static GF_Crypt *cb_open(GF_CRYPTO_MODE mode)
+{
+	u8 iv[17];
+	GF_Crypt *gc = gf_crypt_open(GF_AES_128, mode);
+	if (!gc) return NULL;
+	gf_crypt_init(gc, cb_key, cb_iv);
+	//17-byte form exercises the counter position in CTR mode
+	if (mode==GF_CTR) {
+		iv[0] = 0;
+		memcpy(iv+1, cb_iv, 16);
+		gf_crypt_set_IV(gc, iv, 17);
+	}
+	return gc;
+}
+
+//crypts the payload as a sequence of subsamples, with a pattern if crypt_block and skip_block are set
+static u64 cb_run(GF_CRYPTO_MODE mode, Bool decrypt, u8 *data, u32 crypt_block, u32 skip_block, Bool per_block_calls)
+{
+	u32 i, pos = 0;
+	u64 start;
+	GF_Crypt *gc = cb_open(mode);
+	if (!gc) return 0;
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<cb_nb_subs; i++) {
+		u32 size = cb_subs[i];
+		u8 *buf = data + pos;
+		pos += size;
+		//CBC operates on full blocks
+		if (mode==GF_CBC) size -= size % 16;
+
+		if (!crypt_block) {
+			if (decrypt) gf_crypt_decrypt(gc, buf, size);
+			else gf_crypt_encrypt(gc, buf, size);
+		}
+		//one call per encrypted range, as done before the pattern API
+		else if (per_block_calls) {
+			while (size) {
+				u32 nb = (size >= 16*crypt_block) ? 16*crypt_block : size;
+				if (decrypt) gf_crypt_decrypt(gc, buf, nb);
+				else gf_crypt_encrypt(gc, buf, nb);
+				if (size < 16*(crypt_block+skip_block)) break;
+				buf += 16*(crypt_block+skip_block);
+				size -= 16*(crypt_block+skip_block);
+			}
+		} else {
+			if (decrypt) gf_crypt_decrypt_pattern(gc, buf, size, crypt_block, skip_block);
+			else gf_crypt_encrypt_pattern(gc, buf, size, crypt_block, skip_block);
+		}
+	}
+	start = gf_sys_clock_high_res() - start;
+	gf_crypt_close(gc);
+	return start;
+}
+
+static Bool cb_check_kat(void)
+{
+	u8 buf[16], zero[16];
+	GF_Crypt *gc = gf_crypt_open(GF_AES_128, GF_CBC);
+	if (!gc) return GF_FALSE;
+	memset(zero, 0, 16);
+	memcpy(buf, kat_pt, 16);
+	gf_crypt_init(gc, cb_key, zero);
+	gf_crypt_encrypt(gc, buf, 16);
+	gf_crypt_close(gc);
+	return memcmp(buf, kat_ct, 16) ? GF_FALSE : GF_TRUE;
+}
+
+static const char *cb_mode_name(GF_CRYPTO_MODE mode, u32 crypt_block)
+{
+	if (mode==GF_CTR) return crypt_block ? "cens" : "cenc";
+	return crypt_block ? "cbcs" : "cbc1";
+}
+
+static void cb_bench(GF_CRYPTO_MODE mode, u32 crypt_block, u32 skip_block, u8 *ref, u8 *work, u8 *clear, u32 cpu_caps, u32 nb_iter)
+{
+	u32 i;
+	u64 t_ref=0, t_ref_calls=0, t_aesni=0;
+	Bool ok;
+
+	//fallback backend, one call per encrypted range
+	gf_sys_set_cpu_features(cpu_caps & ~GF_CPU_AES);
+	for (i=0; i<nb_iter; i++) {
+		memcpy(ref, clear, CB_SIZE);
+		t_ref_calls += cb_run(mode, GF_FALSE, ref, crypt_block, skip_block, GF_TRUE);
+	}
+	//fallback backend, pattern API
+	for (i=0; i<nb_iter; i++) {
+		memcpy(work, clear, CB_SIZE);
+		t_ref += cb_run(mode, GF_FALSE, work, crypt_block, skip_block, GF_FALSE);
+	}
+	ok = memcmp(ref, work, CB_SIZE) ? GF_FALSE : GF_TRUE;
+
+	//AES-NI backend, pattern API
+	gf_sys_set_cpu_features(cpu_caps);
+	for (i=0; i<nb_iter; i++) {
+		memcpy(work, clear, CB_SIZE);
+		t_aesni += cb_run(mode, GF_FALSE, work, crypt_block, skip_block, GF_FALSE);
+	}
+	if (memcmp(ref, work, CB_SIZE)) ok = GF_FALSE;
+	//and back
+	cb_run(mode, GF_TRUE, work, crypt_block, skip_block, GF_FALSE);
+	if (memcmp(clear, work, CB_SIZE)) ok = GF_FALSE;
+
+	fprintf(stderr, "%s %d:%d - fallback %8.2f MB/s - fallback pattern API %8.2f MB/s - AES-NI %8.2f MB/s - %s\n",
+		cb_mode_name(mode, crypt_block), crypt_block, skip_block,
+		(Double) CB_SIZE * nb_iter / (Double) (s64) t_ref_calls,
+		(Double) CB_SIZE * nb_iter / (Double) (s64) t_ref,
+		(Double) CB_SIZE * nb_iter / (Double) (s64) t_aesni,
+		ok ? "output identical" : "OUTPUT MISMATCH"
+	);
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, pos, cpu_caps, nb_iter=10;
+	u8 *clear, *ref, *work;
+
+	for (i=1; i<(u32) argc; i++) {
+		if (!strcmp(argv[i], "-n") && (i+1<(u32) argc)) nb_iter = atoi(argv[++i]);
+		else {
+			fprintf(stderr, "usage: cryptbench [-n ITERATIONS]\n");
+			return 1;
+		}
+	}
+	if (!nb_iter) nb_iter = 1;
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	cpu_caps = gf_sys_get_cpu_features();
+	if (!(cpu_caps & GF_CPU_AES)) {
+		fprintf(stderr, "AES instructions not available on this CPU, only the fallback backend will be tested\n");
+	}
+
+	clear = gf_malloc(CB_SIZE);
+	ref = gf_malloc(CB_SIZE);
+	work = gf_malloc(CB_SIZE);
+	gf_rand_init(GF_FALSE);
+	for (i=0; i<CB_SIZE; i++) clear[i] = (u8) gf_rand();
+
+	//random subsample sizes, not multiple of 16 bytes to exercise partial CTR blocks
+	cb_subs = gf_malloc(sizeof(u32) * (CB_SIZE/16));
+	pos = 0;
+	while (pos < CB_SIZE) {
+		u32 size = 16 + gf_rand() % CB_MAX_SUB;
+		if (pos + size > CB_SIZE) size = CB_SIZE - pos;
+		cb_subs[cb_nb_subs++] = size;
+		pos += size;
+	}
+
+	gf_sys_set_cpu_features(cpu_caps & ~GF_CPU_AES);
+	fprintf(stderr, "FIPS-197 known answer: fallback %s", cb_check_kat() ? "OK" : "FAIL");
+	gf_sys_set_cpu_features(cpu_caps);
+	fprintf(stderr, " - AES-NI %s\n", cb_check_kat() ? "OK" : "FAIL");
+	fprintf(stderr, "%d MB payload in %d subsamples, %d iterations\n", CB_SIZE/(1024*1024), cb_nb_subs, nb_iter);
+
+	cb_bench(GF_CTR, 0, 0, ref, work, clear, cpu_caps, nb_iter);
+	cb_bench(GF_CTR, 1, 9, ref, work, clear, cpu_caps, nb_iter);
+	cb_bench(GF_CBC, 0, 0, ref, work, clear, cpu_caps, nb_iter);
+	cb_bench(GF_CBC, 1, 9, ref, work, clear, cpu_caps, nb_iter);
+
+	gf_free(cb_subs);
+	gf_free(clear);
+	gf_free(ref);
+	gf_free(work);
+	gf_sys_close();
+	return 0;
+}
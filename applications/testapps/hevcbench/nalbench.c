@@ -0,0 +1,311 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC developers
+ *			Copyright (c) GPAC developers 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - NAL start code and emulation prevention bytes micro-benchmark
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/internal/media_dev.h>
+
+//size of synthetic NAL buffer
+#define NALB_SIZE	(4*1024*1024)
+//number of passes per test
+#define NALB_PASSES	50
+
+static void nalb_fill(u8 *data, u32 size, u32 seed)
+{
+	u32 i, rnd = seed;
+	for (i=0; i<size; i++) {
+		rnd = rnd * 1103515245 + 12345;
+		data[i] = (u8) (rnd >> 16);
+		//sprinkle some short zero runs, as found in real slice data
+		if ((rnd & 0x3FF) == 0) {
+			data[i] = 0;
+			if (i+1<size) data[++i] = 0;
+			if ((i+1<size) && (rnd & 0x400)) data[++i] = (u8) ((rnd >> 11) & 3);
+		}
+	}
+	//and some start codes
+	for (i=1024; i+4<size; i += 65536 + (i % 4096)) {
+		data[i] = data[i+1] = 0;
+		data[i+2] = 1;
+	}
+}
+
+/*original scanning code from av_parsers.c, before zero pair search was added, used as reference*/
+
+static u32 nalb_ref_next_start_code(const u8 *data, u32 data_len, u32 *sc_size)
+{
+	u32 avail = data_len;
+	const u8 *cur = data;
+
+	while (cur) {
+		u32 v, bpos;
+		u8 *next_zero = memchr(cur, 0, avail);
+		if (!next_zero) return data_len;
+
+		v = 0xffffff00;
+		bpos = (u32)(next_zero - data) + 1;
+		while (1) {
+			u8 cval;
+			if (bpos == (u32)data_len)
+				return data_len;
+
+			cval = data[bpos];
+			v = ((v << 8) & 0xFFFFFF00) | ((u32)cval);
+			bpos++;
+			if (v == 0x00000001) {
+				*sc_size = 4;
+				return bpos - 4;
+			}
+			else if ((v & 0x00FFFFFF) == 0x00000001) {
+				*sc_size = 3;
+				return bpos - 3;
+			}
+			if (cval)
+				break;
+		}
+		if (bpos >= data_len)
+			break;
+		cur = data + bpos;
+		avail = data_len - bpos;
+	}
+	return data_len;
+}
+
+/*returns the nal_size without emulation prevention bytes*/
+static u32 nalb_ref_emulation_bytes_add_count(u8 *buffer, u32 nal_size)
+{
+	u32 i = 0, emulation_bytes_count = 0;
+	u8 num_zero = 0;
+
+	while (i < nal_size) {
+		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
+		other than the following sequences shall not occur at any byte-aligned position:
+		\96 0x00000300
+		\96 0x00000301
+		\96 0x00000302
+		\96 0x00000303"
+		*/
+		if (num_zero == 2 && (u8)buffer[i] < 0x04) {
+			/*emulation code found*/
+			num_zero = 0;
+			emulation_bytes_count++;
+			if (!buffer[i])
+				num_zero = 1;
+		}
+		else {
+			if (!buffer[i])
+				num_zero++;
+			else
+				num_zero = 0;
+		}
+		i++;
+	}
+	return emulation_bytes_count;
+}
+
+static u32 nalb_ref_add_emulation_bytes(const u8 *buffer_src, u8 *buffer_dst, u32 nal_size)
+{
+	u32 i = 0, emulation_bytes_count = 0;
+	u8 num_zero = 0;
+
+	while (i < nal_size) {
+		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
+		other than the following sequences shall not occur at any byte-aligned position:
+		0x00000300
+		0x00000301
+		0x00000302
+		0x00000303"
+		*/
+		if (num_zero == 2 && (u8)buffer_src[i] < 0x04) {
+			/*add emulation code*/
+			num_zero = 0;
+			buffer_dst[i + emulation_bytes_count] = 0x03;
+			emulation_bytes_count++;
+			if (!buffer_src[i])
+				num_zero = 1;
+		}
+		else {
+			if (!buffer_src[i])
+				num_zero++;
+			else
+				num_zero = 0;
+		}
+		buffer_dst[i + emulation_bytes_count] = buffer_src[i];
+		i++;
+	}
+	return nal_size + emulation_bytes_count;
+}
+
+/*returns the nal_size without emulation prevention bytes*/
+static u32 nalb_ref_emulation_bytes_remove_count(const u8 *buffer, u32 nal_size)
+{
+	u32 i = 0, emulation_bytes_count = 0;
+	u8 num_zero = 0;
+	if (!buffer || !nal_size) return 0;
+
+	while (i < nal_size)
+	{
+		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
+		  other than the following sequences shall not occur at any byte-aligned position:
+		  \96 0x00000300
+		  \96 0x00000301
+		  \96 0x00000302
+		  \96 0x00000303"
+		*/
+		if (num_zero == 2
+			&& buffer[i] == 0x03
+			&& i + 1 < nal_size /*next byte is readable*/
+			&& (u8)buffer[i + 1] < 0x04)
+		{
+			/*emulation code found*/
+			num_zero = 0;
+			emulation_bytes_count++;
+			i++;
+		}
+
+		if (!buffer[i])
+			num_zero++;
+		else
+			num_zero = 0;
+
+		i++;
+	}
+
+	return emulation_bytes_count;
+}
+
+/*nal_size is updated to allow better error detection*/
+static u32 nalb_ref_remove_emulation_bytes(const u8 *buffer_src, u8 *buffer_dst, u32 nal_size)
+{
+	u32 i = 0, emulation_bytes_count = 0;
+	u8 num_zero = 0;
+
+	while (i < nal_size)
+	{
+		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
+		  other than the following sequences shall not occur at any byte-aligned position:
+		  0x00000300
+		  0x00000301
+		  0x00000302
+		  0x00000303"
+		*/
+		if (num_zero == 2
+			&& buffer_src[i] == 0x03
+			&& i + 1 < nal_size /*next byte is readable*/
+			&& (u8)buffer_src[i + 1] < 0x04)
+		{
+			/*emulation code found*/
+			num_zero = 0;
+			emulation_bytes_count++;
+			i++;
+		}
+
+		buffer_dst[i - emulation_bytes_count] = buffer_src[i];
+
+		if (!buffer_src[i])
+			num_zero++;
+		else
+			num_zero = 0;
+
+		i++;
+	}
+
+	return nal_size - emulation_bytes_count;
+}
+
+typedef struct
+{
+	u32 (*next_start_code)(const u8 *data, u32 data_len, u32 *sc_size);
+	u32 (*emulation_bytes_add_count)(u8 *buffer, u32 nal_size);
+	u32 (*add_emulation_bytes)(const u8 *buffer_src, u8 *buffer_dst, u32 nal_size);
+	u32 (*emulation_bytes_remove_count)(const u8 *buffer, u32 nal_size);
+	u32 (*remove_emulation_bytes)(const u8 *buffer_src, u8 *buffer_dst, u32 nal_size);
+} NALBFuncs;
+
+static const NALBFuncs nalb_ref_funcs = {
+	nalb_ref_next_start_code,
+	nalb_ref_emulation_bytes_add_count,
+	nalb_ref_add_emulation_bytes,
+	nalb_ref_emulation_bytes_remove_count,
+	nalb_ref_remove_emulation_bytes
+};
+
+static const NALBFuncs nalb_lib_funcs = {
+	gf_media_nalu_next_start_code,
+	gf_media_nalu_emulation_bytes_add_count,
+	gf_media_nalu_add_emulation_bytes,
+	gf_media_nalu_emulation_bytes_remove_count,
+	gf_media_nalu_remove_emulation_bytes
+};
+
+static u64 nalb_run(const NALBFuncs *funcs, u8 *src, u8 *dst, u8 *dst2, u32 size, u32 *checksum)
+{
+	u32 p, crc = 0;
+	u64 start = gf_sys_clock_high_res();
+	for (p=0; p<NALB_PASSES; p++) {
+		u32 pos = 0, sc_size = 0, dst_size;
+		while (pos < size) {
+			u32 next = funcs->next_start_code(src + pos, size - pos, &sc_size);
+			if (next == size - pos) break;
+			crc += next;
+			pos += next + sc_size;
+		}
+		crc += funcs->emulation_bytes_add_count(src, size);
+		dst_size = funcs->add_emulation_bytes(src, dst, size);
+		crc += dst_size;
+		crc += funcs->emulation_bytes_remove_count(dst, dst_size);
+		crc += funcs->remove_emulation_bytes(dst, dst2, dst_size);
+	}
+	*checksum = crc;
+	return gf_sys_clock_high_res() - start;
+}
+
+int main(int argc, char **argv)
+{
+	u32 crc_ref, crc_scalar, crc_simd, features;
+	u64 t_ref, t_scalar, t_simd;
+	u8 *src, *dst, *dst2;
+	GF_Err e = GF_OK;
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+
+	src = gf_malloc(NALB_SIZE);
+	//worst case is one emulation byte every 2 bytes
+	dst = gf_malloc(NALB_SIZE*3/2 + 4);
+	dst2 = gf_malloc(NALB_SIZE*3/2 + 4);
+	nalb_fill(src, NALB_SIZE, 0x1234);
+
+	features = gf_sys_get_cpu_features();
+
+	t_ref = nalb_run(&nalb_ref_funcs, src, dst, dst2, NALB_SIZE, &crc_ref);
+	if (memcmp(src, dst2, NALB_SIZE)) e = GF_CORRUPTED_DATA;
+
+	gf_sys_set_cpu_features(0);
+	t_scalar = nalb_run(&nalb_lib_funcs, src, dst, dst2, NALB_SIZE, &crc_scalar);
+	if (memcmp(src, dst2, NALB_SIZE)) e = GF_CORRUPTED_DATA;
+	if (crc_ref != crc_scalar) e = GF_CORRUPTED_DATA;
+
+	gf_sys_set_cpu_features(features);
+	t_simd = nalb_run(&nalb_lib_funcs, src, dst, dst2, NALB_SIZE, &crc_simd);
+	if (memcmp(src, dst2, NALB_SIZE)) e = GF_CORRUPTED_DATA;
+	if (crc_ref != crc_simd) e = GF_CORRUPTED_DATA;
+
+	fprintf(stderr, "NAL scan of %d passes over %d bytes - CPU features 0x%08X\n", NALB_PASSES, NALB_SIZE, features);
+	fprintf(stderr, "original: "LLU" us\n", t_ref);
+	fprintf(stderr, "scalar: "LLU" us - speedup x%.02f\n", t_scalar, t_scalar ? ((Double) (s64) t_ref) / (s64) t_scalar : 0);
+	fprintf(stderr, "simd: "LLU" us - speedup x%.02f\n", t_simd, t_simd ? ((Double) (s64) t_ref) / (s64) t_simd : 0);
+	if (e) fprintf(stderr, "Error: results differ from original code\n");
+
+	gf_free(src);
+	gf_free(dst);
+	gf_free(dst2);
+	gf_sys_close();
+	return e ? 1 : 0;
+}
@@ -0,0 +1,227 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC developers
+ *			Copyright (c) GPAC developers 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - audio resampler micro-benchmark
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/thread.h>
+#include <gpac/internal/compositor_dev.h>
+
+//test tones, channel 0 then channel 1
+#define RSB_TONE_LOW	1000
+#define RSB_TONE_HIGH	15000
+//output block size in samples
+#define RSB_BLOCK	1024
+
+#define RSB_PI	3.14159265358979323846
+
+typedef struct
+{
+	GF_AudioInterface ai;
+	//one second of interleaved float samples, played in loop
+	Float *data;
+	u32 nb_samples, pos;
+	Bool cfg_sent;
+} RSBSource;
+
+typedef struct
+{
+	u32 in_sr, out_sr, nb_ch, quality, duration;
+	//results
+	u64 time_us, nb_out;
+	Double snr[2];
+} RSBJob;
+
+static u8 *rsb_fetch_frame(void *callback, u32 *size, u32 *planar_stride, u32 audio_delay_ms)
+{
+	RSBSource *src = (RSBSource *)callback;
+	*size = (src->nb_samples - src->pos) * src->ai.chan * sizeof(Float);
+	return (u8 *) (src->data + src->pos * src->ai.chan);
+}
+static void rsb_release_frame(void *callback, u32 nb_bytes)
+{
+	RSBSource *src = (RSBSource *)callback;
+	src->pos += nb_bytes / (src->ai.chan * sizeof(Float));
+	if (src->pos == src->nb_samples) src->pos = 0;
+}
+static Fixed rsb_get_speed(void *callback)
+{
+	return FIX_ONE;
+}
+static Bool rsb_get_channel_volume(void *callback, Fixed *vol)
+{
+	u32 i;
+	for (i=0; i<GF_AUDIO_MIXER_MAX_CHANNELS; i++) vol[i] = FIX_ONE;
+	return GF_FALSE;
+}
+static Bool rsb_is_muted(void *callback)
+{
+	return GF_FALSE;
+}
+static Bool rsb_get_config(GF_AudioInterface *ai, Bool for_reconf)
+{
+	RSBSource *src = (RSBSource *)ai->callback;
+	//report a config change first so that the mixer keeps its output config
+	if (!src->cfg_sent) {
+		src->cfg_sent = GF_TRUE;
+		return GF_FALSE;
+	}
+	return GF_TRUE;
+}
+
+static Double rsb_tone(u32 ch, u64 n, u32 sr)
+{
+	u32 f = (ch%2) ? RSB_TONE_HIGH : RSB_TONE_LOW;
+	return 0.5 * sin(2 * RSB_PI * f * (Double) (s64) (n % sr) / sr);
+}
+
+static u32 rsb_run(void *par)
+{
+	u32 i, j, nb_skip;
+	u64 start, nb_target;
+	Double sig[2], err[2];
+	Float *out;
+	RSBSource src;
+	RSBJob *job = (RSBJob *)par;
+	GF_AudioMixer *am = gf_mixer_new(NULL);
+
+	memset(&src, 0, sizeof(RSBSource));
+	src.ai.callback = &src;
+	src.ai.FetchFrame = rsb_fetch_frame;
+	src.ai.ReleaseFrame = rsb_release_frame;
+	src.ai.GetSpeed = rsb_get_speed;
+	src.ai.GetChannelVolume = rsb_get_channel_volume;
+	src.ai.IsMuted = rsb_is_muted;
+	src.ai.GetConfig = rsb_get_config;
+	src.ai.samplerate = job->in_sr;
+	src.ai.chan = job->nb_ch;
+	src.ai.afmt = GF_AUDIO_FMT_FLT;
+	//1 kHz and 15 kHz tones have an integral number of periods in one second
+	src.nb_samples = job->in_sr;
+	src.data = gf_malloc(sizeof(Float) * src.nb_samples * job->nb_ch);
+	for (i=0; i<src.nb_samples; i++) {
+		for (j=0; j<job->nb_ch; j++)
+			src.data[i*job->nb_ch + j] = (Float) rsb_tone(j, i, job->in_sr);
+	}
+	out = gf_malloc(sizeof(Float) * RSB_BLOCK * job->nb_ch);
+
+	gf_mixer_set_resample_quality(am, job->quality);
+	gf_mixer_add_input(am, &src.ai);
+	gf_mixer_set_config(am, job->out_sr, job->nb_ch, GF_AUDIO_FMT_FLT, 0);
+
+	sig[0] = sig[1] = err[0] = err[1] = 0;
+	//skip filter warm-up in quality measure
+	nb_skip = 1000;
+	nb_target = (u64) job->duration * job->out_sr;
+	job->nb_out = 0;
+	start = gf_sys_clock_high_res();
+	while (job->nb_out < nb_target) {
+		u32 nb = gf_mixer_get_output(am, out, RSB_BLOCK * job->nb_ch * sizeof(Float), 0);
+		nb /= job->nb_ch * sizeof(Float);
+		//quality check on the first second only
+		if (job->nb_out < job->out_sr) {
+			for (i=0; i<nb; i++) {
+				u64 n = job->nb_out + i;
+				if (n < nb_skip) continue;
+				for (j=0; j<2 && j<job->nb_ch; j++) {
+					Double ref = rsb_tone(j, n, job->out_sr);
+					Double d = out[i*job->nb_ch + j] - ref;
+					sig[j] += ref*ref;
+					err[j] += d*d;
+				}
+			}
+		}
+		job->nb_out += nb;
+	}
+	job->time_us = gf_sys_clock_high_res() - start;
+
+	for (j=0; j<2; j++) {
+		job->snr[j] = err[j] ? 10 * log10(sig[j] / err[j]) : 0;
+	}
+	gf_mixer_del(am);
+	gf_free(src.data);
+	gf_free(out);
+	return 0;
+}
+
+static const char *rsb_qnames[] = {"linear", "low", "medium", "high"};
+
+static void rsb_bench(u32 in_sr, u32 out_sr, u32 nb_ch, u32 quality, u32 nb_threads, u32 duration)
+{
+	u32 i;
+	u64 time_us = 0, nb_out = 0;
+	Double msps;
+	RSBJob jobs[64];
+	GF_Thread *threads[64];
+
+	for (i=0; i<nb_threads; i++) {
+		jobs[i].in_sr = in_sr;
+		jobs[i].out_sr = out_sr;
+		jobs[i].nb_ch = nb_ch;
+		jobs[i].quality = quality;
+		jobs[i].duration = duration;
+		threads[i] = gf_th_new("ResampleBench");
+		gf_th_run(threads[i], rsb_run, &jobs[i]);
+	}
+	for (i=0; i<nb_threads; i++) {
+		gf_th_stop(threads[i]);
+		gf_th_del(threads[i]);
+		time_us += jobs[i].time_us;
+		nb_out += jobs[i].nb_out;
+	}
+	//samples per second per core, all channels counted
+	msps = (Double) (s64) (nb_out * nb_ch) / (Double) (s64) time_us;
+	fprintf(stderr, "%6d -> %6d %-7s: %8.2f Msamples/s per core (x%.0f realtime) - SNR %d Hz %6.1f dB - %d Hz %6.1f dB\n",
+		in_sr, out_sr, rsb_qnames[quality], msps, msps * 1000000 / nb_ch / out_sr,
+		RSB_TONE_LOW, jobs[0].snr[0], RSB_TONE_HIGH, jobs[0].snr[1]);
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, q, nb_ch=2, nb_threads=1, duration=20;
+	u32 in_sr=0, out_sr=0, quality=0xFF;
+	u32 rates[][2] = { {44100, 48000}, {48000, 44100}, {32000, 48000}, {96000, 48000} };
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-ch") && (i+1<(u32) argc)) nb_ch = atoi(argv[++i]);
+		else if (!strcmp(arg, "-th") && (i+1<(u32) argc)) nb_threads = atoi(argv[++i]);
+		else if (!strcmp(arg, "-d") && (i+1<(u32) argc)) duration = atoi(argv[++i]);
+		else if (!strcmp(arg, "-sr") && (i+1<(u32) argc)) sscanf(argv[++i], "%u:%u", &in_sr, &out_sr);
+		else if (!strcmp(arg, "-q") && (i+1<(u32) argc)) {
+			arg = argv[++i];
+			for (q=0; q<4; q++) {
+				if (!strcmp(arg, rsb_qnames[q])) quality = q;
+			}
+		} else {
+			fprintf(stderr, "usage: resamplebench [-sr IN:OUT] [-q linear|low|medium|high] [-ch N] [-th N] [-d SEC]\n");
+			return 1;
+		}
+	}
+	if (!nb_ch || (nb_ch>GF_AUDIO_MIXER_MAX_CHANNELS)) nb_ch = 2;
+	if (!nb_threads || (nb_threads>64)) nb_threads = 1;
+	if (!duration) duration = 1;
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	fprintf(stderr, "%d channels, %d thread(s), %d s of output per thread\n", nb_ch, nb_threads, duration);
+	for (i=0; i<sizeof(rates)/sizeof(rates[0]); i++) {
+		//rates given on command line replace the default set
+		if (in_sr && out_sr) {
+			if (i) break;
+			rates[0][0] = in_sr;
+			rates[0][1] = out_sr;
+		}
+		for (q=0; q<4; q++) {
+			if ((quality!=0xFF) && (quality!=q)) continue;
+			rsb_bench(rates[i][0], rates[i][1], nb_ch, q, nb_threads, duration);
+		}
+	}
+	gf_sys_close();
+	return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC developers
+ *			Copyright (c) GPAC developers 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - sample table random access micro-benchmark
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/isomedia.h>
+
+//number of samples in the synthetic track
+#define STBLB_SAMPLES	1000000
+//number of random lookups per test
+#define STBLB_LOOKUPS	2000
+
+static u32 rnd_state = 0x1234;
+static u32 stblb_rand()
+{
+	rnd_state = rnd_state * 1103515245 + 12345;
+	return rnd_state >> 8;
+}
+
+//create a track with many stts, ctts and stsc entries
+static GF_Err stblb_create(const char *file_name, u64 *media_dur)
+{
+	u32 i, track, di, run=0, dur=1000;
+	u8 data[64];
+	GF_ISOSample *samp;
+	GF_GenericSampleDescription udesc;
+	GF_Err e;
+	GF_ISOFile *file = gf_isom_open(file_name, GF_ISOM_OPEN_WRITE, NULL);
+	if (!file) return gf_isom_last_error(NULL);
+
+	track = gf_isom_new_track(file, 0, GF_ISOM_MEDIA_VISUAL, 90000);
+	gf_isom_set_track_enabled(file, track, GF_TRUE);
+	memset(&udesc, 0, sizeof(GF_GenericSampleDescription));
+	udesc.codec_tag = GF_4CC('s','t','b','l');
+	udesc.width = udesc.height = 16;
+	e = gf_isom_new_generic_sample_description(file, track, NULL, NULL, &udesc, &di);
+	if (e) goto exit;
+	//small chunks so that samples per chunk varies with sample size
+	gf_isom_hint_max_chunk_size(file, track, 256);
+
+	memset(data, 0, sizeof(data));
+	samp = gf_isom_sample_new();
+	samp->data = data;
+	for (i=0; i<STBLB_SAMPLES; i++) {
+		//change sample duration every few samples
+		if (!run) {
+			run = 1 + stblb_rand() % 8;
+			dur = 1000 + stblb_rand() % 3;
+		}
+		run--;
+		samp->dataLength = 1 + stblb_rand() % 64;
+		samp->CTS_Offset = (i % 3) * 1000;
+		samp->IsRAP = (i % 25) ? RAP_NO : SAP_TYPE_1;
+		e = gf_isom_add_sample(file, track, di, samp);
+		if (e) break;
+		samp->DTS += dur;
+	}
+	*media_dur = samp->DTS;
+	samp->data = NULL;
+	gf_isom_sample_del(&samp);
+
+exit:
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	return gf_isom_close(file);
+}
+
+static u64 stblb_run(const char *file_name, u32 mode, u64 media_dur, u64 *checksum)
+{
+	u32 i;
+	u64 crc = 0, start;
+	GF_ISOFile *file = gf_isom_open(file_name, mode, NULL);
+	if (!file) return 0;
+
+	rnd_state = 0x5678;
+	start = gf_sys_clock_high_res();
+	//sample number to DTS, CTS and offset
+	for (i=0; i<STBLB_LOOKUPS; i++) {
+		u32 di;
+		u64 offset;
+		GF_ISOSample *samp = gf_isom_get_sample_info(file, 1, 1 + stblb_rand() % STBLB_SAMPLES, &di, &offset);
+		if (!samp) continue;
+		crc += samp->DTS + samp->CTS_Offset + offset + samp->dataLength;
+		gf_isom_sample_del(&samp);
+	}
+	//time to sample number
+	for (i=0; i<STBLB_LOOKUPS; i++) {
+		u32 sample_num, di;
+		u64 offset;
+		u64 time = ((u64) stblb_rand() << 8) % media_dur;
+		gf_isom_get_sample_for_media_time(file, 1, time, &di, GF_ISOM_SEARCH_BACKWARD, NULL, &sample_num, &offset);
+		crc += sample_num + offset;
+	}
+	start = gf_sys_clock_high_res() - start;
+	gf_isom_delete(file);
+	*checksum = crc;
+	return start;
+}
+
+int main(int argc, char **argv)
+{
+	u64 media_dur=0, crc_ref, crc_idx, t_ref, t_idx;
+	const char *file_name = (argc>1) ? argv[1] : "stblbench.mp4";
+	GF_Err e;
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+
+	e = stblb_create(file_name, &media_dur);
+	if (e) {
+		fprintf(stderr, "Error creating %s: %s\n", file_name, gf_error_to_string(e));
+		gf_sys_close();
+		return 1;
+	}
+	//tables of files opened for edition are walked linearly
+	t_ref = stblb_run(file_name, GF_ISOM_OPEN_EDIT, media_dur, &crc_ref);
+	t_idx = stblb_run(file_name, GF_ISOM_OPEN_READ, media_dur, &crc_idx);
+	gf_file_delete(file_name);
+
+	fprintf(stderr, "%d random sample and %d random time lookups in a %d samples track\n", STBLB_LOOKUPS, STBLB_LOOKUPS, STBLB_SAMPLES);
+	fprintf(stderr, "linear: "LLU" us - indexed: "LLU" us - speedup x%.02f\n", t_ref, t_idx, t_idx ? ((Double) (s64) t_ref) / (s64) t_idx : 0);
+	if (crc_ref != crc_idx) fprintf(stderr, "Error: linear and indexed results differ\n");
+
+	gf_sys_close();
+	return (crc_ref != crc_idx) ? 1 : 0;
+}
@@ -0,0 +1,157 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC developers
+ *			Copyright (c) GPAC developers 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - MPEG-2 TS muxer throughput micro-benchmark
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/constants.h>
+#include <gpac/mpegts.h>
+
+//mux rate in bits per second
+#define TSMB_RATE	20000000
+//number of video frames muxed (25 fps)
+#define TSMB_FRAMES	3000
+//number of TS packets per output write, as done by the TS mux filter
+#define TSMB_PACK	7
+
+typedef struct
+{
+	GF_ESInterface esi;
+	u8 *data;
+	u32 nb_au, max_au, au_size, au_dur;
+} TSMBStream;
+
+static u32 rnd_state = 0x1234;
+static u32 tsmb_rand()
+{
+	rnd_state = rnd_state * 1103515245 + 12345;
+	return rnd_state >> 8;
+}
+
+//push the next AU of the synthetic stream when the muxer asks for data
+static GF_Err tsmb_input_ctrl(GF_ESInterface *ifce, u32 act_type, void *param)
+{
+	GF_ESIPacket pck;
+	TSMBStream *st = (TSMBStream *)ifce->input_udta;
+
+	if (act_type != GF_ESI_INPUT_DATA_FLUSH) return GF_OK;
+	if (ifce->caps & GF_ESI_STREAM_IS_OVER) return GF_OK;
+
+	if (st->nb_au == st->max_au) {
+		ifce->caps |= GF_ESI_STREAM_IS_OVER;
+		return GF_OK;
+	}
+	memset(&pck, 0, sizeof(GF_ESIPacket));
+	pck.flags = GF_ESI_DATA_AU_START | GF_ESI_DATA_AU_END | GF_ESI_DATA_HAS_CTS | GF_ESI_DATA_HAS_DTS;
+	pck.sap_type = (st->nb_au % 25) ? 0 : 1;
+	pck.dts = pck.cts = (u64) st->nb_au * st->au_dur;
+	pck.duration = st->au_dur;
+	pck.data = st->data;
+	//vary AU size to get all kind of last packet sizes
+	pck.data_len = st->au_size/2 + tsmb_rand() % st->au_size;
+	st->nb_au++;
+	return ifce->output_ctrl(ifce, GF_ESI_OUTPUT_DATA_DISPATCH, &pck);
+}
+
+static void tsmb_stream_init(TSMBStream *st, u32 codecid, u8 stream_type, u32 au_size, u32 au_dur, u32 max_au)
+{
+	memset(st, 0, sizeof(TSMBStream));
+	st->esi.stream_id = 1;
+	st->esi.codecid = codecid;
+	st->esi.stream_type = stream_type;
+	st->esi.timescale = 90000;
+	st->esi.input_ctrl = tsmb_input_ctrl;
+	st->esi.input_udta = st;
+	st->au_size = au_size;
+	st->au_dur = au_dur;
+	st->max_au = max_au;
+	st->data = gf_malloc(2*au_size);
+	memset(st->data, 0xA5, 2*au_size);
+}
+
+static u64 tsmb_run(Bool batch_nulls, u64 *nb_pck, u64 *nb_null, u32 *checksum)
+{
+	u32 status, crc=0, nb_in_pack=0;
+	u64 start;
+	u8 pack[188*TSMB_PACK];
+	TSMBStream video, audio;
+	GF_M2TS_Mux_Program *prog;
+	GF_M2TS_Mux *mux = gf_m2ts_mux_new(TSMB_RATE, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, GF_FALSE);
+	if (!mux) return 0;
+
+	rnd_state = 0x1234;
+	gf_m2ts_mux_set_initial_pcr(mux, 1000);
+	gf_m2ts_mux_set_pcr_max_interval(mux, 100);
+	//300 ms PCR offset (90kHz)
+	prog = gf_m2ts_mux_program_add(mux, 1, 100, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, 27000, GF_M2TS_MPEG4_SIGNALING_NONE, 0, GF_FALSE, 0);
+
+	tsmb_stream_init(&video, GF_CODECID_MPEG2_MAIN, GF_STREAM_VISUAL, 20000, 3600, TSMB_FRAMES);
+	tsmb_stream_init(&audio, GF_CODECID_MPEG_AUDIO, GF_STREAM_AUDIO, 400, 2160, TSMB_FRAMES*3600/2160);
+	gf_m2ts_program_stream_add(prog, &video.esi, 256, GF_TRUE, GF_FALSE, GF_FALSE);
+	gf_m2ts_program_stream_add(prog, &audio.esi, 257, GF_FALSE, GF_FALSE, GF_FALSE);
+	gf_m2ts_mux_update_config(mux, GF_TRUE);
+
+	*nb_pck = *nb_null = 0;
+	start = gf_sys_clock_high_res();
+	while (1) {
+		const u8 *ts_pck = gf_m2ts_mux_process(mux, &status, NULL);
+		if (!ts_pck) break;
+		memcpy(pack + 188*nb_in_pack, ts_pck, 188);
+		nb_in_pack++;
+		if (status==GF_M2TS_STATE_PADDING) {
+			(*nb_null)++;
+			if (batch_nulls && (nb_in_pack < TSMB_PACK)) {
+				u32 nb = gf_m2ts_mux_consume_null_packets(mux, TSMB_PACK - nb_in_pack);
+				*nb_null += nb;
+				while (nb) {
+					memcpy(pack + 188*nb_in_pack, mux->null_pck, 188);
+					nb_in_pack++;
+					nb--;
+				}
+			}
+		}
+		if ((nb_in_pack == TSMB_PACK) || (status==GF_M2TS_STATE_EOS)) {
+			crc = gf_crc_32(pack, 188*nb_in_pack) ^ (crc * 31);
+			*nb_pck += nb_in_pack;
+			nb_in_pack = 0;
+		}
+		if (status==GF_M2TS_STATE_EOS) break;
+	}
+	start = gf_sys_clock_high_res() - start;
+
+	gf_m2ts_mux_del(mux);
+	gf_free(video.data);
+	gf_free(audio.data);
+	*checksum = crc;
+	return start;
+}
+
+int main(int argc, char **argv)
+{
+	u32 crc_ref, crc_batch;
+	u64 t_ref, t_batch, nb_pck, nb_null;
+	Double mbits;
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	//synthetic streams have no buffer model, don't report late PES
+	gf_log_set_tool_level(GF_LOG_CONTAINER, GF_LOG_ERROR);
+
+	t_ref = tsmb_run(GF_FALSE, &nb_pck, &nb_null, &crc_ref);
+	t_batch = tsmb_run(GF_TRUE, &nb_pck, &nb_null, &crc_batch);
+
+	mbits = (Double) (s64) nb_pck * 188 * 8 / 1000000;
+	fprintf(stderr, "muxed "LLU" TS packets ("LLU" NULL) at %d kbps\n", nb_pck, nb_null, TSMB_RATE/1000);
+	fprintf(stderr, "per packet: "LLU" us (%.02f Mbps) - NULL runs batched: "LLU" us (%.02f Mbps)\n",
+		t_ref, t_ref ? mbits * 1000000 / (s64) t_ref : 0,
+		t_batch, t_batch ? mbits * 1000000 / (s64) t_batch : 0);
+	if (crc_ref != crc_batch) fprintf(stderr, "Error: per packet and batched outputs differ\n");
+
+	gf_sys_close();
+	return (crc_ref != crc_batch) ? 1 : 0;
+}
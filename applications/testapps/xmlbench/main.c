@@ -0,0 +1,211 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC developers
+ *			Copyright (c) GPAC developers 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - SAX XML parser micro-benchmark
+ *
+ */
+
+#include <gpac/tools.h>
+#include <gpac/xml.h>
+
+//number of parsing passes per document
+#define XMLB_PASSES	10
+
+typedef struct
+{
+	u32 nb_nodes, nb_atts, nb_text;
+	u32 crc;
+} XMLBStats;
+
+static void xmlb_node_start(void *sax_cbck, const char *node_name, const char *name_space, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	u32 i;
+	XMLBStats *st = (XMLBStats *)sax_cbck;
+	st->nb_nodes++;
+	st->crc = gf_crc_32((u8 *) node_name, (u32) strlen(node_name)) ^ (st->crc * 31);
+	if (name_space) st->crc = gf_crc_32((u8 *) name_space, (u32) strlen(name_space)) ^ (st->crc * 31);
+	for (i=0; i<nb_attributes; i++) {
+		st->crc = gf_crc_32((u8 *) attributes[i].name, (u32) strlen(attributes[i].name)) ^ (st->crc * 31);
+		st->crc = gf_crc_32((u8 *) attributes[i].value, (u32) strlen(attributes[i].value)) ^ (st->crc * 31);
+	}
+	st->nb_atts += nb_attributes;
+}
+
+static void xmlb_node_end(void *sax_cbck, const char *node_name, const char *name_space)
+{
+	XMLBStats *st = (XMLBStats *)sax_cbck;
+	st->crc = gf_crc_32((u8 *) node_name, (u32) strlen(node_name)) ^ (st->crc * 31);
+}
+
+static void xmlb_text(void *sax_cbck, const char *content, Bool is_cdata)
+{
+	u32 len = (u32) strlen(content);
+	XMLBStats *st = (XMLBStats *)sax_cbck;
+	st->nb_text += len;
+	st->crc = gf_crc_32((u8 *) content, len) ^ (st->crc * 31);
+}
+
+static char *xmlb_doc = NULL;
+static u32 xmlb_doc_size = 0, xmlb_doc_alloc = 0;
+
+static void xmlb_add(const char *fmt, ...)
+{
+	va_list args;
+	u32 len;
+	if (xmlb_doc_alloc - xmlb_doc_size < 1024) {
+		xmlb_doc_alloc = xmlb_doc_alloc ? 2*xmlb_doc_alloc : 1024*1024;
+		xmlb_doc = gf_realloc(xmlb_doc, xmlb_doc_alloc);
+	}
+	va_start(args, fmt);
+	len = vsnprintf(xmlb_doc + xmlb_doc_size, xmlb_doc_alloc - xmlb_doc_size, fmt, args);
+	va_end(args);
+	xmlb_doc_size += len;
+}
+
+//live MPD with a 24h SegmentTimeline per AdaptationSet
+static void xmlb_gen_mpd()
+{
+	u32 i, j;
+	u64 t = 0;
+	xmlb_add("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" type=\"dynamic\" availabilityStartTime=\"2020-01-01T00:00:00Z\" timeShiftBufferDepth=\"PT24H\" profiles=\"urn:mpeg:dash:profile:isoff-live:2011\">\n");
+	xmlb_add(" <Period id=\"1\" start=\"PT0S\">\n");
+	for (j=0; j<2; j++) {
+		xmlb_add("  <AdaptationSet mimeType=\"%s\" segmentAlignment=\"true\">\n", j ? "audio/mp4" : "video/mp4");
+		xmlb_add("   <SegmentTemplate timescale=\"90000\" media=\"seg_$RepresentationID$_$Time$.m4s\" initialization=\"init_$RepresentationID$.mp4\">\n    <SegmentTimeline>\n");
+		for (i=0; i<43200; i++) {
+			if (!i) xmlb_add("     <S t=\"%d\" d=\"%d\"/>\n", (u32) t, 180000);
+			else xmlb_add("     <S d=\"%d\"%s/>\n", (i%2) ? 180000 : 180180, (i%7) ? "" : " r=\"1\"");
+			t += 180000;
+		}
+		xmlb_add("    </SegmentTimeline>\n   </SegmentTemplate>\n");
+		for (i=0; i<4; i++)
+			xmlb_add("   <Representation id=\"%c%d\" bandwidth=\"%d\" codecs=\"%s\"/>\n", j ? 'a' : 'v', i, 500000*(i+1), j ? "mp4a.40.2" : "avc1.64001f");
+		xmlb_add("  </AdaptationSet>\n");
+	}
+	xmlb_add(" </Period>\n</MPD>\n");
+}
+
+//SVG with long path data and text with entities
+static void xmlb_gen_svg()
+{
+	u32 i, j;
+	xmlb_add("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" width=\"1920\" height=\"1080\" viewBox=\"0 0 1920 1080\">\n");
+	for (i=0; i<20000; i++) {
+		xmlb_add(" <g id=\"g%d\" transform=\"translate(%d %d)\">\n  <path fill=\"#%06X\" stroke=\"black\" stroke-width=\"2\" d=\"M 0 0", i, i%1920, i%1080, i*2654435761u & 0xFFFFFF);
+		for (j=0; j<20; j++)
+			xmlb_add(" L %d.%d %d.%d", (i+j*7)%1920, j, (i*3+j)%1080, (i+j)%10);
+		xmlb_add(" Z\"/>\n  <text x=\"10\" y=\"20\" font-family=\"Arial\">Item %d &amp; caption &lt;%d&gt; with some text content</text>\n </g>\n", i, j);
+	}
+	xmlb_add("</svg>\n");
+}
+
+//TTML subtitles
+static void xmlb_gen_ttml()
+{
+	u32 i;
+	xmlb_add("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<tt xmlns=\"http://www.w3.org/ns/ttml\" xmlns:tts=\"http://www.w3.org/ns/ttml#styling\" xml:lang=\"en\">\n <body>\n  <div>\n");
+	for (i=0; i<50000; i++) {
+		xmlb_add("   <p begin=\"%d.000s\" end=\"%d.500s\" tts:textAlign=\"center\">Subtitle line number %d, <span tts:color=\"yellow\">highlighted &quot;words&quot;</span><br/>and a second line of text</p>\n", i*2, i*2+1, i);
+	}
+	xmlb_add("  </div>\n </body>\n</tt>\n");
+}
+
+static u64 xmlb_run(const char *file, XMLBStats *stats, GF_Err *e)
+{
+	u32 i;
+	u64 start = gf_sys_clock_high_res();
+	for (i=0; i<XMLB_PASSES; i++) {
+		GF_SAXParser *sax;
+		memset(stats, 0, sizeof(XMLBStats));
+		sax = gf_xml_sax_new(xmlb_node_start, xmlb_node_end, xmlb_text, stats);
+		*e = gf_xml_sax_parse_file(sax, file, NULL);
+		if (*e==GF_EOS) *e = GF_OK;
+		gf_xml_sax_del(sax);
+		if (*e) break;
+	}
+	return gf_sys_clock_high_res() - start;
+}
+
+static Bool xmlb_test(const char *name, const char *file, u32 features)
+{
+	GF_Err e_ref, e_simd;
+	XMLBStats st_ref, st_simd;
+	u64 t_ref, t_simd, size;
+	Double mb;
+	FILE *f = gf_fopen(file, "rb");
+	if (!f) {
+		fprintf(stderr, "Cannot open %s\n", file);
+		return GF_FALSE;
+	}
+	size = gf_fsize(f);
+	gf_fclose(f);
+
+	gf_sys_set_cpu_features(0);
+	t_ref = xmlb_run(file, &st_ref, &e_ref);
+	gf_sys_set_cpu_features(features);
+	t_simd = xmlb_run(file, &st_simd, &e_simd);
+
+	mb = (Double) (s64) size * XMLB_PASSES / 1000000;
+	fprintf(stderr, "%s: %d KB - %d nodes %d attributes %d text bytes\n", name, (u32) (size/1000), st_ref.nb_nodes, st_ref.nb_atts, st_ref.nb_text);
+	fprintf(stderr, "\tscalar: %.02f MB/s - simd: %.02f MB/s - speedup x%.02f\n",
+		t_ref ? mb * 1000000 / (s64) t_ref : 0, t_simd ? mb * 1000000 / (s64) t_simd : 0, t_simd ? ((Double) (s64) t_ref) / (s64) t_simd : 0);
+
+	if (e_ref || e_simd) {
+		fprintf(stderr, "\tError parsing: scalar %s - simd %s\n", gf_error_to_string(e_ref), gf_error_to_string(e_simd));
+		return GF_FALSE;
+	}
+	if (memcmp(&st_ref, &st_simd, sizeof(XMLBStats))) {
+		fprintf(stderr, "\tError: scalar and simd results differ\n");
+		return GF_FALSE;
+	}
+	return GF_TRUE;
+}
+
+static Bool xmlb_test_gen(const char *name, void (*gen)(), u32 features)
+{
+	Bool res;
+	FILE *f;
+	char file[GF_MAX_PATH];
+	snprintf(file, GF_MAX_PATH, "%s/xmlbench_%d.xml", gf_get_default_cache_directory(), gf_sys_get_process_id());
+	f = gf_fopen(file, "wb");
+	if (!f) return GF_FALSE;
+
+	xmlb_doc_size = 0;
+	gen();
+	gf_fwrite(xmlb_doc, xmlb_doc_size, f);
+	gf_fclose(f);
+
+	res = xmlb_test(name, file, features);
+	gf_file_delete(file);
+	return res;
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	Bool ok = GF_TRUE;
+	u32 features;
+
+	gf_sys_init(GF_MemTrackerNone, NULL);
+	features = gf_sys_get_cpu_features();
+	fprintf(stderr, "SAX parsing, %d passes per document - CPU features 0x%08X\n", XMLB_PASSES, features);
+
+	//documents given on command line, otherwise synthetic ones
+	if (argc>1) {
+		for (i=1; i<argc; i++) {
+			if (!xmlb_test(gf_file_basename(argv[i]), argv[i], features)) ok = GF_FALSE;
+		}
+	} else {
+		if (!xmlb_test_gen("live MPD", xmlb_gen_mpd, features)) ok = GF_FALSE;
+		if (!xmlb_test_gen("SVG", xmlb_gen_svg, features)) ok = GF_FALSE;
+		if (!xmlb_test_gen("TTML", xmlb_gen_ttml, features)) ok = GF_FALSE;
+	}
+
+	if (xmlb_doc) gf_free(xmlb_doc);
+	gf_sys_close();
+	return ok ? 0 : 1;
+}
@@ -63,6 +63,7 @@ LOCAL_SRC_FILES := \
 	../../../../src/compositor/audio_input.c \
 	../../../../src/compositor/audio_mixer.c \
 	../../../../src/compositor/audio_render.c \
+	../../../../src/compositor/audio_resampler.c \
 	../../../../src/compositor/bindable.c \
 	../../../../src/compositor/camera.c \
 	../../../../src/compositor/clock.c \
@@ -133,6 +134,7 @@ LOCAL_SRC_FILES := \
 	../../../../src/compositor/visual_manager.c \
 	../../../../src/compositor/x3d_geometry.c \
 	../../../../src/crypto/g_crypt.c \
+	../../../../src/crypto/g_crypt_aesni.c \
 	../../../../src/crypto/g_crypt_openssl.c \
 	../../../../src/crypto/g_crypt_tinyaes.c \
 	../../../../src/crypto/tiny_aes.c \
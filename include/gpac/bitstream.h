@@ -141,6 +141,15 @@ Prevents byte dispatching in callback mode. This is used when seek operations ar
  */
 void gf_bs_prevent_dispatch(GF_BitStream *bs, Bool prevent_dispatch);
 
+/*!
+\brief forwards bytes dispatched outside of the bitstream
+Dispatches all pending bytes in callback mode, and advances the bitstream position by the given number of bytes. This is used when the caller dispatches a data block by itself right after this call, avoiding a copy of the block in the bitstream.
+\param bs the target bitstream
+\param nb_bytes number of bytes dispatched by the caller
+\return error if any, GF_BAD_PARAM if the bitstream is not in callback mode or if block dispatch is currently prevented, in which case the caller shall write the data in the bitstream
+ */
+GF_Err gf_bs_forward_external(GF_BitStream *bs, u32 nb_bytes);
+
 
 /*!
 \brief integer reading
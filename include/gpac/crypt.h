@@ -141,6 +141,32 @@ GF_Err gf_crypt_encrypt(GF_Crypt *gfc, void *plaintext, u32 size);
 */
 GF_Err gf_crypt_decrypt(GF_Crypt *gfc, void *ciphertext, u32 size);
 
+/*! encrypts a payload using a pattern of encrypted and clear blocks, as used by CENC cens and cbcs schemes. The encryption is done inplace.
+The payload is split in patterns of crypt_block encrypted 16-byte blocks followed by skip_block clear 16-byte blocks. If the last pattern is incomplete, its first crypt_block blocks (or the remaining bytes if less) are encrypted.
+The crypto state is only updated by the encrypted blocks: this is equivalent to calling \ref gf_crypt_encrypt on each encrypted range, but done in a single call.
+If crypt_block or skip_block is 0, the entire payload is encrypted.
+
+\param gfc the target crytpo context
+\param buffer the clear buffer
+\param size the size of the clear buffer
+\param crypt_block number of encrypted 16-byte blocks in the pattern
+\param skip_block number of clear 16-byte blocks in the pattern
+\return error if any
+*/
+GF_Err gf_crypt_encrypt_pattern(GF_Crypt *gfc, void *buffer, u32 size, u32 crypt_block, u32 skip_block);
+
+/*! decrypts a payload using a pattern of encrypted and clear blocks, as used by CENC cens and cbcs schemes. The decryption is done inplace.
+See \ref gf_crypt_encrypt_pattern for the pattern semantics.
+
+\param gfc the target crytpo context
+\param buffer the encrypted buffer
+\param size the size of the encrypted buffer
+\param crypt_block number of encrypted 16-byte blocks in the pattern
+\param skip_block number of clear 16-byte blocks in the pattern
+\return error if any
+*/
+GF_Err gf_crypt_decrypt_pattern(GF_Crypt *gfc, void *buffer, u32 size, u32 crypt_block, u32 skip_block);
+
 
 /*! @} */
 
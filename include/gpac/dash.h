@@ -153,6 +153,9 @@ struct _gf_dash_io
 	/*! callback when manifest (DASH, HLS) or sub-playlist (HLS) is updated*/
 	void (*manifest_updated)(GF_DASHFileIO *dashio, const char *manifest_name, const char *local_path, s32 group_idx);
 
+	/*! callback when a remote segment is queued behind the segment being fetched, see \ref gf_dash_set_segment_prefetch. Function is optional*/
+	void (*prefetch_segment)(GF_DASHFileIO *dashio, const char *url, u64 start_range, u64 end_range, s32 group_idx);
+
 };
 
 /*! DASH client object*/
@@ -724,6 +727,12 @@ typedef enum
 */
 void gf_dash_set_low_latency_mode(GF_DashClient *dash, GF_DASHLowLatencyMode low_lat_mode);
 
+/*! sets the number of segments queued for each group behind the segment being fetched. Each queued remote segment is signaled through the prefetch_segment callback of the DASH IO so that it can be downloaded in parallel. Queued segments keep the quality selected at the time they are queued. Default is 0 (no prefetch)
+\param dash the target dash client
+\param nb_segments number of segments to prefetch per group
+*/
+void gf_dash_set_segment_prefetch(GF_DashClient *dash, u32 nb_segments);
+
 /*! indicates typical buffering used by the user app before playback starts.
  This allows fetching data earlier in live mode, if the timeshiftbuffer allows for it
 \param dash the target dash client
@@ -534,6 +534,38 @@ Forces HTTP headers for a given cache entry
 */
 GF_Err gf_dm_force_headers(GF_DownloadManager *dm, const DownloadedCacheEntry entry, const char *headers);
 
+/*! cache statistics of a download manager*/
+typedef struct
+{
+	/*! number of cache entries*/
+	u32 nb_entries;
+	/*! number of cache entries stored in memory and owned by the cache*/
+	u32 nb_mem_entries;
+	/*! bytes currently allocated by memory entries*/
+	u64 mem_used;
+	/*! highest value of mem_used seen so far*/
+	u64 mem_peak;
+	/*! memory budget in bytes, 0 if unlimited (see -cache-mem)*/
+	u64 mem_max;
+	/*! number of requests served from cache, either directly or after revalidation*/
+	u64 hits;
+	/*! number of requests for which a new cache entry was created*/
+	u64 misses;
+	/*! number of memory entries evicted to meet the memory budget*/
+	u64 evictions;
+	/*! number of evicted memory entries moved to the disk cache (see -cache-mem-spill)*/
+	u64 spills;
+} GF_DMCacheStats;
+
+/*!
+Gets cache statistics of a download manager. Memory entries not attached to any download session are evicted in least recently used order when the total memory exceeds the budget set by the -cache-mem option
+
+\param dm the download manager
+\param stats filled with the cache statistics
+eturn error code if any
+*/
+GF_Err gf_dm_get_cache_stats(GF_DownloadManager *dm, GF_DMCacheStats *stats);
+
 /*! HTTP methods*/
 enum
 {
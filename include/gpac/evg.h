@@ -389,6 +389,14 @@ with normalized coordinates in [-1,1]. It may also contain a modelview part.
 */
 GF_Err gf_evg_surface_set_matrix_3d(GF_EVGSurface *surf, GF_Matrix *mat);
 
+/*! sets the number of extra threads used to rasterize paths on this surface
+When set, the sort and fill pass of large paths is split in horizontal bands of the clipper rectangle rendered in parallel, the calling thread rendering the first band. Paths drawn with an alpha callback or a parametric texture are always rendered on the calling thread. This does not apply to 3D surfaces
+\param surf the surface object
+\param nb_threads number of extra threads to use, 0 disables banded rendering
+\return error if any
+*/
+GF_Err gf_evg_surface_set_raster_threads(GF_EVGSurface *surf, u32 nb_threads);
+
 /*! sets the given rectangle as a clipper
 When a clipper is enabled, nothing is drawn outside of the clipper. The clipper is not affected by the surface matrix
 \param surf the surface object
@@ -201,7 +201,9 @@ typedef enum
 	/*! In this mode, the scheduler uses locks for packet and property queues even if single-threaded (test mode) */
 	GF_FS_SCHEDULER_LOCK_FORCE,
 	/*! In this mode, the scheduler uses direct dispatch and no threads, trying to nest task calls within task calls */
-	GF_FS_SCHEDULER_DIRECT
+	GF_FS_SCHEDULER_DIRECT,
+	/*! In this mode, the scheduler behaves as \ref GF_FS_SCHEDULER_LOCK_FREE but each session thread has its own task list, filter tasks are posted to the task list of the thread which last processed the filter, and idle threads steal tasks from the other threads task lists */
+	GF_FS_SCHEDULER_WORK_STEAL
 } GF_FilterSchedulerType;
 
 /*! Flag set to indicate meta filters should be loaded. A meta filter is a filter providing various sub-filters.
@@ -220,6 +220,7 @@ struct __tag_compositor
 	GF_VideoOutput *video_out;
 
 	Bool softblt;
+	u32 rthreads;
 
 	Bool discard_input_events;
 	u32 video_th_id;
@@ -1217,6 +1218,37 @@ Bool gf_mixer_must_reconfig(GF_AudioMixer *am);
 Bool gf_mixer_empty(GF_AudioMixer *am);
 Bool gf_mixer_buffering(GF_AudioMixer *am);
 
+/*resampling quality of the mixer*/
+enum
+{
+	/*linear interpolation between input samples*/
+	GF_MIXER_RESAMPLE_LINEAR=0,
+	/*polyphase FIR filtering, 16 taps*/
+	GF_MIXER_RESAMPLE_LOW,
+	/*polyphase FIR filtering, 32 taps*/
+	GF_MIXER_RESAMPLE_MEDIUM,
+	/*polyphase FIR filtering, 64 taps*/
+	GF_MIXER_RESAMPLE_HIGH,
+};
+/*sets resampling quality, default is GF_MIXER_RESAMPLE_LINEAR*/
+void gf_mixer_set_resample_quality(GF_AudioMixer *am, u32 quality);
+
+/*polyphase FIR resampler on s32 planar samples*/
+typedef struct __audio_resampler GF_AudioResampler;
+/*creates a resampler - filter banks are shared between resamplers created with the same bank_cache list, which may be NULL*/
+GF_AudioResampler *gf_resampler_new(GF_List *bank_cache, u32 in_sr, u32 out_sr, u32 nb_ch, u32 quality);
+void gf_resampler_del(GF_AudioResampler *rs);
+/*discards history, the next pushed sample is the first sample of the stream*/
+void gf_resampler_reset(GF_AudioResampler *rs);
+/*returns the number of input samples to push before nb_out samples can be produced*/
+u32 gf_resampler_input_needed(GF_AudioResampler *rs, u32 nb_out);
+/*pushes input samples, channel i being read from planes[i] - if planes is NULL, silence is pushed. Returns the number of samples used*/
+u32 gf_resampler_push(GF_AudioResampler *rs, s32 **planes, u32 nb_samples);
+/*pushes enough silence to output the filter tail, used at end of stream*/
+void gf_resampler_flush(GF_AudioResampler *rs);
+/*produces up to nb_out samples, channel i being written to dst[i]. Returns the number of samples produced*/
+u32 gf_resampler_process(GF_AudioResampler *rs, s32 **dst, u32 nb_out);
+
 //#define ENABLE_AOUT
 
 /*the audio renderer*/
@@ -38,7 +38,7 @@ struct _gf_crypt_context
 	GF_CRYPTO_ALGO algo; //single value for now
 	GF_CRYPTO_MODE mode; //CBC or CTR
 
-	/* Internal context for openSSL or tiny AES*/
+	/* Internal context for AES-NI, openSSL or tiny AES*/
 	void *context;
 
 	//ptr to encryption function
@@ -50,8 +50,14 @@ struct _gf_crypt_context
 	GF_Err(*_decrypt) (GF_Crypt*, u8 *buffer, u32 size);
 	GF_Err(*_set_state) (GF_Crypt*, const u8 *IV, u32 IV_size);
 	GF_Err(*_get_state) (GF_Crypt*, u8 *IV, u32 *IV_size);
+	//optional pattern encryption functions, emulated through _crypt and _decrypt if not set
+	GF_Err(*_crypt_pattern) (GF_Crypt*, u8 *buffer, u32 size, u32 crypt_block, u32 skip_block);
+	GF_Err(*_decrypt_pattern) (GF_Crypt*, u8 *buffer, u32 size, u32 crypt_block, u32 skip_block);
 };
 
+//returns GF_NOT_SUPPORTED if the AES instructions are not available
+GF_Err gf_crypt_open_open_aesni(GF_Crypt* td, GF_CRYPTO_MODE mode);
+
 #ifdef GPAC_HAS_SSL
 GF_Err gf_crypt_open_open_openssl(GF_Crypt* td, GF_CRYPTO_MODE mode);
 #else
@@ -1110,6 +1110,12 @@ typedef struct
 	u32 r_currentEntryIndex;
 	u64 r_CurrentDTS;
 
+	/*lazily built index for READ random access: first sample number and DTS of each entry - only enabled for read-only files*/
+	Bool r_idx_enabled;
+	u32 r_idx_nb, r_idx_alloc;
+	u32 *r_idx_first_sample;
+	u64 *r_idx_dts;
+
 	//stats for read
 	u32 max_ts_delta;
 } GF_TimeToSampleBox;
@@ -1137,6 +1143,11 @@ typedef struct
 	u32 r_currentEntryIndex;
 	u32 r_FirstSampleInEntry;
 
+	/*lazily built index for READ random access: first sample number of each entry - only enabled for read-only files*/
+	Bool r_idx_enabled;
+	u32 r_idx_nb, r_idx_alloc;
+	u32 *r_idx_first_sample;
+
 	//stats for read
 	s32 max_ts_delta;
 } GF_CompositionOffsetBox;
@@ -1533,6 +1544,7 @@ static const u8 GF_ISOM_IPOD_EXT[][16] = { { 0x6B, 0x68, 0x40, 0xF2, 0x5F, 0x24,
 
 Bool gf_isom_is_nalu_based_entry(GF_MediaBox *mdia, GF_SampleEntryBox *_entry);
 GF_Err gf_isom_nalu_sample_rewrite(GF_MediaBox *mdia, GF_ISOSample *sample, u32 sampleNumber, GF_MPEGVisualSampleEntryBox *entry);
+Bool gf_isom_nalu_sample_is_untouched(GF_MediaBox *mdia, GF_ISOSample *sample, GF_MPEGVisualSampleEntryBox *entry);
 
 /*this is the default visual sdst (to handle unknown media)*/
 typedef struct
@@ -1881,6 +1893,11 @@ typedef struct
 	u32 currentChunk;
 	u32 ghostNumber;
 
+	/*lazily built index for READ random access: first sample number of each entry - only enabled for read-only files*/
+	Bool r_idx_enabled;
+	u32 r_idx_nb, r_idx_alloc;
+	u32 *r_idx_first_sample;
+
 	u32 w_lastSampleNumber;
 	u32 w_lastChunkNumber;
 } GF_SampleToChunkBox;
@@ -2554,6 +2571,15 @@ typedef struct
 	u32 sequence_number;
 } GF_MovieFragmentHeaderBox;
 
+/*payload of a fragment kept by reference until the fragment is written*/
+typedef struct
+{
+	u8 *data;
+	u32 size;
+	/*user reference, NULL if data is a copy owned by the fragment*/
+	void *ref;
+} GF_FragmentDataRef;
+
 /*MovieFragment is a container IN THE FILE, contains 1 fragment*/
 typedef struct
 {
@@ -2572,6 +2598,12 @@ typedef struct
 	//temp storage of prft box
 	GF_ISOTrackID reference_track_ID;
 	u64 ntp, timestamp;
+
+	//payloads not written in the mdat bitstream, dispatched after the mdat header when writing the fragment
+	Bool use_data_refs;
+	GF_FragmentDataRef *data_refs;
+	u32 nb_data_refs, alloc_data_refs;
+	u32 data_refs_size;
 } GF_MovieFragmentBox;
 
 
@@ -3824,6 +3856,8 @@ typedef struct
 
 /*regular file IO*/
 #define GF_ISOM_DATA_FILE         0x01
+/*File Mapping object, read-only mode on complete files (no download)*/
+#define GF_ISOM_DATA_FILE_MAPPING 0x02
 /*External file object. Needs implementation*/
 #define GF_ISOM_DATA_FILE_EXTERN  0x03
 /*regular memory IO*/
@@ -3897,6 +3931,13 @@ u32 gf_isom_fdm_get_data(GF_FileDataMap *ptr, u8 *buffer, u32 bufferLength, u64
 GF_DataMap *gf_isom_fdm_new_temp(const char *sTempPath);
 #endif
 
+/*File mapping data map, only for complete files opened in read mode - returns NULL if file mapping is not available*/
+GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode);
+void gf_isom_fmo_del(GF_FileMappingDataMap *ptr);
+u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, u8 *buffer, u32 bufferLength, u64 fileOffset);
+/*returns pointer to mapped data, or NULL if out of range*/
+const u8 *gf_isom_fmo_get_data_ref(GF_FileMappingDataMap *ptr, u32 size, u64 fileOffset);
+
 #ifndef GPAC_DISABLE_ISOM_WRITE
 u64 gf_isom_datamap_get_offset(GF_DataMap *map);
 GF_Err gf_isom_datamap_add_data(GF_DataMap *ptr, u8 *data, u32 dataSize);
@@ -4055,6 +4096,7 @@ struct __tag_isom {
 	GF_Err (*on_block_patch)(void *usr_data, u8 *block, u32 block_size, u64 block_offset, Bool is_insert);
 	void *on_block_out_usr_data;
 	u32 on_block_out_block_size;
+	GF_Err (*on_block_ref)(void *usr_data, u8 *block, u32 block_size, void *data_ref);
 
 	//in block disptach mode we don't have the full file, keep the position
 	u64 fragmented_file_pos;
@@ -4141,6 +4183,10 @@ GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offse
 GF_Err stbl_GetSampleShadow(GF_ShadowSyncBox *stsh, u32 *sampleNumber, u32 *syncNum);
 GF_Err stbl_GetPaddingBits(GF_PaddingBitsBox *padb, u32 SampleNumber, u8 *PadBits);
 GF_Err stbl_GetSampleDepType(GF_SampleDependencyTypeBox *stbl, u32 SampleNumber, u32 *isLeading, u32 *dependsOn, u32 *dependedOn, u32 *redundant);
+/*enable the random access indexes of stts, ctts and stsc. The tables must not be edited afterwards, except by appending
+entries (fragment merging) or by resetting them through stbl_reset_read_index*/
+void stbl_enable_read_index(GF_SampleTableBox *stbl);
+void stbl_reset_read_index(GF_SampleTableBox *stbl);
 
 
 /*unpack sample2chunk and chunk offset so that we have 1 sample per chunk (edition mode only)*/
@@ -75,4 +75,38 @@ void mult_polys(int dst[], int p1[], int p2[]);
 
 void copy_poly(int dst[], int src[]);
 void zero_poly(int poly[]);
+
+
+/* Reed-Solomon erasure code over GF(2^8) as defined in RFC 5510 (FEC encoding ID 5), using the same field generator polynomial as above
+
+The code is systematic: encoding symbols 0 to k-1 of a source block are the source symbols, repair symbol of index esi (k <= esi < 255) is the value at alpha^esi
+of the polynomial of degree k-1 taking the values of the source symbols at alpha^0 ... alpha^(k-1). Any k distinct encoding symbols recover the source block.
+These functions do not use any global state other than constant field tables and can be called from any thread*/
+
+/*! maximum number of encoding symbols in a source block*/
+#define GF_RS_ERASURE_MAX_SYMBOLS	255
+
+/*! computes repair symbols of a source block
+\param src the k source symbols of the block
+\param k number of source symbols in the block, at most 254
+\param first_esi index of the first repair symbol to compute, at least k
+\param nb_repair number of consecutive repair symbols to compute, first_esi+nb_repair shall not exceed 255
+\param repair destination buffers for the repair symbols
+\param symbol_size size in bytes of each symbol
+\return error if any
+*/
+GF_Err gf_rs_erasure_encode(u8 **src, u32 k, u32 first_esi, u32 nb_repair, u8 **repair, u32 symbol_size);
+
+/*! recovers missing source symbols of a source block
+\param src the k source symbols of the block. Buffers for missing symbols must be allocated and are filled by the decoder
+\param src_present flags (k entries) indicating if the corresponding source symbol was received
+\param k number of source symbols in the block, at most 254
+\param repair received repair symbols
+\param repair_esi encoding symbol index of each received repair symbol
+\param nb_repair number of received repair symbols
+\param symbol_size size in bytes of each symbol
+\return error if any, GF_CORRUPTED_DATA if not enough repair symbols are available
+*/
+GF_Err gf_rs_erasure_decode(u8 **src, const u8 *src_present, u32 k, u8 **repair, const u32 *repair_esi, u32 nb_repair, u32 symbol_size);
+
 #endif //_ECC_H_
@@ -758,6 +758,14 @@ If the movie is successfully loaded (isom_file non-NULL), BytesMissing is zero
 */
 GF_Err gf_isom_open_progressive_ex(const char *fileName, u64 start_range, u64 end_range, Bool enable_frag_templates, GF_ISOFile **isom_file, u64 *BytesMissing, u32 *topBoxType);
 
+/*! switches a file opened in read mode to a memory-mapped view of the file, if supported by the platform.
+This shall only be used on complete local files which are no longer modified, and fails if the file was opened on a byte range.
+Sample data is then copied from the mapping rather than read through file IO, and can be accessed without copy using \ref gf_isom_get_sample_data_ref
+\param isom_file the target ISO file
+\return error if any, GF_NOT_SUPPORTED if file mapping cannot be used for this file
+*/
+GF_Err gf_isom_enable_file_mapping(GF_ISOFile *isom_file);
+
 /*! retrieves number of bytes missing.
 if requesting a sample fails with error GF_ISOM_INCOMPLETE_FILE, use this function
 to get the number of bytes missing to retrieve the sample
@@ -1047,6 +1055,18 @@ GF_ISOSample *gf_isom_get_sample_info(GF_ISOFile *isom_file, u32 trackNumber, u3
 */
 GF_ISOSample *gf_isom_get_sample_info_ex(GF_ISOFile *isom_file, u32 trackNumber, u32 sampleNumber, u32 *sampleDescriptionIndex, u64 *data_offset, GF_ISOSample *static_sample);
 
+/*! gets a pointer to the sample payload in the file mapping, without copying data. The file must have been switched to file mapping using \ref gf_isom_enable_file_mapping
+The payload is only exposed if it does not need any rewriting (NAL-based extractors or parameter set insertion, OD or text conversion, ...); for NAL-based tracks, the SAP type of the sample may be updated as done by \ref gf_isom_get_sample_ex
+\param isom_file the target ISO file
+\param trackNumber the target track
+\param sampleDescriptionIndex the sample description index of the sample as retrieved by \ref gf_isom_get_sample_info_ex
+\param data_offset the sample data offset as retrieved by \ref gf_isom_get_sample_info_ex
+\param sample the sample as retrieved by \ref gf_isom_get_sample_info_ex
+\param data set to the sample payload in the file mapping, valid until the file is closed. This memory is read-only
+\return error if any, GF_NOT_SUPPORTED if the payload cannot be used without copy - \ref gf_isom_get_sample_ex shall then be used
+*/
+GF_Err gf_isom_get_sample_data_ref(GF_ISOFile *isom_file, u32 trackNumber, u32 sampleDescriptionIndex, u64 data_offset, GF_ISOSample *sample, const u8 **data);
+
 /*! get sample decoding time
 \param isom_file the target ISO file
 \param trackNumber the target track
@@ -2681,6 +2701,20 @@ GF_Err gf_isom_set_write_callback(GF_ISOFile *isom_file,
  			void *usr_data,
  			u32 block_size);
 
+/*! sets the callback function for fragment payloads written by reference
+
+When set, payloads passed with a reference to \ref gf_isom_fragment_add_sample_ref and \ref gf_isom_fragment_append_data_ref are not copied but kept until the fragment is written, and are then dispatched through this callback right after the mdat header, in place of the block write callback. This only applies to fragments with the moof stored first; payloads are copied otherwise.
+
+The callback is called exactly once for each reference kept by the library:
+- with the payload data and size when the payload is written
+- with NULL data and a size of 0 when the reference is no longer used, in which case the payload has been copied or the fragment was discarded
+
+\param isom_file the target ISO file, with write callbacks already set (see \ref gf_isom_set_write_callback)
+\param on_block_ref the reference write callback function, called with the user data of the write callback
+\return error if any
+*/
+GF_Err gf_isom_set_write_ref_callback(GF_ISOFile *isom_file, GF_Err (*on_block_ref)(void *usr_data, u8 *block, u32 block_size, void *data_ref));
+
 /*! checks if file will use in-place rewriting or not
 \param isom_file the target ISO file
 \return GF_TRUE if in-place rewrite is used, GF_FALSE otherwise
@@ -4507,6 +4541,25 @@ GF_Err gf_isom_fragment_add_sample(GF_ISOFile *isom_file, GF_ISOTrackID TrackID,
                                    u32 sampleDescriptionIndex,
                                    u32 Duration, u8 PaddingBits, u16 DegradationPriority, Bool redundantCoding);
 
+/*! adds a sample to a fragmented track, keeping its payload by reference
+
+Same as \ref gf_isom_fragment_add_sample, but the sample payload is not copied if the reference write callback is set (see \ref gf_isom_set_write_ref_callback). The payload must then remain valid until the reference is handed back through the callback.
+\param isom_file the target ISO file
+\param TrackID destination track
+\param sample sample to add
+\param sampleDescriptionIndex sample description for this sample. If 0, the default one
+is used
+\param Duration sample duration; the sample duration MUST be provided at least for the last sample (for intermediate samples, it is recomputed internally by the lib)
+\param PaddingBits padding bits for the sample, or 0
+\param DegradationPriority for the sample, or 0
+\param redundantCoding indicates this is samples acts as a sync shadow point
+\param data_ref opaque reference of the sample payload, or NULL to copy the payload. If an error is returned, the reference is not used by the library
+\return error if any
+*/
+GF_Err gf_isom_fragment_add_sample_ref(GF_ISOFile *isom_file, GF_ISOTrackID TrackID, const GF_ISOSample *sample,
+                                   u32 sampleDescriptionIndex,
+                                   u32 Duration, u8 PaddingBits, u16 DegradationPriority, Bool redundantCoding, void *data_ref);
+
 /*! appends data into last sample of track for video fragments/other media
 \warning This shall not be used with OD tracks
 \param isom_file the target ISO file
@@ -4518,6 +4571,20 @@ GF_Err gf_isom_fragment_add_sample(GF_ISOFile *isom_file, GF_ISOTrackID TrackID,
 */
 GF_Err gf_isom_fragment_append_data(GF_ISOFile *isom_file, GF_ISOTrackID TrackID, u8 *data, u32 data_size, u8 PaddingBits);
 
+/*! appends data into last sample of track for video fragments/other media, keeping the data by reference
+
+Same as \ref gf_isom_fragment_append_data, but the data is not copied if the reference write callback is set (see \ref gf_isom_set_write_ref_callback)
+\warning This shall not be used with OD tracks
+\param isom_file the target ISO file
+\param TrackID destination track
+\param data the data to append
+\param data_size the size of the data to append
+\param PaddingBits padding bits for the sample, or 0
+\param data_ref opaque reference of the data, or NULL to copy the data. If an error is returned, the reference is not used by the library
+\return error if any
+*/
+GF_Err gf_isom_fragment_append_data_ref(GF_ISOFile *isom_file, GF_ISOTrackID TrackID, u8 *data, u32 data_size, u8 PaddingBits, void *data_ref);
+
 
 /*! sets side information for common encryption for the last added sample
 \param isom_file the target ISO file
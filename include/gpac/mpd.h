@@ -866,6 +866,8 @@ typedef struct {
 	Bool m3u8_time;
 	/*! indicates  LL-HLS forced generation. 0: regular write, 1: write as byterange, 2: write as independent files*/
 	u32 force_llhls_mode;
+	/*! segment timelines created while loading the manifest file, only set during \ref gf_mpd_init_from_file - GPAC internal*/
+	GF_List *loaded_timelines;
 } GF_MPD;
 
 /*! parses an MPD Element (and subtree) from DOM
@@ -882,6 +884,14 @@ GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *base_url)
 \return error if any
 */
 GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *base_url);
+/*! parses an MPD file. SegmentTimeline entries are created while reading the file and are not loaded in a DOM tree, which is much faster for large timelines
+\param file the local MPD file to parse
+\param mpd MPD structure to fill
+\param base_url base URL of the document
+\param nb_timeline_entries set to the number of SegmentTimeline entries parsed - optional, may be NULL
+\return error if any
+*/
+GF_Err gf_mpd_init_from_file(const char *file, GF_MPD *mpd, const char *base_url, u32 *nb_timeline_entries);
 /*! MPD constructor
 \return a new MPD*/
 GF_MPD *gf_mpd_new();
@@ -550,6 +550,16 @@ typedef struct __m2ts_demux_table
 	GF_List *sections;
 	/*! total table size*/
 	u32 table_size;
+	/*! cache of the last valid sections received, indexed by section number*/
+	struct __m2ts_section_cache *section_cache;
+	/*! number of entries in section cache*/
+	u32 section_cache_size;
+	/*! number of sections of the current table skipped as exact repeats of cached sections*/
+	u32 nb_skipped_sections;
+	/*! section number of the first skipped section*/
+	u32 first_skipped_section;
+	/*! total size of skipped sections*/
+	u32 skipped_size;
 } GF_M2TS_Table;
 
 
@@ -1125,6 +1135,11 @@ struct tag_m2ts_demux
 	if set, on_event shall be non-null
 	*/
 	Bool split_mode;
+
+	/*! burst mode: payload-only continuation packets of PES streams are grouped per PID over the input buffer and appended to their PES without per-packet processing*/
+	Bool burst_mode;
+	/*! private burst mode state*/
+	struct __m2ts_burst *burst;
 };
 
 //! @endcond
@@ -1186,6 +1201,15 @@ GF_M2TS_SDT *gf_m2ts_get_sdt_info(GF_M2TS_Demuxer *demux, u32 program_id);
 */
 void gf_m2ts_flush_pes(GF_M2TS_Demuxer *demux, GF_M2TS_PES *pes, Bool force_flush);
 
+/*! swaps the PES reassembly buffer of a stream. This can be used while processing a GF_M2TS_EVT_PES_PCK event whose data points to the PES reassembly buffer, in order to take ownership of the event data instead of copying it. The reassembly of the next PES of this stream will use the new buffer, growing it if needed
+\param pes the target stream
+\param buffer the new reassembly buffer, allocated with gf_malloc - may be NULL
+\param alloc_size the allocated size of the new buffer
+\param detached_alloc_size set to the allocated size of the returned buffer
+\return the previous reassembly buffer, now owned by the caller and to be freed with gf_free
+*/
+u8 *gf_m2ts_pes_swap_buffer(GF_M2TS_PES *pes, u8 *buffer, u32 alloc_size, u32 *detached_alloc_size);
+
 /*! flushes all streams in the mux. This is used to flush internal demultiplexer buffers on end of stream
 \param demux the target MPEG-2 demultiplexer
 \param no_force_flush do not force a flush of incomplete PES (used for HLS)
@@ -1510,6 +1534,8 @@ typedef struct __m2ts_mux_stream {
 	u32 pid;
 	/*! CC of the stream*/
 	u8 continuity_counter;
+	/*! TS packet header template (sync byte and PID bytes)*/
+	u8 pck_hdr[3];
 	/*! parent program*/
 	struct __m2ts_mux_program *program;
 	/*! average stream bit-rate in bit/sec*/
@@ -1796,6 +1822,8 @@ struct __m2ts_mux {
 	u64 last_pts;
 	/*! last PID (used when dashing to build sidx)*/
 	u32 last_pid;
+	/*! end of the current run of NULL packets (fixed rate only), set when a NULL packet is produced*/
+	GF_M2TS_Time null_run_end;
 };
 
 /*! default refresh rate for PSI data*/
@@ -1897,6 +1925,12 @@ typedef enum
 \return packet produced or NULL if error or idle
 */
 const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *usec_till_next);
+/*! consumes NULL packets following the NULL packet just produced by \ref gf_m2ts_mux_process, without scheduling the streams again. In fixed rate and non real-time mode, the multiplexer knows when the next data of each stream is due, and the NULL packets until that time can be written in a single batch. The multiplexer time and counters are updated as if \ref gf_m2ts_mux_process was called for each NULL packet
+\param muxer the target MPEG-2 TS multiplexer
+\param max_packets maximum number of NULL packets to consume
+\return number of NULL packets consumed, to be written after the previous NULL packet
+*/
+u32 gf_m2ts_mux_consume_null_packets(GF_M2TS_Mux *muxer, u32 max_packets);
 /*! gets the system clock of the multiplexer (time ellapsed since start)
 \param muxer the target MPEG-2 TS multiplexer
 \return system clock of the multiplexer in milliseconds
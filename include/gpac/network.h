@@ -432,6 +432,18 @@ Sends a buffer on the socket. The socket must be in a bound or connected mode
  */
 GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length);
 /*!
+\brief file data emission
+
+Sends a range of a file on a connected TCP socket without copying file data to user memory, using sendfile() when available
+\param sock the socket object
+\param file the file to send data from; the file position is not modified
+\param offset the offset in the file of the first byte to send
+\param length the number of bytes to send
+\param written set to the number of bytes actually sent, which may be less than length if end of file was reached or if the socket would block - may be NULL
+\return error if any, GF_IP_SOCK_WOULD_BLOCK if nothing could be sent, or GF_NOT_SUPPORTED if zero-copy sending is not available for this socket, file or platform - in that case nothing was sent
+ */
+GF_Err gf_sk_send_file(GF_Socket *sock, FILE *file, u64 offset, u32 length, u32 *written);
+/*!
 \brief data reception
 
 Fetches data on a socket. The socket must be in a bound or connected state
@@ -596,6 +608,39 @@ Fetches data on a socket without performing any select (wait), to be used with s
  */
 GF_Err gf_sk_receive_no_select(GF_Socket *sock, u8 *buffer, u32 length, u32 *read);
 
+/*! datagram descriptor for batch socket I/O*/
+typedef struct
+{
+	/*! data buffer of the datagram*/
+	u8 *data;
+	/*! for emission, size of the datagram to send; for reception, allocated size of the data buffer*/
+	u32 size;
+	/*! for reception, size of the received datagram*/
+	u32 read;
+} GF_SockDatagram;
+
+/*!
+Fetches several datagrams on a socket without performing any select (wait), using a single system call when supported (recvmmsg). For blocking sockets, the call only waits for the first datagram.
+Stream sockets or platforms without batch reception fetch a single datagram per call.
+\param sock the socket object
+\param dgrams array of datagram descriptors; each datagram is received in its own buffer, and datagrams larger than their buffer are truncated
+\param nb_dgrams number of datagram descriptors
+\param nb_received set to the number of received datagrams - may be NULL
+\return error if any, GF_IP_NETWORK_EMPTY or GF_IP_SOCK_WOULD_BLOCK if nothing to read
+ */
+GF_Err gf_sk_receive_batch(GF_Socket *sock, GF_SockDatagram *dgrams, u32 nb_dgrams, u32 *nb_received);
+
+/*!
+Sends several datagrams on a socket, using as few system calls as possible when supported (sendmmsg). The socket must be in a bound or connected mode.
+Stream sockets or platforms without batch emission send datagrams one by one.
+\param sock the socket object
+\param dgrams array of datagram descriptors
+\param nb_dgrams number of datagram descriptors
+\param nb_sent set to the number of datagrams sent, which is less than nb_dgrams in case of error - may be NULL
+\return error if any
+ */
+GF_Err gf_sk_send_batch(GF_Socket *sock, const GF_SockDatagram *dgrams, u32 nb_dgrams, u32 *nb_sent);
+
 /*!
 Checks if connection has been closed by remote peer
 \param sock the socket object
@@ -643,6 +688,7 @@ Deletes a socket group
 void gf_sk_group_del(GF_SockGroup *sg);
 /*!
 Registers a socket to a socket group
+\note On Linux, socket groups use epoll and the socket descriptor stays registered until \ref gf_sk_group_unregister is called; a socket registered before being bound or connected is added to the group once its descriptor is created. A socket can only belong to a single group
 \param sg socket group object
 \param sk socket object to register
  */
@@ -0,0 +1 @@
+#define GPAC_GIT_REVISION	"UNKNOWN-master"
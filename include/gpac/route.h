@@ -190,6 +190,23 @@ GF_Err gf_route_set_reorder(GF_ROUTEDmx *routedmx, Bool force_reorder, u32 timeo
  */
 GF_Err gf_route_set_allow_progressive_dispatch(GF_ROUTEDmx *routedmx, Bool allow_progressive);
 
+/*! Sets the number of LCT packets to read per system call on ROUTE sessions (batch reception)
+
+\param routedmx the ROUTE demultiplexer
+\param nb_packets maximum number of packets per read, 0 or 1 disables batch reception
+\return error code if any
+ */
+GF_Err gf_route_set_batch_size(GF_ROUTEDmx *routedmx, u32 nb_packets);
+
+/*! Sets the number of receive threads. Services are sharded across the threads, which read sockets, reassemble LCT objects and perform FEC recovery.
+Completed objects are dispatched to the user callback from \ref gf_route_dmx_process only, so that the callback is never called from a receive thread.
+This must be called once, before any call to \ref gf_route_dmx_process
+\param routedmx the ROUTE demultiplexer
+\param nb_threads number of receive threads, 0 means reception in caller thread
+\return error code if any
+ */
+GF_Err gf_route_set_receive_threads(GF_ROUTEDmx *routedmx, u32 nb_threads);
+
 /*! Sets the service ID to tune into for ATSC 3.0
 \param routedmx the ROUTE demultiplexer
 \param service_id ID of the service to tune in. 0 means no service, 0xFFFFFFFF means all services and 0xFFFFFFFE means first service found
@@ -223,6 +223,16 @@ Sets the thread execution priority level.
  */
 void gf_th_set_priority(GF_Thread *th, s32 priority);
 /*!
+\brief thread CPU affinity
+
+Restricts execution of the thread to the given set of CPUs.
+\param th the thread object, or NULL for the calling thread
+\param cpus array of CPU indexes the thread may run on
+\param nb_cpus number of CPU indexes in the array
+\return error if any, GF_NOT_SUPPORTED if the platform does not support thread affinity
+ */
+GF_Err gf_th_set_affinity(GF_Thread *th, const u32 *cpus, u32 nb_cpus);
+/*!
 \brief current thread ID
 
 Gets the ID of the current thread the caller is in.
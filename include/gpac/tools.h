@@ -986,6 +986,8 @@ typedef struct
     u32 flags;
     /*! blob mutex for multi-thread access */
     struct __tag_mutex *mx;
+    /*! number of \ref gf_blob_get calls not yet released, the blob data is not discarded while non zero */
+    u32 ref_count;
 } GF_Blob;
 
 /*!
@@ -1198,6 +1200,41 @@ Gets CPU and memory usage info for the calling process and the system. Informati
  */
 Bool gf_sys_get_rti(u32 refresh_time_ms, GF_SystemRTInfo *rti, u32 flags);
 
+/*! CPU features flags*/
+enum
+{
+	/*! x86 SSE2 instructions available*/
+	GF_CPU_SSE2 = 1,
+	/*! x86 SSSE3 instructions available*/
+	GF_CPU_SSSE3 = 1<<1,
+	/*! x86 SSE4.1 instructions available*/
+	GF_CPU_SSE41 = 1<<2,
+	/*! x86 AVX2 instructions available and supported by OS*/
+	GF_CPU_AVX2 = 1<<3,
+	/*! x86 AES-NI instructions available*/
+	GF_CPU_AES = 1<<4,
+	/*! x86 carry-less multiplication instructions available*/
+	GF_CPU_PCLMUL = 1<<5,
+	/*! ARM NEON instructions available*/
+	GF_CPU_NEON = 1<<6
+};
+
+/*!
+\brief Gets CPU features
+
+Gets the SIMD instruction sets available on the CPU, as detected at first call and possibly restricted by \ref gf_sys_set_cpu_features or the `-no-simd` option. Optimized code paths shall check these flags before use.
+\return CPU features flags
+ */
+u32 gf_sys_get_cpu_features();
+
+/*!
+\brief Restricts CPU features
+
+Restricts the SIMD instruction sets used by GPAC. This is typically used to test or benchmark scalar code paths.
+\param features CPU features flags to allow (only features supported by the CPU will be enabled), 0 disables all SIMD code paths
+ */
+void gf_sys_set_cpu_features(u32 features);
+
 /*!	@} */
 
 /*!
@@ -54,6 +54,17 @@ typedef struct
 	Fixed pan[GF_AUDIO_MIXER_MAX_CHANNELS];
 
 	s32 (*get_sample)(u8 *data, u32 nb_ch, u32 sample_offset, u32 channel, u32 planar_stride);
+	/*converts nb_samples samples of all channels starting at sample_offset to s32, channel i being written at dst[i]+dst_offset*/
+	void (*get_block)(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset);
+	/*converted input samples for resampling, one plane per channel*/
+	s32 *cvt_buf;
+	u32 cvt_size;
+	/*polyphase resampler, NULL when using linear interpolation*/
+	GF_AudioResampler *rs;
+	/*resampled samples before channel mapping*/
+	s32 *rs_buf;
+	u32 rs_size;
+	Bool rs_flushed;
 	Bool is_planar;
 	Bool muted;
 } MixerInput;
@@ -79,13 +90,27 @@ struct __audiomix
 
 	Fixed max_speed;
 
+	/*mix buffer, one plane of nb_samples per channel*/
 	s32 *output;
 	u32 output_size;
+
+	/*CPU features for block kernels*/
+	u32 cpu_features;
+	/*adds src to dst with saturation*/
+	void (*mix_block)(s32 *dst, const s32 *src, u32 nb_samples);
+	/*scales samples by vol/100*/
+	void (*volume_block)(s32 *buf, u32 nb_samples, s32 vol);
+
+	/*GF_MIXER_RESAMPLE_* */
+	u32 rs_quality;
+	/*polyphase filter banks shared by all inputs*/
+	GF_List *rs_banks;
 };
 
 #define GF_S24_MAX	8388607
 #define GF_S24_MIN	-8388608
 
+static void gf_mixer_set_kernels(GF_AudioMixer *am);
 
 GF_EXPORT
 GF_AudioMixer *gf_mixer_new(struct _audio_render *ar)
@@ -105,6 +130,8 @@ GF_AudioMixer *gf_mixer_new(struct _audio_render *ar)
 	am->output = NULL;
 	am->output_size = 0;
 	am->max_speed = FIX_MAX;
+	am->rs_banks = gf_list_new();
+	gf_mixer_set_kernels(am);
 	return am;
 }
 
@@ -118,11 +145,29 @@ void gf_mixer_set_max_speed(GF_AudioMixer *am, Double max_speed)
 	am->max_speed = FLT2FIX(max_speed);
 }
 
+GF_EXPORT
+void gf_mixer_set_resample_quality(GF_AudioMixer *am, u32 quality)
+{
+	u32 i=0;
+	MixerInput *in;
+	if (quality>GF_MIXER_RESAMPLE_HIGH) quality = GF_MIXER_RESAMPLE_HIGH;
+	gf_mixer_lock(am, GF_TRUE);
+	if (am->rs_quality != quality) {
+		am->rs_quality = quality;
+		//recompute resampling state of all inputs
+		while ((in = (MixerInput *)gf_list_enum(am->sources, &i))) {
+			in->ratio_aligned = 0;
+		}
+	}
+	gf_mixer_lock(am, GF_FALSE);
+}
+
 GF_EXPORT
 void gf_mixer_del(GF_AudioMixer *am)
 {
 	gf_mixer_remove_all(am);
 	gf_list_del(am->sources);
+	gf_list_del(am->rs_banks);
 	gf_mx_del(am->mx);
 	if (am->output) gf_free(am->output);
 	gf_free(am);
@@ -138,6 +183,9 @@ void gf_mixer_remove_all(GF_AudioMixer *am)
 		for (j=0; j<GF_AUDIO_MIXER_MAX_CHANNELS; j++) {
 			if (in->ch_buf[j]) gf_free(in->ch_buf[j]);
 		}
+		if (in->cvt_buf) gf_free(in->cvt_buf);
+		if (in->rs) gf_resampler_del(in->rs);
+		if (in->rs_buf) gf_free(in->rs_buf);
 		gf_free(in);
 	}
 	am->isEmpty = GF_TRUE;
@@ -229,6 +277,9 @@ void gf_mixer_remove_input(GF_AudioMixer *am, GF_AudioInterface *src)
 		for (j=0; j<GF_AUDIO_MIXER_MAX_CHANNELS; j++) {
 			if (in->ch_buf[j]) gf_free(in->ch_buf[j]);
 		}
+		if (in->cvt_buf) gf_free(in->cvt_buf);
+		if (in->rs) gf_resampler_del(in->rs);
+		if (in->rs_buf) gf_free(in->rs_buf);
 		gf_free(in);
 		break;
 	}
@@ -376,7 +427,633 @@ s32 input_sample_u8p(u8 *data, u32 nb_ch, u32 sample_offset, u32 channel, u32 pl
 	return res * MIX_U8_SCALE;
 }
 
-static void gf_am_configure_source(MixerInput *in)
+/*block kernels
+
+Input samples are converted by blocks to the s32 planar buffers of each input, inputs are mixed in an s32 planar mix buffer
+which is then converted by blocks to the output format. The most common formats (s16, flt, s32) and the mix and volume operations
+use SSE2/AVX2 when available, with a scalar fallback giving the exact same result*/
+
+#if defined(WIN32) && !defined(__GNUC__)
+# include <intrin.h>
+# define GPAC_HAS_SSE2
+# define GPAC_HAS_AVX2
+# define MIX_AVX2_TARGET
+#else
+# ifdef __SSE2__
+#  include <emmintrin.h>
+#  define GPAC_HAS_SSE2
+# endif
+# if defined(__SSE2__) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  include <immintrin.h>
+#  define GPAC_HAS_AVX2
+#  define MIX_AVX2_TARGET __attribute__((target("avx2")))
+# endif
+#endif
+
+static GFINLINE s32 mix_flt_to_s32(Float samp)
+{
+	TRUNC_FLT_DBL(samp);
+}
+static GFINLINE s32 mix_dbl_to_s32(Double samp)
+{
+	TRUNC_FLT_DBL(samp);
+}
+
+#define MIX_S16_TO_S32(_v)	(((s32) (_v)) * MIX_S16_SCALE)
+#define MIX_U8_TO_S32(_v)	((((s32) (_v)) - 128) * MIX_U8_SCALE)
+#define MIX_S32_TO_S32(_v)	(_v)
+
+#define MIX_INPUT_BLOCK(_name, _type, _conv) \
+static void _name(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset) \
+{ \
+	u32 i, j; \
+	for (j=0; j<nb_ch; j++) { \
+		_type *src = ((_type *)data) + sample_offset*nb_ch + j; \
+		s32 *out = dst[j] + dst_offset; \
+		for (i=0; i<nb_samples; i++) { \
+			out[i] = _conv(*src); \
+			src += nb_ch; \
+		} \
+	} \
+} \
+static void _name##p(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset) \
+{ \
+	u32 i, j; \
+	for (j=0; j<nb_ch; j++) { \
+		_type *src = ((_type *) (data + j*planar_stride)) + sample_offset; \
+		s32 *out = dst[j] + dst_offset; \
+		for (i=0; i<nb_samples; i++) { \
+			out[i] = _conv(src[i]); \
+		} \
+	} \
+}
+
+MIX_INPUT_BLOCK(input_block_s32, s32, MIX_S32_TO_S32)
+MIX_INPUT_BLOCK(input_block_flt, Float, mix_flt_to_s32)
+MIX_INPUT_BLOCK(input_block_dbl, Double, mix_dbl_to_s32)
+MIX_INPUT_BLOCK(input_block_s16, s16, MIX_S16_TO_S32)
+MIX_INPUT_BLOCK(input_block_u8, u8, MIX_U8_TO_S32)
+
+static void input_block_s24(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset)
+{
+	u32 i, j;
+	for (j=0; j<nb_ch; j++) {
+		u8 *src = data + sample_offset*nb_ch*3 + 3*j;
+		s32 *out = dst[j] + dst_offset;
+		for (i=0; i<nb_samples; i++) {
+			out[i] = make_s24_int(src) * MIX_S24_SCALE;
+			src += 3*nb_ch;
+		}
+	}
+}
+static void input_block_s24p(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset)
+{
+	u32 i, j;
+	for (j=0; j<nb_ch; j++) {
+		u8 *src = data + j*planar_stride + sample_offset*3;
+		s32 *out = dst[j] + dst_offset;
+		for (i=0; i<nb_samples; i++) {
+			out[i] = make_s24_int(src) * MIX_S24_SCALE;
+			src += 3;
+		}
+	}
+}
+
+static void mix_block_c(s32 *dst, const s32 *src, u32 nb_samples)
+{
+	u32 i;
+	for (i=0; i<nb_samples; i++) {
+		s64 oval = dst[i];
+		oval += src[i];
+		if (oval>GF_INT_MAX) oval = GF_INT_MAX;
+		else if (oval<GF_INT_MIN) oval = GF_INT_MIN;
+		dst[i] = (s32) oval;
+	}
+}
+
+static void volume_block_c(s32 *buf, u32 nb_samples, s32 vol)
+{
+	u32 i;
+	for (i=0; i<nb_samples; i++) {
+		buf[i] = (s32) ( ((s64) buf[i]) * vol / 100);
+	}
+}
+
+/*output block converters, from mix buffer with one plane of mix_stride samples per channel*/
+typedef void (*mix_output_block)(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer);
+
+static GFINLINE s16 mix_s32_to_s16(s32 samp)
+{
+	samp /= MIX_S16_SCALE;
+	if (samp > GF_SHORT_MAX) samp = GF_SHORT_MAX;
+	else if (samp < GF_SHORT_MIN) samp = GF_SHORT_MIN;
+	return (s16) samp;
+}
+static GFINLINE u8 mix_s32_to_u8(s32 samp)
+{
+	samp /= MIX_U8_SCALE;
+	if (samp > 127) samp = 127;
+	else if (samp < -128) samp = -128;
+	samp += 128;
+	return (u8) samp;
+}
+static GFINLINE s32 mix_s32_to_s24(s32 samp)
+{
+	samp /= MIX_S24_SCALE;
+	if (samp > GF_S24_MAX) samp = GF_S24_MAX;
+	else if (samp < GF_S24_MIN) samp = GF_S24_MIN;
+	return samp;
+}
+#define MIX_S32_TO_FLT(_v)	(((Float) (_v)) / GF_INT_MAX)
+#define MIX_S32_TO_DBL(_v)	(((Double) (_v)) / GF_INT_MAX)
+
+#define MIX_OUTPUT_BLOCK(_name, _type, _conv) \
+static void _name(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer) \
+{ \
+	u32 i, j; \
+	for (j=0; j<nb_ch; j++) { \
+		_type *out = ((_type *)buffer) + j; \
+		s32 *src = mix + j*mix_stride; \
+		for (i=0; i<nb_samples; i++) { \
+			*out = _conv(src[i]); \
+			out += nb_ch; \
+		} \
+	} \
+} \
+static void _name##p(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer) \
+{ \
+	u32 i, j; \
+	for (j=0; j<nb_ch; j++) { \
+		_type *out = ((_type *)buffer) + j*nb_samples; \
+		s32 *src = mix + j*mix_stride; \
+		for (i=0; i<nb_samples; i++) { \
+			out[i] = _conv(src[i]); \
+		} \
+	} \
+}
+
+MIX_OUTPUT_BLOCK(output_block_s32, s32, MIX_S32_TO_S32)
+MIX_OUTPUT_BLOCK(output_block_flt, Float, MIX_S32_TO_FLT)
+MIX_OUTPUT_BLOCK(output_block_dbl, Double, MIX_S32_TO_DBL)
+MIX_OUTPUT_BLOCK(output_block_s16, s16, mix_s32_to_s16)
+MIX_OUTPUT_BLOCK(output_block_u8, u8, mix_s32_to_u8)
+
+static void output_block_s24(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer)
+{
+	u32 i, j;
+	for (j=0; j<nb_ch; j++) {
+		u8 *out = buffer + 3*j;
+		s32 *src = mix + j*mix_stride;
+		for (i=0; i<nb_samples; i++) {
+			s32 samp = mix_s32_to_s24(src[i]);
+			out[2] = (samp>>16) & 0xFF;
+			out[1] = (samp>>8) & 0xFF;
+			out[0] = samp & 0xFF;
+			out += 3*nb_ch;
+		}
+	}
+}
+static void output_block_s24p(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer)
+{
+	u32 i, j;
+	for (j=0; j<nb_ch; j++) {
+		u8 *out = buffer + 3*j*nb_samples;
+		s32 *src = mix + j*mix_stride;
+		for (i=0; i<nb_samples; i++) {
+			s32 samp = mix_s32_to_s24(src[i]);
+			out[2] = (samp>>16) & 0xFF;
+			out[1] = (samp>>8) & 0xFF;
+			out[0] = samp & 0xFF;
+			out += 3;
+		}
+	}
+}
+
+#ifdef GPAC_HAS_SSE2
+
+static GFINLINE __m128i mix_s16_to_s32_sse2(__m128i v, Bool hi)
+{
+	__m128i r = hi ? _mm_unpackhi_epi16(v, v) : _mm_unpacklo_epi16(v, v);
+	r = _mm_srai_epi32(r, 16);
+	//multiply by 65535
+	return _mm_sub_epi32(_mm_slli_epi32(r, 16), r);
+}
+
+static GFINLINE __m128i mix_flt_to_s32_sse2(__m128 v)
+{
+	//values below -1 overflow to GF_INT_MIN, as in scalar code
+	__m128i r = _mm_cvttps_epi32(_mm_mul_ps(v, _mm_set1_ps((Float) GF_INT_MAX)));
+	__m128i gt = _mm_castps_si128(_mm_cmpgt_ps(v, _mm_set1_ps(1.0f)));
+	return _mm_or_si128(_mm_andnot_si128(gt, r), _mm_and_si128(gt, _mm_set1_epi32(GF_INT_MAX)));
+}
+
+//converts s16 or float samples, mono, stereo or planar, other channel configurations use scalar code
+static void input_block_s16_sse2(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset)
+{
+	u32 i=0;
+	s16 *src = ((s16 *)data) + sample_offset*nb_ch;
+	s32 *outL = dst[0] + dst_offset;
+	if (nb_ch==1) {
+		for (; i+8<=nb_samples; i+=8) {
+			__m128i v = _mm_loadu_si128((const __m128i *) (src+i));
+			_mm_storeu_si128((__m128i *) (outL+i), mix_s16_to_s32_sse2(v, GF_FALSE));
+			_mm_storeu_si128((__m128i *) (outL+i+4), mix_s16_to_s32_sse2(v, GF_TRUE));
+		}
+	} else if (nb_ch==2) {
+		s32 *outR = dst[1] + dst_offset;
+		for (; i+4<=nb_samples; i+=4) {
+			__m128i v = _mm_loadu_si128((const __m128i *) (src+2*i));
+			__m128 lo = _mm_castsi128_ps(mix_s16_to_s32_sse2(v, GF_FALSE));
+			__m128 hi = _mm_castsi128_ps(mix_s16_to_s32_sse2(v, GF_TRUE));
+			_mm_storeu_ps((Float *) (outL+i), _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2,0,2,0)));
+			_mm_storeu_ps((Float *) (outR+i), _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3,1,3,1)));
+		}
+	}
+	if (i<nb_samples) input_block_s16(data, nb_ch, sample_offset+i, nb_samples-i, planar_stride, dst, dst_offset+i);
+}
+static void input_block_s16p_sse2(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset)
+{
+	u32 i, j;
+	for (j=0; j<nb_ch; j++) {
+		s16 *src = ((s16 *) (data + j*planar_stride)) + sample_offset;
+		s32 *out = dst[j] + dst_offset;
+		for (i=0; i+8<=nb_samples; i+=8) {
+			__m128i v = _mm_loadu_si128((const __m128i *) (src+i));
+			_mm_storeu_si128((__m128i *) (out+i), mix_s16_to_s32_sse2(v, GF_FALSE));
+			_mm_storeu_si128((__m128i *) (out+i+4), mix_s16_to_s32_sse2(v, GF_TRUE));
+		}
+		for (; i<nb_samples; i++) out[i] = MIX_S16_TO_S32(src[i]);
+	}
+}
+static void input_block_flt_sse2(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset)
+{
+	u32 i=0;
+	Float *src = ((Float *)data) + sample_offset*nb_ch;
+	s32 *outL = dst[0] + dst_offset;
+	if (nb_ch==1) {
+		for (; i+4<=nb_samples; i+=4) {
+			_mm_storeu_si128((__m128i *) (outL+i), mix_flt_to_s32_sse2(_mm_loadu_ps(src+i)));
+		}
+	} else if (nb_ch==2) {
+		s32 *outR = dst[1] + dst_offset;
+		for (; i+4<=nb_samples; i+=4) {
+			__m128 lo = _mm_castsi128_ps(mix_flt_to_s32_sse2(_mm_loadu_ps(src+2*i)));
+			__m128 hi = _mm_castsi128_ps(mix_flt_to_s32_sse2(_mm_loadu_ps(src+2*i+4)));
+			_mm_storeu_ps((Float *) (outL+i), _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2,0,2,0)));
+			_mm_storeu_ps((Float *) (outR+i), _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3,1,3,1)));
+		}
+	}
+	if (i<nb_samples) input_block_flt(data, nb_ch, sample_offset+i, nb_samples-i, planar_stride, dst, dst_offset+i);
+}
+static void input_block_fltp_sse2(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset)
+{
+	u32 i, j;
+	for (j=0; j<nb_ch; j++) {
+		Float *src = ((Float *) (data + j*planar_stride)) + sample_offset;
+		s32 *out = dst[j] + dst_offset;
+		for (i=0; i+4<=nb_samples; i+=4) {
+			_mm_storeu_si128((__m128i *) (out+i), mix_flt_to_s32_sse2(_mm_loadu_ps(src+i)));
+		}
+		for (; i<nb_samples; i++) out[i] = mix_flt_to_s32(src[i]);
+	}
+}
+
+static GFINLINE __m128i mix_add_sat_sse2(__m128i a, __m128i b)
+{
+	__m128i sum = _mm_add_epi32(a, b);
+	//overflow if a and b have the same sign and sum has a different one, saturate to the sign of a
+	__m128i ov = _mm_srai_epi32(_mm_andnot_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, sum)), 31);
+	__m128i sat = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(GF_INT_MAX));
+	return _mm_or_si128(_mm_andnot_si128(ov, sum), _mm_and_si128(ov, sat));
+}
+static void mix_block_sse2(s32 *dst, const s32 *src, u32 nb_samples)
+{
+	u32 i;
+	for (i=0; i+4<=nb_samples; i+=4) {
+		__m128i a = _mm_loadu_si128((const __m128i *) (dst+i));
+		__m128i b = _mm_loadu_si128((const __m128i *) (src+i));
+		_mm_storeu_si128((__m128i *) (dst+i), mix_add_sat_sse2(a, b));
+	}
+	if (i<nb_samples) mix_block_c(dst+i, src+i, nb_samples-i);
+}
+
+//integer division with truncation of 4 s32 using doubles, exact since both dividend and quotient fit in 53 bits
+static GFINLINE __m128i mix_div_sse2(__m128i v, __m128d mul, __m128d div)
+{
+	__m128d lo = _mm_div_pd(_mm_mul_pd(_mm_cvtepi32_pd(v), mul), div);
+	__m128d hi = _mm_div_pd(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(v, 8)), mul), div);
+	return _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+}
+static void volume_block_sse2(s32 *buf, u32 nb_samples, s32 vol)
+{
+	u32 i=0;
+	//result may not fit in s32 if volume is above 100, use scalar code
+	if ((vol>=0) && (vol<=100)) {
+		__m128d mul = _mm_set1_pd((Double) vol);
+		__m128d div = _mm_set1_pd(100.0);
+		for (; i+4<=nb_samples; i+=4) {
+			__m128i v = _mm_loadu_si128((const __m128i *) (buf+i));
+			_mm_storeu_si128((__m128i *) (buf+i), mix_div_sse2(v, mul, div));
+		}
+	}
+	if (i<nb_samples) volume_block_c(buf+i, nb_samples-i, vol);
+}
+
+//s16 output: truncated division by MIX_S16_SCALE, clamping done by saturated packing
+static void output_block_s16_sse2(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer)
+{
+	u32 i=0;
+	s16 *out = (s16 *) buffer;
+	__m128d one = _mm_set1_pd(1.0);
+	__m128d div = _mm_set1_pd((Double) MIX_S16_SCALE);
+	if (nb_ch==1) {
+		for (; i+8<=nb_samples; i+=8) {
+			__m128i q0 = mix_div_sse2(_mm_loadu_si128((const __m128i *) (mix+i)), one, div);
+			__m128i q1 = mix_div_sse2(_mm_loadu_si128((const __m128i *) (mix+i+4)), one, div);
+			_mm_storeu_si128((__m128i *) (out+i), _mm_packs_epi32(q0, q1));
+		}
+	} else if (nb_ch==2) {
+		s32 *mixR = mix + mix_stride;
+		for (; i+4<=nb_samples; i+=4) {
+			__m128i l = mix_div_sse2(_mm_loadu_si128((const __m128i *) (mix+i)), one, div);
+			__m128i r = mix_div_sse2(_mm_loadu_si128((const __m128i *) (mixR+i)), one, div);
+			_mm_storeu_si128((__m128i *) (out+2*i), _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r)));
+		}
+	}
+	if (i<nb_samples) {
+		u32 j;
+		for (j=0; j<nb_ch; j++) {
+			u32 k;
+			for (k=i; k<nb_samples; k++) out[k*nb_ch + j] = mix_s32_to_s16(mix[j*mix_stride + k]);
+		}
+	}
+}
+static void output_block_s16p_sse2(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer)
+{
+	u32 i, j;
+	__m128d one = _mm_set1_pd(1.0);
+	__m128d div = _mm_set1_pd((Double) MIX_S16_SCALE);
+	for (j=0; j<nb_ch; j++) {
+		s16 *out = ((s16 *) buffer) + j*nb_samples;
+		s32 *src = mix + j*mix_stride;
+		for (i=0; i+8<=nb_samples; i+=8) {
+			__m128i q0 = mix_div_sse2(_mm_loadu_si128((const __m128i *) (src+i)), one, div);
+			__m128i q1 = mix_div_sse2(_mm_loadu_si128((const __m128i *) (src+i+4)), one, div);
+			_mm_storeu_si128((__m128i *) (out+i), _mm_packs_epi32(q0, q1));
+		}
+		for (; i<nb_samples; i++) out[i] = mix_s32_to_s16(src[i]);
+	}
+}
+//float output: int to float conversion then exact division by 2^31
+static void output_block_flt_sse2(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer)
+{
+	u32 i=0;
+	Float *out = (Float *) buffer;
+	__m128 scale = _mm_set1_ps(1.0f / (Float) GF_INT_MAX);
+	if (nb_ch==1) {
+		for (; i+4<=nb_samples; i+=4) {
+			_mm_storeu_ps(out+i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *) (mix+i))), scale));
+		}
+	} else if (nb_ch==2) {
+		s32 *mixR = mix + mix_stride;
+		for (; i+4<=nb_samples; i+=4) {
+			__m128 l = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *) (mix+i))), scale);
+			__m128 r = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *) (mixR+i))), scale);
+			_mm_storeu_ps(out+2*i, _mm_unpacklo_ps(l, r));
+			_mm_storeu_ps(out+2*i+4, _mm_unpackhi_ps(l, r));
+		}
+	}
+	if (i<nb_samples) {
+		u32 j;
+		for (j=0; j<nb_ch; j++) {
+			u32 k;
+			for (k=i; k<nb_samples; k++) out[k*nb_ch + j] = MIX_S32_TO_FLT(mix[j*mix_stride + k]);
+		}
+	}
+}
+static void output_block_fltp_sse2(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer)
+{
+	u32 i, j;
+	__m128 scale = _mm_set1_ps(1.0f / (Float) GF_INT_MAX);
+	for (j=0; j<nb_ch; j++) {
+		Float *out = ((Float *) buffer) + j*nb_samples;
+		s32 *src = mix + j*mix_stride;
+		for (i=0; i+4<=nb_samples; i+=4) {
+			_mm_storeu_ps(out+i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *) (src+i))), scale));
+		}
+		for (; i<nb_samples; i++) out[i] = MIX_S32_TO_FLT(src[i]);
+	}
+}
+#endif //GPAC_HAS_SSE2
+
+#ifdef GPAC_HAS_AVX2
+MIX_AVX2_TARGET
+static void input_block_s16p_avx2(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset)
+{
+	u32 i, j;
+	for (j=0; j<nb_ch; j++) {
+		s16 *src = ((s16 *) (data + j*planar_stride)) + sample_offset;
+		s32 *out = dst[j] + dst_offset;
+		for (i=0; i+8<=nb_samples; i+=8) {
+			__m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) (src+i)));
+			_mm256_storeu_si256((__m256i *) (out+i), _mm256_sub_epi32(_mm256_slli_epi32(v, 16), v));
+		}
+		for (; i<nb_samples; i++) out[i] = MIX_S16_TO_S32(src[i]);
+	}
+}
+MIX_AVX2_TARGET
+static void input_block_fltp_avx2(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset)
+{
+	u32 i, j;
+	__m256 scale = _mm256_set1_ps((Float) GF_INT_MAX);
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256i imax = _mm256_set1_epi32(GF_INT_MAX);
+	for (j=0; j<nb_ch; j++) {
+		Float *src = ((Float *) (data + j*planar_stride)) + sample_offset;
+		s32 *out = dst[j] + dst_offset;
+		for (i=0; i+8<=nb_samples; i+=8) {
+			__m256 v = _mm256_loadu_ps(src+i);
+			__m256i r = _mm256_cvttps_epi32(_mm256_mul_ps(v, scale));
+			__m256i gt = _mm256_castps_si256(_mm256_cmp_ps(v, one, _CMP_GT_OQ));
+			_mm256_storeu_si256((__m256i *) (out+i), _mm256_blendv_epi8(r, imax, gt));
+		}
+		for (; i<nb_samples; i++) out[i] = mix_flt_to_s32(src[i]);
+	}
+}
+//interleaved mono is the same as planar, other layouts use SSE2 code
+MIX_AVX2_TARGET
+static void input_block_s16_avx2(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset)
+{
+	if (nb_ch==1) input_block_s16p_avx2(data, 1, sample_offset, nb_samples, 0, dst, dst_offset);
+	else input_block_s16_sse2(data, nb_ch, sample_offset, nb_samples, planar_stride, dst, dst_offset);
+}
+MIX_AVX2_TARGET
+static void input_block_flt_avx2(u8 *data, u32 nb_ch, u32 sample_offset, u32 nb_samples, u32 planar_stride, s32 **dst, u32 dst_offset)
+{
+	if (nb_ch==1) input_block_fltp_avx2(data, 1, sample_offset, nb_samples, 0, dst, dst_offset);
+	else input_block_flt_sse2(data, nb_ch, sample_offset, nb_samples, planar_stride, dst, dst_offset);
+}
+
+MIX_AVX2_TARGET
+static void mix_block_avx2(s32 *dst, const s32 *src, u32 nb_samples)
+{
+	u32 i;
+	__m256i imax = _mm256_set1_epi32(GF_INT_MAX);
+	for (i=0; i+8<=nb_samples; i+=8) {
+		__m256i a = _mm256_loadu_si256((const __m256i *) (dst+i));
+		__m256i b = _mm256_loadu_si256((const __m256i *) (src+i));
+		__m256i sum = _mm256_add_epi32(a, b);
+		__m256i ov = _mm256_srai_epi32(_mm256_andnot_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, sum)), 31);
+		__m256i sat = _mm256_xor_si256(_mm256_srai_epi32(a, 31), imax);
+		_mm256_storeu_si256((__m256i *) (dst+i), _mm256_blendv_epi8(sum, sat, ov));
+	}
+	if (i<nb_samples) mix_block_c(dst+i, src+i, nb_samples-i);
+}
+
+MIX_AVX2_TARGET
+static GFINLINE __m128i mix_div_avx2(__m128i v, __m256d mul, __m256d div)
+{
+	return _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(v), mul), div));
+}
+MIX_AVX2_TARGET
+static void volume_block_avx2(s32 *buf, u32 nb_samples, s32 vol)
+{
+	u32 i=0;
+	if ((vol>=0) && (vol<=100)) {
+		__m256d mul = _mm256_set1_pd((Double) vol);
+		__m256d div = _mm256_set1_pd(100.0);
+		for (; i+4<=nb_samples; i+=4) {
+			__m128i v = _mm_loadu_si128((const __m128i *) (buf+i));
+			_mm_storeu_si128((__m128i *) (buf+i), mix_div_avx2(v, mul, div));
+		}
+	}
+	if (i<nb_samples) volume_block_c(buf+i, nb_samples-i, vol);
+}
+MIX_AVX2_TARGET
+static void output_block_s16p_avx2(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer)
+{
+	u32 i, j;
+	__m256d one = _mm256_set1_pd(1.0);
+	__m256d div = _mm256_set1_pd((Double) MIX_S16_SCALE);
+	for (j=0; j<nb_ch; j++) {
+		s16 *out = ((s16 *) buffer) + j*nb_samples;
+		s32 *src = mix + j*mix_stride;
+		for (i=0; i+8<=nb_samples; i+=8) {
+			__m128i q0 = mix_div_avx2(_mm_loadu_si128((const __m128i *) (src+i)), one, div);
+			__m128i q1 = mix_div_avx2(_mm_loadu_si128((const __m128i *) (src+i+4)), one, div);
+			_mm_storeu_si128((__m128i *) (out+i), _mm_packs_epi32(q0, q1));
+		}
+		for (; i<nb_samples; i++) out[i] = mix_s32_to_s16(src[i]);
+	}
+}
+MIX_AVX2_TARGET
+static void output_block_s16_avx2(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer)
+{
+	u32 i=0;
+	s16 *out = (s16 *) buffer;
+	__m256d one = _mm256_set1_pd(1.0);
+	__m256d div = _mm256_set1_pd((Double) MIX_S16_SCALE);
+	if (nb_ch==1) {
+		output_block_s16p_avx2(mix, mix_stride, 1, nb_samples, buffer);
+		return;
+	}
+	if (nb_ch==2) {
+		s32 *mixR = mix + mix_stride;
+		for (; i+4<=nb_samples; i+=4) {
+			__m128i l = mix_div_avx2(_mm_loadu_si128((const __m128i *) (mix+i)), one, div);
+			__m128i r = mix_div_avx2(_mm_loadu_si128((const __m128i *) (mixR+i)), one, div);
+			_mm_storeu_si128((__m128i *) (out+2*i), _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r)));
+		}
+	}
+	if (i<nb_samples) {
+		u32 j;
+		for (j=0; j<nb_ch; j++) {
+			u32 k;
+			for (k=i; k<nb_samples; k++) out[k*nb_ch + j] = mix_s32_to_s16(mix[j*mix_stride + k]);
+		}
+	}
+}
+MIX_AVX2_TARGET
+static void output_block_fltp_avx2(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer)
+{
+	u32 i, j;
+	__m256 scale = _mm256_set1_ps(1.0f / (Float) GF_INT_MAX);
+	for (j=0; j<nb_ch; j++) {
+		Float *out = ((Float *) buffer) + j*nb_samples;
+		s32 *src = mix + j*mix_stride;
+		for (i=0; i+8<=nb_samples; i+=8) {
+			_mm256_storeu_ps(out+i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *) (src+i))), scale));
+		}
+		for (; i<nb_samples; i++) out[i] = MIX_S32_TO_FLT(src[i]);
+	}
+}
+MIX_AVX2_TARGET
+static void output_block_flt_avx2(s32 *mix, u32 mix_stride, u32 nb_ch, u32 nb_samples, u8 *buffer)
+{
+	if (nb_ch==1) output_block_fltp_avx2(mix, mix_stride, 1, nb_samples, buffer);
+	else output_block_flt_sse2(mix, mix_stride, nb_ch, nb_samples, buffer);
+}
+#endif //GPAC_HAS_AVX2
+
+static void gf_mixer_set_kernels(GF_AudioMixer *am)
+{
+	am->cpu_features = gf_sys_get_cpu_features();
+	am->mix_block = mix_block_c;
+	am->volume_block = volume_block_c;
+#ifdef GPAC_HAS_SSE2
+	if (am->cpu_features & GF_CPU_SSE2) {
+		am->mix_block = mix_block_sse2;
+		am->volume_block = volume_block_sse2;
+	}
+#endif
+#ifdef GPAC_HAS_AVX2
+	if (am->cpu_features & GF_CPU_AVX2) {
+		am->mix_block = mix_block_avx2;
+		am->volume_block = volume_block_avx2;
+	}
+#endif
+}
+
+static mix_output_block gf_mixer_get_output_block(GF_AudioMixer *am)
+{
+#ifdef GPAC_HAS_AVX2
+	if (am->cpu_features & GF_CPU_AVX2) {
+		switch (am->afmt) {
+		case GF_AUDIO_FMT_S16: return output_block_s16_avx2;
+		case GF_AUDIO_FMT_S16P: return output_block_s16p_avx2;
+		case GF_AUDIO_FMT_FLT: return output_block_flt_avx2;
+		case GF_AUDIO_FMT_FLTP: return output_block_fltp_avx2;
+		}
+	}
+#endif
+#ifdef GPAC_HAS_SSE2
+	if (am->cpu_features & GF_CPU_SSE2) {
+		switch (am->afmt) {
+		case GF_AUDIO_FMT_S16: return output_block_s16_sse2;
+		case GF_AUDIO_FMT_S16P: return output_block_s16p_sse2;
+		case GF_AUDIO_FMT_FLT: return output_block_flt_sse2;
+		case GF_AUDIO_FMT_FLTP: return output_block_fltp_sse2;
+		}
+	}
+#endif
+	switch (am->afmt) {
+	case GF_AUDIO_FMT_S32: return output_block_s32;
+	case GF_AUDIO_FMT_S32P: return output_block_s32p;
+	case GF_AUDIO_FMT_FLT: return output_block_flt;
+	case GF_AUDIO_FMT_FLTP: return output_block_fltp;
+	case GF_AUDIO_FMT_DBL: return output_block_dbl;
+	case GF_AUDIO_FMT_DBLP: return output_block_dblp;
+	case GF_AUDIO_FMT_S24: return output_block_s24;
+	case GF_AUDIO_FMT_S24P: return output_block_s24p;
+	case GF_AUDIO_FMT_S16: return output_block_s16;
+	case GF_AUDIO_FMT_S16P: return output_block_s16p;
+	case GF_AUDIO_FMT_U8: return output_block_u8;
+	case GF_AUDIO_FMT_U8P: return output_block_u8p;
+	}
+	return NULL;
+}
+
+static void gf_am_configure_source(GF_AudioMixer *am, MixerInput *in)
 {
 	in->bit_depth = gf_audio_fmt_bit_depth(in->src->afmt);
 	in->bytes_per_sec = in->src->samplerate * in->src->chan * in->bit_depth / 8;
@@ -384,41 +1061,69 @@ static void gf_am_configure_source(MixerInput *in)
 	switch (in->src->afmt) {
 	case GF_AUDIO_FMT_S32:
 		in->get_sample = input_sample_s32;
+		in->get_block = input_block_s32;
 		break;
 	case GF_AUDIO_FMT_S32P:
 		in->get_sample = input_sample_s32p;
+		in->get_block = input_block_s32p;
 		break;
 	case GF_AUDIO_FMT_S24:
 		in->get_sample = input_sample_s24;
+		in->get_block = input_block_s24;
 		break;
 	case GF_AUDIO_FMT_S24P:
 		in->get_sample = input_sample_s24p;
+		in->get_block = input_block_s24p;
 		break;
 	case GF_AUDIO_FMT_FLT:
 		in->get_sample = input_sample_flt;
+		in->get_block = input_block_flt;
 		break;
 	case GF_AUDIO_FMT_FLTP:
 		in->get_sample = input_sample_fltp;
+		in->get_block = input_block_fltp;
 		break;
 	case GF_AUDIO_FMT_DBL:
 		in->get_sample = input_sample_dbl;
+		in->get_block = input_block_dbl;
 		break;
 	case GF_AUDIO_FMT_DBLP:
 		in->get_sample = input_sample_dblp;
+		in->get_block = input_block_dblp;
 		break;
 	case GF_AUDIO_FMT_S16:
 		in->get_sample = input_sample_s16;
+		in->get_block = input_block_s16;
 		break;
 	case GF_AUDIO_FMT_S16P:
 		in->get_sample = input_sample_s16p;
+		in->get_block = input_block_s16p;
 		break;
 	case GF_AUDIO_FMT_U8:
 		in->get_sample = input_sample_u8;
+		in->get_block = input_block_u8;
 		break;
 	case GF_AUDIO_FMT_U8P:
 		in->get_sample = input_sample_u8p;
+		in->get_block = input_block_u8p;
 		break;
 	}
+#ifdef GPAC_HAS_SSE2
+	if (am->cpu_features & GF_CPU_SSE2) {
+		if (in->src->afmt==GF_AUDIO_FMT_S16) in->get_block = input_block_s16_sse2;
+		else if (in->src->afmt==GF_AUDIO_FMT_S16P) in->get_block = input_block_s16p_sse2;
+		else if (in->src->afmt==GF_AUDIO_FMT_FLT) in->get_block = input_block_flt_sse2;
+		else if (in->src->afmt==GF_AUDIO_FMT_FLTP) in->get_block = input_block_fltp_sse2;
+	}
+#endif
+#ifdef GPAC_HAS_AVX2
+	if (am->cpu_features & GF_CPU_AVX2) {
+		if (in->src->afmt==GF_AUDIO_FMT_S16) in->get_block = input_block_s16_avx2;
+		else if (in->src->afmt==GF_AUDIO_FMT_S16P) in->get_block = input_block_s16p_avx2;
+		else if (in->src->afmt==GF_AUDIO_FMT_FLT) in->get_block = input_block_flt_avx2;
+		else if (in->src->afmt==GF_AUDIO_FMT_FLTP) in->get_block = input_block_fltp_avx2;
+	}
+#endif
 }
 
 GF_EXPORT
@@ -501,7 +1206,7 @@ Bool gf_mixer_reconfig(GF_AudioMixer *am)
 		}
 
 		numInit++;
-		gf_am_configure_source(in);
+		gf_am_configure_source(am, in);
 
 		/*cfg has changed, we must reconfig everything*/
 		if (cfg_changed || (max_sample_rate != am->sample_rate) ) {
@@ -673,29 +1378,175 @@ static GFINLINE void gf_mixer_map_channels(s32 *inChan, u32 nb_in, u64 in_ch_lay
 
 #define RESAMPLE_SCALER	1000
 
-static void gf_mixer_fetch_input(GF_AudioMixer *am, MixerInput *in, u32 audio_delay)
+static GFINLINE void gf_mixer_input_alloc_cvt(MixerInput *in, u32 size)
 {
-	u32 j, in_ch, out_ch, prev, next, src_samp, src_size;
-	Bool use_prev;
-	u32 planar_stride=0;
-	s8 *in_data;
-	s32 frac, inChan[GF_AUDIO_MIXER_MAX_CHANNELS], inChanNext[GF_AUDIO_MIXER_MAX_CHANNELS];
+	if (in->cvt_size < size) {
+		in->cvt_buf = (s32 *) gf_realloc(in->cvt_buf, sizeof(s32) * size);
+		in->cvt_size = size;
+	}
+}
+
+//channel mapping only copies or zeroes channels, samples can be written directly in the channel buffers
+static GFINLINE Bool gf_mixer_is_direct_map(u32 in_ch, u32 out_ch)
+{
+	if ((in_ch==out_ch) || ((in_ch==1) && (out_ch==2)) || ((in_ch==2) && (out_ch>2)))
+		return GF_TRUE;
+	return GF_FALSE;
+}
+
+/*pans and maps nb samples of the input channels in planes to the channel buffers at the current write position. If direct_map is set, planes are the first channel buffers*/
+static void gf_mixer_map_block(GF_AudioMixer *am, MixerInput *in, s32 **planes, u32 nb, Bool direct_map, s32 *inChan)
+{
+	u32 i, j, in_ch, out_ch, offset;
 
 	in_ch = in->src->chan;
 	out_ch = am->nb_channels;
-	use_prev = in->has_prev;
+	offset = in->out_samples_written;
 
-	in_data = (s8 *) in->src->FetchFrame(in->src->callback, &src_size, &planar_stride, audio_delay);
-	if (!in_data || !src_size) {
-		//end of stream, flush if needed
-		if (in->src->is_eos && use_prev) {
+	//don't apply pan when forced layout is used
+	if (!in->src->forced_layout) {
+		for (j=0; j<in_ch; j++) {
+			if (in->pan[j]!=FIX_ONE)
+				am->volume_block(planes[j], nb, FIX2INT(100 * in->pan[j]));
+		}
+	}
 
+	if (direct_map) {
+		if ((in_ch==1) && (out_ch==2)) {
+			memcpy(in->ch_buf[1] + offset, in->ch_buf[0] + offset, sizeof(s32)*nb);
 		} else {
+			for (j=in_ch; j<out_ch; j++) memset(in->ch_buf[j] + offset, 0, sizeof(s32)*nb);
+		}
+		return;
+	}
+
+	for (i=0; i<nb; i++) {
+		for (j=0; j<in_ch; j++) inChan[j] = planes[j][i];
+		//map inChannel to the output channel config
+		gf_mixer_map_channels(inChan, in_ch, in->src->ch_layout, in->src->forced_layout, out_ch, am->channel_layout);
+		for (j=0; j<out_ch; j++) in->ch_buf[j][offset + i] = inChan[j];
+	}
+}
+
+/*converts nb input samples starting at first and writes them to the channel buffers, used when no resampling is needed*/
+static void gf_mixer_fetch_block(GF_AudioMixer *am, MixerInput *in, s8 *in_data, u32 first, u32 nb, u32 planar_stride, s32 *inChan)
+{
+	u32 j, in_ch, out_ch, offset;
+	Bool direct_map;
+	s32 *planes[GF_AUDIO_MIXER_MAX_CHANNELS];
+
+	in_ch = in->src->chan;
+	out_ch = am->nb_channels;
+	offset = in->out_samples_written;
+
+	if (in->speed > am->max_speed) {
+		for (j=0; j<out_ch; j++) memset(in->ch_buf[j] + offset, 0, sizeof(s32)*nb);
+		return;
+	}
+
+	direct_map = gf_mixer_is_direct_map(in_ch, out_ch);
+	if (direct_map) {
+		for (j=0; j<in_ch; j++) planes[j] = in->ch_buf[j] + offset;
+	} else {
+		gf_mixer_input_alloc_cvt(in, in_ch * nb);
+		for (j=0; j<in_ch; j++) planes[j] = in->cvt_buf + j*nb;
+	}
+	in->get_block((u8 *) in_data, in_ch, first, nb, planar_stride, planes, 0);
+
+	gf_mixer_map_block(am, in, planes, nb, direct_map, inChan);
+}
+
+/*fills the channel buffers using the polyphase resampler, converting input samples only when the resampler needs them*/
+static void gf_mixer_fetch_input_rs(GF_AudioMixer *am, MixerInput *in, s8 *in_data, u32 src_size, u32 planar_stride)
+{
+	u32 j, in_ch, out_ch, src_samp, consumed;
+	Bool direct_map;
+	s32 inChan[GF_AUDIO_MIXER_MAX_CHANNELS];
+	s32 *planes[GF_AUDIO_MIXER_MAX_CHANNELS];
+
+	in_ch = in->src->chan;
+	out_ch = am->nb_channels;
+	direct_map = gf_mixer_is_direct_map(in_ch, out_ch);
+
+	src_samp = 0;
+	if (!in_data || !src_size) {
+		if (!in->src->is_eos) {
 			/*done, stop fill*/
 			in->out_samples_to_write = 0;
 			return;
 		}
+		//end of stream, push silence once to output the filter tail
+		if (!in->rs_flushed) {
+			gf_resampler_flush(in->rs);
+			in->rs_flushed = GF_TRUE;
+		}
+	} else {
+		in->rs_flushed = GF_FALSE;
+		src_samp = (u32) (src_size / in->bytes_p_samp);
 	}
+	memset(inChan, 0, sizeof(s32)*GF_AUDIO_MIXER_MAX_CHANNELS);
+
+	consumed = 0;
+	while (1) {
+		u32 nb, nb_out = in->out_samples_to_write - in->out_samples_written;
+		if (direct_map) {
+			for (j=0; j<in_ch; j++) planes[j] = in->ch_buf[j] + in->out_samples_written;
+		} else {
+			if (in->rs_size < in_ch * nb_out) {
+				in->rs_buf = (s32 *) gf_realloc(in->rs_buf, sizeof(s32) * in_ch * nb_out);
+				in->rs_size = in_ch * nb_out;
+			}
+			for (j=0; j<in_ch; j++) planes[j] = in->rs_buf + j*nb_out;
+		}
+		nb = gf_resampler_process(in->rs, planes, nb_out);
+		if (nb) {
+			if (in->speed > am->max_speed) {
+				for (j=0; j<out_ch; j++) memset(in->ch_buf[j] + in->out_samples_written, 0, sizeof(s32)*nb);
+			} else {
+				gf_mixer_map_block(am, in, planes, nb, direct_map, inChan);
+			}
+			in->out_samples_written += nb;
+			if (in->out_samples_written == in->out_samples_to_write)
+				break;
+		}
+		if (consumed == src_samp)
+			break;
+
+		//convert the input samples needed for the rest of the output
+		nb = gf_resampler_input_needed(in->rs, in->out_samples_to_write - in->out_samples_written);
+		nb = MIN(nb, src_samp - consumed);
+		if (!nb) break;
+		gf_mixer_input_alloc_cvt(in, in_ch * nb);
+		for (j=0; j<in_ch; j++) planes[j] = in->cvt_buf + j*nb;
+		in->get_block((u8 *) in_data, in_ch, consumed, nb, planar_stride, planes, 0);
+		consumed += gf_resampler_push(in->rs, planes, nb);
+	}
+	if (!src_samp) {
+		//filter tail done, stop fill
+		if (in->out_samples_written < in->out_samples_to_write)
+			in->out_samples_to_write = 0;
+		return;
+	}
+
+	in->in_bytes_used = consumed * in->bytes_p_samp;
+	/*cf below, make sure we call release*/
+	in->in_bytes_used += 1;
+}
+
+static void gf_mixer_fetch_input(GF_AudioMixer *am, MixerInput *in, u32 audio_delay)
+{
+	u32 j, in_ch, out_ch, prev, next, src_samp, src_size, cvt_start, cvt_end;
+	Bool use_prev, same_rate;
+	u32 planar_stride=0;
+	s8 *in_data;
+	s32 frac, inChan[GF_AUDIO_MIXER_MAX_CHANNELS], inChanNext[GF_AUDIO_MIXER_MAX_CHANNELS];
+	s32 *cvt[GF_AUDIO_MIXER_MAX_CHANNELS];
+
+	in_ch = in->src->chan;
+	out_ch = am->nb_channels;
+	use_prev = in->has_prev;
+
+	in_data = (s8 *) in->src->FetchFrame(in->src->callback, &src_size, &planar_stride, audio_delay);
 
 	//config changed, recompute our values
 	if (!in->ratio_aligned) {
@@ -707,13 +1558,66 @@ static void gf_mixer_fetch_input(GF_AudioMixer *am, MixerInput *in, u32 audio_de
 		in->scaled_sr = FIX2INT(in->src->samplerate * in->speed);
 
 		in->bytes_p_samp = in->bit_depth * in->src->chan / 8;
+
+		if (in->rs) gf_resampler_del(in->rs);
+		in->rs = NULL;
+		in->rs_flushed = GF_FALSE;
+		if (am->rs_quality && in->scaled_sr && (in->scaled_sr != am->sample_rate)) {
+			in->rs = gf_resampler_new(am->rs_banks, in->scaled_sr, am->sample_rate, in->src->chan, am->rs_quality);
+			if (!in->rs) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_AUDIO, ("[AudioMixer] Failed to create resampler %d -> %d Hz, using linear interpolation\n", in->scaled_sr, am->sample_rate));
+			}
+		}
 	}
+	if (in->rs) {
+		gf_mixer_fetch_input_rs(am, in, in_data, src_size, planar_stride);
+		return;
+	}
+
+	if (!in_data || !src_size) {
+		//end of stream, flush if needed
+		if (in->src->is_eos && use_prev) {
+
+		} else {
+			/*done, stop fill*/
+			in->out_samples_to_write = 0;
+			return;
+		}
+	}
+
 	src_samp = (u32) (src_size / in->bytes_p_samp);
 
 
 	memset(inChan, 0, sizeof(s32)*GF_AUDIO_MIXER_MAX_CHANNELS);
 	memset(inChanNext, 0, sizeof(s32)*GF_AUDIO_MIXER_MAX_CHANNELS);
 
+	same_rate = (in->scaled_sr == am->sample_rate) ? GF_TRUE : GF_FALSE;
+
+	/*when resampling, convert once all input samples used for this output window*/
+	cvt_start = cvt_end = 0;
+	if (src_samp && !same_rate) {
+		u64 first, last;
+		first = in->out_samples_pos;
+		first *= in->scaled_sr;
+		first /= am->sample_rate;
+		last = in->out_samples_pos + in->out_samples_to_write - in->out_samples_written - 1;
+		last *= in->scaled_sr;
+		last /= am->sample_rate;
+		//we need prev and next of the last output sample
+		last += 2;
+		if (first > in->in_samples_pos) cvt_start = (u32) MIN(first - in->in_samples_pos, src_samp);
+		if (last > in->in_samples_pos) cvt_end = (u32) MIN(last - in->in_samples_pos, src_samp);
+
+		if (cvt_end > cvt_start) {
+			u32 len = cvt_end - cvt_start;
+			gf_mixer_input_alloc_cvt(in, in_ch * len);
+			for (j=0; j<in_ch; j++) cvt[j] = in->cvt_buf + j*len;
+			in->get_block((u8 *) in_data, in_ch, cvt_start, len, planar_stride, cvt, 0);
+		} else {
+			cvt_start = cvt_end = 0;
+		}
+	}
+
 	/*while output not full and input data, convert*/
 	next = prev = 0;
 	while (1) {
@@ -726,6 +1630,26 @@ static void gf_mixer_fetch_input(GF_AudioMixer *am, MixerInput *in, u32 audio_de
 		lfrac *= RESAMPLE_SCALER;
 		frac = (s32) (lfrac / am->sample_rate);
 
+		/*no resampling, process all available samples at once*/
+		if (src_samp && same_rate && !use_prev && (src_pos >= in->in_samples_pos)) {
+			u32 nb;
+			prev = (u32) (src_pos - in->in_samples_pos);
+			next = prev+1;
+			if (prev>=src_samp)
+				break;
+
+			nb = MIN(src_samp - prev, in->out_samples_to_write - in->out_samples_written);
+			gf_mixer_fetch_block(am, in, in_data, prev, nb, planar_stride, inChan);
+			in->out_samples_written += nb;
+			in->out_samples_pos += nb;
+			prev += nb;
+			//output full, last sample used is the previous one
+			if (in->out_samples_written == in->out_samples_to_write)
+				prev--;
+			next = prev+1;
+			break;
+		}
+
 		if (src_samp) {
 			if (src_pos < in->in_samples_pos) {
 				use_prev = GF_TRUE;
@@ -757,9 +1681,18 @@ static void gf_mixer_fetch_input(GF_AudioMixer *am, MixerInput *in, u32 audio_de
 		}
 
 		for (j = 0; j < in_ch; j++) {
-			inChan[j] = use_prev ? in->last_channels[j] : in->get_sample(in_data, in_ch, prev, j, planar_stride);
+			if (use_prev)
+				inChan[j] = in->last_channels[j];
+			else if ((prev>=cvt_start) && (prev<cvt_end))
+				inChan[j] = cvt[j][prev - cvt_start];
+			else
+				inChan[j] = in->get_sample(in_data, in_ch, prev, j, planar_stride);
+
 			if (frac) {
-				inChanNext[j] = in->get_sample(in_data, in_ch, next, j, planar_stride);
+				if ((next>=cvt_start) && (next<cvt_end))
+					inChanNext[j] = cvt[j][next - cvt_start];
+				else
+					inChanNext[j] = in->get_sample(in_data, in_ch, next, j, planar_stride);
 				inChan[j] = (s32) ( ( ((s64) inChanNext[j])*frac + ((s64)inChan[j])*(RESAMPLE_SCALER-frac)) / RESAMPLE_SCALER );
 			}
 			//don't apply pan when forced layout is used
@@ -831,8 +1764,9 @@ u32 gf_mixer_get_output(GF_AudioMixer *am, void *buffer, u32 buffer_size, u32 de
 	Fixed pan[GF_AUDIO_MIXER_MAX_CHANNELS];
 	Bool is_muted, force_mix;
 	u32 i, j, count, size, in_size, nb_samples, nb_written;
-	s32 *out_mix, nb_act_src;
+	s32 nb_act_src;
 	char *data, *ptr;
+	mix_output_block output_block;
 
 	am->source_buffering = GF_FALSE;
 	//reset buffer whatever the state of the mixer is
@@ -935,7 +1869,7 @@ do_mix:
 		in = (MixerInput *)gf_list_get(am->sources, i);
 		in->muted = in->src->IsMuted(in->src->callback);
 		if (in->muted) continue;
-		if (!in->bit_depth) gf_am_configure_source(in);
+		if (!in->bit_depth) gf_am_configure_source(am, in);
 
 		if (in->buffer_size < nb_samples) {
 			for (j=0; j<GF_AUDIO_MIXER_MAX_CHANNELS; j++) {
@@ -1025,25 +1959,16 @@ do_mix:
 		//only resync on the first fill
 		delay=0;
 	}
-	/*step 3, mix the final buffer*/
-	memset(am->output, 0, sizeof(s32) * buffer_size);
+	/*step 3, mix the final buffer, one plane of nb_samples per channel*/
+	memset(am->output, 0, sizeof(s32) * nb_samples * am->nb_channels);
 
 	nb_written = 0;
 	for (i=0; i<count; i++) {
-		u32 k;
-		out_mix = am->output;
 		in = (MixerInput *)gf_list_get(am->sources, i);
 		if (!in->out_samples_written) continue;
 		/*only write what has been filled in the source buffer (may be less than output size)*/
-		for (j = 0; j < in->out_samples_written; j++) {
-			for (k = 0; k < am->nb_channels; k++) {
-				s64 oval = (*out_mix);
-				oval += *(in->ch_buf[k] + j);
-				if (oval>GF_INT_MAX) oval = GF_INT_MAX;
-				else if (oval<GF_INT_MIN) oval = GF_INT_MIN;
-				(*out_mix) = (s32) oval;
-				out_mix += 1;
-			}
+		for (j = 0; j < am->nb_channels; j++) {
+			am->mix_block(am->output + j*nb_samples, in->ch_buf[j], in->out_samples_written);
 		}
 		if (nb_written < in->out_samples_written) nb_written = in->out_samples_written;
 	}
@@ -1056,169 +1981,9 @@ do_mix:
 	//TODO big-endian support (output is assumed to be little endian PCM)
 
 	//we do not re-normalize based on the number of input, this is the author's responsability
-	out_mix = am->output;
-	if (am->afmt == GF_AUDIO_FMT_S32) {
-		s32 *out_s32 = (s32 *)buffer;
-		for (i = 0; i < nb_written; i++) {
-			for (j = 0; j < am->nb_channels; j++) {
-				s32 samp = (*out_mix);
-				(*out_s32) = samp;
-				out_s32 += 1;
-				out_mix += 1;
-			}
-		}
-	}
-	else if (am->afmt == GF_AUDIO_FMT_S32P) {
-		s32 *out_s32 = (s32 *) buffer;
-		for (j = 0; j < am->nb_channels; j++) {
-			out_mix = am->output + j;
-			for (i = 0; i < nb_written; i++) {
-				s32 samp = (*out_mix);
-				(*out_s32) = samp;
-				out_s32 += 1;
-				out_mix += am->nb_channels;
-			}
-		}
-	}
-	else if (am->afmt == GF_AUDIO_FMT_FLT) {
-		Float *out_flt = (Float *)buffer;
-		for (i = 0; i < nb_written; i++) {
-			for (j = 0; j < am->nb_channels; j++) {
-				s32 samp = (*out_mix);
-				(*out_flt) = ((Float)samp) / GF_INT_MAX;
-				out_flt += 1;
-				out_mix += 1;
-			}
-		}
-	}
-	else if (am->afmt == GF_AUDIO_FMT_FLTP) {
-		Float *out_flt = (Float *)buffer;
-		for (j = 0; j < am->nb_channels; j++) {
-			out_mix = am->output + j;
-			for (i = 0; i < nb_written; i++) {
-				s32 samp = (*out_mix);
-				(*out_flt) = ((Float)samp) / GF_INT_MAX;
-				out_flt += 1;
-				out_mix += am->nb_channels;
-			}
-		}
-	}
-	else if (am->afmt == GF_AUDIO_FMT_DBL) {
-		Double *out_dbl = (Double *)buffer;
-		for (i = 0; i < nb_written; i++) {
-			for (j = 0; j < am->nb_channels; j++) {
-				s32 samp = (*out_mix);
-				(*out_dbl) = ((Double)samp) / GF_INT_MAX;
-				out_dbl += 1;
-				out_mix += 1;
-			}
-		}
-	}
-	else if (am->afmt == GF_AUDIO_FMT_DBLP) {
-		Double *out_dbl = (Double *)buffer;
-		for (j = 0; j < am->nb_channels; j++) {
-			out_mix = am->output + j;
-			for (i = 0; i < nb_written; i++) {
-				s32 samp = (*out_mix);
-				(*out_dbl) = ((Double)samp) / GF_INT_MAX;
-				out_dbl += 1;
-				out_mix += am->nb_channels;
-			}
-		}
-	}
-	else if (am->afmt == GF_AUDIO_FMT_S24) {
-		s8 *out_s24 = (s8 *)buffer;
-		for (i = 0; i<nb_written; i++) {
-			for (j = 0; j<am->nb_channels; j++) {
-				s32 samp = (*out_mix);
-//				char samp_c[4];
-				samp /= MIX_S24_SCALE;
-				if (samp > GF_S24_MAX) samp = GF_S24_MAX;
-				else if (samp < GF_S24_MIN) samp = GF_S24_MIN;
-//				memcpy(samp_c, &samp, 3);
-				out_s24[2] = (samp>>16) & 0xFF;
-				out_s24[1] = (samp>>8) & 0xFF;
-				out_s24[0] = samp & 0xFF;
-				out_s24 += 3;
-				out_mix += 1;
-			}
-		}
-	} else if (am->afmt == GF_AUDIO_FMT_S24P) {
-		s8 *out_s24 = (s8 *)buffer;
-		for (j = 0; j<am->nb_channels; j++) {
-			out_mix = am->output + j;
-			for (i = 0; i<nb_written; i++) {
-				s32 samp = (*out_mix);
-				char s16tmp[2];
-				u8 lsb;
-				samp /= MIX_S24_SCALE;
-				if (samp > GF_S24_MAX) samp = GF_S24_MAX;
-				else if (samp < GF_S24_MIN) samp = GF_S24_MIN;
-				lsb = (samp) & 0xFF;
-				samp >>= 8;
-//				*((s16 *) (out_s24 +1) ) = (s16)samp;
-				*((s16 *) s16tmp) = (s16)samp;
-				memcpy(out_s24 +1, s16tmp, 2);
-				out_s24[0] = lsb;
-				out_s24 += 3;
-				out_mix += am->nb_channels;
-			}
-		}
-	} else if (am->afmt == GF_AUDIO_FMT_S16) {
-		s16 *out_s16 = (s16 *)buffer;
-		for (i = 0; i<nb_written; i++) {
-			for (j = 0; j<am->nb_channels; j++) {
-				s32 samp = (*out_mix);
-				samp /= MIX_S16_SCALE;
-				if (samp > GF_SHORT_MAX) samp = GF_SHORT_MAX;
-				else if (samp < GF_SHORT_MIN) samp = GF_SHORT_MIN;
-				(*out_s16) = samp;
-				out_s16 += 1;
-				out_mix += 1;
-			}
-		}
-	} else if (am->afmt == GF_AUDIO_FMT_S16P) {
-		s16 *out_s16 = (s16 *)buffer;
-		for (j = 0; j<am->nb_channels; j++) {
-			out_mix = am->output + j;
-			for (i = 0; i<nb_written; i++) {
-				s32 samp = (*out_mix);
-				samp /= MIX_S16_SCALE;
-				if (samp > GF_SHORT_MAX) samp = GF_SHORT_MAX;
-				else if (samp < GF_SHORT_MIN) samp = GF_SHORT_MIN;
-				(*out_s16) = samp;
-				out_s16 += 1;
-				out_mix += am->nb_channels;
-			}
-		}
-	} else if (am->afmt == GF_AUDIO_FMT_U8) {
-		u8 *out_u8 = (u8 *) buffer;
-		for (i=0; i<nb_written; i++) {
-			for (j=0; j<am->nb_channels; j++) {
-				s32 samp = (*out_mix ) / MIX_U8_SCALE;
-				if (samp > 127) samp = 127;
-				else if (samp < -128) samp = -128;
-				samp += 128;
-				(*out_u8) = (u8) samp;
-				out_u8 += 1;
-				out_mix += 1;
-			}
-		}
-	} else if (am->afmt == GF_AUDIO_FMT_U8P) {
-		s8 *out_s8 = (s8 *) buffer;
-		for (j=0; j<am->nb_channels; j++) {
-			out_mix = am->output + j;
-			for (i=0; i<nb_written; i++) {
-				s32 samp = (*out_mix ) / MIX_U8_SCALE;
-				if (samp > 127) samp = 127;
-				else if (samp < -128) samp = -128;
-				samp += 128;
-				(*out_s8) = samp;
-				out_s8 += 1;
-				out_mix += am->nb_channels;
-			}
-		}
-	}
+	output_block = gf_mixer_get_output_block(am);
+	if (output_block)
+		output_block(am->output, nb_samples, am->nb_channels, nb_written, (u8 *) buffer);
 
 	nb_written *= am->nb_channels * am->bit_depth / 8;
 
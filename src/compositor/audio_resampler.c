@@ -0,0 +1,456 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC developers
+ *			Copyright (c) GPAC developers 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / Scene Compositor sub-project
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#include <gpac/internal/compositor_dev.h>
+
+/*
+	Notes about the resampler:
+	- the resampling ratio in_sr/out_sr is reduced to down/up, output sample n is located at input position n*down/up
+	- the filter bank holds one windowed-sinc FIR per fractional position (phase), so each output sample is a single
+	dot product between the input history and the coefficients of its phase
+	- when up is too large (odd rates due to playback speed), phases are quantized to GF_RESAMPLER_MAX_PHASES
+	- input history is kept as float planes, the dot products use SSE2/AVX2 when available
+*/
+
+/*max number of phases in a bank*/
+#define GF_RESAMPLER_MAX_PHASES	1024
+/*max number of taps per phase*/
+#define GF_RESAMPLER_MAX_TAPS	1024
+/*input history size in samples, excluding filter length*/
+#define GF_RESAMPLER_HISTORY	4096
+
+#define RS_PI	3.14159265358979323846
+
+typedef struct
+{
+	//number of taps for upsampling, scaled by the ratio for downsampling
+	u32 nb_taps;
+	//cutoff as a fraction of the lowest nyquist frequency
+	Double rolloff;
+	//kaiser window beta
+	Double beta;
+} RSQuality;
+
+static const RSQuality rs_qualities[] =
+{
+	{0, 0, 0},
+	//GF_MIXER_RESAMPLE_LOW
+	{16, 0.80, 5.0},
+	//GF_MIXER_RESAMPLE_MEDIUM
+	{32, 0.88, 7.0},
+	//GF_MIXER_RESAMPLE_HIGH
+	{64, 0.94, 9.0},
+};
+
+typedef struct
+{
+	u32 in_sr, out_sr, quality;
+	//reduced ratio, output sample n is at input position n*down/up
+	u32 up, down;
+	u32 nb_taps, nb_phases;
+	//(nb_phases+1) rows of nb_taps coefficients, the last row being phase 0 of the next input sample
+	Float *coefs;
+	u32 refs;
+	GF_List *cache;
+} GF_AudioFilterBank;
+
+typedef void (*rs_filter_block)(const GF_AudioFilterBank *bank, const Float *hist, u32 pos, u32 frac, s32 *dst, u32 nb_out);
+
+struct __audio_resampler
+{
+	GF_AudioFilterBank *bank;
+	u32 nb_ch;
+	//float input history, one plane of hist_size samples per channel
+	Float *hist;
+	u32 hist_size, nb_hist;
+	//first input sample and phase of next output
+	u32 pos, frac;
+	rs_filter_block filter;
+};
+
+static Double rs_bessel_i0(Double x)
+{
+	Double sum = 1, term = 1, hx = x/2;
+	u32 k;
+	for (k=1; k<50; k++) {
+		term *= hx / k;
+		sum += term*term;
+		if (term*term < sum * 1e-21) break;
+	}
+	return sum;
+}
+
+static u32 rs_gcd(u32 a, u32 b)
+{
+	while (b) {
+		u32 t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+static GF_AudioFilterBank *rs_bank_new(u32 in_sr, u32 out_sr, u32 quality)
+{
+	u32 g, p, k, nb_taps;
+	Double ratio, fc, i0_beta, half;
+	const RSQuality *q = &rs_qualities[quality];
+	GF_AudioFilterBank *bank;
+
+	GF_SAFEALLOC(bank, GF_AudioFilterBank);
+	if (!bank) return NULL;
+	bank->in_sr = in_sr;
+	bank->out_sr = out_sr;
+	bank->quality = quality;
+	g = rs_gcd(in_sr, out_sr);
+	bank->up = out_sr / g;
+	bank->down = in_sr / g;
+	bank->nb_phases = MIN(bank->up, GF_RESAMPLER_MAX_PHASES);
+
+	//when downsampling, lower the cutoff and widen the filter to keep the same transition band
+	ratio = ((Double) out_sr) / in_sr;
+	if (ratio > 1) ratio = 1;
+	fc = q->rolloff * ratio;
+	nb_taps = (u32) (q->nb_taps / ratio);
+	//multiple of 16 for SIMD
+	nb_taps = (nb_taps + 15) & ~15;
+	if (nb_taps > GF_RESAMPLER_MAX_TAPS) nb_taps = GF_RESAMPLER_MAX_TAPS;
+	bank->nb_taps = nb_taps;
+
+	bank->coefs = (Float *) gf_malloc(sizeof(Float) * nb_taps * (bank->nb_phases+1));
+	if (!bank->coefs) {
+		gf_free(bank);
+		return NULL;
+	}
+
+	i0_beta = rs_bessel_i0(q->beta);
+	half = nb_taps / 2;
+	for (p=0; p<=bank->nb_phases; p++) {
+		Double sum = 0;
+		Double offset = ((Double) p) / bank->nb_phases;
+		Float *row = bank->coefs + p*nb_taps;
+		Double tmp[GF_RESAMPLER_MAX_TAPS];
+		for (k=0; k<nb_taps; k++) {
+			Double x, w, s;
+			//distance between tap input sample and output position, tap half-1 being the input sample at or before the output
+			Double d = ((Double) k) - (half - 1) - offset;
+			x = d / half;
+			if ((x <= -1) || (x >= 1)) {
+				w = 0;
+			} else {
+				w = rs_bessel_i0(q->beta * sqrt(1 - x*x)) / i0_beta;
+			}
+			if (d == 0) s = fc;
+			else s = sin(RS_PI * fc * d) / (RS_PI * d);
+			tmp[k] = s * w;
+			sum += tmp[k];
+		}
+		//unity gain for every phase
+		for (k=0; k<nb_taps; k++) {
+			row[k] = (Float) (tmp[k] / sum);
+		}
+	}
+	bank->refs = 1;
+	return bank;
+}
+
+static void rs_bank_del(GF_AudioFilterBank *bank)
+{
+	if (bank->refs>1) {
+		bank->refs--;
+		return;
+	}
+	if (bank->cache) gf_list_del_item(bank->cache, bank);
+	gf_free(bank->coefs);
+	gf_free(bank);
+}
+
+static GFINLINE s32 rs_float_to_s32(Float v)
+{
+	if (v >= 2147483648.0f) return GF_INT_MAX;
+	if (v <= -2147483648.0f) return GF_INT_MIN;
+	return (s32) v;
+}
+
+static GFINLINE u32 rs_phase(const GF_AudioFilterBank *bank, u32 frac)
+{
+	if (bank->nb_phases == bank->up) return frac;
+	return (u32) ( ( ((u64) frac) * bank->nb_phases + bank->up/2) / bank->up);
+}
+
+#define RS_STEP(_bank, _pos, _frac) \
+	_frac += _bank->down; \
+	if (_frac >= _bank->up) { \
+		_pos += _frac / _bank->up; \
+		_frac %= _bank->up; \
+	}
+
+static void rs_filter_c(const GF_AudioFilterBank *bank, const Float *hist, u32 pos, u32 frac, s32 *dst, u32 nb_out)
+{
+	u32 i, k;
+	for (i=0; i<nb_out; i++) {
+		const Float *h = hist + pos;
+		const Float *c = bank->coefs + rs_phase(bank, frac) * bank->nb_taps;
+		Float acc = 0;
+		for (k=0; k<bank->nb_taps; k++)
+			acc += h[k] * c[k];
+		dst[i] = rs_float_to_s32(acc);
+		RS_STEP(bank, pos, frac)
+	}
+}
+
+#if defined(WIN32) && !defined(__GNUC__)
+# include <intrin.h>
+# define GPAC_HAS_SSE2
+# define GPAC_HAS_AVX2
+# define RS_AVX2_TARGET
+#else
+# ifdef __SSE2__
+#  include <emmintrin.h>
+#  define GPAC_HAS_SSE2
+# endif
+# if defined(__SSE2__) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  include <immintrin.h>
+#  define GPAC_HAS_AVX2
+#  define RS_AVX2_TARGET __attribute__((target("avx2")))
+# endif
+#endif
+
+#ifdef GPAC_HAS_SSE2
+
+static GFINLINE s32 rs_hsum_sse2(__m128 v)
+{
+	__m128 r, gt;
+	v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+	v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+	//values above the s32 range saturate to GF_INT_MAX, as in scalar code
+	r = _mm_castsi128_ps(_mm_cvttps_epi32(v));
+	gt = _mm_cmpge_ss(v, _mm_set_ss(2147483648.0f));
+	r = _mm_or_ps(_mm_andnot_ps(gt, r), _mm_and_ps(gt, _mm_castsi128_ps(_mm_set1_epi32(GF_INT_MAX))));
+	return _mm_cvtsi128_si32(_mm_castps_si128(r));
+}
+
+static void rs_filter_sse2(const GF_AudioFilterBank *bank, const Float *hist, u32 pos, u32 frac, s32 *dst, u32 nb_out)
+{
+	u32 i, k;
+	for (i=0; i<nb_out; i++) {
+		const Float *h = hist + pos;
+		const Float *c = bank->coefs + rs_phase(bank, frac) * bank->nb_taps;
+		__m128 a0 = _mm_setzero_ps();
+		__m128 a1 = _mm_setzero_ps();
+		for (k=0; k<bank->nb_taps; k+=8) {
+			a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(h+k), _mm_loadu_ps(c+k)));
+			a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(h+k+4), _mm_loadu_ps(c+k+4)));
+		}
+		dst[i] = rs_hsum_sse2(_mm_add_ps(a0, a1));
+		RS_STEP(bank, pos, frac)
+	}
+}
+#endif //GPAC_HAS_SSE2
+
+#ifdef GPAC_HAS_AVX2
+RS_AVX2_TARGET
+static void rs_filter_avx2(const GF_AudioFilterBank *bank, const Float *hist, u32 pos, u32 frac, s32 *dst, u32 nb_out)
+{
+	u32 i, k;
+	for (i=0; i<nb_out; i++) {
+		const Float *h = hist + pos;
+		const Float *c = bank->coefs + rs_phase(bank, frac) * bank->nb_taps;
+		__m256 a0 = _mm256_setzero_ps();
+		__m256 a1 = _mm256_setzero_ps();
+		for (k=0; k<bank->nb_taps; k+=16) {
+			a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_loadu_ps(h+k), _mm256_loadu_ps(c+k)));
+			a1 = _mm256_add_ps(a1, _mm256_mul_ps(_mm256_loadu_ps(h+k+8), _mm256_loadu_ps(c+k+8)));
+		}
+		a0 = _mm256_add_ps(a0, a1);
+		dst[i] = rs_hsum_sse2(_mm_add_ps(_mm256_castps256_ps128(a0), _mm256_extractf128_ps(a0, 1)));
+		RS_STEP(bank, pos, frac)
+	}
+}
+#endif //GPAC_HAS_AVX2
+
+GF_AudioResampler *gf_resampler_new(GF_List *bank_cache, u32 in_sr, u32 out_sr, u32 nb_ch, u32 quality)
+{
+	u32 i, count;
+	u32 cpu;
+	GF_AudioResampler *rs;
+	GF_AudioFilterBank *bank = NULL;
+
+	if (!in_sr || !out_sr || !nb_ch || (nb_ch>GF_AUDIO_MIXER_MAX_CHANNELS)) return NULL;
+	if (!quality || (quality > GF_MIXER_RESAMPLE_HIGH)) return NULL;
+
+	count = bank_cache ? gf_list_count(bank_cache) : 0;
+	for (i=0; i<count; i++) {
+		bank = gf_list_get(bank_cache, i);
+		if ((bank->in_sr==in_sr) && (bank->out_sr==out_sr) && (bank->quality==quality)) {
+			bank->refs++;
+			break;
+		}
+		bank = NULL;
+	}
+	if (!bank) {
+		bank = rs_bank_new(in_sr, out_sr, quality);
+		if (!bank) return NULL;
+		if (bank_cache) {
+			bank->cache = bank_cache;
+			gf_list_add(bank_cache, bank);
+		}
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_AUDIO, ("[AudioResampler] Created filter bank %d -> %d Hz, %d phases of %d taps\n", in_sr, out_sr, bank->nb_phases, bank->nb_taps));
+	}
+
+	GF_SAFEALLOC(rs, GF_AudioResampler);
+	if (!rs) {
+		rs_bank_del(bank);
+		return NULL;
+	}
+	rs->bank = bank;
+	rs->nb_ch = nb_ch;
+	rs->hist_size = GF_RESAMPLER_HISTORY + bank->nb_taps;
+	rs->hist = (Float *) gf_malloc(sizeof(Float) * rs->hist_size * nb_ch);
+	if (!rs->hist) {
+		gf_resampler_del(rs);
+		return NULL;
+	}
+
+	cpu = gf_sys_get_cpu_features();
+	rs->filter = rs_filter_c;
+#ifdef GPAC_HAS_SSE2
+	if (cpu & GF_CPU_SSE2) rs->filter = rs_filter_sse2;
+#endif
+#ifdef GPAC_HAS_AVX2
+	if (cpu & GF_CPU_AVX2) rs->filter = rs_filter_avx2;
+#endif
+	gf_resampler_reset(rs);
+	return rs;
+}
+
+void gf_resampler_del(GF_AudioResampler *rs)
+{
+	if (!rs) return;
+	if (rs->bank) rs_bank_del(rs->bank);
+	if (rs->hist) gf_free(rs->hist);
+	gf_free(rs);
+}
+
+void gf_resampler_reset(GF_AudioResampler *rs)
+{
+	u32 j;
+	//prime with zeros so that the first output is centered on the first input sample
+	rs->nb_hist = rs->bank->nb_taps/2 - 1;
+	rs->pos = rs->frac = 0;
+	for (j=0; j<rs->nb_ch; j++) {
+		memset(rs->hist + j*rs->hist_size, 0, sizeof(Float) * rs->nb_hist);
+	}
+}
+
+static u32 rs_make_room(GF_AudioResampler *rs)
+{
+	u32 j;
+	if (rs->pos) {
+		if (rs->nb_hist > rs->pos) {
+			u32 nb_keep = rs->nb_hist - rs->pos;
+			for (j=0; j<rs->nb_ch; j++) {
+				Float *h = rs->hist + j*rs->hist_size;
+				memmove(h, h + rs->pos, sizeof(Float) * nb_keep);
+			}
+			rs->nb_hist = nb_keep;
+			rs->pos = 0;
+		} else {
+			//next input samples to push are skipped by the filter
+			rs->pos -= rs->nb_hist;
+			rs->nb_hist = 0;
+		}
+	}
+	return rs->hist_size - rs->nb_hist;
+}
+
+u32 gf_resampler_input_needed(GF_AudioResampler *rs, u32 nb_out)
+{
+	u64 last;
+	const GF_AudioFilterBank *bank = rs->bank;
+	if (!nb_out) return 0;
+	//history needed for the last output sample
+	last = rs->frac + ((u64) nb_out - 1) * bank->down;
+	last /= bank->up;
+	last += rs->pos + bank->nb_taps;
+	if (last <= rs->nb_hist) return 0;
+	last -= rs->nb_hist;
+	//don't ask for more than what can be pushed
+	if (last > rs->hist_size - rs->nb_hist + rs->pos) last = rs->hist_size - rs->nb_hist + rs->pos;
+	return (u32) last;
+}
+
+u32 gf_resampler_push(GF_AudioResampler *rs, s32 **planes, u32 nb_samples)
+{
+	u32 i, j;
+	if (rs->nb_hist + nb_samples > rs->hist_size) {
+		u32 room = rs_make_room(rs);
+		if (nb_samples > room) nb_samples = room;
+	}
+	for (j=0; j<rs->nb_ch; j++) {
+		Float *h = rs->hist + j*rs->hist_size + rs->nb_hist;
+		if (planes) {
+			const s32 *src = planes[j];
+			for (i=0; i<nb_samples; i++) h[i] = (Float) src[i];
+		} else {
+			memset(h, 0, sizeof(Float)*nb_samples);
+		}
+	}
+	rs->nb_hist += nb_samples;
+	return nb_samples;
+}
+
+void gf_resampler_flush(GF_AudioResampler *rs)
+{
+	u32 nb_zeros = rs->bank->nb_taps/2;
+	while (nb_zeros) {
+		u32 nb = gf_resampler_push(rs, NULL, nb_zeros);
+		if (!nb) break;
+		nb_zeros -= nb;
+	}
+}
+
+u32 gf_resampler_process(GF_AudioResampler *rs, s32 **dst, u32 nb_out)
+{
+	u32 j;
+	u64 avail;
+	const GF_AudioFilterBank *bank = rs->bank;
+
+	if (rs->pos + bank->nb_taps > rs->nb_hist) return 0;
+	//number of outputs whose input window is in history
+	avail = rs->nb_hist - bank->nb_taps - rs->pos + 1;
+	avail *= bank->up;
+	avail -= rs->frac;
+	avail = (avail + bank->down - 1) / bank->down;
+	if (avail < nb_out) nb_out = (u32) avail;
+
+	for (j=0; j<rs->nb_ch; j++) {
+		rs->filter(bank, rs->hist + j*rs->hist_size, rs->pos, rs->frac, dst[j], nb_out);
+	}
+	avail = rs->frac + ((u64) nb_out) * bank->down;
+	rs->pos += (u32) (avail / bank->up);
+	rs->frac = (u32) (avail % bank->up);
+	return nb_out;
+}
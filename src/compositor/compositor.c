@@ -1621,6 +1621,10 @@ void gf_sc_reload_config(GF_Compositor *compositor)
 		compositor->video_out->dpi_y = compositor->dpi.y;
 	}
 
+	/*apply rasterizer threads now, they may have been updated at run time*/
+	if (compositor->visual->raster_surface)
+		gf_evg_surface_set_raster_threads(compositor->visual->raster_surface, compositor->rthreads);
+
 	gf_sc_reset_graphics(compositor);
 	gf_sc_next_frame_state(compositor, GF_SC_DRAW_FRAME);
 
@@ -37,6 +37,7 @@ GF_Err visual_2d_init_raster(GF_VisualManager *visual)
 		visual->raster_surface = gf_evg_surface_new(visual->center_coords);
 		if (!visual->raster_surface) return GF_IO_ERR;
 	}
+	gf_evg_surface_set_raster_threads(visual->raster_surface, visual->compositor->rthreads);
 	return visual->GetSurfaceAccess(visual);
 }
 
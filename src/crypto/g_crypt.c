@@ -34,11 +34,14 @@ GF_Crypt *gf_crypt_open(GF_CRYPTO_ALGO algorithm, GF_CRYPTO_MODE mode)
 	GF_SAFEALLOC(td, GF_Crypt);
 	if (td == NULL) return NULL;
 
+	e = gf_crypt_open_open_aesni(td, mode);
+	if (e == GF_NOT_SUPPORTED) {
 #ifdef GPAC_HAS_SSL
-	e = gf_crypt_open_open_openssl(td, mode);
+		e = gf_crypt_open_open_openssl(td, mode);
 #else
-	e = gf_crypt_open_open_tinyaes(td, mode);
+		e = gf_crypt_open_open_tinyaes(td, mode);
 #endif
+	}
 
 	if (e != GF_OK) {
 		gf_free(td);
@@ -103,3 +106,40 @@ GF_Err gf_crypt_decrypt(GF_Crypt *td, void *ciphertext, u32 len)
 	if (!len) return GF_OK;
 	return td->_decrypt(td, ciphertext, len);
 }
+
+GF_EXPORT
+GF_Err gf_crypt_encrypt_pattern(GF_Crypt *td, void *buffer, u32 len, u32 crypt_block, u32 skip_block)
+{
+	u8 *buf = (u8 *)buffer;
+	if (!td) return GF_BAD_PARAM;
+	if (!crypt_block || !skip_block) return td->_crypt(td, buf, len);
+	if (td->_crypt_pattern) return td->_crypt_pattern(td, buf, len, crypt_block, skip_block);
+
+	while (len) {
+		GF_Err e = td->_crypt(td, buf, (len >= 16*crypt_block) ? 16*crypt_block : len);
+		if (e) return e;
+		if (len < 16*(crypt_block+skip_block)) break;
+		buf += 16*(crypt_block+skip_block);
+		len -= 16*(crypt_block+skip_block);
+	}
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_crypt_decrypt_pattern(GF_Crypt *td, void *buffer, u32 len, u32 crypt_block, u32 skip_block)
+{
+	u8 *buf = (u8 *)buffer;
+	if (!td) return GF_BAD_PARAM;
+	if (!len) return GF_OK;
+	if (!crypt_block || !skip_block) return td->_decrypt(td, buf, len);
+	if (td->_decrypt_pattern) return td->_decrypt_pattern(td, buf, len, crypt_block, skip_block);
+
+	while (len) {
+		GF_Err e = td->_decrypt(td, buf, (len >= 16*crypt_block) ? 16*crypt_block : len);
+		if (e) return e;
+		if (len < 16*(crypt_block+skip_block)) break;
+		buf += 16*(crypt_block+skip_block);
+		len -= 16*(crypt_block+skip_block);
+	}
+	return GF_OK;
+}
@@ -0,0 +1,491 @@
+/*
+*			GPAC - Multimedia Framework C SDK
+*
+*			Authors: GPAC developers
+*			Copyright (c) GPAC developers 2026
+*					All rights reserved
+*
+*  This file is part of GPAC / crypto lib sub-project
+*
+*  GPAC is free software; you can redistribute it and/or modify
+*  it under the terms of the GNU Lesser General Public License as published by
+*  the Free Software Foundation; either version 2, or (at your option)
+*  any later version.
+*
+*  GPAC is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Lesser General Public License for more details.
+*
+*  You should have received a copy of the GNU Lesser General Public
+*  License along with this library; see the file COPYING.  If not, write to
+*  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+*
+*/
+
+#include <gpac/internal/crypt_dev.h>
+
+/*
+	AES-128 using the x86 AES instructions, selected at runtime when the CPU supports them.
+
+	The state semantics are the same as the openssl and tinyaes backends:
+	- CBC: the IV is the last ciphertext block, and is carried over from one call to the next
+	- CTR: the IV is the next counter block (128 bits big endian), the state also holds the key stream of the current block
+	and the number of bytes already used in it, exposed as the first byte of the 17-byte IV
+
+	CTR and CBC decryption process 8 independent blocks at once to hide the latency of the AES units,
+	CBC encryption is inherently serial.
+*/
+
+#if defined(WIN32) && !defined(__GNUC__)
+# include <intrin.h>
+# define GPAC_HAS_AESNI
+# define AESNI_TARGET
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# include <immintrin.h>
+# define GPAC_HAS_AESNI
+# define AESNI_TARGET __attribute__((target("aes,ssse3")))
+#endif
+
+#ifdef GPAC_HAS_AESNI
+
+#define AESNI_ROUNDS	10
+#define AESNI_BATCH	8
+
+typedef struct
+{
+	u8 enc_keys[16*(AESNI_ROUNDS+1)];
+	u8 dec_keys[16*(AESNI_ROUNDS+1)];
+	u8 iv[16];
+	//CTR only: key stream of the current counter block and number of bytes used in it
+	u8 block[16];
+	u32 counter_pos;
+} AESNI_Ctx;
+
+AESNI_TARGET
+static GFINLINE __m128i aesni_key_assist(__m128i key, __m128i kga)
+{
+	kga = _mm_shuffle_epi32(kga, 0xFF);
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+	return _mm_xor_si128(key, kga);
+}
+
+#define AESNI_EXPAND(_k, _i, _rcon)	_k[_i] = aesni_key_assist(_k[_i-1], _mm_aeskeygenassist_si128(_k[_i-1], _rcon));
+
+AESNI_TARGET
+static void aesni_set_key(AESNI_Ctx *ctx, const u8 *key)
+{
+	u32 i;
+	__m128i k[AESNI_ROUNDS+1];
+	k[0] = _mm_loadu_si128((const __m128i *) key);
+	AESNI_EXPAND(k, 1, 0x01)
+	AESNI_EXPAND(k, 2, 0x02)
+	AESNI_EXPAND(k, 3, 0x04)
+	AESNI_EXPAND(k, 4, 0x08)
+	AESNI_EXPAND(k, 5, 0x10)
+	AESNI_EXPAND(k, 6, 0x20)
+	AESNI_EXPAND(k, 7, 0x40)
+	AESNI_EXPAND(k, 8, 0x80)
+	AESNI_EXPAND(k, 9, 0x1B)
+	AESNI_EXPAND(k, 10, 0x36)
+
+	//equivalent inverse cipher: reversed round keys, InvMixColumns applied on inner ones
+	for (i=0; i<=AESNI_ROUNDS; i++) {
+		__m128i dk = k[AESNI_ROUNDS-i];
+		if (i && (i<AESNI_ROUNDS)) dk = _mm_aesimc_si128(dk);
+		_mm_storeu_si128((__m128i *) (ctx->enc_keys + 16*i), k[i]);
+		_mm_storeu_si128((__m128i *) (ctx->dec_keys + 16*i), dk);
+	}
+}
+
+AESNI_TARGET
+static GFINLINE void aesni_load_keys(__m128i *k, const u8 *src)
+{
+	u32 i;
+	for (i=0; i<=AESNI_ROUNDS; i++)
+		k[i] = _mm_loadu_si128((const __m128i *) (src + 16*i));
+}
+
+AESNI_TARGET
+static GFINLINE __m128i aesni_encrypt_block(const __m128i *k, __m128i b)
+{
+	u32 i;
+	b = _mm_xor_si128(b, k[0]);
+	for (i=1; i<AESNI_ROUNDS; i++)
+		b = _mm_aesenc_si128(b, k[i]);
+	return _mm_aesenclast_si128(b, k[AESNI_ROUNDS]);
+}
+
+AESNI_TARGET
+static GFINLINE void aesni_encrypt_blocks(const __m128i *k, __m128i *b)
+{
+	u32 i, j;
+	for (j=0; j<AESNI_BATCH; j++)
+		b[j] = _mm_xor_si128(b[j], k[0]);
+	for (i=1; i<AESNI_ROUNDS; i++) {
+		for (j=0; j<AESNI_BATCH; j++)
+			b[j] = _mm_aesenc_si128(b[j], k[i]);
+	}
+	for (j=0; j<AESNI_BATCH; j++)
+		b[j] = _mm_aesenclast_si128(b[j], k[AESNI_ROUNDS]);
+}
+
+AESNI_TARGET
+static GFINLINE __m128i aesni_decrypt_block(const __m128i *k, __m128i b)
+{
+	u32 i;
+	b = _mm_xor_si128(b, k[0]);
+	for (i=1; i<AESNI_ROUNDS; i++)
+		b = _mm_aesdec_si128(b, k[i]);
+	return _mm_aesdeclast_si128(b, k[AESNI_ROUNDS]);
+}
+
+AESNI_TARGET
+static GFINLINE void aesni_decrypt_blocks(const __m128i *k, __m128i *b)
+{
+	u32 i, j;
+	for (j=0; j<AESNI_BATCH; j++)
+		b[j] = _mm_xor_si128(b[j], k[0]);
+	for (i=1; i<AESNI_ROUNDS; i++) {
+		for (j=0; j<AESNI_BATCH; j++)
+			b[j] = _mm_aesdec_si128(b[j], k[i]);
+	}
+	for (j=0; j<AESNI_BATCH; j++)
+		b[j] = _mm_aesdeclast_si128(b[j], k[AESNI_ROUNDS]);
+}
+
+/** CBC mode **/
+
+AESNI_TARGET
+static void aesni_cbc_encrypt(AESNI_Ctx *ctx, const __m128i *k, u8 *buf, u32 len)
+{
+	__m128i iv = _mm_loadu_si128((const __m128i *) ctx->iv);
+	while (len >= 16) {
+		iv = aesni_encrypt_block(k, _mm_xor_si128(_mm_loadu_si128((const __m128i *) buf), iv));
+		_mm_storeu_si128((__m128i *) buf, iv);
+		buf += 16;
+		len -= 16;
+	}
+	//trailing partial block is zero-padded, only the first bytes of the ciphertext are written back
+	if (len) {
+		u8 block[16];
+		memset(block, 0, 16);
+		memcpy(block, buf, len);
+		iv = aesni_encrypt_block(k, _mm_xor_si128(_mm_loadu_si128((const __m128i *) block), iv));
+		_mm_storeu_si128((__m128i *) block, iv);
+		memcpy(buf, block, len);
+	}
+	_mm_storeu_si128((__m128i *) ctx->iv, iv);
+}
+
+//trailing partial block is left untouched
+AESNI_TARGET
+static void aesni_cbc_decrypt(AESNI_Ctx *ctx, const __m128i *k, u8 *buf, u32 len)
+{
+	u32 j;
+	__m128i b[AESNI_BATCH], c[AESNI_BATCH];
+	__m128i iv = _mm_loadu_si128((const __m128i *) ctx->iv);
+
+	while (len >= 16*AESNI_BATCH) {
+		for (j=0; j<AESNI_BATCH; j++)
+			b[j] = c[j] = _mm_loadu_si128((const __m128i *) (buf + 16*j));
+		aesni_decrypt_blocks(k, b);
+		_mm_storeu_si128((__m128i *) buf, _mm_xor_si128(b[0], iv));
+		for (j=1; j<AESNI_BATCH; j++)
+			_mm_storeu_si128((__m128i *) (buf + 16*j), _mm_xor_si128(b[j], c[j-1]));
+		iv = c[AESNI_BATCH-1];
+		buf += 16*AESNI_BATCH;
+		len -= 16*AESNI_BATCH;
+	}
+	while (len >= 16) {
+		__m128i cb = _mm_loadu_si128((const __m128i *) buf);
+		_mm_storeu_si128((__m128i *) buf, _mm_xor_si128(aesni_decrypt_block(k, cb), iv));
+		iv = cb;
+		buf += 16;
+		len -= 16;
+	}
+	_mm_storeu_si128((__m128i *) ctx->iv, iv);
+}
+
+/** CTR mode **/
+
+static GFINLINE u64 aesni_get_be64(const u8 *p)
+{
+	return ((u64)p[0]<<56) | ((u64)p[1]<<48) | ((u64)p[2]<<40) | ((u64)p[3]<<32)
+		| ((u64)p[4]<<24) | ((u64)p[5]<<16) | ((u64)p[6]<<8) | (u64)p[7];
+}
+
+static GFINLINE void aesni_set_be64(u8 *p, u64 v)
+{
+	u32 i;
+	for (i=0; i<8; i++) {
+		p[7-i] = (u8) (v & 0xFF);
+		v >>= 8;
+	}
+}
+
+//counter block from a 128-bit big endian counter held as two native 64-bit halves
+AESNI_TARGET
+static GFINLINE __m128i aesni_ctr_block(u64 hi, u64 lo, __m128i bswap)
+{
+	return _mm_shuffle_epi8(_mm_set_epi64x((s64) lo, (s64) hi), bswap);
+}
+
+#define AESNI_CTR_INC(_hi, _lo) { _lo++; if (!_lo) _hi++; }
+
+AESNI_TARGET
+static void aesni_ecb_encrypt(const u8 *keys, u8 *block)
+{
+	__m128i k[AESNI_ROUNDS+1];
+	aesni_load_keys(k, keys);
+	_mm_storeu_si128((__m128i *) block, aesni_encrypt_block(k, _mm_loadu_si128((const __m128i *) block)));
+}
+
+AESNI_TARGET
+static void aesni_ctr_xcrypt(AESNI_Ctx *ctx, const __m128i *k, u8 *buf, u32 len)
+{
+	u32 j;
+	u64 hi, lo;
+	__m128i b[AESNI_BATCH];
+	const __m128i bswap = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+
+	//finish current key stream block
+	while (ctx->counter_pos && len) {
+		*buf++ ^= ctx->block[ctx->counter_pos];
+		ctx->counter_pos = (ctx->counter_pos + 1) % 16;
+		len--;
+	}
+	if (!len) return;
+
+	hi = aesni_get_be64(ctx->iv);
+	lo = aesni_get_be64(ctx->iv + 8);
+	while (len >= 16*AESNI_BATCH) {
+		for (j=0; j<AESNI_BATCH; j++) {
+			b[j] = aesni_ctr_block(hi, lo, bswap);
+			AESNI_CTR_INC(hi, lo)
+		}
+		aesni_encrypt_blocks(k, b);
+		for (j=0; j<AESNI_BATCH; j++) {
+			__m128i *dst = (__m128i *) (buf + 16*j);
+			_mm_storeu_si128(dst, _mm_xor_si128(b[j], _mm_loadu_si128(dst)));
+		}
+		buf += 16*AESNI_BATCH;
+		len -= 16*AESNI_BATCH;
+	}
+	while (len >= 16) {
+		__m128i ks = aesni_encrypt_block(k, aesni_ctr_block(hi, lo, bswap));
+		AESNI_CTR_INC(hi, lo)
+		_mm_storeu_si128((__m128i *) buf, _mm_xor_si128(ks, _mm_loadu_si128((const __m128i *) buf)));
+		buf += 16;
+		len -= 16;
+	}
+	if (len) {
+		_mm_storeu_si128((__m128i *) ctx->block, aesni_encrypt_block(k, aesni_ctr_block(hi, lo, bswap)));
+		AESNI_CTR_INC(hi, lo)
+		for (j=0; j<len; j++)
+			buf[j] ^= ctx->block[j];
+		ctx->counter_pos = len;
+	}
+	aesni_set_be64(ctx->iv, hi);
+	aesni_set_be64(ctx->iv + 8, lo);
+}
+
+/** GF_Crypt interface **/
+
+static GF_Err gf_crypt_init_aesni(GF_Crypt* td, void *key, const void *iv)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	if (!ctx) {
+		GF_SAFEALLOC(ctx, AESNI_Ctx);
+		if (ctx == NULL) return GF_OUT_OF_MEM;
+		td->context = ctx;
+	}
+	ctx->counter_pos = 0;
+	if (iv != NULL) {
+		memcpy(ctx->iv, iv, 16);
+	}
+	return GF_OK;
+}
+
+static void gf_crypt_deinit_aesni(GF_Crypt* td)
+{
+}
+
+static void gf_set_key_aesni(GF_Crypt* td, void *key)
+{
+	aesni_set_key((AESNI_Ctx *)td->context, (const u8 *) key);
+}
+
+static GF_Err gf_crypt_set_IV_aesni_cbc(GF_Crypt* td, const u8 *iv, u32 iv_size)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	if (iv_size>16) return GF_BAD_PARAM;
+	memcpy(ctx->iv, iv, iv_size);
+	return GF_OK;
+}
+
+static GF_Err gf_crypt_get_IV_aesni_cbc(GF_Crypt* td, u8 *iv, u32 *iv_size)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	*iv_size = 16;
+	memcpy(iv, ctx->iv, 16);
+	return GF_OK;
+}
+
+AESNI_TARGET
+static GF_Err gf_crypt_encrypt_aesni_cbc(GF_Crypt* td, u8 *plaintext, u32 len)
+{
+	__m128i k[AESNI_ROUNDS+1];
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	aesni_load_keys(k, ctx->enc_keys);
+	aesni_cbc_encrypt(ctx, k, plaintext, len);
+	return GF_OK;
+}
+
+AESNI_TARGET
+static GF_Err gf_crypt_decrypt_aesni_cbc(GF_Crypt* td, u8 *ciphertext, u32 len)
+{
+	__m128i k[AESNI_ROUNDS+1];
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	aesni_load_keys(k, ctx->dec_keys);
+	aesni_cbc_decrypt(ctx, k, ciphertext, len);
+	return GF_OK;
+}
+
+AESNI_TARGET
+static GF_Err gf_crypt_encrypt_pattern_aesni_cbc(GF_Crypt* td, u8 *buffer, u32 len, u32 crypt_block, u32 skip_block)
+{
+	__m128i k[AESNI_ROUNDS+1];
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	u32 crypt_size = 16*crypt_block;
+	u32 pattern_size = 16*(crypt_block+skip_block);
+	aesni_load_keys(k, ctx->enc_keys);
+	while (len) {
+		aesni_cbc_encrypt(ctx, k, buffer, (len >= crypt_size) ? crypt_size : len);
+		if (len < pattern_size) break;
+		buffer += pattern_size;
+		len -= pattern_size;
+	}
+	return GF_OK;
+}
+
+AESNI_TARGET
+static GF_Err gf_crypt_decrypt_pattern_aesni_cbc(GF_Crypt* td, u8 *buffer, u32 len, u32 crypt_block, u32 skip_block)
+{
+	__m128i k[AESNI_ROUNDS+1];
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	u32 crypt_size = 16*crypt_block;
+	u32 pattern_size = 16*(crypt_block+skip_block);
+	aesni_load_keys(k, ctx->dec_keys);
+	while (len) {
+		aesni_cbc_decrypt(ctx, k, buffer, (len >= crypt_size) ? crypt_size : len);
+		if (len < pattern_size) break;
+		buffer += pattern_size;
+		len -= pattern_size;
+	}
+	return GF_OK;
+}
+
+static GF_Err gf_crypt_set_IV_aesni_ctr(GF_Crypt* td, const u8 *iv, u32 iv_size)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	if (iv_size>16) {
+		if (iv_size>17) return GF_BAD_PARAM;
+		ctx->counter_pos = iv[0] % 16;
+		memcpy(ctx->iv, iv+1, 16);
+		//resuming within a block: regenerate the key stream of the previous counter value
+		if (ctx->counter_pos) {
+			u64 hi = aesni_get_be64(ctx->iv);
+			u64 lo = aesni_get_be64(ctx->iv + 8);
+			if (!lo) hi--;
+			lo--;
+			aesni_set_be64(ctx->block, hi);
+			aesni_set_be64(ctx->block + 8, lo);
+			aesni_ecb_encrypt(ctx->enc_keys, ctx->block);
+		}
+	} else {
+		ctx->counter_pos = 0;
+		memcpy(ctx->iv, iv, iv_size);
+	}
+	return GF_OK;
+}
+
+static GF_Err gf_crypt_get_IV_aesni_ctr(GF_Crypt* td, u8 *iv, u32 *iv_size)
+{
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	*iv_size = 17;
+	iv[0] = ctx->counter_pos;
+	memcpy(iv+1, ctx->iv, 16);
+	return GF_OK;
+}
+
+AESNI_TARGET
+static GF_Err gf_crypt_xcrypt_aesni_ctr(GF_Crypt* td, u8 *buffer, u32 len)
+{
+	__m128i k[AESNI_ROUNDS+1];
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	aesni_load_keys(k, ctx->enc_keys);
+	aesni_ctr_xcrypt(ctx, k, buffer, len);
+	return GF_OK;
+}
+
+AESNI_TARGET
+static GF_Err gf_crypt_xcrypt_pattern_aesni_ctr(GF_Crypt* td, u8 *buffer, u32 len, u32 crypt_block, u32 skip_block)
+{
+	__m128i k[AESNI_ROUNDS+1];
+	AESNI_Ctx *ctx = (AESNI_Ctx *)td->context;
+	u32 crypt_size = 16*crypt_block;
+	u32 pattern_size = 16*(crypt_block+skip_block);
+	aesni_load_keys(k, ctx->enc_keys);
+	while (len) {
+		aesni_ctr_xcrypt(ctx, k, buffer, (len >= crypt_size) ? crypt_size : len);
+		if (len < pattern_size) break;
+		buffer += pattern_size;
+		len -= pattern_size;
+	}
+	return GF_OK;
+}
+
+GF_Err gf_crypt_open_open_aesni(GF_Crypt* td, GF_CRYPTO_MODE mode)
+{
+	if (! (gf_sys_get_cpu_features() & GF_CPU_AES) || ! (gf_sys_get_cpu_features() & GF_CPU_SSSE3))
+		return GF_NOT_SUPPORTED;
+
+	td->mode = mode;
+	td->_init_crypt = gf_crypt_init_aesni;
+	td->_deinit_crypt = gf_crypt_deinit_aesni;
+	td->_set_key = gf_set_key_aesni;
+	switch (td->mode) {
+	case GF_CBC:
+		td->_crypt = gf_crypt_encrypt_aesni_cbc;
+		td->_decrypt = gf_crypt_decrypt_aesni_cbc;
+		td->_crypt_pattern = gf_crypt_encrypt_pattern_aesni_cbc;
+		td->_decrypt_pattern = gf_crypt_decrypt_pattern_aesni_cbc;
+		td->_get_state = gf_crypt_get_IV_aesni_cbc;
+		td->_set_state = gf_crypt_set_IV_aesni_cbc;
+		break;
+	case GF_CTR:
+		td->_crypt = gf_crypt_xcrypt_aesni_ctr;
+		td->_decrypt = gf_crypt_xcrypt_aesni_ctr;
+		td->_crypt_pattern = gf_crypt_xcrypt_pattern_aesni_ctr;
+		td->_decrypt_pattern = gf_crypt_xcrypt_pattern_aesni_ctr;
+		td->_get_state = gf_crypt_get_IV_aesni_ctr;
+		td->_set_state = gf_crypt_set_IV_aesni_ctr;
+		break;
+	default:
+		return GF_BAD_PARAM;
+	}
+	td->algo = GF_AES_128;
+	return GF_OK;
+}
+
+#else
+
+GF_Err gf_crypt_open_open_aesni(GF_Crypt* td, GF_CRYPTO_MODE mode)
+{
+	return GF_NOT_SUPPORTED;
+}
+
+#endif //GPAC_HAS_AESNI
@@ -66,6 +66,7 @@
 */
 
 #include "rast_soft.h"
+#include <gpac/thread.h>
 
 
 void gray_record_cell( TRaster *raster )
@@ -621,10 +622,213 @@ void gray_sweep_line( TRaster *raster, AAScanline *sl, int y, Bool zero_non_zero
 }
 
 
+static void gray_sweep_rows(TRaster *raster, u32 start, u32 end, Bool zero_non_zero_rule)
+{
+	u32 i;
+	for (i=start; i<end; i++) {
+		AAScanline *sl = &raster->scanlines[i];
+		if (sl->num) {
+			if (sl->num>1) gray_quick_sort(sl->cells, sl->num);
+			gray_sweep_line(raster, sl, i, zero_non_zero_rule);
+			sl->num = 0;
+		}
+	}
+}
+
+/*
+	banded rendering: once the outline is decomposed, each scanline is independent from the others and
+	the sort/sweep/fill pass is split in horizontal bands. Each extra band uses its own span buffer and a shallow
+	copy of the surface with its own stencil and uv alpha buffers, and is run on a dedicated thread
+*/
+
+/*minimum number of scanlines in a band*/
+#define EVG_MIN_BAND_ROWS	32
+
+typedef struct _evg_raster_band
+{
+	TRaster raster;
+	GF_EVGSurface surf;
+	void *pix_run;
+	u32 pix_run_size;
+	u8 *uv_alpha;
+	u32 uv_alpha_alloc;
+
+	u32 start, end;
+	Bool zero_non_zero_rule;
+	Bool done;
+
+	GF_Thread *th;
+	GF_Semaphore *run;
+	GF_Semaphore *band_done;
+} EVG_RasterBand;
+
+static u32 evg_raster_band_run(void *par)
+{
+	EVG_RasterBand *band = (EVG_RasterBand *)par;
+	while (1) {
+		gf_sema_wait(band->run);
+		if (band->done) break;
+		gray_sweep_rows(&band->raster, band->start, band->end, band->zero_non_zero_rule);
+		gf_sema_notify(band->band_done, 1);
+	}
+	return 0;
+}
+
+static void evg_raster_del_bands(TRaster *raster)
+{
+	u32 i;
+	for (i=0; i<raster->nb_bands; i++) {
+		EVG_RasterBand *band = &raster->bands[i];
+		if (band->th) {
+			band->done = GF_TRUE;
+			gf_sema_notify(band->run, 1);
+			gf_th_del(band->th);
+		}
+		if (band->run) gf_sema_del(band->run);
+		if (band->raster.gray_spans) gf_free(band->raster.gray_spans);
+		if (band->pix_run) gf_free(band->pix_run);
+		if (band->uv_alpha) gf_free(band->uv_alpha);
+	}
+	if (raster->bands) gf_free(raster->bands);
+	raster->bands = NULL;
+	raster->nb_bands = 0;
+	if (raster->bands_done) gf_sema_del(raster->bands_done);
+	raster->bands_done = NULL;
+}
+
+void evg_raster_set_threads(EVG_Raster raster, u32 nb_threads)
+{
+	u32 i;
+	if (!raster || (raster->nb_bands==nb_threads)) return;
+	evg_raster_del_bands(raster);
+	if (!nb_threads) return;
+
+	raster->bands = gf_malloc(sizeof(EVG_RasterBand) * nb_threads);
+	if (!raster->bands) return;
+	memset(raster->bands, 0, sizeof(EVG_RasterBand) * nb_threads);
+	raster->bands_done = gf_sema_new(nb_threads, 0);
+	raster->nb_bands = nb_threads;
+
+	for (i=0; i<nb_threads; i++) {
+		EVG_RasterBand *band = &raster->bands[i];
+		band->raster.max_gray_spans = band->raster.alloc_gray_spans = FT_MAX_GRAY_SPANS;
+		band->raster.gray_spans = gf_malloc(sizeof(EVG_Span) * FT_MAX_GRAY_SPANS);
+		band->run = gf_sema_new(1, 0);
+		band->band_done = raster->bands_done;
+		band->th = gf_th_new("EVGBand");
+		if (!band->raster.gray_spans || !band->run || !raster->bands_done || !band->th
+			|| (gf_th_run(band->th, evg_raster_band_run, band) != GF_OK)
+		) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_MEDIA, ("[EVG] Failed to setup raster band thread, using single-threaded rendering\n"));
+			if (band->th) gf_th_del(band->th);
+			band->th = NULL;
+			raster->nb_bands = i+1;
+			evg_raster_del_bands(raster);
+			return;
+		}
+	}
+}
+
+static Bool evg_raster_band_setup(EVG_RasterBand *band, GF_EVGSurface *surf, u32 start, u32 end, Bool zero_non_zero_rule)
+{
+	TRaster *raster = surf->raster;
+	u32 pix_run_size = sizeof(u32) * (surf->width+2);
+	if (surf->not_8bits) pix_run_size *= 2;
+
+	if (band->pix_run_size < pix_run_size) {
+		band->pix_run = gf_realloc(band->pix_run, pix_run_size);
+		if (!band->pix_run) {
+			band->pix_run_size = 0;
+			return GF_FALSE;
+		}
+		band->pix_run_size = pix_run_size;
+	}
+	if (surf->uv_alpha_alloc) {
+		if (band->uv_alpha_alloc < surf->uv_alpha_alloc) {
+			band->uv_alpha = gf_realloc(band->uv_alpha, surf->uv_alpha_alloc);
+			if (!band->uv_alpha) {
+				band->uv_alpha_alloc = 0;
+				return GF_FALSE;
+			}
+			band->uv_alpha_alloc = surf->uv_alpha_alloc;
+		}
+		memset(band->uv_alpha, 0, band->uv_alpha_alloc);
+	}
+	band->surf = *surf;
+	band->surf.stencil_pix_run = band->pix_run;
+	band->surf.uv_alpha = band->uv_alpha;
+	band->surf.uv_alpha_alloc = band->uv_alpha_alloc;
+
+	band->raster.scanlines = raster->scanlines;
+	band->raster.min_ex = raster->min_ex;
+	band->raster.max_ex = raster->max_ex;
+	band->raster.min_ey = raster->min_ey;
+	band->raster.max_ey = raster->max_ey;
+	band->raster.max_gray_spans = raster->max_gray_spans;
+	band->raster.num_gray_spans = 0;
+	band->raster.render_span = raster->render_span;
+	band->raster.render_span_data = &band->surf;
+	band->raster.mx = raster->mx;
+
+	band->start = start;
+	band->end = end;
+	band->zero_non_zero_rule = zero_non_zero_rule;
+	return GF_TRUE;
+}
+
+static u32 evg_raster_band_bound(GF_EVGSurface *surf, u32 first, u32 nb_rows, u32 idx, u32 nb_bands)
+{
+	u32 row;
+	if (idx>=nb_bands) return first + nb_rows;
+	row = first + idx * nb_rows / nb_bands;
+	/*YUV 420/422 fills process pairs of lines, bands must start on an even line*/
+	if ((surf->yuv_type==EVG_YUV) && ((row + surf->raster->min_ey) & 1)) row++;
+	return row;
+}
+
+static Bool evg_raster_render_bands(GF_EVGSurface *surf, u32 size_y, Bool zero_non_zero_rule)
+{
+	u32 i, nb_bands, nb_rows, first, last, start, nb_run=0;
+	TRaster *raster = surf->raster;
+	GF_EVGStencil *sten = surf->sten;
+
+	/*user callbacks are not assumed to be thread-safe*/
+	if (surf->get_alpha) return GF_FALSE;
+	if (sten && (sten->type==GF_STENCIL_TEXTURE) && ((EVG_Texture *)sten)->tx_callback) return GF_FALSE;
+
+	first = raster->first_scanline;
+	last = size_y;
+	while ((last > first) && !raster->scanlines[last-1].num)
+		last--;
+	nb_rows = last - first;
+	nb_bands = 1 + raster->nb_bands;
+	if (nb_bands > nb_rows / EVG_MIN_BAND_ROWS) nb_bands = nb_rows / EVG_MIN_BAND_ROWS;
+	if (nb_bands < 2) return GF_FALSE;
+
+	/*first band is rendered by the calling thread*/
+	start = evg_raster_band_bound(surf, first, nb_rows, 1, nb_bands);
+	for (i=1; i<nb_bands; i++) {
+		EVG_RasterBand *band = &raster->bands[i-1];
+		u32 end = evg_raster_band_bound(surf, first, nb_rows, i+1, nb_bands);
+		if (!evg_raster_band_setup(band, surf, start, end, zero_non_zero_rule)) break;
+		gf_sema_notify(band->run, 1);
+		nb_run++;
+		start = end;
+	}
+	gray_sweep_rows(raster, first, evg_raster_band_bound(surf, first, nb_rows, 1, nb_bands), zero_non_zero_rule);
+	//band setup failure, finish remaining lines on this thread
+	if (start<last)
+		gray_sweep_rows(raster, start, last, zero_non_zero_rule);
+
+	for (i=0; i<nb_run; i++)
+		gf_sema_wait(raster->bands_done);
+	return GF_TRUE;
+}
+
 int evg_raster_render(GF_EVGSurface *surf)
 {
 	Bool zero_non_zero_rule;
-	u32 i, size_y;
+	u32 size_y;
 	EVG_Raster raster = surf->raster;
 	EVG_Outline*  outline = (EVG_Outline*)&surf->ftoutline;
 
@@ -661,16 +865,13 @@ int evg_raster_render(GF_EVGSurface *surf)
 	/*store odd/even rule*/
 	zero_non_zero_rule = (outline->flags & GF_PATH_FILL_ZERO_NONZERO) ? GF_TRUE : GF_FALSE;
 
-	/* sort each scanline and render it*/
-	for (i=raster->first_scanline; i<size_y; i++) {
-		AAScanline *sl = &raster->scanlines[i];
-		if (sl->num) {
-			if (sl->num>1) gray_quick_sort(sl->cells, sl->num);
-			gray_sweep_line(raster, sl, i, zero_non_zero_rule);
-			sl->num = 0;
-		}
+	if (raster->nb_bands && (raster->first_scanline<size_y)) {
+		if (evg_raster_render_bands(surf, size_y, zero_non_zero_rule))
+			return 0;
 	}
 
+	/* sort each scanline and render it*/
+	gray_sweep_rows(raster, raster->first_scanline, size_y, zero_non_zero_rule);
 	return 0;
 }
 
@@ -700,6 +901,7 @@ void evg_raster_del(EVG_Raster raster)
 			gf_free(raster->scanlines[i].pixels);
 	}
 	gf_free(raster->gray_spans);
+	evg_raster_del_bands(raster);
 
 	gf_free(raster->scanlines);
 	gf_free(raster);
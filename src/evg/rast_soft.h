@@ -75,6 +75,7 @@ typedef void (*EVG_SpanFunc)(int y, int count, EVG_Span *spans, void *user);
 EVG_Raster evg_raster_new();
 void evg_raster_del(EVG_Raster raster);
 int evg_raster_render(GF_EVGSurface *surf);
+void evg_raster_set_threads(EVG_Raster raster, u32 nb_threads);
 
 GF_Err evg_raster_render_path_3d(GF_EVGSurface *surf);
 GF_Err evg_raster_render3d(GF_EVGSurface *surf, u32 *indices, u32 nb_idx, Float *vertices, u32 nb_vertices, u32 nb_comp, GF_EVGPrimitiveType prim_type);
@@ -512,6 +513,11 @@ typedef struct  TRaster_
 	u32 first_scanline;
 
 	GF_Matrix2D *mx;
+
+	/*banded rendering: extra bands, each running on its own thread*/
+	struct _evg_raster_band *bands;
+	u32 nb_bands;
+	struct __tag_semaphore *bands_done;
 } TRaster;
 
 void gray_record_cell( TRaster *raster );
@@ -77,6 +77,14 @@ void gf_evg_surface_set_center_coords(GF_EVGSurface *surf, Bool center_coords)
 	if (surf) surf->center_coords = center_coords;
 }
 
+GF_EXPORT
+GF_Err gf_evg_surface_set_raster_threads(GF_EVGSurface *surf, u32 nb_threads)
+{
+	if (!surf || !surf->raster) return GF_BAD_PARAM;
+	evg_raster_set_threads(surf->raster, nb_threads);
+	return GF_OK;
+}
+
 GF_EXPORT
 void gf_evg_surface_delete(GF_EVGSurface *surf)
 {
@@ -68,105 +68,306 @@ GF_Err gf_filter_pck_merge_properties(GF_FilterPacket *pck_src, GF_FilterPacket
 	return gf_filter_pck_merge_properties_filter(pck_src, pck_dst, NULL, NULL);
 }
 
-typedef struct
+//size in bytes of the blocks of a slab class
+#define PCK_SLAB_BLOCK_SIZE(_cls)	(1<<((_cls) + GF_PCK_SLAB_MIN_SHIFT))
+//number of blocks kept in a thread magazine: up to 1 MByte per class, at least one block
+#define PCK_SLAB_MAG_CAP(_cls)	MAX(1, MIN(GF_PCK_SLAB_MAG_SIZE, (1<<20) >> ((_cls) + GF_PCK_SLAB_MIN_SHIFT)))
+
+//get size class for a given size, -1 if above largest class
+static s32 pck_slab_class(u32 size)
 {
-	u32 data_size;
-	GF_FilterPacket *pck;
-	GF_FilterPacket *closest;
-} GF_PckQueueEnum;
+	u32 nb_bits;
+	if (size <= (1<<GF_PCK_SLAB_MIN_SHIFT)) return 0;
+	nb_bits = gf_get_bit_size(size-1);
+	if (nb_bits > GF_PCK_SLAB_MAX_SHIFT) return -1;
+	return nb_bits - GF_PCK_SLAB_MIN_SHIFT;
+}
 
-static Bool pck_queue_enum(void *udta, void *item)
+//locate session thread of the caller, NULL if not a session thread (user thread or session not running)
+//the hint filter, if currently processed by the caller, gives the thread index without browsing the thread list
+static GF_SessionThread *pck_slab_get_thread(GF_FilterSession *fsess, GF_Filter *hint)
 {
-	GF_PckQueueEnum *enum_state = (GF_PckQueueEnum *) udta;
-	GF_FilterPacket *cur = (GF_FilterPacket *) item;
+	u32 i, count, th_id = gf_th_id();
+	GF_SessionThread *st;
+	if (hint && (hint->process_th_id == th_id)) {
+		st = hint->last_th_idx ? gf_list_get(fsess->threads, hint->last_th_idx-1) : &fsess->main_th;
+		if (st && (st->th_id == th_id)) return st;
+	}
+	if (fsess->main_th.th_id == th_id) return &fsess->main_th;
+	count = gf_list_count(fsess->threads);
+	for (i=0; i<count; i++) {
+		st = gf_list_get(fsess->threads, i);
+		if (st->th_id == th_id) return st;
+	}
+	return NULL;
+}
 
-	if (cur->alloc_size >= enum_state->data_size) {
-		if (!enum_state->pck || (enum_state->pck->alloc_size > cur->alloc_size)) {
-			enum_state->pck = cur;
+//push block to depot, freeing it if depot is full - slab mutex shall be grabbed
+static void pck_slab_depot_put(GF_FilterSession *fsess, s32 cls, u8 *data)
+{
+	GF_PckSlabDepot *depot = &fsess->pck_depot[cls];
+	u32 bsize = PCK_SLAB_BLOCK_SIZE(cls);
+
+	if (fsess->pck_depot_bytes + bsize > fsess->pck_depot_max) {
+		gf_free(data);
+		depot->nb_evict++;
+		return;
+	}
+	if (depot->nb_blocks == depot->nb_alloc) {
+		u8 **blocks = gf_realloc(depot->blocks, sizeof(u8 *) * (depot->nb_alloc ? 2*depot->nb_alloc : 16));
+		if (!blocks) {
+			gf_free(data);
+			depot->nb_evict++;
+			return;
 		}
+		depot->blocks = blocks;
+		depot->nb_alloc = depot->nb_alloc ? 2*depot->nb_alloc : 16;
+#ifdef GPAC_MEMORY_TRACKING
+		fsess->nb_realloc_pck++;
+#endif
 	}
-	else if (!enum_state->closest) enum_state->closest = cur;
-	//small data blocks, find smaller one
-	else if (enum_state->data_size<1000) {
-		if (enum_state->closest->alloc_size > cur->alloc_size) enum_state->closest = cur;
+	depot->blocks[depot->nb_blocks++] = data;
+	fsess->pck_depot_bytes += bsize;
+}
+
+u8 *gf_fs_pck_data_alloc(GF_FilterSession *fsess, GF_Filter *hint, u32 size, u32 *alloc_size)
+{
+	u8 *data = NULL;
+	u64 used;
+	s32 cls;
+	GF_SessionThread *st;
+
+	if (!fsess->pck_slab_mx) {
+		*alloc_size = size;
+#ifdef GPAC_MEMORY_TRACKING
+		fsess->nb_alloc_pck++;
+#endif
+		return gf_malloc(sizeof(char)*size);
 	}
-	//otherwise find largest one below our target size
-	else if (enum_state->closest->alloc_size < cur->alloc_size) enum_state->closest = cur;
-	return GF_FALSE;
+
+	cls = pck_slab_class(size);
+	if (cls<0) {
+		data = gf_malloc(sizeof(char)*size);
+		if (!data) return NULL;
+		safe_int_inc(&fsess->pck_nb_large);
+		*alloc_size = size;
+	} else {
+		*alloc_size = PCK_SLAB_BLOCK_SIZE(cls);
+
+		st = pck_slab_get_thread(fsess, hint);
+		if (st) {
+			GF_PckSlabMagazine *mag = &st->pck_mags[cls];
+			//empty magazine, refill half of it from depot
+			if (!mag->nb_blocks && fsess->pck_depot[cls].nb_blocks) {
+				GF_PckSlabDepot *depot = &fsess->pck_depot[cls];
+				gf_mx_p(fsess->pck_slab_mx);
+				while (depot->nb_blocks && (mag->nb_blocks < (PCK_SLAB_MAG_CAP(cls)+1)/2)) {
+					mag->blocks[mag->nb_blocks++] = depot->blocks[--depot->nb_blocks];
+					fsess->pck_depot_bytes -= *alloc_size;
+					depot->nb_get++;
+				}
+				gf_mx_v(fsess->pck_slab_mx);
+			}
+			if (mag->nb_blocks) {
+				data = mag->blocks[--mag->nb_blocks];
+				mag->nb_hits++;
+			} else {
+				mag->nb_miss++;
+			}
+		} else {
+			GF_PckSlabDepot *depot = &fsess->pck_depot[cls];
+			gf_mx_p(fsess->pck_slab_mx);
+			if (depot->nb_blocks) {
+				data = depot->blocks[--depot->nb_blocks];
+				fsess->pck_depot_bytes -= *alloc_size;
+				depot->nb_get++;
+			} else {
+				depot->nb_miss++;
+			}
+			gf_mx_v(fsess->pck_slab_mx);
+		}
+		if (!data) {
+			data = gf_malloc(sizeof(char) * (*alloc_size));
+			if (!data) return NULL;
+#ifdef GPAC_MEMORY_TRACKING
+			fsess->nb_alloc_pck++;
+#endif
+		}
+	}
+	used = safe_int64_add(&fsess->pck_bytes_used, *alloc_size);
+	//peak is only indicative, no need to protect it
+	if (used > fsess->pck_bytes_peak) fsess->pck_bytes_peak = used;
+	return data;
 }
 
-static GF_FilterPacket *gf_filter_pck_new_alloc_internal(GF_FilterPid *pid, u32 data_size, u8 **data)
+void gf_fs_pck_data_free(GF_FilterSession *fsess, GF_Filter *hint, u8 *data, u32 alloc_size)
 {
-	GF_FilterPacket *pck=NULL;
-	GF_FilterPacket *closest=NULL;
-	u32 count, max_reservoir_size;
+	s32 cls;
+	GF_SessionThread *st;
+	if (!data) return;
 
-	if (PID_IS_INPUT(pid)) {
-		GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Attempt to allocate a packet on an input PID in filter %s\n", pid->filter->name));
-		return NULL;
+	if (!fsess->pck_slab_mx) {
+		gf_free(data);
+		return;
 	}
+	safe_int64_sub(&fsess->pck_bytes_used, alloc_size);
 
-	count = gf_fq_count(pid->filter->pcks_alloc_reservoir);
-	if (count) {
-		GF_PckQueueEnum pck_enum_state;
-		memset(&pck_enum_state, 0, sizeof(GF_PckQueueEnum));
-		pck_enum_state.data_size = data_size;
-		gf_fq_enum(pid->filter->pcks_alloc_reservoir, pck_queue_enum, &pck_enum_state);
-		pck = pck_enum_state.pck;
-		closest = pck_enum_state.closest;
-	}
-
-	//stop allocating after a while - TODO we for sur can design a better algo...
-	max_reservoir_size = pid->num_destinations ? 10 : 1;
-	//if pid is file, force 1 max
-	if (!pck && (pid->stream_type==GF_STREAM_FILE))
-		max_reservoir_size = 1;
-
-	if (!pck && (count>=max_reservoir_size)) {
-		assert(closest);
-		closest->alloc_size = data_size;
-		closest->data = gf_realloc(closest->data, closest->alloc_size);
-		if (!closest->data) {
-			gf_free(closest);
-			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to allocate new packet on PID %s of filter %s\n", pid->name, pid->filter->name));
-			return NULL;
+	cls = pck_slab_class(alloc_size);
+	if (cls<0) {
+		safe_int_dec(&fsess->pck_nb_large);
+		gf_free(data);
+		return;
+	}
+	assert(alloc_size == PCK_SLAB_BLOCK_SIZE(cls));
+
+	st = pck_slab_get_thread(fsess, hint);
+	if (st) {
+		GF_PckSlabMagazine *mag = &st->pck_mags[cls];
+		u32 cap = PCK_SLAB_MAG_CAP(cls);
+		//full magazine, move half of it to depot
+		if (mag->nb_blocks == cap) {
+			GF_PckSlabDepot *depot = &fsess->pck_depot[cls];
+			gf_mx_p(fsess->pck_slab_mx);
+			while (mag->nb_blocks > cap/2) {
+				pck_slab_depot_put(fsess, cls, mag->blocks[--mag->nb_blocks]);
+				depot->nb_put++;
+			}
+			gf_mx_v(fsess->pck_slab_mx);
 		}
-		pck = closest;
+		mag->blocks[mag->nb_blocks++] = data;
+		return;
+	}
+	gf_mx_p(fsess->pck_slab_mx);
+	pck_slab_depot_put(fsess, cls, data);
+	gf_mx_v(fsess->pck_slab_mx);
+}
+
+u8 *gf_fs_pck_data_realloc(GF_FilterSession *fsess, GF_Filter *hint, u8 *data, u32 data_length, u32 old_alloc_size, u32 new_size, u32 *alloc_size)
+{
+	u8 *new_data;
+	if (!fsess->pck_slab_mx) {
+		*alloc_size = new_size;
 #ifdef GPAC_MEMORY_TRACKING
-		pid->filter->session->nb_realloc_pck++;
+		fsess->nb_realloc_pck++;
 #endif
+		return gf_realloc(data, new_size);
 	}
+	if (new_size <= old_alloc_size) {
+		*alloc_size = old_alloc_size;
+		return data;
+	}
+	new_data = gf_fs_pck_data_alloc(fsess, hint, new_size, alloc_size);
+	if (!new_data) return NULL;
+	if (data) {
+		memcpy(new_data, data, MIN(data_length, new_size));
+		gf_fs_pck_data_free(fsess, hint, data, old_alloc_size);
+	}
+	return new_data;
+}
 
+void gf_fs_pck_slab_init(GF_FilterSession *fsess)
+{
+	fsess->pck_slab_mx = gf_mx_new("PacketSlab");
+	fsess->pck_depot_max = gf_opts_get_int("core", "pck-depot");
+}
+
+static void pck_slab_reset_thread(GF_SessionThread *st)
+{
+	u32 i;
+	for (i=0; i<GF_PCK_SLAB_NB_CLASSES; i++) {
+		GF_PckSlabMagazine *mag = &st->pck_mags[i];
+		while (mag->nb_blocks) {
+			gf_free(mag->blocks[--mag->nb_blocks]);
+		}
+	}
+}
+
+void gf_fs_pck_slab_del(GF_FilterSession *fsess)
+{
+	u32 i, count;
+	if (!fsess->pck_slab_mx) return;
+
+	pck_slab_reset_thread(&fsess->main_th);
+	count = gf_list_count(fsess->threads);
+	for (i=0; i<count; i++) {
+		pck_slab_reset_thread(gf_list_get(fsess->threads, i));
+	}
+	for (i=0; i<GF_PCK_SLAB_NB_CLASSES; i++) {
+		GF_PckSlabDepot *depot = &fsess->pck_depot[i];
+		while (depot->nb_blocks) {
+			gf_free(depot->blocks[--depot->nb_blocks]);
+		}
+		if (depot->blocks) gf_free(depot->blocks);
+		depot->blocks = NULL;
+		depot->nb_alloc = 0;
+	}
+	fsess->pck_depot_bytes = 0;
+	gf_mx_del(fsess->pck_slab_mx);
+	fsess->pck_slab_mx = NULL;
+}
+
+void gf_fs_pck_slab_print_stats(GF_FilterSession *fsess)
+{
+	u32 i, j, count;
+	u64 mag_bytes=0, hits=0, misses=0, depot_get=0;
+
+	if (!fsess->pck_slab_mx) return;
+
+	count = gf_list_count(fsess->threads);
+	gf_mx_p(fsess->pck_slab_mx);
+	for (i=0; i<GF_PCK_SLAB_NB_CLASSES; i++) {
+		GF_PckSlabDepot *depot = &fsess->pck_depot[i];
+		u32 nb_cached = 0;
+		u64 cls_hits=0, cls_misses=depot->nb_miss;
+
+		//magazines are read without locking, stats are only indicative
+		for (j=0; j<=count; j++) {
+			GF_SessionThread *st = j ? gf_list_get(fsess->threads, j-1) : &fsess->main_th;
+			nb_cached += st->pck_mags[i].nb_blocks;
+			cls_hits += st->pck_mags[i].nb_hits;
+			cls_misses += st->pck_mags[i].nb_miss;
+		}
+		mag_bytes += (u64) nb_cached * PCK_SLAB_BLOCK_SIZE(i);
+		hits += cls_hits;
+		misses += cls_misses;
+		depot_get += depot->nb_get;
+
+		if (!cls_hits && !cls_misses && !depot->nb_get) continue;
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\tClass %u bytes: %u cached in threads %u in depot - thread hits "LLU" depot gets "LLU" puts "LLU" misses "LLU" evictions "LLU"\n",
+			PCK_SLAB_BLOCK_SIZE(i), nb_cached, depot->nb_blocks, cls_hits, depot->nb_get, depot->nb_put, cls_misses, depot->nb_evict));
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("Packet allocator: "LLU" bytes in use (peak "LLU", %u large blocks in use) - cached "LLU" bytes in threads "LLU" bytes in depot (max "LLU") - thread hits "LLU" depot gets "LLU" misses "LLU"\n",
+		fsess->pck_bytes_used, fsess->pck_bytes_peak, fsess->pck_nb_large, mag_bytes, fsess->pck_depot_bytes, fsess->pck_depot_max, hits, depot_get, misses));
+	gf_mx_v(fsess->pck_slab_mx);
+}
+
+static GF_FilterPacket *gf_filter_pck_new_alloc_internal(GF_FilterPid *pid, u32 data_size, u8 **data)
+{
+	GF_FilterPacket *pck;
+
+	if (PID_IS_INPUT(pid)) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Attempt to allocate a packet on an input PID in filter %s\n", pid->filter->name));
+		return NULL;
+	}
+
+	//packets in reservoir have no payload attached, payloads are recycled at session level by the packet allocator
+	pck = gf_fq_pop(pid->filter->pcks_alloc_reservoir);
 	if (!pck) {
 		GF_SAFEALLOC(pck, GF_FilterPacket);
 		if (!pck) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to allocate new packet on PID %s of filter %s\n", pid->name, pid->filter->name));
 			return NULL;
 		}
-		pck->data = gf_malloc(sizeof(char)*data_size);
-		if (!pck->data) {
-			gf_free(pck);
-			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to allocate new packet on PID %s of filter %s\n", pid->name, pid->filter->name));
-			return NULL;
-		}
-		pck->alloc_size = data_size;
 #ifdef GPAC_MEMORY_TRACKING
-		pid->filter->session->nb_alloc_pck+=2;
+		pid->filter->session->nb_alloc_pck++;
 #endif
-	} else {
-		//pop first item and swap pointers. We can safely do this since this filter
-		//is the only one accessing the queue in pop mode, all others are just pushing to it
-		//this may however imply that we don't get the best matching block size if new packets
-		//were added to the list
-
-		GF_FilterPacket *head_pck = gf_fq_pop(pid->filter->pcks_alloc_reservoir);
-		char *pck_data = pck->data;
-		u32 alloc_size = pck->alloc_size;
-		pck->data = head_pck->data;
-		pck->alloc_size = head_pck->alloc_size;
-		head_pck->data = pck_data;
-		head_pck->alloc_size = alloc_size;
-		pck = head_pck;
+	}
+	assert(!pck->data);
+	pck->data = gf_fs_pck_data_alloc(pid->filter->session, pid->filter, data_size, &pck->alloc_size);
+	if (!pck->data) {
+		gf_free(pck);
+		GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to allocate new packet on PID %s of filter %s\n", pid->name, pid->filter->name));
+		return NULL;
 	}
 
 	pck->pck = pck;
@@ -646,7 +847,7 @@ void gf_filter_packet_destroy(GF_FilterPacket *pck)
 			gf_free(pck);
 		}
 	} else if (is_filter_destroyed) {
-		if (!pck->filter_owns_mem && pck->data) gf_free(pck->data);
+		if (!pck->filter_owns_mem && pck->data) gf_fs_pck_data_free(pck->session, NULL, pck->data, pck->alloc_size);
 		gf_free(pck);
 	} else if (pck->is_dangling) {
 		if (pck->data) gf_free(pck->data);
@@ -659,10 +860,12 @@ void gf_filter_packet_destroy(GF_FilterPacket *pck)
 			gf_free(pck);
 		}
 	} else {
+		gf_fs_pck_data_free(pck->session, pid->filter, pck->data, pck->alloc_size);
+		pck->data = NULL;
+		pck->alloc_size = 0;
 		if (pid->filter && pid->filter->pcks_alloc_reservoir) {
 			gf_fq_add(pid->filter->pcks_alloc_reservoir, pck);
 		} else {
-			if (pck->data) gf_free(pck->data);
 			gf_free(pck);
 		}
 	}
@@ -1783,11 +1986,9 @@ GF_Err gf_filter_pck_expand(GF_FilterPacket *pck, u32 nb_bytes_to_add, u8 **data
 		return GF_BAD_PARAM;
 
 	if (pck->data_length + nb_bytes_to_add > pck->alloc_size) {
-		pck->alloc_size = pck->data_length + nb_bytes_to_add;
-		pck->data = gf_realloc(pck->data, pck->alloc_size);
-#ifdef GPAC_MEMORY_TRACKING
-		pck->pid->filter->session->nb_realloc_pck++;
-#endif
+		u8 *data = gf_fs_pck_data_realloc(pck->session, pck->pid->filter, pck->data, pck->data_length, pck->alloc_size, pck->data_length + nb_bytes_to_add, &pck->alloc_size);
+		if (!data) return GF_OUT_OF_MEM;
+		pck->data = data;
 	}
 	pck->info.byte_offset = GF_FILTER_NO_BO;
 	if (data_start) *data_start = pck->data;
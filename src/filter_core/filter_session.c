@@ -37,6 +37,151 @@ void gf_font_manager_del(struct _gf_ft_mgr *fm);
 #endif
 
 
+//number of tasks posted on the secondary task list, including thread-local task lists in work-stealing mode
+static u32 gf_fs_tasks_count(GF_FilterSession *fsess)
+{
+	u32 i, count, nb_tasks = gf_fq_count(fsess->tasks);
+	if (!fsess->work_stealing) return nb_tasks;
+	count = gf_list_count(fsess->threads);
+	for (i=0; i<count; i++) {
+		GF_SessionThread *st = gf_list_get(fsess->threads, i);
+		nb_tasks += gf_fq_count(st->local_tasks);
+	}
+	return nb_tasks;
+}
+
+//post a task on the secondary task list. In work-stealing mode, the task is posted on the local task list of the thread
+//which last processed the filter, in order to keep filters on the same thread as much as possible
+static void gf_fs_push_task(GF_FilterSession *fsess, GF_FSTask *task)
+{
+	if (fsess->work_stealing && task->filter && task->filter->last_th_idx) {
+		GF_SessionThread *st = gf_list_get(fsess->threads, task->filter->last_th_idx-1);
+		if (st && st->local_tasks) {
+			gf_fq_add(st->local_tasks, task);
+			return;
+		}
+	}
+	gf_fq_add(fsess->tasks, task);
+}
+
+//pop a task from the secondary task list. In work-stealing mode, the local task list of the thread is checked first, then the
+//global task list, then the local task lists of the other threads
+static GF_FSTask *gf_fs_pop_task(GF_FilterSession *fsess, GF_SessionThread *sess_thread)
+{
+	u32 i, count;
+	GF_FSTask *task;
+	if (!fsess->work_stealing)
+		return gf_fq_pop(fsess->tasks);
+
+	if (sess_thread->local_tasks) {
+		task = gf_fq_pop(sess_thread->local_tasks);
+		if (task) return task;
+	}
+	task = gf_fq_pop(fsess->tasks);
+	if (task) return task;
+
+	count = gf_list_count(fsess->threads);
+	for (i=0; i<count; i++) {
+		//start with our next peer so that idle threads do not all steal from the same thread
+		GF_SessionThread *st = gf_list_get(fsess->threads, (sess_thread->th_idx + i) % count);
+		if (st == sess_thread) continue;
+		task = gf_fq_pop(st->local_tasks);
+		if (task) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_SCHEDULER, ("Thread %u stole task %s from thread %u\n", gf_th_id(), task->log_name, st->th_idx));
+			sess_thread->nb_tasks_stolen++;
+			return task;
+		}
+	}
+	return NULL;
+}
+
+//highest CPU index accepted in CPU lists, matches default CPU_SETSIZE on linux
+#define GF_FS_MAX_CPU_INDEX	1024
+
+//parse a CPU list in the form "0-3,8,10-11" as used by linux sysfs
+static void gf_fs_parse_cpu_list(GF_FilterSession *fsess, const char *cpu_list)
+{
+	const char *list = cpu_list;
+	u32 nb_alloc = 0;
+	while (cpu_list && cpu_list[0]) {
+		u32 i, start, end;
+		if (sscanf(cpu_list, "%u-%u", &start, &end) != 2) {
+			if (sscanf(cpu_list, "%u", &start) != 1) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Invalid CPU list %s, ignoring thread affinity\n", list));
+				goto exit;
+			}
+			end = start;
+		}
+		if ((start > end) || (end >= GF_FS_MAX_CPU_INDEX)) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Invalid CPU range %u-%u in CPU list %s (max CPU index %u), ignoring thread affinity\n", start, end, list, GF_FS_MAX_CPU_INDEX-1));
+			goto exit;
+		}
+		for (i=start; i<=end; i++) {
+			if (fsess->nb_th_cpus == nb_alloc) {
+				u32 *cpus;
+				nb_alloc = nb_alloc ? 2*nb_alloc : 16;
+				cpus = gf_realloc(fsess->th_cpus, sizeof(u32) * nb_alloc);
+				if (!cpus) {
+					GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Failed to allocate CPU list, ignoring thread affinity\n"));
+					goto exit;
+				}
+				fsess->th_cpus = cpus;
+			}
+			fsess->th_cpus[fsess->nb_th_cpus] = i;
+			fsess->nb_th_cpus++;
+		}
+		cpu_list = strchr(cpu_list, ',');
+		if (cpu_list) cpu_list++;
+	}
+	return;
+
+exit:
+	if (fsess->th_cpus) gf_free(fsess->th_cpus);
+	fsess->th_cpus = NULL;
+	fsess->nb_th_cpus = 0;
+}
+
+static void gf_fs_setup_affinity(GF_FilterSession *fsess)
+{
+	const char *opt = gf_opts_get_key("core", "th-cpus");
+	if (opt) {
+		gf_fs_parse_cpu_list(fsess, opt);
+		return;
+	}
+	opt = gf_opts_get_key("core", "numa-node");
+	if (opt) {
+#ifdef GPAC_CONFIG_LINUX
+		char szPath[GF_MAX_PATH], szCPUs[1024];
+		FILE *f;
+		sprintf(szPath, "/sys/devices/system/node/node%d/cpulist", atoi(opt));
+		f = gf_fopen(szPath, "r");
+		if (!f) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("NUMA node %s not found, ignoring node binding\n", opt));
+			return;
+		}
+		szCPUs[0] = 0;
+		if (gf_fgets(szCPUs, 1023, f))
+			gf_fs_parse_cpu_list(fsess, szCPUs);
+		gf_fclose(f);
+		fsess->th_cpus_shared = GF_TRUE;
+#else
+		GF_LOG(GF_LOG_WARNING, GF_LOG_FILTER, ("NUMA node binding not supported on this platform\n"));
+#endif
+	}
+}
+
+static void gf_fs_thread_set_affinity(GF_FilterSession *fsess, GF_SessionThread *sess_thread)
+{
+	sess_thread->affinity_done = GF_TRUE;
+	//only pin threads created by the session, the main thread belongs to the application calling gf_fs_run
+	if (!fsess->nb_th_cpus || !sess_thread->th_idx) return;
+	if (fsess->th_cpus_shared) {
+		gf_th_set_affinity(NULL, fsess->th_cpus, fsess->nb_th_cpus);
+	} else {
+		gf_th_set_affinity(NULL, &fsess->th_cpus[(sess_thread->th_idx-1) % fsess->nb_th_cpus], 1);
+	}
+}
+
 static GFINLINE void gf_fs_sema_io(GF_FilterSession *fsess, Bool notify, Bool main)
 {
 	GF_Semaphore *sem = main ? fsess->semaphore_main : fsess->semaphore_other;
@@ -58,7 +203,7 @@ static GFINLINE void gf_fs_sema_io(GF_FilterSession *fsess, Bool notify, Bool ma
 			nb_tasks = 1;
 			//no active threads, count number of tasks. If no posted tasks we are likely at the end of the session, don't block, rather use a sem_wait 
 			if (!fsess->active_threads)
-			 	nb_tasks = gf_fq_count(fsess->main_thread_tasks) + gf_fq_count(fsess->tasks);
+			 	nb_tasks = gf_fq_count(fsess->main_thread_tasks) + gf_fs_tasks_count(fsess);
 
 			//if main semaphore, keep track that we are going to sleep
 			if (main) {
@@ -185,6 +330,9 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u
 		fsess->direct_mode = GF_TRUE;
 		nb_threads=0;
 	}
+	if ((sched_type==GF_FS_SCHEDULER_WORK_STEAL) && nb_threads) {
+		fsess->work_stealing = GF_TRUE;
+	}
 	if (nb_threads && (sched_type != GF_FS_SCHEDULER_LOCK_FREE_X)) {
 		fsess->tasks_mx = gf_mx_new("TasksList");
 	}
@@ -202,6 +350,7 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u
 
 	if (!(flags & GF_FS_FLAG_NO_RESERVOIR)) {
 		fsess->tasks_reservoir = gf_fq_new(fsess->tasks_mx);
+		gf_fs_pck_slab_init(fsess);
 	}
 
 	if (nb_threads || (sched_type==GF_FS_SCHEDULER_LOCK_FORCE) ) {
@@ -270,6 +419,8 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u
 		fsess->ui_mx = gf_mx_new("FilterSessionUIProc");
 	}
 
+	gf_fs_setup_affinity(fsess);
+
 	for (i=0; i<(u32) nb_threads; i++) {
 		GF_SessionThread *sess_thread;
 		GF_SAFEALLOC(sess_thread, GF_SessionThread);
@@ -283,7 +434,13 @@ GF_FilterSession *gf_fs_new(s32 nb_threads, GF_FilterSchedulerType sched_type, u
 			continue;
 		}
 		sess_thread->fsess = fsess;
+		if (fsess->work_stealing) {
+			if (fsess->tasks_mx)
+				sess_thread->local_tasks_mx = gf_mx_new("ThreadTasksList");
+			sess_thread->local_tasks = gf_fq_new(sess_thread->local_tasks_mx);
+		}
 		gf_list_add(fsess->threads, sess_thread);
+		sess_thread->th_idx = gf_list_count(fsess->threads);
 	}
 
 	gf_fs_set_separators(fsess, NULL);
@@ -437,6 +594,7 @@ GF_FilterSession *gf_fs_new_defaults(u32 inflags)
 	else if (!strcmp(opt, "direct")) sched_type = GF_FS_SCHEDULER_DIRECT;
 	else if (!strcmp(opt, "free")) sched_type = GF_FS_SCHEDULER_LOCK_FREE;
 	else if (!strcmp(opt, "freex")) sched_type = GF_FS_SCHEDULER_LOCK_FREE_X;
+	else if (!strcmp(opt, "steal")) sched_type = GF_FS_SCHEDULER_WORK_STEAL;
 	else {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_FILTER, ("Unrecognized scheduler type %s\n", opt));
 		return NULL;
@@ -675,6 +833,12 @@ void gf_fs_del(GF_FilterSession *fsess)
 	if (fsess->tasks_reservoir)
 		gf_fq_del(fsess->tasks_reservoir, gf_void_del);
 
+	if (fsess->th_cpus)
+		gf_free(fsess->th_cpus);
+
+	//all packets are destroyed, release cached payloads
+	gf_fs_pck_slab_del(fsess);
+
 	if (fsess->threads) {
 		if (fsess->main_thread_tasks)
 			gf_fq_del(fsess->main_thread_tasks, gf_void_del);
@@ -682,6 +846,10 @@ void gf_fs_del(GF_FilterSession *fsess)
 		while (gf_list_count(fsess->threads)) {
 			GF_SessionThread *sess_th = gf_list_pop_back(fsess->threads);
 			gf_th_del(sess_th->th);
+			if (sess_th->local_tasks)
+				gf_fq_del(sess_th->local_tasks, gf_void_del);
+			if (sess_th->local_tasks_mx)
+				gf_mx_del(sess_th->local_tasks_mx);
 			gf_free(sess_th);
 		}
 		gf_list_del(fsess->threads);
@@ -905,7 +1073,7 @@ void gf_fs_post_task_ex(GF_FilterSession *fsess, gf_fs_task_callback task_fun, G
 			gf_fs_sema_io(fsess, GF_TRUE, GF_TRUE);
 		} else {
 			assert(task->run_task);
-			gf_fq_add(fsess->tasks, task);
+			gf_fs_push_task(fsess, task);
 			gf_fs_sema_io(fsess, GF_TRUE, GF_FALSE);
 		}
 	}
@@ -1252,6 +1420,8 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 
 	GF_Filter *current_filter = NULL;
 	sess_thread->th_id = gf_th_id();
+	if (!sess_thread->affinity_done)
+		gf_fs_thread_set_affinity(fsess, sess_thread);
 
 #ifndef GPAC_DISABLE_REMOTERY
 	sess_thread->rmt_tasks=40;
@@ -1307,7 +1477,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 					task = gf_fq_pop(fsess->main_thread_tasks);
 				}
 				if (!task) {
-					task = gf_fq_pop(fsess->tasks);
+					task = gf_fs_pop_task(fsess, sess_thread);
 					if (task && task->blocking) {
 						gf_fq_add(fsess->tasks, task);
 						task = NULL;
@@ -1316,7 +1486,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 				}
 				force_secondary_tasks = GF_FALSE;
 			} else {
-				task = gf_fq_pop(fsess->tasks);
+				task = gf_fs_pop_task(fsess, sess_thread);
 			}
 			if (task) {
 				assert( task->run_task );
@@ -1364,7 +1534,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 
 			//no pending tasks and first time main task queue is empty, flush to detect if we
 			//are indeed done
-			if (!fsess->tasks_pending && !fsess->tasks_in_process && !sess_thread->has_seen_eot && !gf_fq_count(fsess->tasks)) {
+			if (!fsess->tasks_pending && !fsess->tasks_in_process && !sess_thread->has_seen_eot && !gf_fs_tasks_count(fsess)) {
 				//maybe last task, force a notify to check if we are truly done
 				sess_thread->has_seen_eot = GF_TRUE;
 				//not main thread and some tasks pending on main, notify only ourselves
@@ -1584,7 +1754,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 								gf_fs_sema_io(fsess, GF_TRUE, GF_TRUE);
 							}
 						} else {
-							gf_fq_add(fsess->tasks, task);
+							gf_fs_push_task(fsess, task);
 							//we are not the main thread and we are reposting to the secondary task list, don't notify/wait for the sema, just retry
 							//we are not sure to get a task from secondary list at next iteration, but the end of thread check will make
 							//sure we renotify secondary sema if some tasks are still pending
@@ -1616,6 +1786,8 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 			assert(!current_filter->in_process);
 			current_filter->in_process = GF_TRUE;
 			current_filter->process_th_id = gf_th_id();
+			//remember thread affinity for work-stealing mode
+			current_filter->last_th_idx = thid;
 		}
 
 		sess_thread->nb_tasks++;
@@ -1766,7 +1938,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 				if (task->filter && (task->filter->freg->flags & GF_FS_REG_MAIN_THREAD)) {
 					gf_fq_add(fsess->main_thread_tasks, task);
 				} else {
-					gf_fq_add(fsess->tasks, task);
+					gf_fs_push_task(fsess, task);
 				}
 				gf_fs_sema_io(fsess, GF_TRUE, use_main_sema);
 			}
@@ -1808,7 +1980,7 @@ static u32 gf_fs_thread_proc(GF_SessionThread *sess_thread)
 			current_filter->in_process = GF_FALSE;
 		}
 		//not requeuing and first time we have an empty task queue, flush to detect if we are indeed done
-		if (!current_filter && !fsess->tasks_pending && !sess_thread->has_seen_eot && !gf_fq_count(fsess->tasks)) {
+		if (!current_filter && !fsess->tasks_pending && !sess_thread->has_seen_eot && !gf_fs_tasks_count(fsess)) {
 			//if not the main thread, or if main thread and task list is empty, enter end of session probing mode
 			if (thid || !gf_fq_count(fsess->main_thread_tasks) ) {
 				//maybe last task, force a notify to check if we are truly done. We only tag "session done" for the non-main
@@ -2013,7 +2185,7 @@ GF_Err gf_fs_stop(GF_FilterSession *fsess)
 		if (gf_fq_count(fsess->main_thread_tasks))
 			continue;
 
-		if (count && (count == fsess->nb_threads_stopped) && gf_fq_count(fsess->tasks) ) {
+		if (count && (count == fsess->nb_threads_stopped) && gf_fs_tasks_count(fsess) ) {
 			continue;
 		}
 		break;
@@ -2154,13 +2326,25 @@ void gf_fs_print_stats(GF_FilterSession *fsess)
 	for (i=0; i<count; i++) {
 		GF_SessionThread *s = gf_list_get(fsess->threads, i);
 
-		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\tThread %u: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"\n", i+2, s->run_time, s->active_time, s->nb_tasks));
+		if (fsess->work_stealing) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\tThread %u: run_time "LLU" us active_time "LLU" us nb_tasks "LLU" (stolen "LLU")\n", i+2, s->run_time, s->active_time, s->nb_tasks, s->nb_tasks_stolen));
+		} else {
+			GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\tThread %u: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"\n", i+2, s->run_time, s->active_time, s->nb_tasks));
+		}
 
 		run_time+=s->run_time;
 		active_time+=s->active_time;
 		nb_tasks+=s->nb_tasks;
 	}
 	GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("\nTotal: run_time "LLU" us active_time "LLU" us nb_tasks "LLU"\n", run_time, active_time, nb_tasks));
+
+	if (fsess->download_manager) {
+		GF_DMCacheStats cstats;
+		gf_dm_get_cache_stats(fsess->download_manager, &cstats);
+		GF_LOG(GF_LOG_INFO, GF_LOG_APP, ("HTTP cache: %d entries (%d in memory) - memory "LLU" bytes (peak "LLU" max "LLU") - hits "LLU" misses "LLU" evictions "LLU" (spilled "LLU")\n",
+			cstats.nb_entries, cstats.nb_mem_entries, cstats.mem_used, cstats.mem_peak, cstats.mem_max, cstats.hits, cstats.misses, cstats.evictions, cstats.spills));
+	}
+	gf_fs_pck_slab_print_stats(fsess);
 }
 
 static void gf_fs_print_filter_outputs(GF_Filter *f, GF_List *filters_done, u32 indent, GF_FilterPid *pid, GF_Filter *alias_for, u32 src_num_tiled_pids, Bool skip_print)
@@ -3325,7 +3509,7 @@ Bool gf_fs_is_last_task(GF_FilterSession *fsess)
 	if (!fsess) return GF_TRUE;
 	if (fsess->tasks_pending>1) return GF_FALSE;
 	if (gf_fq_count(fsess->main_thread_tasks)) return GF_FALSE;
-	if (gf_fq_count(fsess->tasks)) return GF_FALSE;
+	if (gf_fs_tasks_count(fsess)) return GF_FALSE;
 	return GF_TRUE;
 }
 
@@ -299,6 +299,32 @@ void gf_fs_post_task_ex(GF_FilterSession *fsess, gf_fs_task_callback task_fun, G
 void gf_filter_pid_send_event_downstream(GF_FSTask *task);
 
 
+//packet payload slab allocator: power-of-two size classes from 2^GF_PCK_SLAB_MIN_SHIFT to 2^GF_PCK_SLAB_MAX_SHIFT bytes
+//larger payloads are directly allocated
+#define GF_PCK_SLAB_MIN_SHIFT	8
+#define GF_PCK_SLAB_MAX_SHIFT	23
+#define GF_PCK_SLAB_NB_CLASSES	(GF_PCK_SLAB_MAX_SHIFT - GF_PCK_SLAB_MIN_SHIFT + 1)
+//max number of blocks per class in a thread magazine, reduced for large classes
+#define GF_PCK_SLAB_MAG_SIZE	16
+
+//per-thread cache of free blocks for one size class, only accessed by its owning thread
+typedef struct
+{
+	u8 *blocks[GF_PCK_SLAB_MAG_SIZE];
+	u32 nb_blocks;
+	//number of allocations served from the magazine, and number of allocations falling back to system allocator
+	u64 nb_hits, nb_miss;
+} GF_PckSlabMagazine;
+
+//session-wide list of free blocks for one size class, protected by the session slab mutex
+typedef struct
+{
+	u8 **blocks;
+	u32 nb_blocks, nb_alloc;
+	//number of blocks moved from/to thread magazines, allocated by non-session threads, and freed because depot was full
+	u64 nb_get, nb_put, nb_miss, nb_evict;
+} GF_PckSlabDepot;
+
 typedef struct __gf_fs_thread
 {
 	//NULL for main thread
@@ -308,10 +334,23 @@ typedef struct __gf_fs_thread
 	
 	Bool has_seen_eot; //set when no more tasks in global queue
 
+	//local task list in work-stealing mode, NULL otherwise
+	GF_FilterQueue *local_tasks;
+	//mutex protecting the local task list, NULL in lock-free mode
+	GF_Mutex *local_tasks_mx;
+	//1-based index of the thread in session, 0 for main thread
+	u32 th_idx;
+	//set once CPU affinity has been applied for this thread
+	Bool affinity_done;
+
 	u64 nb_tasks;
+	u64 nb_tasks_stolen;
 	u64 run_time;
 	u64 active_time;
 
+	//packet payload magazines, one per size class
+	GF_PckSlabMagazine pck_mags[GF_PCK_SLAB_NB_CLASSES];
+
 #ifndef GPAC_DISABLE_REMOTERY
 	u32 rmt_tasks;
 	char rmt_name[20];
@@ -344,6 +383,7 @@ struct __gf_filter_session
 	u32 flags;
 	Bool use_locks;
 	Bool direct_mode;
+	Bool work_stealing;
 	volatile u32 tasks_in_process;
 	Bool requires_solved_graph;
 	Bool no_main_thread;
@@ -379,6 +419,17 @@ struct __gf_filter_session
 
 	GF_Mutex *props_mx;
 
+	//packet payload allocator, NULL mutex if disabled (no reservoir mode)
+	GF_Mutex *pck_slab_mx;
+	GF_PckSlabDepot pck_depot[GF_PCK_SLAB_NB_CLASSES];
+	//bytes in depot and max depot size
+	u64 pck_depot_bytes, pck_depot_max;
+	//payload bytes currently allocated (slab and large blocks) and peak value
+	volatile u64 pck_bytes_used;
+	u64 pck_bytes_peak;
+	//number of payloads above the largest size class
+	volatile u32 pck_nb_large;
+
 	GF_Mutex *info_mx;
 
 	GF_Mutex *ui_mx;
@@ -386,6 +437,12 @@ struct __gf_filter_session
 	GF_List *threads;
 	GF_SessionThread main_th;
 
+	//CPUs to pin session threads to, NULL if no affinity
+	u32 *th_cpus;
+	u32 nb_th_cpus;
+	//if set, all threads are pinned to the full CPU set (NUMA node binding), otherwise thread N is pinned to CPU N modulo nb_th_cpus
+	Bool th_cpus_shared;
+
 	//only used in forced lock mode
 	GF_Mutex *tasks_mx;
 
@@ -551,6 +608,8 @@ struct __gf_filter
 	//set to true when the filter is being processed by a thread
 	volatile Bool in_process;
 	u32 process_th_id;
+	//1-based index of the session thread which last processed this filter, 0 if main thread or none - only used in work-stealing mode
+	volatile u32 last_th_idx;
 	//user data for the filter implementation
 	void *filter_udta;
 
@@ -957,6 +1016,17 @@ void gf_filter_pid_del_task(GF_FSTask *task);
 
 void gf_filter_packet_destroy(GF_FilterPacket *pck);
 
+//packet payload allocator - hint filter is used to locate the calling session thread, may be NULL
+//alloc_size is set to the allocated block size, which may be larger than the requested size
+u8 *gf_fs_pck_data_alloc(GF_FilterSession *fsess, GF_Filter *hint, u32 size, u32 *alloc_size);
+//reallocates payload to new_size, keeping the first data_length bytes
+u8 *gf_fs_pck_data_realloc(GF_FilterSession *fsess, GF_Filter *hint, u8 *data, u32 data_length, u32 old_alloc_size, u32 new_size, u32 *alloc_size);
+void gf_fs_pck_data_free(GF_FilterSession *fsess, GF_Filter *hint, u8 *data, u32 alloc_size);
+void gf_fs_pck_slab_init(GF_FilterSession *fsess);
+//releases all cached blocks, shall only be called once session threads are done
+void gf_fs_pck_slab_del(GF_FilterSession *fsess);
+void gf_fs_pck_slab_print_stats(GF_FilterSession *fsess);
+
 void gf_fs_cleanup_filters(GF_FilterSession *fsess);
 
 /*specific task posting*/
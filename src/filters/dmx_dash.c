@@ -59,7 +59,7 @@ typedef struct
 	Bool max_res, immediate, abort, use_bmin;
 	char *query;
 	Bool noxlink, split_as, noseek, groupsel;
-	u32 lowlat;
+	u32 lowlat, prefetch;
 
 	GF_FilterPid *mpd_pid;
 	GF_Filter *filter;
@@ -72,6 +72,8 @@ typedef struct
 	GF_DownloadManager *dm;
 	
 	Bool reuse_download_session;
+	//pending segment prefetches
+	GF_List *prefetches;
 
 	Bool initial_setup_done;
 	Bool in_error;
@@ -145,8 +147,21 @@ typedef struct
 	u32 nb_pending;
 
 	char *template;
+	//download rate of the prefetched segment being played, 0 if not prefetched
+	u32 prefetch_rate;
 } GF_DASHGroup;
 
+typedef struct
+{
+	GF_DownloadSession *sess;
+	char *url;
+	u64 start_range, end_range;
+	s32 group_idx;
+	u32 bytes_per_sec;
+	Bool done;
+	GF_Err error;
+} GF_DASHPrefetch;
+
 static void dashdmx_notify_group_quality(GF_DASHDmxCtx *ctx, GF_DASHGroup *group);
 
 static void dashdmx_set_string_list_prop(GF_FilterPacket *ref, u32 prop_name, GF_List **str_list)
@@ -765,6 +780,169 @@ void dashdmx_io_manifest_updated(GF_DASHFileIO *dashio, const char *manifest_nam
 	}
 }
 
+static void dashdmx_prefetch_del(GF_DASHDmxCtx *ctx, GF_DASHPrefetch *pf, Bool drop_cache)
+{
+	if (pf->sess) {
+		if (!pf->done) gf_dm_sess_abort(pf->sess);
+		gf_dm_sess_del(pf->sess);
+	}
+	//remove segment from cache if never consumed, unless we store segments
+	if (drop_cache && (ctx->segstore!=2))
+		gf_dm_delete_cached_file_entry(ctx->dm, pf->url);
+	gf_free(pf->url);
+	gf_free(pf);
+}
+
+static void dashdmx_prefetch_reset(GF_DASHDmxCtx *ctx)
+{
+	if (!ctx->prefetches) return;
+	while (gf_list_count(ctx->prefetches)) {
+		GF_DASHPrefetch *pf = gf_list_pop_back(ctx->prefetches);
+		dashdmx_prefetch_del(ctx, pf, GF_TRUE);
+	}
+}
+
+//prefetch sessions are not threaded and are run from the filter process, return number of active prefetches
+static u32 dashdmx_prefetch_run(GF_DASHDmxCtx *ctx)
+{
+	u32 i, count, nb_active=0;
+	char szBuf[16000];
+
+	count = ctx->prefetches ? gf_list_count(ctx->prefetches) : 0;
+	for (i=0; i<count; i++) {
+		u32 nb_loops = 0;
+		GF_Err e = GF_OK;
+		GF_DASHPrefetch *pf = gf_list_get(ctx->prefetches, i);
+		if (pf->done) continue;
+
+		//read what is available, the downloader writes it to the cache entry
+		while (nb_loops<50) {
+			u32 read = 0;
+			e = gf_dm_sess_fetch_data(pf->sess, szBuf, 16000, &read);
+			if (e || !read) break;
+			nb_loops++;
+		}
+		if (!e || (e==GF_IP_NETWORK_EMPTY)) {
+			nb_active++;
+			continue;
+		}
+		pf->done = GF_TRUE;
+		if (e==GF_EOS) {
+			gf_dm_sess_get_stats(pf->sess, NULL, NULL, NULL, NULL, &pf->bytes_per_sec, NULL);
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASHDmx] group %d prefetched segment %s at %d kbps\n", pf->group_idx, pf->url, pf->bytes_per_sec*8/1000));
+		} else {
+			pf->error = e;
+			GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASHDmx] group %d failed to prefetch segment %s: %s\n", pf->group_idx, pf->url, gf_error_to_string(e) ));
+		}
+		//done, destroy the session so that its connection can be reused
+		gf_dm_sess_del(pf->sess);
+		pf->sess = NULL;
+	}
+	return nb_active;
+}
+
+void dashdmx_io_prefetch_segment(GF_DASHFileIO *dashio, const char *url, u64 start_range, u64 end_range, s32 group_idx)
+{
+	u32 i, count, nb_in_group=0;
+	u32 flags = GF_NETIO_SESSION_NOT_THREADED | GF_NETIO_SESSION_PERSISTENT;
+	GF_Err e;
+	GF_DASHPrefetch *pf;
+	GF_DASHDmxCtx *ctx = (GF_DASHDmxCtx *)dashio->udta;
+
+	if (strnicmp(url, "http://", 7) && strnicmp(url, "https://", 8))
+		return;
+
+	if (!ctx->prefetches) ctx->prefetches = gf_list_new();
+	count = gf_list_count(ctx->prefetches);
+	for (i=0; i<count; i++) {
+		pf = gf_list_get(ctx->prefetches, i);
+		if (pf->group_idx != group_idx) continue;
+		if (!strcmp(pf->url, url) && (pf->start_range==start_range) && (pf->end_range==end_range))
+			return;
+		nb_in_group++;
+	}
+	//segments were never requested (seek, period switch), drop oldest ones
+	while (nb_in_group >= 2*ctx->prefetch) {
+		for (i=0; i<gf_list_count(ctx->prefetches); i++) {
+			pf = gf_list_get(ctx->prefetches, i);
+			if (pf->group_idx != group_idx) continue;
+			gf_list_rem(ctx->prefetches, i);
+			dashdmx_prefetch_del(ctx, pf, GF_TRUE);
+			break;
+		}
+		nb_in_group--;
+	}
+
+	if (!ctx->segstore) flags |= GF_NETIO_SESSION_MEMORY_CACHE;
+	else if (ctx->segstore==2) flags |= GF_NETIO_SESSION_KEEP_CACHE;
+
+	GF_SAFEALLOC(pf, GF_DASHPrefetch);
+	if (!pf) return;
+	pf->sess = gf_dm_sess_new(ctx->dm, url, flags, NULL, NULL, &e);
+	if (!pf->sess) {
+		gf_free(pf);
+		return;
+	}
+	if (start_range || end_range)
+		gf_dm_sess_set_range(pf->sess, start_range, end_range, GF_TRUE);
+	pf->url = gf_strdup(url);
+	pf->start_range = start_range;
+	pf->end_range = end_range;
+	pf->group_idx = group_idx;
+	gf_list_add(ctx->prefetches, pf);
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASHDmx] group %d prefetching segment %s\n", group_idx, url));
+}
+
+static GF_DASHPrefetch *dashdmx_prefetch_find(GF_DASHDmxCtx *ctx, GF_DASHGroup *group, const char *url, u64 start_range, u64 end_range)
+{
+	u32 i, count;
+	if (!ctx->prefetches) return NULL;
+	count = gf_list_count(ctx->prefetches);
+	for (i=0; i<count; i++) {
+		GF_DASHPrefetch *pf = gf_list_get(ctx->prefetches, i);
+		if (pf->group_idx != group->idx) continue;
+		if (!strcmp(pf->url, url) && (pf->start_range==start_range) && (pf->end_range==end_range))
+			return pf;
+	}
+	return NULL;
+}
+
+//check if the segment was prefetched, removing older prefetches of the group
+static Bool dashdmx_prefetch_claim(GF_DASHDmxCtx *ctx, GF_DASHGroup *group, const char *url, u64 start_range, u64 end_range)
+{
+	u32 i;
+	GF_DASHPrefetch *pf;
+	group->prefetch_rate = 0;
+	pf = dashdmx_prefetch_find(ctx, group, url, start_range, end_range);
+	if (!pf) return GF_FALSE;
+
+	//purge all prefetches of the group queued before this one
+	for (i=0; i<gf_list_count(ctx->prefetches); i++) {
+		GF_DASHPrefetch *a_pf = gf_list_get(ctx->prefetches, i);
+		if (a_pf==pf) break;
+		if (a_pf->group_idx != group->idx) continue;
+		gf_list_rem(ctx->prefetches, i);
+		i--;
+		dashdmx_prefetch_del(ctx, a_pf, GF_TRUE);
+	}
+	if (pf->error) {
+		gf_list_del_item(ctx->prefetches, pf);
+		dashdmx_prefetch_del(ctx, pf, GF_TRUE);
+		return GF_FALSE;
+	}
+	//not done (dependent groups or representations), let the segment source fetch it again
+	if (!pf->done) {
+		gf_list_del_item(ctx->prefetches, pf);
+		dashdmx_prefetch_del(ctx, pf, GF_TRUE);
+		return GF_FALSE;
+	}
+	group->prefetch_rate = pf->bytes_per_sec;
+	gf_list_del_item(ctx->prefetches, pf);
+	dashdmx_prefetch_del(ctx, pf, GF_FALSE);
+	return GF_TRUE;
+}
+
 GF_Err dashdmx_io_on_dash_event(GF_DASHFileIO *dashio, GF_DASHEventType dash_evt, s32 group_idx, GF_Err error_code)
 {
 	GF_Err e;
@@ -1833,6 +2011,8 @@ static GF_Err dashdmx_initialize(GF_Filter *filter)
 		ctx->dash_io.manifest_updated = dashdmx_io_manifest_updated;
 
 	ctx->dash_io.get_bytes_per_sec = dashdmx_io_get_bytes_per_sec;
+	if (ctx->prefetch)
+		ctx->dash_io.prefetch_segment = dashdmx_io_prefetch_segment;
 
 #if 0 //unused since we are in non threaded mode
 	ctx->dash_io.abort = dashdmx_io_abort;
@@ -1941,6 +2121,7 @@ static GF_Err dashdmx_initialize(GF_Filter *filter)
 	gf_dash_ignore_xlink(ctx->dash, ctx->noxlink);
 	gf_dash_set_period_xlink_query_string(ctx->dash, ctx->query);
 	gf_dash_set_low_latency_mode(ctx->dash, ctx->lowlat);
+	gf_dash_set_segment_prefetch(ctx->dash, ctx->prefetch);
 	if (ctx->split_as)
 		gf_dash_split_adaptation_sets(ctx->dash);
 	gf_dash_disable_low_quality_tiles(ctx->dash, ctx->skip_lqt);
@@ -1984,6 +2165,11 @@ static void dashdmx_finalize(GF_Filter *filter)
 	GF_DASHDmxCtx *ctx = (GF_DASHDmxCtx*) gf_filter_get_udta(filter);
 	assert(ctx);
 
+	dashdmx_prefetch_reset(ctx);
+	if (ctx->prefetches)
+		gf_list_del(ctx->prefetches);
+	ctx->prefetches = NULL;
+
 	if (ctx->dash)
 		gf_dash_del(ctx->dash);
 
@@ -2377,6 +2563,8 @@ static void dashdmx_update_group_stats(GF_DASHDmxCtx *ctx, GF_DASHGroup *group)
 
 	p = gf_filter_get_info(group->seg_filter_src, GF_PROP_PID_DOWN_RATE, &pe);
 	if (p) bytes_per_sec = p->value.uint / 8;
+	//segment was read from cache after prefetch, use the prefetch download rate
+	if (group->prefetch_rate) bytes_per_sec = group->prefetch_rate;
 
 	p = gf_filter_get_info(group->seg_filter_src, GF_PROP_PID_DOWN_SIZE, &pe);
 	if (p) file_size = p->value.longuint;
@@ -2514,6 +2702,18 @@ fetch_next:
 		return;
 	}
 
+	//segment is being prefetched, wait for its download to complete rather than fetching it twice
+	if (!seg_disabled && !has_scalable_next && !group->nb_group_deps && !group->next_dependent_rep_idx
+		&& (!next_url_init_or_switch_segment || group->init_switch_seg_sent)
+	) {
+		GF_DASHPrefetch *pf = dashdmx_prefetch_find(ctx, group, next_url, start_range, end_range);
+		if (pf && !pf->done) {
+			group->seg_was_not_ready = GF_TRUE;
+			group->stats_uploaded = GF_TRUE;
+			return;
+		}
+	}
+
 	if (!has_scalable_next) {
 		group->next_dependent_rep_idx = 0;
 	} else {
@@ -2579,6 +2779,9 @@ fetch_next:
 	evt.seek.start_offset = start_range;
 	evt.seek.end_offset = end_range;
 	evt.seek.is_init_segment = GF_FALSE;
+	//segment was prefetched, use the cache entry as is
+	if (dashdmx_prefetch_claim(ctx, group, next_url, start_range, end_range))
+		evt.seek.skip_cache_expiration = GF_TRUE;
 	gf_filter_send_event(group->seg_filter_src, &evt, GF_FALSE);
 }
 
@@ -2655,7 +2858,7 @@ GF_Err dashdmx_process(GF_Filter *filter)
 	}
 	e = gf_dash_process(ctx->dash);
 	if (e == GF_IP_NETWORK_EMPTY) {
-		gf_filter_ask_rt_reschedule(filter, 100000);
+		gf_filter_ask_rt_reschedule(filter, (ctx->prefetches && dashdmx_prefetch_run(ctx)) ? 1000 : 100000);
 		return GF_OK;
 	}
 	else if (e==GF_SERVICE_ERROR) {
@@ -2841,7 +3044,10 @@ GF_Err dashdmx_process(GF_Filter *filter)
 		}
 	}
 
-	if (gf_dash_is_in_setup(ctx->dash))
+	//send requests for segments queued during this process, and check for pending prefetches
+	if (ctx->prefetches && dashdmx_prefetch_run(ctx))
+		gf_filter_ask_rt_reschedule(filter, 1000);
+	else if (gf_dash_is_in_setup(ctx->dash))
 		gf_filter_post_process_task(filter);
 	else if (ctx->abort)
 		gf_filter_ask_rt_reschedule(filter, 50000);
@@ -2942,6 +3148,7 @@ static const GF_FilterArgs DASHDmxArgs[] =
 		"- no: disable low latency\n"
 		"- strict: strict respect of AST offset in low latency\n"
 		"- early: allow fetching segments earlier than their AST in low latency when input demux is empty", GF_PROP_UINT, "early", "no|strict|early", GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(prefetch), "number of segments to prefetch per group behind the segment being fetched. Prefetched segments are downloaded in parallel, sharing HTTP/2 sessions or idle HTTP/1.1 connections (see [-conn-pool](CORE))", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(forward), "segment forwarding mode  -see filter help\n"
 		"- none: regular DASH read\n"
 		"- file: do not demux files and forward them as file pids (imply `segstore=mem`)\n"
@@ -55,11 +55,22 @@ enum
 
 };
 
+typedef struct
+{
+	//PES reassembly buffer, owned by an output packet or waiting for reuse
+	u8 *data;
+	u32 alloc_size;
+	GF_FilterPacket *pck;
+} GF_M2TSDmxBuffer;
+
+//max number of unused PES buffers kept for reuse
+#define M2TSDMX_MAX_FREE_BUFFERS	20
+
 typedef struct
 {
 	//opts
 	const char *temi_url;
-	Bool dsmcc, seeksrc, sigfrag;
+	Bool dsmcc, seeksrc, sigfrag, burst, zcopy;
 
 	GF_Filter *filter;
 	GF_FilterPid *ipid;
@@ -87,6 +98,10 @@ typedef struct
 	u32 wait_for_progs;
 
 	Bool is_dash;
+
+	//PES buffers attached to output packets, and free PES buffers - packet destructors may be called from any thread
+	GF_List *out_buffers, *free_buffers;
+	GF_Mutex *buffers_mx;
 } GF_M2TSDmxCtx;
 
 
@@ -458,10 +473,87 @@ static void m2tdmx_merge_temi(GF_FilterPid *pid, GF_M2TS_ES *stream, GF_FilterPa
 	}
 }
 
+static void m2tsdmx_pes_buffer_release(GF_Filter *filter, GF_FilterPid *pid, GF_FilterPacket *pck)
+{
+	u32 i, count;
+	GF_M2TSDmxCtx *ctx = gf_filter_get_udta(filter);
+
+	//filter finalized, buffers already released
+	if (!ctx->buffers_mx) return;
+
+	gf_mx_p(ctx->buffers_mx);
+	count = gf_list_count(ctx->out_buffers);
+	for (i=0; i<count; i++) {
+		GF_M2TSDmxBuffer *buf = gf_list_get(ctx->out_buffers, i);
+		if (buf->pck != pck) continue;
+		gf_list_rem(ctx->out_buffers, i);
+		buf->pck = NULL;
+		if (gf_list_count(ctx->free_buffers) < M2TSDMX_MAX_FREE_BUFFERS) {
+			gf_list_add(ctx->free_buffers, buf);
+		} else {
+			if (buf->data) gf_free(buf->data);
+			gf_free(buf);
+		}
+		break;
+	}
+	gf_mx_v(ctx->buffers_mx);
+}
+
+//move the PES reassembly buffer holding the payload to a shared output packet, and give the PES a recycled buffer for its next payload
+static GF_FilterPacket *m2tsdmx_new_pes_packet(GF_M2TSDmxCtx *ctx, GF_FilterPid *opid, GF_M2TS_PES_PCK *pck)
+{
+	u32 i, count, detached_size;
+	GF_M2TSDmxBuffer *buf = NULL;
+	GF_M2TS_PES *pes = pck->stream;
+	GF_FilterPacket *dst_pck;
+
+	//payload not in PES buffer (rewritten by the reframer)
+	if (!pes->pck_data || ((u8 *)pck->data < pes->pck_data) || ((u8 *)pck->data + pck->data_len > pes->pck_data + pes->pck_alloc_len))
+		return NULL;
+
+	gf_mx_p(ctx->buffers_mx);
+	//pick the smallest free buffer large enough for a payload of the same size, or the largest one
+	count = gf_list_count(ctx->free_buffers);
+	for (i=0; i<count; i++) {
+		GF_M2TSDmxBuffer *a_buf = gf_list_get(ctx->free_buffers, i);
+		if (!buf) buf = a_buf;
+		else if (a_buf->alloc_size >= pes->pck_data_len) {
+			if ((buf->alloc_size < pes->pck_data_len) || (a_buf->alloc_size < buf->alloc_size)) buf = a_buf;
+		} else if (a_buf->alloc_size > buf->alloc_size) {
+			buf = a_buf;
+		}
+	}
+	if (buf) {
+		gf_list_del_item(ctx->free_buffers, buf);
+	}
+	gf_mx_v(ctx->buffers_mx);
+
+	if (!buf) {
+		GF_SAFEALLOC(buf, GF_M2TSDmxBuffer);
+		if (!buf) return NULL;
+	}
+
+	dst_pck = gf_filter_pck_new_shared(opid, pck->data, pck->data_len, m2tsdmx_pes_buffer_release);
+	if (!dst_pck) {
+		gf_mx_p(ctx->buffers_mx);
+		gf_list_add(ctx->free_buffers, buf);
+		gf_mx_v(ctx->buffers_mx);
+		return NULL;
+	}
+	buf->data = gf_m2ts_pes_swap_buffer(pes, buf->data, buf->alloc_size, &detached_size);
+	buf->alloc_size = detached_size;
+	buf->pck = dst_pck;
+
+	gf_mx_p(ctx->buffers_mx);
+	gf_list_add(ctx->out_buffers, buf);
+	gf_mx_v(ctx->buffers_mx);
+	return dst_pck;
+}
+
 static void m2tsdmx_send_packet(GF_M2TSDmxCtx *ctx, GF_M2TS_PES_PCK *pck)
 {
 	GF_FilterPid *opid;
-	GF_FilterPacket *dst_pck;
+	GF_FilterPacket *dst_pck = NULL;
 	u8 * data;
 
 	/*pcr not initialized, don't send any data*/
@@ -469,10 +561,15 @@ static void m2tsdmx_send_packet(GF_M2TSDmxCtx *ctx, GF_M2TS_PES_PCK *pck)
 	if (!pck->stream->user) return;
 	opid = pck->stream->user;
 
-	dst_pck = gf_filter_pck_new_alloc(opid, pck->data_len, &data);
-	if (!dst_pck) return;
+	if (ctx->zcopy)
+		dst_pck = m2tsdmx_new_pes_packet(ctx, opid, pck);
+
+	if (!dst_pck) {
+		dst_pck = gf_filter_pck_new_alloc(opid, pck->data_len, &data);
+		if (!dst_pck) return;
 
-	memcpy(data, pck->data, pck->data_len);
+		memcpy(data, pck->data, pck->data_len);
+	}
 	//we don't have end of frame signaling
 	gf_filter_pck_set_framing(dst_pck, (pck->flags & GF_M2TS_PES_PCK_AU_START) ? GF_TRUE : GF_FALSE, GF_FALSE);
 
@@ -913,6 +1010,7 @@ static GF_Err m2tsdmx_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool i
 		ctx->ts = gf_m2ts_demux_new();
 		ctx->ts->on_event = m2tsdmx_on_event;
 		ctx->ts->user = filter;
+		ctx->ts->burst_mode = ctx->burst;
 	} else if (!p) {
 		GF_FilterEvent evt;
 		ctx->duration.num = 1;
@@ -1089,8 +1187,15 @@ static GF_Err m2tsdmx_initialize(GF_Filter *filter)
 
 	ctx->ts->on_event = m2tsdmx_on_event;
 	ctx->ts->user = filter;
+	ctx->ts->burst_mode = ctx->burst;
 
 	ctx->filter = filter;
+	if (ctx->zcopy) {
+		ctx->out_buffers = gf_list_new();
+		ctx->free_buffers = gf_list_new();
+		ctx->buffers_mx = gf_mx_new("M2TSDmxBuffers");
+		if (!ctx->out_buffers || !ctx->free_buffers || !ctx->buffers_mx) return GF_OUT_OF_MEM;
+	}
 	if (ctx->dsmcc) {
 		gf_m2ts_demux_dmscc_init(ctx->ts);
 	}
@@ -1104,6 +1209,22 @@ static void m2tsdmx_finalize(GF_Filter *filter)
 	GF_M2TSDmxCtx *ctx = gf_filter_get_udta(filter);
 	if (ctx->ts) gf_m2ts_demux_del(ctx->ts);
 
+	if (ctx->free_buffers) {
+		//input packet queues of all filters are reset before finalizing
+		while (gf_list_count(ctx->out_buffers)) {
+			gf_list_add(ctx->free_buffers, gf_list_pop_back(ctx->out_buffers));
+		}
+		while (gf_list_count(ctx->free_buffers)) {
+			GF_M2TSDmxBuffer *buf = gf_list_pop_back(ctx->free_buffers);
+			if (buf->data) gf_free(buf->data);
+			gf_free(buf);
+		}
+		gf_list_del(ctx->free_buffers);
+		gf_list_del(ctx->out_buffers);
+		ctx->free_buffers = ctx->out_buffers = NULL;
+	}
+	if (ctx->buffers_mx) gf_mx_del(ctx->buffers_mx);
+	ctx->buffers_mx = NULL;
 }
 
 static GF_Err m2tsdmx_process(GF_Filter *filter)
@@ -1203,6 +1324,8 @@ static const GF_FilterArgs M2TSDmxArgs[] =
 	{ OFFS(dsmcc), "enable DSMCC receiver", GF_PROP_BOOL, "no", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(seeksrc), "seek local source file back to origin once all programs are setup", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(sigfrag), "signal segment boundaries of source on output packets", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(zcopy), "assemble PES payloads in recycled buffers handed over to output packets instead of copying each PES to a new packet", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(burst), "group payload-only TS packets of each PES stream over the input block and reassemble them per PID instead of processing each TS packet", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
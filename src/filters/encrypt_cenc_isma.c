@@ -27,6 +27,7 @@
 #include <gpac/constants.h>
 #include <gpac/crypt_tools.h>
 #include <gpac/crypt.h>
+#include <gpac/thread.h>
 #include <gpac/base_coding.h>
 #include <gpac/download.h>
 #include <gpac/xml.h>
@@ -118,17 +119,76 @@ typedef struct
 	GF_PropUIntList mkey_indices;
 } GF_CENCStream;
 
+/*
+	parallel CENC encryption: samples are parsed and their SAI computed on the filter thread, the encrypted ranges of each sample
+	are recorded in a job and jobs are dispatched to worker threads, each worker using its own crypto contexts.
+	This is only possible when the crypto state at the start of a sample does not depend on the ciphertext of previous samples:
+	CTR modes, for which the IV of the next sample is derived from the number of encrypted bytes, and CBC modes with constant IV
+*/
+//number of samples gathered per thread before encrypting
+#define CENC_JOBS_PER_THREAD	4
+
+typedef struct
+{
+	u32 offset, size, key_idx;
+	Bool use_pattern;
+} CENCRange;
+
 typedef struct
+{
+	//output packet, sent once encrypted
+	GF_FilterPacket *pck;
+	u8 *output;
+
+	Bool ctr_mode;
+	u32 crypt_byte_block, skip_byte_block;
+	//keys and IVs at sample start, number of bytes encrypted per key
+	u32 nb_keys, alloc_keys;
+	bin128 *keys;
+	bin128 *IVs;
+	u32 *nb_crypted;
+
+	CENCRange *ranges;
+	u32 nb_ranges, alloc_ranges;
+	GF_Err e;
+} CENCJob;
+
+typedef struct
+{
+	struct __cenc_enc_ctx *ctx;
+	GF_Thread *th;
+	GF_Semaphore *run;
+	Bool done;
+
+	//crypto contexts and associated keys, one per key index
+	Bool ctr_mode;
+	u32 nb_crypts;
+	GF_Crypt **crypts;
+	bin128 *keys;
+} CENCWorker;
+
+typedef struct __cenc_enc_ctx
 {
 	//options
 	const char *cfile;
 	Bool allc;
+	s32 threads;
 	
 	//internal
 	GF_CryptInfo *cinfo;
 
 	GF_List *streams;
 	GF_BitStream *bs_w, *bs_r;
+
+	//extra workers, the filter thread also processes jobs
+	u32 nb_workers;
+	CENCWorker *workers;
+	CENCWorker main_worker;
+	GF_Semaphore *workers_done;
+	//pending jobs, in packet order
+	CENCJob *jobs;
+	u32 nb_jobs, alloc_jobs, max_jobs;
+	s32 next_job;
 } GF_CENCEncCtx;
 
 
@@ -1276,12 +1336,8 @@ static void increase_counter(char *x, int x_size) {
 	return;
 }
 
-static void cenc_resync_IV(GF_Crypt *mc, char IV[16], u8 IV_size)
+static void cenc_next_IV(char next_IV[17], u8 IV_size)
 {
-	char next_IV[17];
-	u32 size = 17;
-
-	gf_crypt_get_IV(mc, (u8 *) next_IV, &size);
 	/*
 		NOTE 1: the next_IV returned by get_state has 17 bytes, the first byte being the current counter position in the following 16 bytes.
 		If this index is 0, this means that we are at the beginning of a new block and we can use it as IV for next sample,
@@ -1309,6 +1365,15 @@ static void cenc_resync_IV(GF_Crypt *mc, char IV[16], u8 IV_size)
 		increase_counter(&next_IV[1], IV_size);
 		next_IV[0] = 0;
 	}
+}
+
+static void cenc_resync_IV(GF_Crypt *mc, char IV[16], u8 IV_size)
+{
+	char next_IV[17];
+	u32 size = 17;
+
+	gf_crypt_get_IV(mc, (u8 *) next_IV, &size);
+	cenc_next_IV(next_IV, IV_size);
 
 	gf_crypt_set_IV(mc, next_IV, size);
 
@@ -1316,6 +1381,309 @@ static void cenc_resync_IV(GF_Crypt *mc, char IV[16], u8 IV_size)
 	memcpy(IV, next_IV+1, 16*sizeof(char));
 }
 
+//same as cenc_resync_IV when the sample is encrypted by a worker: the counter state is computed from the number of bytes encrypted since IV
+static void cenc_advance_IV(GF_Crypt *mc, char IV[16], u8 IV_size, u32 nb_crypted)
+{
+	char next_IV[17];
+	u32 i, nb_blocks = (nb_crypted + 15) / 16;
+	u64 lo=0, new_lo;
+
+	next_IV[0] = nb_crypted % 16;
+	memcpy(next_IV+1, IV, 16);
+	for (i=0; i<8; i++)
+		lo = (lo<<8) | (u8) next_IV[9+i];
+	new_lo = lo + nb_blocks;
+	for (i=0; i<8; i++)
+		next_IV[16-i] = (char) ((new_lo >> (8*i)) & 0xFF);
+	//carry
+	if (new_lo < lo)
+		increase_counter(&next_IV[1], 8);
+
+	cenc_next_IV(next_IV, IV_size);
+	gf_crypt_set_IV(mc, next_IV, 17);
+
+	memcpy(IV, next_IV+1, 16*sizeof(char));
+}
+
+//number of bytes encrypted in a range, only encrypted blocks of a pattern advance the crypto state
+static u32 cenc_range_crypted_bytes(u32 size, u32 crypt_block, u32 skip_block)
+{
+	u32 nb_pat, res;
+	if (!crypt_block || !skip_block) return size;
+	nb_pat = size / (16*(crypt_block + skip_block));
+	res = size - nb_pat * 16*(crypt_block + skip_block);
+	if (res > 16*crypt_block) res = 16*crypt_block;
+	return nb_pat * 16*crypt_block + res;
+}
+
+static CENCJob *cenc_job_new(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, u32 nb_keys)
+{
+	u32 i;
+	CENCJob *job;
+	if (ctx->nb_jobs == ctx->alloc_jobs) {
+		CENCJob *jobs = gf_realloc(ctx->jobs, sizeof(CENCJob) * (ctx->alloc_jobs+1));
+		if (!jobs) return NULL;
+		ctx->jobs = jobs;
+		memset(&ctx->jobs[ctx->alloc_jobs], 0, sizeof(CENCJob));
+		ctx->alloc_jobs++;
+	}
+	job = &ctx->jobs[ctx->nb_jobs];
+	if (job->alloc_keys < nb_keys) {
+		job->keys = gf_realloc(job->keys, sizeof(bin128) * nb_keys);
+		job->IVs = gf_realloc(job->IVs, sizeof(bin128) * nb_keys);
+		job->nb_crypted = gf_realloc(job->nb_crypted, sizeof(u32) * nb_keys);
+		if (!job->keys || !job->IVs || !job->nb_crypted) {
+			job->alloc_keys = 0;
+			return NULL;
+		}
+		job->alloc_keys = nb_keys;
+	}
+	job->nb_keys = nb_keys;
+	for (i=0; i<nb_keys; i++) {
+		memcpy(job->keys[i], cstr->keys[i].key, 16);
+		memcpy(job->IVs[i], cstr->keys[i].IV, 16);
+		job->nb_crypted[i] = 0;
+	}
+	job->ctr_mode = cstr->ctr_mode;
+	job->crypt_byte_block = cstr->tci->crypt_byte_block;
+	job->skip_byte_block = cstr->tci->skip_byte_block;
+	job->nb_ranges = 0;
+	job->pck = NULL;
+	job->output = NULL;
+	job->e = GF_OK;
+	return job;
+}
+
+static GF_Err cenc_crypt_range(GF_CENCStream *cstr, CENCJob *job, u8 *output, u32 offset, u32 size, u32 key_idx, Bool use_pattern)
+{
+	if (job) {
+		CENCRange *r;
+		if (job->nb_ranges == job->alloc_ranges) {
+			job->alloc_ranges = job->alloc_ranges ? 2*job->alloc_ranges : 16;
+			job->ranges = gf_realloc(job->ranges, sizeof(CENCRange) * job->alloc_ranges);
+			if (!job->ranges) {
+				job->alloc_ranges = job->nb_ranges = 0;
+				return GF_OUT_OF_MEM;
+			}
+		}
+		r = &job->ranges[job->nb_ranges];
+		job->nb_ranges++;
+		r->offset = offset;
+		r->size = size;
+		r->key_idx = key_idx;
+		r->use_pattern = use_pattern;
+		if (use_pattern)
+			job->nb_crypted[key_idx] += cenc_range_crypted_bytes(size, job->crypt_byte_block, job->skip_byte_block);
+		else
+			job->nb_crypted[key_idx] += size;
+		return GF_OK;
+	}
+
+	//cbcs scheme with constant IV, reinit at each sub sample,
+	if (!cstr->ctr_mode && !cstr->tci->keys[key_idx].IV_size)
+		gf_crypt_set_IV(cstr->keys[key_idx].crypt, cstr->keys[key_idx].IV, 16);
+
+	if (use_pattern)
+		return gf_crypt_encrypt_pattern(cstr->keys[key_idx].crypt, output+offset, size, cstr->tci->crypt_byte_block, cstr->tci->skip_byte_block);
+	return gf_crypt_encrypt(cstr->keys[key_idx].crypt, output+offset, size);
+}
+
+static GF_Err cenc_worker_setup(CENCWorker *w, CENCJob *job)
+{
+	u32 i;
+	//mode changed, reset all contexts
+	if (w->nb_crypts && (w->ctr_mode != job->ctr_mode)) {
+		for (i=0; i<w->nb_crypts; i++) {
+			if (w->crypts[i]) gf_crypt_close(w->crypts[i]);
+			w->crypts[i] = NULL;
+		}
+	}
+	w->ctr_mode = job->ctr_mode;
+	if (w->nb_crypts < job->nb_keys) {
+		w->crypts = gf_realloc(w->crypts, sizeof(GF_Crypt *) * job->nb_keys);
+		w->keys = gf_realloc(w->keys, sizeof(bin128) * job->nb_keys);
+		if (!w->crypts || !w->keys) {
+			w->nb_crypts = 0;
+			return GF_OUT_OF_MEM;
+		}
+		for (i=w->nb_crypts; i<job->nb_keys; i++)
+			w->crypts[i] = NULL;
+		w->nb_crypts = job->nb_keys;
+	}
+	for (i=0; i<job->nb_keys; i++) {
+		if (!w->crypts[i]) {
+			GF_Err e;
+			w->crypts[i] = gf_crypt_open(GF_AES_128, job->ctr_mode ? GF_CTR : GF_CBC);
+			if (!w->crypts[i]) return GF_IO_ERR;
+			memcpy(w->keys[i], job->keys[i], 16);
+			e = gf_crypt_init(w->crypts[i], w->keys[i], job->IVs[i]);
+			if (e) {
+				w->crypts[i] = NULL;
+				return e;
+			}
+		} else if (memcmp(w->keys[i], job->keys[i], 16)) {
+			memcpy(w->keys[i], job->keys[i], 16);
+			gf_crypt_set_key(w->crypts[i], w->keys[i]);
+		}
+		//CTR: counter at start of sample, CBC: IV is set for each range
+		if (job->ctr_mode) {
+			char IV[17];
+			IV[0] = 0;
+			memcpy(IV+1, job->IVs[i], 16);
+			gf_crypt_set_IV(w->crypts[i], IV, 17);
+		}
+	}
+	return GF_OK;
+}
+
+static void cenc_worker_process(CENCWorker *w, CENCJob *job)
+{
+	u32 i;
+	job->e = cenc_worker_setup(w, job);
+	if (job->e) return;
+
+	for (i=0; i<job->nb_ranges; i++) {
+		CENCRange *r = &job->ranges[i];
+		GF_Crypt *gc = w->crypts[r->key_idx];
+		//only CBC with constant IV is processed by workers, reinit at each sub sample
+		if (!job->ctr_mode)
+			gf_crypt_set_IV(gc, job->IVs[r->key_idx], 16);
+
+		if (r->use_pattern)
+			job->e = gf_crypt_encrypt_pattern(gc, job->output + r->offset, r->size, job->crypt_byte_block, job->skip_byte_block);
+		else
+			job->e = gf_crypt_encrypt(gc, job->output + r->offset, r->size);
+		if (job->e) return;
+	}
+}
+
+static void cenc_worker_run_jobs(CENCWorker *w)
+{
+	GF_CENCEncCtx *ctx = w->ctx;
+	while (1) {
+		s32 idx = safe_int_inc(&ctx->next_job) - 1;
+		if (idx >= (s32) ctx->nb_jobs) break;
+		cenc_worker_process(w, &ctx->jobs[idx]);
+	}
+}
+
+static u32 cenc_worker_thread(void *par)
+{
+	CENCWorker *w = (CENCWorker *)par;
+	while (1) {
+		gf_sema_wait(w->run);
+		if (w->done) break;
+		cenc_worker_run_jobs(w);
+		gf_sema_notify(w->ctx->workers_done, 1);
+	}
+	return 0;
+}
+
+static void cenc_worker_reset(CENCWorker *w)
+{
+	u32 i;
+	for (i=0; i<w->nb_crypts; i++) {
+		if (w->crypts[i]) gf_crypt_close(w->crypts[i]);
+	}
+	if (w->crypts) gf_free(w->crypts);
+	if (w->keys) gf_free(w->keys);
+	w->crypts = NULL;
+	w->keys = NULL;
+	w->nb_crypts = 0;
+}
+
+static void cenc_del_workers(GF_CENCEncCtx *ctx)
+{
+	u32 i;
+	for (i=0; i<ctx->nb_workers; i++) {
+		CENCWorker *w = &ctx->workers[i];
+		if (w->th) {
+			w->done = GF_TRUE;
+			gf_sema_notify(w->run, 1);
+			gf_th_del(w->th);
+		}
+		if (w->run) gf_sema_del(w->run);
+		cenc_worker_reset(w);
+	}
+	if (ctx->workers) gf_free(ctx->workers);
+	ctx->workers = NULL;
+	ctx->nb_workers = 0;
+	if (ctx->workers_done) gf_sema_del(ctx->workers_done);
+	ctx->workers_done = NULL;
+}
+
+static void cenc_setup_workers(GF_CENCEncCtx *ctx)
+{
+	u32 i, nb_threads = 0;
+	if (ctx->threads == -1) {
+		GF_SystemRTInfo rti;
+		memset(&rti, 0, sizeof(GF_SystemRTInfo));
+		if (gf_sys_get_rti(0, &rti, 0) && rti.nb_cores)
+			nb_threads = rti.nb_cores-1;
+	} else if (ctx->threads > 0) {
+		nb_threads = ctx->threads;
+	}
+	ctx->main_worker.ctx = ctx;
+	//max number of samples gathered before encryption
+	ctx->max_jobs = nb_threads ? CENC_JOBS_PER_THREAD * (nb_threads+1) : 0;
+	if (!nb_threads) return;
+
+	ctx->workers = gf_malloc(sizeof(CENCWorker) * nb_threads);
+	if (!ctx->workers) return;
+	memset(ctx->workers, 0, sizeof(CENCWorker) * nb_threads);
+	ctx->workers_done = gf_sema_new(nb_threads, 0);
+	ctx->nb_workers = nb_threads;
+
+	for (i=0; i<nb_threads; i++) {
+		CENCWorker *w = &ctx->workers[i];
+		w->ctx = ctx;
+		w->run = gf_sema_new(1, 0);
+		w->th = gf_th_new("CENCWorker");
+		if (!w->run || !ctx->workers_done || !w->th
+			|| (gf_th_run(w->th, cenc_worker_thread, w) != GF_OK)
+		) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_AUTHOR, ("[CENC] Failed to setup worker thread, encrypting samples in parallel on %d threads\n", i+1));
+			if (w->th) gf_th_del(w->th);
+			w->th = NULL;
+			if (w->run) gf_sema_del(w->run);
+			w->run = NULL;
+			ctx->nb_workers = i;
+			if (!i) cenc_del_workers(ctx);
+			break;
+		}
+	}
+}
+
+//encrypts pending jobs and sends their packets in order
+static GF_Err cenc_flush_jobs(GF_CENCEncCtx *ctx)
+{
+	u32 i, nb_run = 0;
+	GF_Err e = GF_OK;
+	if (!ctx->nb_jobs) return GF_OK;
+
+	ctx->next_job = 0;
+	for (i=0; (i<ctx->nb_workers) && (i+1<ctx->nb_jobs); i++) {
+		gf_sema_notify(ctx->workers[i].run, 1);
+		nb_run++;
+	}
+	cenc_worker_run_jobs(&ctx->main_worker);
+	for (i=0; i<nb_run; i++)
+		gf_sema_wait(ctx->workers_done);
+
+	for (i=0; i<ctx->nb_jobs; i++) {
+		CENCJob *job = &ctx->jobs[i];
+		if (job->e) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("[CENC] Error encrypting packet: %s\n", gf_error_to_string(job->e) ));
+			e = job->e;
+		}
+		if (e) gf_filter_pck_discard(job->pck);
+		else gf_filter_pck_send(job->pck);
+		job->pck = NULL;
+	}
+	ctx->nb_jobs = 0;
+	return e;
+}
+
 #ifndef GPAC_DISABLE_AV_PARSERS
 //parses slice header and returns its size
 static u32 cenc_get_clear_bytes(GF_CENCStream *cstr, GF_BitStream *plaintext_bs, char *samp_data, u32 nal_size, u32 bytes_in_nalhr)
@@ -1380,6 +1748,7 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 	u32 nb_subs_crypted = 0;
 	u32 nb_sub_offset;
 	Bool multi_key;
+	CENCJob *job = NULL;
 
 	if (cstr->multi_key) {
 		nb_keys = cstr->tci->nb_keys;
@@ -1403,6 +1772,20 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 		}
 	}
 
+	//parallel mode, only if the sample does not depend on the ciphertext of the previous one (no CBC chaining)
+	if (ctx->max_jobs) {
+		Bool use_job = GF_TRUE;
+		if (!cstr->ctr_mode) {
+			for (i=0; i<nb_keys; i++) {
+				if (cstr->tci->keys[i].IV_size) use_job = GF_FALSE;
+			}
+		}
+		if (use_job) {
+			job = cenc_job_new(ctx, cstr, nb_keys);
+			if (!job) return GF_OUT_OF_MEM;
+		}
+	}
+
 	data = gf_filter_pck_get_data(pck, &pck_size);
 
 	//CENC can use inplace processing for decryption
@@ -1692,29 +2075,16 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 					/*skip bytes of encrypted data*/
 					gf_bs_skip_bytes(ctx->bs_r, nalu_size - clear_bytes);
 
-					//cbcs scheme with constant IV, reinit at each sub sample,
-					if (!cstr->ctr_mode && !cstr->tci->keys[key_idx].IV_size)
-						gf_crypt_set_IV(cstr->keys[key_idx].crypt, cstr->keys[key_idx].IV, 16);
-
 					//pattern encryption
 					if (cstr->tci->crypt_byte_block && cstr->tci->skip_byte_block) {
 						u32 res = nalu_size - clear_bytes - clear_bytes_at_end;
-						pos = cur_pos;
 						assert((res % 16) == 0);
-
-						while (res) {
-							e = gf_crypt_encrypt(cstr->keys[key_idx].crypt, output+pos, res >= (u32) (16*cstr->tci->crypt_byte_block) ? 16*cstr->tci->crypt_byte_block : res);
-							if (res >= (u32) (16 * (cstr->tci->crypt_byte_block + cstr->tci->skip_byte_block))) {
-								pos += 16 * (cstr->tci->crypt_byte_block + cstr->tci->skip_byte_block);
-								res -= 16 * (cstr->tci->crypt_byte_block + cstr->tci->skip_byte_block);
-							} else {
-								res = 0;
-							}
-						}
+						if (res)
+							e = cenc_crypt_range(cstr, job, output, cur_pos, res, key_idx, GF_TRUE);
 					}
 					//full subsample encryption
 					else {
-						e = gf_crypt_encrypt(cstr->keys[key_idx].crypt, output+cur_pos, nalu_size - clear_bytes);
+						e = cenc_crypt_range(cstr, job, output, cur_pos, nalu_size - clear_bytes, key_idx, GF_FALSE);
 					}
 				}
 
@@ -1805,7 +2175,7 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 		//CTR full sample
 		else if (cstr->ctr_mode) {
 			gf_bs_skip_bytes(ctx->bs_r, pck_size);
-			e = gf_crypt_encrypt(cstr->keys[0].crypt, output, pck_size);
+			e = cenc_crypt_range(cstr, job, output, 0, pck_size, 0, GF_FALSE);
 		}
 		//CBC full sample with padding
 		else {
@@ -1813,12 +2183,8 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 
 			clear_trailing = pck_size % 16;
 
-			//cbcs scheme with constant IV, reinit at each sample,
-			if (!cstr->tci->keys[0].IV_size)
-				gf_crypt_set_IV(cstr->keys[0].crypt, cstr->keys[0].IV, 16);
-
 			if (pck_size >= 16) {
-				gf_crypt_encrypt(cstr->keys[0].crypt, output, pck_size - clear_trailing);
+				e = cenc_crypt_range(cstr, job, output, 0, pck_size - clear_trailing, 0, GF_FALSE);
 			}
 			gf_bs_skip_bytes(ctx->bs_r, pck_size);
 		}
@@ -1840,7 +2206,10 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 	}
 	if (cstr->ctr_mode) {
 		for (i=0; i<nb_keys; i++) {
-			cenc_resync_IV(cstr->keys[i].crypt, cstr->keys[i].IV, cstr->tci->keys[i].IV_size);
+			if (job)
+				cenc_advance_IV(cstr->keys[i].crypt, cstr->keys[i].IV, cstr->tci->keys[i].IV_size, job->nb_crypted[i]);
+			else
+				cenc_resync_IV(cstr->keys[i].crypt, cstr->keys[i].IV, cstr->tci->keys[i].IV_size);
 		}
 	}
 
@@ -1859,6 +2228,13 @@ static GF_Err cenc_encrypt_packet(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_Fi
 	}
 	gf_bs_del(sai_bs);
 
+	//packet is sent once encrypted, see cenc_flush_jobs
+	if (job) {
+		job->pck = dst_pck;
+		job->output = output;
+		ctx->nb_jobs++;
+		return GF_OK;
+	}
 	gf_filter_pck_send(dst_pck);
 	return GF_OK;
 }
@@ -1913,6 +2289,11 @@ static GF_Err cenc_process(GF_CENCEncCtx *ctx, GF_CENCStream *cstr, GF_FilterPac
 		u32 i, sai_size = 0;
 		Bool signal_sai = GF_FALSE;
 		GF_FilterPacket *dst_pck;
+
+		//send pending encrypted packets first
+		e = cenc_flush_jobs(ctx);
+		if (e) return e;
+
 		dst_pck = gf_filter_pck_new_ref(cstr->opid, 0, 0, pck);
 		if (!dst_pck) return GF_OUT_OF_MEM;
 		
@@ -2049,29 +2430,39 @@ static GF_Err cenc_enc_process(GF_Filter *filter)
 
 	nb_eos = 0;
 	for (i=0; i<count; i++) {
-		GF_Err e = GF_OK;;
+		GF_Err fe, e = GF_OK;
 		GF_CENCStream *cstr = gf_list_get(ctx->streams, i);
-		GF_FilterPacket *pck = gf_filter_pid_get_packet(cstr->ipid);
-		if (!pck) {
-			if (gf_filter_pid_is_eos(cstr->ipid)) {
-				gf_filter_pid_set_eos(cstr->opid);
-				nb_eos++;
+
+		while (1) {
+			GF_FilterPacket *pck = gf_filter_pid_get_packet(cstr->ipid);
+			if (!pck) {
+				if (gf_filter_pid_is_eos(cstr->ipid)) {
+					e = cenc_flush_jobs(ctx);
+					gf_filter_pid_set_eos(cstr->opid);
+					nb_eos++;
+				}
+				break;
 			}
-			continue;
-		}
 
-		if (cstr->passthrough) {
-			gf_filter_pck_forward(pck, cstr->opid);
-		}
-		else if (cstr->isma_oma) {
-			e = isma_process(ctx, cstr, pck);
-		} else if (cstr->is_adobe) {
-	 		e = adobe_process(ctx, cstr, pck);
-		} else {
-			e = cenc_process(ctx, cstr, pck);
+			if (cstr->passthrough) {
+				gf_filter_pck_forward(pck, cstr->opid);
+			}
+			else if (cstr->isma_oma) {
+				e = isma_process(ctx, cstr, pck);
+			} else if (cstr->is_adobe) {
+				e = adobe_process(ctx, cstr, pck);
+			} else {
+				e = cenc_process(ctx, cstr, pck);
+			}
+			gf_filter_pid_drop_packet(cstr->ipid);
+			cstr->nb_pck++;
+
+			if (e) break;
+			//gather several samples when encrypting in parallel
+			if (!ctx->nb_jobs || (ctx->nb_jobs >= ctx->max_jobs)) break;
 		}
-		gf_filter_pid_drop_packet(cstr->ipid);
-		cstr->nb_pck++;
+		fe = cenc_flush_jobs(ctx);
+		if (!e) e = fe;
 
 		if (e) return e;
 	}
@@ -2094,11 +2485,13 @@ static GF_Err cenc_enc_initialize(GF_Filter *filter)
 	}
 
 	ctx->streams = gf_list_new();
+	cenc_setup_workers(ctx);
 	return GF_OK;
 }
 
 static void cenc_enc_finalize(GF_Filter *filter)
 {
+	u32 i;
 	GF_CENCEncCtx *ctx = (GF_CENCEncCtx *)gf_filter_get_udta(filter);
 	if (ctx->cinfo) gf_crypt_info_del(ctx->cinfo);
 	while (gf_list_count(ctx->streams)) {
@@ -2108,6 +2501,18 @@ static void cenc_enc_finalize(GF_Filter *filter)
 	gf_list_del(ctx->streams);
 	if (ctx->bs_w) gf_bs_del(ctx->bs_w);
 	if (ctx->bs_r) gf_bs_del(ctx->bs_r);
+
+	cenc_del_workers(ctx);
+	cenc_worker_reset(&ctx->main_worker);
+	for (i=0; i<ctx->alloc_jobs; i++) {
+		CENCJob *job = &ctx->jobs[i];
+		if (job->pck) gf_filter_pck_discard(job->pck);
+		if (job->keys) gf_free(job->keys);
+		if (job->IVs) gf_free(job->IVs);
+		if (job->nb_crypted) gf_free(job->nb_crypted);
+		if (job->ranges) gf_free(job->ranges);
+	}
+	if (ctx->jobs) gf_free(ctx->jobs);
 }
 
 
@@ -2127,7 +2532,8 @@ static const GF_FilterCapability CENCEncCaps[] =
 static const GF_FilterArgs GF_CENCEncArgs[] =
 {
 	{ OFFS(cfile), "crypt file location - see filter help", GF_PROP_STRING, NULL, NULL, 0},
-	{ OFFS(allc), "throw error if no DRM config file is found for a PID - see filter help", GF_PROP_STRING, NULL, NULL, 0},
+	{ OFFS(allc), "throw error if no DRM config file is found for a PID - see filter help", GF_PROP_BOOL, "false", NULL, 0},
+	{ OFFS(threads), "number of extra threads used to encrypt CENC samples in parallel, -1 for one per CPU core minus one - see filter help", GF_PROP_SINT, "0", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{0}
 };
 
@@ -2139,6 +2545,9 @@ GF_FilterRegister CENCEncRegister = {
 	"The DRM config file can be set per PID using the property `CryptInfo`, or set at the filter level using [-cfile]().\n"
 	"When the DRM config file is set per PID, the first `CrypTrack` in the DRM config file with the same ID is used, otherwise the first `CrypTrack` is used.\n"
 	"If no DRM config file is defined for a given PID, this PID will not be encrypted, or an error will be thrown if [-allc]() is specified.\n"
+	"\n"
+	"When [-threads]() is set, several CENC samples are gathered and encrypted in parallel. This is only used for CTR schemes (`cenc`, `cens`) and CBC schemes with constant IV (usually `cbcs`), "
+	"since with per-sample IVs in CBC mode the IV of a sample is the last cipher block of the previous sample.\n"
 	)
 	.private_size = sizeof(GF_CENCEncCtx),
 	.max_extra_pids=-1,
@@ -56,7 +56,7 @@ typedef struct
 	//options
 	char *src, *ifce, *odir;
 	Bool gcache, kc, skipr, reorder, fullseg;
-	u32 buffer, timeout, stats, max_segs, tsidbg, rtimeout, nbcached, repair;
+	u32 buffer, timeout, stats, max_segs, tsidbg, rtimeout, nbcached, repair, mmsg, rxthreads;
 	s32 tunein, stsi;
 	
 	//internal
@@ -813,6 +813,8 @@ static GF_Err routein_initialize(GF_Filter *filter)
 	gf_route_set_allow_progressive_dispatch(ctx->route_dmx, !ctx->fullseg);
 
 	gf_route_set_reorder(ctx->route_dmx, ctx->reorder, ctx->rtimeout);
+	gf_route_set_batch_size(ctx->route_dmx, ctx->mmsg);
+	gf_route_set_receive_threads(ctx->route_dmx, ctx->rxthreads);
 
 	if (ctx->tsidbg) {
 		gf_route_dmx_debug_tsi(ctx->route_dmx, ctx->tsidbg);
@@ -860,6 +862,8 @@ static const GF_FilterArgs ROUTEInArgs[] =
 	{ OFFS(gcache), "indicate the files should populate GPAC HTTP cache - see filter help", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(tunein), "service ID to bootstrap on for ATSC 3.0 mode. 0 means tune to no service, -1 tune all services -2 means tune on first service found", GF_PROP_SINT, "-2", NULL, 0},
 	{ OFFS(buffer), "receive buffer size to use in bytes", GF_PROP_UINT, "0x80000", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(mmsg), "number of LCT packets read per system call (0 or 1 disables batch reception)", GF_PROP_UINT, "16", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(rxthreads), "number of receive threads, services being distributed across threads (0 receives in filter thread)", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(timeout), "timeout in ms after which tunein fails", GF_PROP_UINT, "5000", NULL, 0},
     { OFFS(nbcached), "number of segments to keep in cache per service", GF_PROP_UINT, "8", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(kc), "keep corrupted file", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_ADVANCED},
@@ -928,6 +932,10 @@ GF_FilterRegister ROUTEInRegister = {
 	"\n"
 	"If [-max_segs]() is set, old files will be deleted.\n"
 	"\n"
+	"# FEC\n"
+	"When the S-TSID declares a repair flow (`RprFlow`) using Reed-Solomon over GF(2^8) (FEC encoding ID 5), repair symbols are used to recover lost source packets before any file repair is attempted.\n"
+	"Other FEC schemes (e.g. RaptorQ) are not supported and their repair flows are ignored.\n"
+	"\n"
 	"# File Repair\n"
 	"In case of losses or incomplete segment reception (during tune-in), the files are patched as follows:\n"
 	"- MPEG-2 TS: all lost ranges are adjusted to 188-bytes boundaries, and transformed into NULL TS packets.\n"
@@ -60,7 +60,7 @@ typedef struct
 	const char *ext;
 	const char *mime;
 	Bool tsprobe, listen, ka, block;
-	u32 timeout;
+	u32 timeout, mmsg;
 #ifndef GPAC_DISABLE_STREAMING
 	u32 reorder_pck;
 	u32 reorder_delay;
@@ -72,11 +72,16 @@ typedef struct
 	Bool is_udp;
 
 	char *buffer;
+	u32 buffer_size;
+	GF_SockDatagram *dgrams;
 
 	GF_SockGroup *active_sockets;
 	u64 last_rcv_time;
 } GF_SockInCtx;
 
+//batch reception slot size, large enough for any UDP datagram
+#define SOCKIN_DGRAM_SLOT_SIZE	0x10000
+
 
 
 static GF_Err sockin_initialize(GF_Filter *filter)
@@ -176,7 +181,16 @@ static GF_Err sockin_initialize(GF_Filter *filter)
 	gf_sk_set_buffer_size(ctx->sock_c.socket, 0, ctx->block_size);
 	gf_sk_set_block_mode(ctx->sock_c.socket, (!ctx->is_udp && ctx->block) ? GF_FALSE : GF_TRUE);
 
-	ctx->buffer = gf_malloc(ctx->block_size + 1);
+	ctx->buffer_size = ctx->block_size;
+	//batch reception of UDP datagrams, each datagram is received in its own slot of the read buffer
+	//slots must hold the largest possible datagram, the read buffer is enlarged to hold mmsg slots
+	if (ctx->is_udp && (ctx->mmsg>1)) {
+		ctx->dgrams = gf_malloc(sizeof(GF_SockDatagram) * ctx->mmsg);
+		if (!ctx->dgrams) return GF_OUT_OF_MEM;
+		if (ctx->buffer_size < ctx->mmsg * SOCKIN_DGRAM_SLOT_SIZE)
+			ctx->buffer_size = ctx->mmsg * SOCKIN_DGRAM_SLOT_SIZE;
+	}
+	ctx->buffer = gf_malloc(ctx->buffer_size + 1);
 	if (!ctx->buffer) return GF_OUT_OF_MEM;
 	//ext/mime given and not mpeg2, disable probe
 	if (ctx->ext && !strstr("ts|m2t|mts|dmb|trp", ctx->ext)) ctx->tsprobe = GF_FALSE;
@@ -211,6 +225,7 @@ static void sockin_finalize(GF_Filter *filter)
 	}
 	sockin_client_reset(&ctx->sock_c);
 	if (ctx->buffer) gf_free(ctx->buffer);
+	if (ctx->dgrams) gf_free(ctx->dgrams);
 	if (ctx->active_sockets) gf_sk_group_del(ctx->active_sockets);
 }
 
@@ -275,7 +290,35 @@ static GF_Err sockin_read_client(GF_Filter *filter, GF_SockInCtx *ctx, GF_SockIn
 	nb_read=0;
 	while (pos < ctx->block_size) {
 		u32 read=0;
-		e = gf_sk_receive_no_select(sock_c->socket, ctx->buffer+pos, ctx->block_size - pos, &read);
+		u32 nb_dgrams = 0;
+		//batch reception for raw UDP, not for RTP which is processed packet by packet
+		if (ctx->dgrams && !sock_c->rtp_reorder) {
+			nb_dgrams = (ctx->buffer_size - pos) / SOCKIN_DGRAM_SLOT_SIZE;
+			if (nb_dgrams > ctx->mmsg) nb_dgrams = ctx->mmsg;
+		}
+		if (nb_dgrams>1) {
+			u32 i, nb_recv=0;
+			for (i=0; i<nb_dgrams; i++) {
+				ctx->dgrams[i].data = (u8 *) ctx->buffer + pos + i*SOCKIN_DGRAM_SLOT_SIZE;
+				ctx->dgrams[i].size = SOCKIN_DGRAM_SLOT_SIZE;
+			}
+			e = gf_sk_receive_batch(sock_c->socket, ctx->dgrams, nb_dgrams, &nb_recv);
+			if (!e) {
+				//pack datagrams
+				for (i=0; i<nb_recv; i++) {
+					if (ctx->dgrams[i].data != (u8 *) ctx->buffer + pos + read)
+						memmove(ctx->buffer + pos + read, ctx->dgrams[i].data, ctx->dgrams[i].read);
+					read += ctx->dgrams[i].read;
+				}
+				//socket queue is empty, don't wait for next read to fail
+				if (nb_recv < nb_dgrams) {
+					nb_read += read;
+					break;
+				}
+			}
+		} else {
+			e = gf_sk_receive_no_select(sock_c->socket, ctx->buffer+pos, ctx->block_size - pos, &read);
+		}
 		if (e) {
 			if (nb_read) break;
 			switch (e) {
@@ -520,6 +563,7 @@ static const GF_FilterArgs SockInArgs[] =
 	{ OFFS(mime), "indicate mime type of udp data", GF_PROP_STRING, NULL, NULL, 0},
 	{ OFFS(block), "set blocking mode for socket(s)", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_ADVANCED},
 	{ OFFS(timeout), "set timeout in ms for UDP socket(s)", GF_PROP_UINT, "5000", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(mmsg), "number of UDP datagrams read per system call, each datagram being read in a 64 kB slot (0 or 1 disables batch reception)", GF_PROP_UINT, "16", NULL, GF_FS_ARG_HINT_EXPERT},
 
 #ifndef GPAC_DISABLE_STREAMING
 	{ OFFS(reorder_pck), "number of packets delay for RTP reordering (M2TS over RTP) ", GF_PROP_UINT, "100", NULL, GF_FS_ARG_HINT_ADVANCED},
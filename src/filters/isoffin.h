@@ -70,7 +70,7 @@ typedef struct
 	u32 xps_check;
 	char *catseg;
 	Bool sigfrag;
-	Bool nocrypt, strtxt, nodata;
+	Bool nocrypt, strtxt, nodata, mmap;
 	u32 mstore_purge, mstore_samples, mstore_size;
 
 	//internal
@@ -127,6 +127,12 @@ typedef struct
 	u64 last_min_offset;
 	GF_Err in_error;
 	Bool force_fetch;
+
+	//file is memory-mapped, packets may point to mapped sample data
+	Bool mapped;
+	u32 nb_mapped_pck;
+	//mapped files closed while packets were still pending
+	GF_List *mapped_movs;
 } ISOMReader;
 
 typedef struct
@@ -145,6 +151,8 @@ typedef struct
 	GF_ISOSample *static_sample;
 	GF_ISOSample *sample;
 	u64 sample_data_offset, last_valid_sample_data_offset;
+	//payload of current sample in file mapping, NULL if sample data was copied
+	const u8 *mapped_data;
 	GF_Err last_state;
 	Bool sap_3;
 	GF_ISOSampleRollType sap_4_type;
@@ -142,6 +142,19 @@ static GF_Err isoffin_setup(GF_Filter *filter, ISOMReader *read)
 	if (!read->input_loaded && read->frag_type)
 		read->refresh_fragmented = GF_TRUE;
 
+	//complete local file, switch to file mapping
+	if (read->mmap && !read->start_range && !read->end_range) {
+		prop = read->pid ? gf_filter_pid_get_property(read->pid, GF_PROP_PID_FILE_CACHED) : NULL;
+		if (read->src || (prop && prop->value.boolean)) {
+			e = gf_isom_enable_file_mapping(read->mov);
+			if (e) {
+				GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[IsoMedia] Cannot use file mapping for %s: %s\n", szURL, gf_error_to_string(e) ));
+			} else {
+				read->mapped = GF_TRUE;
+			}
+		}
+	}
+
 	if (read->strtxt)
 		gf_isom_text_set_streaming_mode(read->mov, GF_TRUE);
 
@@ -158,6 +171,39 @@ static void isoffin_delete_channel(ISOMChannel *ch)
 	gf_free(ch);
 }
 
+static void isoffin_mapped_pck_del(GF_Filter *filter, GF_FilterPid *pid, GF_FilterPacket *pck)
+{
+	ISOMReader *read = (ISOMReader *) gf_filter_get_udta(filter);
+	if (!safe_int_dec(&read->nb_mapped_pck) && read->mapped_movs)
+		gf_filter_post_process_task(filter);
+}
+
+static void isoffin_close_mov(ISOMReader *read)
+{
+	if (!read->mov) return;
+	//packets still point to the file mapping, close once they are all released
+	if (read->mapped && read->nb_mapped_pck) {
+		if (!read->mapped_movs) read->mapped_movs = gf_list_new();
+		gf_list_add(read->mapped_movs, read->mov);
+	} else {
+		gf_isom_close(read->mov);
+	}
+	read->mov = NULL;
+	read->mapped = GF_FALSE;
+}
+
+static void isoffin_purge_mapped_movs(ISOMReader *read, Bool force)
+{
+	if (!read->mapped_movs) return;
+	if (read->nb_mapped_pck && !force) return;
+	while (gf_list_count(read->mapped_movs)) {
+		GF_ISOFile *mov = gf_list_pop_back(read->mapped_movs);
+		gf_isom_close(mov);
+	}
+	gf_list_del(read->mapped_movs);
+	read->mapped_movs = NULL;
+}
+
 static void isoffin_disconnect(ISOMReader *read)
 {
 	read->disconnected = GF_TRUE;
@@ -169,8 +215,7 @@ static void isoffin_disconnect(ISOMReader *read)
 		isoffin_delete_channel(ch);
 	}
 
-	if (read->mov) gf_isom_close(read->mov);
-	read->mov = NULL;
+	isoffin_close_mov(read);
 
 	read->pid = NULL;
 }
@@ -252,7 +297,7 @@ static GF_Err isoffin_reconfigure(GF_Filter *filter, ISOMReader *read, const cha
 			}
 		}
 
-		if (read->mov) gf_isom_close(read->mov);
+		isoffin_close_mov(read);
 		e = gf_isom_open_progressive(next_url, read->start_range, read->end_range, read->sigfrag, &read->mov, &read->missing_bytes);
 
 		//init seg not completely downloaded, retry at next packet
@@ -478,6 +523,7 @@ static void isoffin_finalize(GF_Filter *filter)
 
 	if (!read->extern_mov && read->mov) gf_isom_close(read->mov);
 	read->mov = NULL;
+	isoffin_purge_mapped_movs(read, GF_TRUE);
 
 	if (read->mem_blob.data) gf_free(read->mem_blob.data);
 	if (read->mem_url) gf_free(read->mem_url);
@@ -1128,6 +1174,9 @@ static GF_Err isoffin_process(GF_Filter *filter)
 	if (read->in_error)
 		return read->in_error;
 
+	if (read->mapped_movs)
+		isoffin_purge_mapped_movs(read, GF_FALSE);
+
 	if (read->pid) {
 		Bool fetch_input = GF_TRUE;
 
@@ -1310,6 +1359,12 @@ static GF_Err isoffin_process(GF_Filter *filter)
 				if (read->nodata) {
 					pck = gf_filter_pck_new_shared(ch->pid, NULL, ch->sample->dataLength, NULL);
 					if (!pck) return GF_OUT_OF_MEM;
+				} else if (ch->mapped_data) {
+					pck = gf_filter_pck_new_shared(ch->pid, ch->mapped_data, ch->sample->dataLength, isoffin_mapped_pck_del);
+					if (!pck) return GF_OUT_OF_MEM;
+					//mapped memory is read-only
+					gf_filter_pck_set_readonly(pck);
+					safe_int_inc(&read->nb_mapped_pck);
 				} else {
 					pck = gf_filter_pck_new_alloc(ch->pid, ch->sample->dataLength, &data);
 					if (!pck) return GF_OUT_OF_MEM;
@@ -1521,6 +1576,7 @@ static const GF_FilterArgs ISOFFInArgs[] =
 	"- auto: resolves to `keep` for `smode=splix` (dasher mode), `rem` otherwise"
 	, GF_PROP_UINT, "auto", "auto|keep|rem", GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(nodata), "do not load sample data", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(mmap), "memory-map complete local files and dispatch packets pointing to sample data in the mapping when possible", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
@@ -443,6 +443,14 @@ void isor_reader_get_sample(ISOMChannel *ch)
 		if (do_fetch) {
 			if (ch->owner->nodata) {
 				ch->sample = gf_isom_get_sample_info_ex(ch->owner->mov, ch->track, ch->sample_num, &sample_desc_index, &ch->sample_data_offset, ch->static_sample);
+			}
+			//mapped file, try to use payload in file mapping unless we need to inspect it
+			else if (ch->owner->mapped && !ch->check_avc_ps && !ch->check_hevc_ps && !ch->check_vvc_ps && !ch->check_mhas_pl) {
+				ch->sample = gf_isom_get_sample_info_ex(ch->owner->mov, ch->track, ch->sample_num, &sample_desc_index, &ch->sample_data_offset, ch->static_sample);
+				if (ch->sample && gf_isom_get_sample_data_ref(ch->owner->mov, ch->track, sample_desc_index, ch->sample_data_offset, ch->sample, &ch->mapped_data)) {
+					ch->mapped_data = NULL;
+					ch->sample = gf_isom_get_sample_ex(ch->owner->mov, ch->track, ch->sample_num, &sample_desc_index, ch->static_sample, &ch->sample_data_offset);
+				}
 			} else {
 				ch->sample = gf_isom_get_sample_ex(ch->owner->mov, ch->track, ch->sample_num, &sample_desc_index, ch->static_sample, &ch->sample_data_offset);
 			}
@@ -588,6 +596,7 @@ void isor_reader_release_sample(ISOMChannel *ch)
 	if (ch->sample)
 		ch->au_seq_num++;
 	ch->sample = NULL;
+	ch->mapped_data = NULL;
 	ch->sai_buffer_size = 0;
 }
 
@@ -281,6 +281,7 @@ typedef struct
 	Bool forcesync, refrag;
 	u32 itags;
 	Double start;
+	Bool mdatref;
 
 	//internal
 	Bool owns_mov;
@@ -3587,6 +3588,32 @@ GF_FilterSAPType mp4_mux_get_sap(GF_MP4MuxCtx *ctx, GF_FilterPacket *pck)
 	return sap;
 }
 
+//adds sample to the current fragment, keeping its payload in the source packet if ref_pck is set
+static GF_Err mp4_mux_fragment_add_sample(GF_MP4MuxCtx *ctx, TrackWriter *tkw, u32 sample_desc_index, u32 duration, GF_FilterPacket *ref_pck)
+{
+	GF_Err e;
+	if (!ref_pck)
+		return gf_isom_fragment_add_sample(ctx->file, tkw->track_id, &tkw->sample, sample_desc_index, duration, 0, 0, 0);
+
+	//released in mp4_mux_on_data_ref
+	gf_filter_pck_ref(&ref_pck);
+	e = gf_isom_fragment_add_sample_ref(ctx->file, tkw->track_id, &tkw->sample, sample_desc_index, duration, 0, 0, 0, ref_pck);
+	if (e) gf_filter_pck_unref(ref_pck);
+	return e;
+}
+
+static GF_Err mp4_mux_fragment_append_data(GF_MP4MuxCtx *ctx, TrackWriter *tkw, u8 *data, u32 data_size, GF_FilterPacket *ref_pck)
+{
+	GF_Err e;
+	if (!ref_pck)
+		return gf_isom_fragment_append_data(ctx->file, tkw->track_id, data, data_size, 0);
+
+	gf_filter_pck_ref(&ref_pck);
+	e = gf_isom_fragment_append_data_ref(ctx->file, tkw->track_id, data, data_size, 0, ref_pck);
+	if (e) gf_filter_pck_unref(ref_pck);
+	return e;
+}
+
 static GF_Err mp4_mux_process_sample(GF_MP4MuxCtx *ctx, TrackWriter *tkw, GF_FilterPacket *pck, Bool for_fragment)
 {
 	GF_Err e=GF_OK;
@@ -3599,6 +3626,7 @@ static GF_Err mp4_mux_process_sample(GF_MP4MuxCtx *ctx, TrackWriter *tkw, GF_Fil
 	u32 insert_subsample_dsi_size = 0;
 	u32 first_nal_is_audelim = GF_FALSE;
 	u32 sample_desc_index = tkw->stsd_idx;
+	GF_FilterPacket *ref_pck = NULL;
 
 	timescale = gf_filter_pck_get_timescale(pck);
 
@@ -3606,6 +3634,9 @@ static GF_Err mp4_mux_process_sample(GF_MP4MuxCtx *ctx, TrackWriter *tkw, GF_Fil
 	prev_size = tkw->sample.dataLength;
 	tkw->sample.CTS_Offset = 0;
 	tkw->sample.data = (char *)gf_filter_pck_get_data(pck, &tkw->sample.dataLength);
+	//fragment payload written from the source packet, unless the packet must be released quickly
+	if (for_fragment && ctx->mdatref && tkw->sample.data && !gf_filter_pck_is_blocking_ref(pck))
+		ref_pck = pck;
 
 	ctx->update_report = GF_TRUE;
 	ctx->total_bytes_in += tkw->sample.dataLength;
@@ -3770,7 +3801,7 @@ static GF_Err mp4_mux_process_sample(GF_MP4MuxCtx *ctx, TrackWriter *tkw, GF_Fil
 		}
 	} else if (tkw->nb_frames_per_sample && (tkw->nb_samples % tkw->nb_frames_per_sample)) {
 		if (for_fragment) {
-		 	e = gf_isom_fragment_append_data(ctx->file, tkw->track_id, tkw->sample.data, tkw->sample.dataLength, 0);
+		 	e = mp4_mux_fragment_append_data(ctx, tkw, tkw->sample.data, tkw->sample.dataLength, ref_pck);
 		} else {
 			e = gf_isom_append_sample_data(ctx->file, tkw->track_num, tkw->sample.data, tkw->sample.dataLength);
 		}
@@ -3826,11 +3857,11 @@ static GF_Err mp4_mux_process_sample(GF_MP4MuxCtx *ctx, TrackWriter *tkw, GF_Fil
 			}
 
 			if (for_fragment) {
-				e = gf_isom_fragment_add_sample(ctx->file, tkw->track_id, &tkw->sample, sample_desc_index, duration, 0, 0, 0);
+				e = mp4_mux_fragment_add_sample(ctx, tkw, sample_desc_index, duration, au_delim ? ref_pck : NULL);
 				if (!e && au_delim) {
 					e = gf_isom_fragment_append_data(ctx->file, tkw->track_id, inband_xps, inband_xps_size, 0);
 				}
-				if (!e) e = gf_isom_fragment_append_data(ctx->file, tkw->track_id, pck_data, pck_data_len, 0);
+				if (!e) e = mp4_mux_fragment_append_data(ctx, tkw, pck_data, pck_data_len, ref_pck);
 			} else {
 				e = gf_isom_add_sample(ctx->file, tkw->track_num, sample_desc_index, &tkw->sample);
 				if (au_delim && !e) {
@@ -3840,7 +3871,7 @@ static GF_Err mp4_mux_process_sample(GF_MP4MuxCtx *ctx, TrackWriter *tkw, GF_Fil
 			}
 			insert_subsample_dsi_size = inband_xps_size;
 		} else if (for_fragment) {
-			e = gf_isom_fragment_add_sample(ctx->file, tkw->track_id, &tkw->sample, sample_desc_index, duration, 0, 0, 0);
+			e = mp4_mux_fragment_add_sample(ctx, tkw, sample_desc_index, duration, ref_pck);
 		} else {
 			e = gf_isom_add_sample(ctx->file, tkw->track_num, sample_desc_index, &tkw->sample);
 			if (!e && !duration) {
@@ -5874,6 +5905,36 @@ static GF_Err mp4_mux_on_data_patch(void *cbk, u8 *data, u32 block_size, u64 fil
 	return GF_OK;
 }
 
+static void mp4_mux_output_block(GF_MP4MuxCtx *ctx, u32 block_size)
+{
+	gf_filter_pck_set_framing(ctx->dst_pck, !ctx->first_pck_sent, GF_FALSE);
+
+	//set packet prop as string since we may discard the seg_name  packet before this packet is processed
+	if (!ctx->first_pck_sent && ctx->seg_name) {
+		ctx->current_offset = 0;
+		gf_filter_pck_set_property(ctx->dst_pck, GF_PROP_PCK_FILENAME, &PROP_STRING(ctx->seg_name) );
+		gf_filter_pck_set_property(ctx->dst_pck, GF_PROP_PCK_FILENUM, &PROP_UINT(ctx->dash_seg_num_plus_one-1) );
+	}
+	if (ctx->min_cts_plus_one) {
+		u64 orig = ctx->min_cts_plus_one-1;
+		gf_filter_pck_set_cts(ctx->dst_pck, orig);
+		gf_filter_pck_set_duration(ctx->dst_pck, (u32) (ctx->min_cts_next_frag - orig) );
+	}
+
+	if ((ctx->llhls_mode>1) && ctx->fragment_started && !ctx->frag_size && ctx->dst_pck) {
+		ctx->frag_num++;
+		gf_filter_pck_set_property(ctx->dst_pck, GF_PROP_PCK_HLS_FRAG_NUM, &PROP_UINT(ctx->frag_num));
+	}
+	ctx->frag_size += block_size;
+
+	ctx->first_pck_sent = GF_TRUE;
+	ctx->current_size += block_size;
+	//non-frag mode, send right away
+	if (ctx->store<MP4MX_MODE_FRAG) {
+		mp4mux_send_output(ctx);
+	}
+}
+
 static GF_Err mp4_mux_on_data(void *cbk, u8 *data, u32 block_size)
 {
 	GF_Filter *filter = (GF_Filter *) cbk;
@@ -5942,33 +6003,40 @@ static GF_Err mp4_mux_on_data(void *cbk, u8 *data, u32 block_size)
 	if (!ctx->dst_pck) return GF_OUT_OF_MEM;
 
 	memcpy(output, data, block_size);
-	gf_filter_pck_set_framing(ctx->dst_pck, !ctx->first_pck_sent, GF_FALSE);
+	mp4_mux_output_block(ctx, block_size);
+	return GF_OK;
+}
 
-	//set packet prop as string since we may discard the seg_name  packet before this packet is processed
-	if (!ctx->first_pck_sent && ctx->seg_name) {
-		ctx->current_offset = 0;
-		gf_filter_pck_set_property(ctx->dst_pck, GF_PROP_PCK_FILENAME, &PROP_STRING(ctx->seg_name) );
-		gf_filter_pck_set_property(ctx->dst_pck, GF_PROP_PCK_FILENUM, &PROP_UINT(ctx->dash_seg_num_plus_one-1) );
-	}
-	if (ctx->min_cts_plus_one) {
-		u64 orig = ctx->min_cts_plus_one-1;
-		gf_filter_pck_set_cts(ctx->dst_pck, orig);
-		gf_filter_pck_set_duration(ctx->dst_pck, (u32) (ctx->min_cts_next_frag - orig) );
-	}
+static GF_Err mp4_mux_on_data_ref(void *cbk, u8 *data, u32 block_size, void *data_ref)
+{
+	GF_Err e = GF_OK;
+	GF_Filter *filter = (GF_Filter *) cbk;
+	GF_FilterPacket *src_pck = (GF_FilterPacket *) data_ref;
+	GF_MP4MuxCtx *ctx = gf_filter_get_udta(filter);
 
-	if ((ctx->llhls_mode>1) && ctx->fragment_started && !ctx->frag_size && ctx->dst_pck) {
-		ctx->frag_num++;
-		gf_filter_pck_set_property(ctx->dst_pck, GF_PROP_PCK_HLS_FRAG_NUM, &PROP_UINT(ctx->frag_num));
-	}
-	ctx->frag_size += block_size;
+	//NULL data means the payload was copied or discarded, only release the source packet
+	if (data) {
+		//final sidx and temp storage need the data in the output block
+		if (ctx->final_sidx_flush || ctx->store_output) {
+			e = mp4_mux_on_data(cbk, data, block_size);
+		} else {
+			u32 src_size;
+			const u8 *src_data = gf_filter_pck_get_data(src_pck, &src_size);
 
-	ctx->first_pck_sent = GF_TRUE;
-	ctx->current_size += block_size;
-	//non-frag mode, send right away
-	if (ctx->store<MP4MX_MODE_FRAG) {
-		mp4mux_send_output(ctx);
+			ctx->total_bytes_out += block_size;
+			mp4mux_send_output(ctx);
+
+			//output packet shares the payload of the source packet
+			ctx->dst_pck = gf_filter_pck_new_ref(ctx->opid, (u32) (data - src_data), block_size, src_pck);
+			if (!ctx->dst_pck) {
+				e = GF_OUT_OF_MEM;
+			} else {
+				mp4_mux_output_block(ctx, block_size);
+			}
+		}
 	}
-	return GF_OK;
+	gf_filter_pck_unref(src_pck);
+	return e;
 }
 
 void mp4_mux_progress_cbk(void *udta, u64 done, u64 total)
@@ -6006,6 +6074,8 @@ static GF_Err mp4_mux_initialize(GF_Filter *filter)
 		if (!ctx->file) return GF_OUT_OF_MEM;
 
 		gf_isom_set_write_callback(ctx->file, mp4_mux_on_data, mp4_mux_on_data_patch, filter, ctx->block_size);
+		if (ctx->mdatref)
+			gf_isom_set_write_ref_callback(ctx->file, mp4_mux_on_data_ref);
 
 		gf_isom_set_progress_callback(ctx->file, mp4_mux_progress_cbk, filter);
 
@@ -6632,6 +6702,7 @@ static const GF_FilterArgs MP4MuxArgs[] =
 	{ OFFS(trun_inter), "interleave samples in trun based on the temporal level, the lowest level are stored first - this will create as many trun as required", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(truns_first), "store track runs before sample group description and sample encryption information", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(block_size), "target output block size, 0 for default internal value (10k)", GF_PROP_UINT, "10000", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(mdatref), "in fragmented mode, send sample payloads by reference to input packets rather than copying them in output blocks - see filter help", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(boxpatch), "apply box patch before writing", GF_PROP_STRING, NULL, NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(deps), "add samples dependencies information", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(mfra), "enable movie fragment random access when fragmenting (ignored when dashing)", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
@@ -6678,6 +6749,9 @@ GF_FilterRegister MP4MuxRegister = {
 	"- If set to `replace`, SIDX/SSIX size will be estimated based on duration and DASH segment length, and padding will be used in the file __before__ the final SIDX. If input pids have the properties `DSegs` set, this will be as the number of segments.\n"
 	"The `on` and `insert` modes will produce exactly the same file, while the mode `replace` may inject a `free` box before the sidx.\n"
 	"  \n"
+	"The [-mdatref]() option avoids copying sample payloads when fragmenting with moof first: the moof and mdat header are sent in an output packet, followed by one output packet per sample payload referencing the input packet data. "
+	"Payloads are still copied when generating a SIDX (e.g. DASH onDemand), for interleaved track runs and for input packets that must be released quickly (e.g. hardware decoder frames).\n"
+	"  \n"
 	"# Custom boxes\n"
 	"Custom boxes can be specified as box patches:\n"
 	"For movie-level patch, the [-boxpatch]() option of the filter should be used.\n"
@@ -1399,6 +1399,16 @@ static GF_Err tsmux_process(GF_Filter *filter)
 				memcpy(ctx->pack_buffer + 188 * nb_pck_in_pack, ts_pck, 188);
 				nb_pck_in_pack++;
 
+				//fill the rest of the pack with the current run of NULL packets, if any
+				if ((status==GF_M2TS_STATE_PADDING) && (nb_pck_in_pack < ctx->nb_pack)) {
+					u32 nb_null = gf_m2ts_mux_consume_null_packets(ctx->mux, ctx->nb_pack - nb_pck_in_pack);
+					while (nb_null) {
+						memcpy(ctx->pack_buffer + 188 * nb_pck_in_pack, ctx->mux->null_pck, 188);
+						nb_pck_in_pack++;
+						nb_null--;
+					}
+				}
+
 				if (nb_pck_in_pack < ctx->nb_pack)
 					continue;
 
@@ -77,7 +77,7 @@ typedef struct
 	//options
 	char *dst, *user_agent, *ifce, *cache_control, *ext, *mime, *wdir, *cert, *pkey, *reqlog;
 	GF_PropStringList rdirs;
-	Bool close, hold, quit, post, dlist, ice;
+	Bool close, hold, quit, post, dlist, ice, zcopy;
 	u32 port, block_size, maxc, maxp, timeout, hmode, sutc, cors, max_client_errors;
 
 	//internal
@@ -198,6 +198,8 @@ typedef struct __httpout_session
 	Bool is_h2;
 	Bool sub_sess_pending;
 	Bool canceled;
+	//zero-copy sending failed for this session, use regular reads
+	Bool no_zcopy;
 
 	Bool force_destroy;
 } GF_HTTPOutSession;
@@ -940,6 +942,7 @@ static void httpout_sess_io(void *usr_cbk, GF_NETIO_Parameter *parameter)
 	sess->put_in_progress = 0;
 	sess->nb_bytes = 0;
 	sess->upload_type = 0;
+	sess->no_zcopy = GF_FALSE;
 
 	if (parameter->reply==GF_HTTP_DELETE) {
 		no_body = GF_TRUE;
@@ -2242,6 +2245,23 @@ resend:
 		if (to_read > (u64) sess->ctx->block_size)
 			to_read = (u64) sess->ctx->block_size;
 
+		//plain HTTP/1.1 file transfer, send file data directly from disk
+		if (ctx->zcopy && !sess->no_zcopy && !sess->is_h2 && !sess->use_chunk_transfer && !ctx->ssl_ctx && !sess->put_in_progress) {
+			e = gf_sk_send_file(sess->socket, sess->resource, sess->file_pos, (u32) to_read, &read);
+			if (e==GF_NOT_SUPPORTED) {
+				GF_LOG(GF_LOG_DEBUG, GF_LOG_HTTP, ("[HTTPOut] Zero-copy not available for %s, using regular send\n", sess->path));
+				sess->no_zcopy = GF_TRUE;
+				gf_fseek(sess->resource, sess->file_pos, SEEK_SET);
+			} else {
+				sess->last_active_time = gf_sys_clock_high_res();
+				sess->file_pos += read;
+				sess->nb_bytes += read;
+				//may happen when file writing is in progress
+				if ((e==GF_IP_SOCK_WOULD_BLOCK) || (!e && !read)) return;
+				goto send_done;
+			}
+		}
+
 		read = (u32) gf_fread(sess->buffer, (u32) to_read, sess->resource);
 		//may happen when file writing is in progress
 		if (!read) {
@@ -2266,6 +2286,7 @@ resend:
 		sess->file_pos += read;
 		sess->nb_bytes += read;
 
+send_done:
 		if (e) {
 			if (e==GF_IP_CONNECTION_CLOSED) {
 				GF_LOG(GF_LOG_DEBUG, GF_LOG_HTTP, ("[HTTPOut] Connection to %s for %s closed\n", sess->peer_address, sess->path));
@@ -3098,6 +3119,7 @@ static const GF_FilterArgs HTTPOutArgs[] =
 	{ OFFS(cert), "certificate file in PEM format to use for TLS mode", GF_PROP_STRING, NULL, NULL, 0},
 	{ OFFS(pkey), "private key file in PEM format to use for TLS mode", GF_PROP_STRING, NULL, NULL, 0},
 	{ OFFS(block_size), "block size used to read and write TCP socket", GF_PROP_UINT, "10000", NULL, GF_FS_ARG_HINT_ADVANCED},
+	{ OFFS(zcopy), "use zero-copy transfer (sendfile) when sending files from disk over plain HTTP/1.1", GF_PROP_BOOL, "true", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(user_agent), "user agent string, by default solved from GPAC preferences", GF_PROP_STRING, "$GUA", NULL, 0},
 	{ OFFS(close), "close HTTP connection after each request", GF_PROP_BOOL, "false", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(maxc), "maximum number of connections, 0 is unlimited", GF_PROP_UINT, "100", NULL, GF_FS_ARG_HINT_EXPERT},
@@ -29,6 +29,7 @@
 #include <gpac/xml.h>
 #include <gpac/route.h>
 #include <gpac/network.h>
+#include <gpac/internal/reedsolomon.h>
 
 
 enum
@@ -41,7 +42,7 @@ enum
 typedef struct
 {
 	char *dst, *ext, *mime, *ifce, *ip;
-	u32 carousel, first_port, bsid, mtu, splitlct, ttl, brinc, runfor;
+	u32 carousel, first_port, bsid, mtu, splitlct, ttl, brinc, runfor, mmsg, fec;
 	Bool korean, llmode, noreg;
 
 	GF_FilterCapability in_caps[2];
@@ -64,9 +65,19 @@ typedef struct
 	u64 bytes_sent;
 	u8 *lct_buffer;
 
+	//batch emission: LCT packets pending on the same socket
+	GF_SockDatagram *dgrams;
+	u32 nb_dgrams_pending;
+	GF_Socket *dgrams_sock;
+
 	u64 reschedule_us;
 	u32 next_raw_file_toi;
 
+	//FEC: Reed-Solomon symbol size and max source block length, transport object and repair symbols buffer
+	u32 fec_symbol_size, fec_max_sbl;
+	u8 *fec_buf;
+	u32 fec_buf_alloc;
+
 	Bool reporting_on;
 	u64 total_size, total_bytes;
 	Bool total_size_unknown;
@@ -167,6 +178,12 @@ typedef struct
 	u32 pck_dur_at_frame_start;
 
 	u32 bitrate;
+
+	//object data gathered for FEC encoding when object is sent in several packets
+	u8 *fec_data;
+	u32 fec_data_size, fec_data_alloc;
+	//set if the current object could not be gathered for FEC
+	Bool fec_data_error;
 } ROUTEPid;
 
 
@@ -270,6 +287,7 @@ void routeout_remove_pid(ROUTEPid *rpid, Bool is_rem)
 	if (rpid->hld_child_pl_name) gf_free(rpid->hld_child_pl_name);
 	if (rpid->template) gf_free(rpid->template);
 	if (rpid->seg_name) gf_free(rpid->seg_name);
+	if (rpid->fec_data) gf_free(rpid->fec_data);
 
 	if (rpid->current_pck)
 		gf_filter_pck_unref(rpid->current_pck);
@@ -630,7 +648,27 @@ static GF_Err routeout_initialize(GF_Filter *filter)
 		gf_sk_setup_multicast(ctx->sock_atsc_lls, GF_ATSC_MCAST_ADDR, GF_ATSC_MCAST_PORT, 0, GF_FALSE, ctx->ifce);
 	}
 
-	ctx->lct_buffer = gf_malloc(sizeof(u8) * ctx->mtu);
+	if (ctx->mmsg>1) {
+		ctx->dgrams = gf_malloc(sizeof(GF_SockDatagram) * ctx->mmsg);
+		if (!ctx->dgrams) return GF_OUT_OF_MEM;
+		ctx->lct_buffer = gf_malloc(sizeof(u8) * ctx->mtu * ctx->mmsg);
+	} else {
+		ctx->lct_buffer = gf_malloc(sizeof(u8) * ctx->mtu);
+	}
+	if (!ctx->lct_buffer) return GF_OUT_OF_MEM;
+
+	if (ctx->fec) {
+		//repair symbols are sent one per packet, with an LCT header of at most 28 bytes (TOL48 and FEC payload ID)
+		if (ctx->mtu <= 32) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] MTU %u too small for FEC\n", ctx->mtu));
+			return GF_BAD_PARAM;
+		}
+		ctx->fec_symbol_size = MIN(ctx->mtu - 28, 0xFFFF);
+		//leave room in each source block for the requested repair symbols
+		ctx->fec_max_sbl = (GF_RS_ERASURE_MAX_SYMBOLS * 100) / (100 + ctx->fec);
+		if (!ctx->fec_max_sbl) ctx->fec_max_sbl = 1;
+		else if (ctx->fec_max_sbl >= GF_RS_ERASURE_MAX_SYMBOLS) ctx->fec_max_sbl = GF_RS_ERASURE_MAX_SYMBOLS - 1;
+	}
 	ctx->clock_init = gf_sys_clock_high_res();
 	ctx->clock_stats = ctx->clock_init;
 
@@ -658,6 +696,8 @@ static void routeout_finalize(GF_Filter *filter)
 		gf_sk_del(ctx->sock_atsc_lls);
 
 	if (ctx->lct_buffer) gf_free(ctx->lct_buffer);
+	if (ctx->dgrams) gf_free(ctx->dgrams);
+	if (ctx->fec_buf) gf_free(ctx->fec_buf);
 	if (ctx->lls_slt_table) gf_free(ctx->lls_slt_table);
 	if (ctx->lls_time_table) gf_free(ctx->lls_time_table);
 }
@@ -1187,9 +1227,20 @@ static GF_Err routeout_check_service_updates(GF_ROUTEOutCtx *ctx, ROUTEService *
 
 			gf_dynstrcat(&payload_text, temp, NULL);
 
-			gf_dynstrcat(&payload_text,
-					"   </SrcFlow>\n"
-					"  </LS>\n", NULL);
+			gf_dynstrcat(&payload_text, "   </SrcFlow>\n", NULL);
+
+			//repair flow on the same TSI, using RFC 5510 FEC OTI with transfer length signaled per object
+			if (ctx->fec) {
+				snprintf(temp, 1000,
+					"   <RprFlow>\n"
+					"    <FECParameters fecEncodingId=\"5\">\n"
+					"     <FECOTI>00000000000008%02X%04X%04X%04X</FECOTI>\n"
+					"    </FECParameters>\n"
+					"   </RprFlow>\n"
+					, 1, ctx->fec_symbol_size, ctx->fec_max_sbl, GF_RS_ERASURE_MAX_SYMBOLS);
+				gf_dynstrcat(&payload_text, temp, NULL);
+			}
+			gf_dynstrcat(&payload_text, "  </LS>\n", NULL);
 		}
 		gf_dynstrcat(&payload_text, " </RS>\n", NULL);
 	}
@@ -1224,13 +1275,26 @@ static GF_Err routeout_check_service_updates(GF_ROUTEOutCtx *ctx, ROUTEService *
 }
 
 
-u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u32 codepoint, u8 *payload, u32 len, u32 offset, u32 service_id, u32 total_size, u32 offset_in_frame)
+static void routeout_flush_lct(GF_ROUTEOutCtx *ctx)
+{
+	u32 nb_sent;
+	GF_Err e;
+	if (!ctx->nb_dgrams_pending) return;
+	e = gf_sk_send_batch(ctx->dgrams_sock, ctx->dgrams, ctx->nb_dgrams_pending, &nb_sent);
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] Failed to send %u LCT packets: %s\n", ctx->nb_dgrams_pending - nb_sent, gf_error_to_string(e) ));
+	}
+	ctx->nb_dgrams_pending = 0;
+	ctx->dgrams_sock = NULL;
+}
+
+static u32 routeout_lct_send_ex(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u32 codepoint, u8 *payload, u32 len, u32 offset, u32 service_id, u32 total_size, u32 offset_in_frame, Bool is_repair)
 {
 	u32 max_size = ctx->mtu;
 	u32 send_payl_size;
 	u32 hdr_len = 4;
 	u32 hpos;
-	GF_Err e;
+	u8 *lct_buffer = ctx->lct_buffer;
 
 	if (total_size) {
 		//TOL extension
@@ -1238,6 +1302,13 @@ u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u3
 		else hdr_len += 2;
 	}
 
+	if (ctx->dgrams) {
+		//send pending packets if batch is full or if destination changes
+		if (ctx->nb_dgrams_pending && ((ctx->nb_dgrams_pending == ctx->mmsg) || (ctx->dgrams_sock != sock)))
+			routeout_flush_lct(ctx);
+		lct_buffer = ctx->lct_buffer + ctx->nb_dgrams_pending * ctx->mtu;
+	}
+
 	//start offset is not in header
 	send_payl_size = 4 * (hdr_len+1) + len - offset;
 	if (send_payl_size > max_size) {
@@ -1245,21 +1316,28 @@ u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u3
 	} else {
 		send_payl_size = len - offset;
 	}
-	ctx->lct_buffer[0] = 0x12; //V=b0001, C=b00, PSI=b10
-	ctx->lct_buffer[1] = 0xA0; //S=b1, 0=b01, h=b0, res=b00, A=b0, B=X
+	//with FEC, align source packets on symbol boundaries so that a lost packet only loses one symbol
+	if (ctx->fec && !is_repair) {
+		u32 sym_left = ctx->fec_symbol_size - (offset_in_frame % ctx->fec_symbol_size);
+		if (send_payl_size > sym_left) send_payl_size = sym_left;
+	}
+	lct_buffer[0] = 0x12; //V=b0001, C=b00, PSI=b10
+	//repair packet, PSI=b00
+	if (is_repair) lct_buffer[0] = 0x10;
+	lct_buffer[1] = 0xA0; //S=b1, 0=b01, h=b0, res=b00, A=b0, B=X
 	//set close flag only if total_len is known
-	if (total_size && (offset + send_payl_size == len))
-		ctx->lct_buffer[1] |= 1;
+	if (total_size && !is_repair && (offset + send_payl_size == len))
+		lct_buffer[1] |= 1;
 
-	ctx->lct_buffer[2] = hdr_len;
-	ctx->lct_buffer[3] = (u8) codepoint;
+	lct_buffer[2] = hdr_len;
+	lct_buffer[3] = (u8) codepoint;
 	hpos = 4;
 
 #define PUT_U32(_val)\
-	ctx->lct_buffer[hpos] = (_val>>24 & 0xFF);\
-	ctx->lct_buffer[hpos+1] = (_val>>16 & 0xFF);\
-	ctx->lct_buffer[hpos+2] = (_val>>8 & 0xFF);\
-	ctx->lct_buffer[hpos+3] = (_val & 0xFF); \
+	lct_buffer[hpos] = (_val>>24 & 0xFF);\
+	lct_buffer[hpos+1] = (_val>>16 & 0xFF);\
+	lct_buffer[hpos+2] = (_val>>8 & 0xFF);\
+	lct_buffer[hpos+3] = (_val & 0xFF); \
 	hpos+=4;
 
 	//CCI=0
@@ -1270,32 +1348,39 @@ u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u3
 	//total length
 	if (total_size) {
 		if (total_size<=0xFFFFFF) {
-			ctx->lct_buffer[hpos] = GF_LCT_EXT_TOL24;
-			ctx->lct_buffer[hpos+1] = total_size>>16 & 0xFF;
-			ctx->lct_buffer[hpos+2] = total_size>>8 & 0xFF;
-			ctx->lct_buffer[hpos+3] = total_size & 0xFF;
+			lct_buffer[hpos] = GF_LCT_EXT_TOL24;
+			lct_buffer[hpos+1] = total_size>>16 & 0xFF;
+			lct_buffer[hpos+2] = total_size>>8 & 0xFF;
+			lct_buffer[hpos+3] = total_size & 0xFF;
 			hpos+=4;
 		} else {
-			ctx->lct_buffer[hpos] = GF_LCT_EXT_TOL48;
-			ctx->lct_buffer[hpos+1] = 2; //2 x 32 bits for header ext
-			ctx->lct_buffer[hpos+2] = 0;
-			ctx->lct_buffer[hpos+3] = 0;
+			lct_buffer[hpos] = GF_LCT_EXT_TOL48;
+			lct_buffer[hpos+1] = 2; //2 x 32 bits for header ext
+			lct_buffer[hpos+2] = 0;
+			lct_buffer[hpos+3] = 0;
 			hpos+=4;
 			PUT_U32(total_size);
 		}
 	}
 
-	//start_offset
+	//start_offset, or FEC payload ID for repair packets
 	PUT_U32(offset_in_frame);
 
 	assert(send_payl_size+hpos <= ctx->mtu);
 
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] LCT SID %u TSI %u TOI %u size %u (frag %u total %u) offset %u (%u in obj)\n", service_id, tsi, toi, send_payl_size, len, total_size, offset, offset_in_frame));
 
-	memcpy(ctx->lct_buffer + hpos, payload + offset, send_payl_size);
-	e = gf_sk_send(sock, ctx->lct_buffer, send_payl_size + hpos);
-	if (e) {
-		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] Failed to send LCT object TSI %u TOI %u fragment: %s\n", tsi, toi, gf_error_to_string(e) ));
+	memcpy(lct_buffer + hpos, payload + offset, send_payl_size);
+	if (ctx->dgrams) {
+		ctx->dgrams[ctx->nb_dgrams_pending].data = lct_buffer;
+		ctx->dgrams[ctx->nb_dgrams_pending].size = send_payl_size + hpos;
+		ctx->dgrams_sock = sock;
+		ctx->nb_dgrams_pending++;
+	} else {
+		GF_Err e = gf_sk_send(sock, lct_buffer, send_payl_size + hpos);
+		if (e) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] Failed to send LCT object TSI %u TOI %u fragment: %s\n", tsi, toi, gf_error_to_string(e) ));
+		}
 	}
 	//store what we actually sent including header for rate estimation
 	ctx->bytes_sent += send_payl_size + hpos;
@@ -1303,6 +1388,67 @@ u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u3
 	return send_payl_size;
 }
 
+u32 routeout_lct_send(GF_ROUTEOutCtx *ctx, GF_Socket *sock, u32 tsi, u32 toi, u32 codepoint, u8 *payload, u32 len, u32 offset, u32 service_id, u32 total_size, u32 offset_in_frame)
+{
+	return routeout_lct_send_ex(ctx, sock, tsi, toi, codepoint, payload, len, offset, service_id, total_size, offset_in_frame, GF_FALSE);
+}
+
+/*sends Reed-Solomon (RFC 5510) repair packets for an object. The FEC transport object is the object data, zero padding and the object size
+on 4 bytes, split in source blocks as defined in RFC 5052. Each repair packet carries one symbol, with the transport object length as TOL*/
+static void routeout_send_repair(GF_ROUTEOutCtx *ctx, ROUTEService *serv, ROUTEPid *rpid, u32 toi, u32 codepoint, const u8 *data, u32 size)
+{
+	u32 i, b, E, L, nb_syms, N, A_large, A_small, I, first_sym, nb_repair=0;
+	u8 *src[GF_RS_ERASURE_MAX_SYMBOLS], *repair[GF_RS_ERASURE_MAX_SYMBOLS];
+
+	E = ctx->fec_symbol_size;
+	if ((u64) size + 4 + E + (u64) E * GF_RS_ERASURE_MAX_SYMBOLS >= 0xFFFFFFFF) return;
+	nb_syms = (size + 4 + E - 1) / E;
+	L = nb_syms * E;
+	N = (nb_syms + ctx->fec_max_sbl - 1) / ctx->fec_max_sbl;
+	A_large = (nb_syms + N - 1) / N;
+	A_small = nb_syms / N;
+	I = nb_syms - A_small * N;
+
+	//transport object followed by room for the repair symbols of one block
+	if (ctx->fec_buf_alloc < L + E * GF_RS_ERASURE_MAX_SYMBOLS) {
+		u8 *fec_buf = gf_realloc(ctx->fec_buf, L + E * GF_RS_ERASURE_MAX_SYMBOLS);
+		if (!fec_buf) return;
+		ctx->fec_buf = fec_buf;
+		ctx->fec_buf_alloc = L + E * GF_RS_ERASURE_MAX_SYMBOLS;
+	}
+	memcpy(ctx->fec_buf, data, size);
+	memset(ctx->fec_buf + size, 0, L - 4 - size);
+	ctx->fec_buf[L-4] = (size>>24) & 0xFF;
+	ctx->fec_buf[L-3] = (size>>16) & 0xFF;
+	ctx->fec_buf[L-2] = (size>>8) & 0xFF;
+	ctx->fec_buf[L-1] = size & 0xFF;
+
+	first_sym = 0;
+	for (b=0; b<N; b++) {
+		u32 k = (b<I) ? A_large : A_small;
+		u32 nb_rep = (k * ctx->fec + 99) / 100;
+		if (!nb_rep) nb_rep = 1;
+		if (k + nb_rep > GF_RS_ERASURE_MAX_SYMBOLS) nb_rep = GF_RS_ERASURE_MAX_SYMBOLS - k;
+
+		for (i=0; i<k; i++)
+			src[i] = ctx->fec_buf + (first_sym + i) * E;
+		for (i=0; i<nb_rep; i++)
+			repair[i] = ctx->fec_buf + L + i * E;
+		first_sym += k;
+
+		if (gf_rs_erasure_encode(src, k, k, nb_rep, repair, E) != GF_OK) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] Failed to compute repair symbols for TSI %u TOI %u block %u\n", rpid->tsi, toi, b));
+			return;
+		}
+		//FEC payload ID: SBN on 24 bits, ESI on 8 bits
+		for (i=0; i<nb_rep; i++) {
+			routeout_lct_send_ex(ctx, rpid->rlct->sock, rpid->tsi, toi, codepoint, repair[i], E, 0, serv->service_id, L, (b<<8) | (k+i), GF_TRUE);
+		}
+		nb_repair += nb_rep;
+	}
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Sent %u repair symbols for TSI %u TOI %u (%u source symbols in %u blocks)\n", nb_repair, rpid->tsi, toi, nb_syms, N));
+}
+
 static GF_Err routeout_service_send_bundle(GF_ROUTEOutCtx *ctx, ROUTEService *serv)
 {
 	u32 offset = 0;
@@ -1692,6 +1838,8 @@ next_packet:
 					}
 					offset += routeout_lct_send(ctx, rpid->rlct->sock, rpid->tsi, ROUTE_INIT_TOI, codepoint, (u8 *) rpid->init_seg_data, rpid->init_seg_size, offset, serv->service_id, rpid->init_seg_size, offset);
 				}
+				if (ctx->fec)
+					routeout_send_repair(ctx, serv, rpid, ROUTE_INIT_TOI, rpid->init_seg_sent ? 7 : 5, (u8 *) rpid->init_seg_data, rpid->init_seg_size);
 				if (ctx->reporting_on) {
 					ctx->total_size += rpid->init_seg_size;
 					ctx->total_bytes = rpid->init_seg_size;
@@ -1709,6 +1857,8 @@ next_packet:
 				//we use codepoint 1 (NRT - file mode) for subplaylists
 				offset += routeout_lct_send(ctx, rpid->rlct->sock, rpid->tsi, ROUTE_INIT_TOI-1, 1, (u8 *) rpid->hld_child_pl, hls_len, offset, serv->service_id, hls_len, offset);
 			}
+			if (ctx->fec)
+				routeout_send_repair(ctx, serv, rpid, ROUTE_INIT_TOI-1, 1, (u8 *) rpid->hld_child_pl, hls_len);
 			if (ctx->reporting_on) {
 				ctx->total_size += hls_len;
 				ctx->total_bytes = hls_len;
@@ -1756,6 +1906,36 @@ next_packet:
 		assert (rpid->pck_offset <= rpid->pck_size);
 
 		if (rpid->pck_offset == rpid->pck_size) {
+			if (ctx->fec) {
+				u32 codepoint = rpid->raw_file ? rpid->fmtp : 8;
+				//single packet object, protect packet data directly
+				if (!rpid->frag_idx && rpid->full_frame_size) {
+					routeout_send_repair(ctx, serv, rpid, rpid->current_toi, codepoint, rpid->pck_data, rpid->pck_size);
+				}
+				//gather object fragments
+				else {
+					if (!rpid->frag_idx) {
+						rpid->fec_data_size = 0;
+						rpid->fec_data_error = GF_FALSE;
+					}
+					if (!rpid->fec_data_error && (rpid->fec_data_size + rpid->pck_size > rpid->fec_data_alloc)) {
+						u8 *fec_data = gf_realloc(rpid->fec_data, rpid->fec_data_size + rpid->pck_size);
+						if (fec_data) {
+							rpid->fec_data = fec_data;
+							rpid->fec_data_alloc = rpid->fec_data_size + rpid->pck_size;
+						} else {
+							GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] Failed to allocate FEC buffer, no repair symbols for TOI %u\n", rpid->current_toi));
+							rpid->fec_data_error = GF_TRUE;
+						}
+					}
+					if (!rpid->fec_data_error) {
+						memcpy(rpid->fec_data + rpid->fec_data_size, rpid->pck_data, rpid->pck_size);
+						rpid->fec_data_size += rpid->pck_size;
+						if (rpid->full_frame_size)
+							routeout_send_repair(ctx, serv, rpid, rpid->current_toi, codepoint, rpid->fec_data, rpid->fec_data_size);
+					}
+				}
+			}
 			//print fragment push info except if single fragment
 			if (rpid->frag_idx || !rpid->full_frame_size) {
 				GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] pushed fragment %s#%d (%d bytes) in "LLU" us - target push "LLU" us\n", rpid->seg_name, rpid->frag_idx+1, rpid->pck_size, ctx->clock - rpid->clock_at_pck, rpid->current_dur_us));
@@ -2011,6 +2191,9 @@ static GF_Err routeout_process(GF_Filter *filter)
 		}
 	}
 
+	//send pending LCT packets before leaving, sockets may be destroyed before next call
+	routeout_flush_lct(ctx);
+
 	if (all_serv_done) {
 		return e ? e : GF_EOS;
 	}
@@ -2088,6 +2271,7 @@ static const GF_FilterArgs ROUTEOutArgs[] =
 	{ OFFS(ttl), "time-to-live for multicast packets", GF_PROP_UINT, "0", NULL, 0},
 	{ OFFS(bsid), "ID for ATSC broadcast stream", GF_PROP_UINT, "800", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(mtu), "size of LCT MTU in bytes", GF_PROP_UINT, "1472", NULL, 0},
+	{ OFFS(mmsg), "number of LCT packets sent per system call (0 or 1 disables batch emission)", GF_PROP_UINT, "16", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(splitlct), "split mode for LCT channels\n"
 		"- off: all streams are in the same LCT channel\n"
 		"- type: each new stream type results in a new LCT channel\n"
@@ -2099,6 +2283,7 @@ static const GF_FilterArgs ROUTEOutArgs[] =
 	{ OFFS(noreg), "disable rate regulation for media segments, pushing them as fast as received", GF_PROP_BOOL, "false", NULL, GF_ARG_HINT_EXPERT},
 
 	{ OFFS(runfor), "run for the given time in ms", GF_PROP_UINT, "0", NULL, 0},
+	{ OFFS(fec), "percentage of Reed-Solomon repair symbols sent per source block of each object, 0 disables FEC - see filter help", GF_PROP_UINT, "0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
@@ -2147,6 +2332,10 @@ GF_FilterRegister ROUTEOutRegister = {
 		"- otherwise, the first PID found is assigned TSI 10, the second TSI 20 etc ...\n"
 		"\n"
 		"Init segments and HLS subplaylists are sent before each new segment, independently of [-carousel]().\n"
+		"\n"
+		"When [-fec]() is set, Reed-Solomon repair symbols (RFC 5510, FEC encoding ID 5) are sent after each object on the object TSI, and signaled as a repair flow in the S-TSID.\n"
+		"Each object is split in source blocks of symbols of MTU minus 28 bytes, and the number of repair symbols sent for a block is the given percentage of its source symbols.\n"
+		"This allows receivers to recover lost packets without a repair server.\n"
 		"# ATSC 3.0 mode\n"
 		"In this mode, the filter allows multiple service multiplexing, identified through the `ServiceID` property.\n"
 		"By default, a single multicast IP is used for route sessions, each service will be assigned a different port.\n"
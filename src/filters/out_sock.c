@@ -42,7 +42,7 @@ typedef struct
 	Double start, speed;
 	char *dst, *mime, *ext, *ifce;
 	Bool listen;
-	u32 maxc, port, sockbuf, ka, kp, rate, ttl;
+	u32 maxc, port, sockbuf, ka, kp, rate, ttl, mmsg;
 	GF_Fraction pckr, pckd;
 
 	GF_Socket *socket;
@@ -66,8 +66,22 @@ typedef struct
 	GF_FilterPacket *rev_pck;
 	u32 next_pckd_idx, next_pckr_idx;
 	u32 nb_pckd_wnd, nb_pckr_wnd;
+
+	//batch emission for datagram sockets: packets are kept until sent
+	GF_SockDatagram *dgrams;
+	GF_FilterPacket **batch_pcks;
+	u32 nb_batch, batch_sent;
 } GF_SockOutCtx;
 
+static void sockout_reset_batch(GF_SockOutCtx *ctx)
+{
+	u32 i;
+	for (i=0; i<ctx->nb_batch; i++) {
+		gf_filter_pck_unref(ctx->batch_pcks[i]);
+	}
+	ctx->nb_batch = ctx->batch_sent = 0;
+}
+
 
 static GF_Err sockout_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool is_remove)
 {
@@ -75,6 +89,7 @@ static GF_Err sockout_configure_pid(GF_Filter *filter, GF_FilterPid *pid, Bool i
 	GF_SockOutCtx *ctx = (GF_SockOutCtx *) gf_filter_get_udta(filter);
 	if (is_remove) {
 		ctx->pid = NULL;
+		sockout_reset_batch(ctx);
 		gf_sk_del(ctx->socket);
 		ctx->socket = NULL;
 		return GF_OK;
@@ -230,6 +245,16 @@ static GF_Err sockout_initialize(GF_Filter *filter)
 
 	gf_sk_set_buffer_size(ctx->socket, 0, ctx->sockbuf);
 
+	//batch emission for datagram sockets
+	if ((ctx->mmsg>1) && ((sock_type == GF_SOCK_TYPE_UDP)
+#ifdef GPAC_HAS_SOCK_UN
+		|| (sock_type == GF_SOCK_TYPE_UDP_UN)
+#endif
+	)) {
+		ctx->dgrams = gf_malloc(sizeof(GF_SockDatagram) * ctx->mmsg);
+		ctx->batch_pcks = gf_malloc(sizeof(GF_FilterPacket *) * ctx->mmsg);
+		if (!ctx->dgrams || !ctx->batch_pcks) return GF_OUT_OF_MEM;
+	}
 	return GF_OK;
 }
 
@@ -245,6 +270,10 @@ static void sockout_finalize(GF_Filter *filter)
 		gf_list_del(ctx->clients);
 	}
 
+	sockout_reset_batch(ctx);
+	if (ctx->dgrams) gf_free(ctx->dgrams);
+	if (ctx->batch_pcks) gf_free(ctx->batch_pcks);
+
 	if (ctx->socket) gf_sk_del(ctx->socket);
 }
 
@@ -315,6 +344,62 @@ static GF_Err sockout_send_packet(GF_SockOutCtx *ctx, GF_FilterPacket *pck, GF_S
 }
 
 
+static GF_Err sockout_send_batch(GF_SockOutCtx *ctx)
+{
+	u32 i, nb_sent=0;
+	u64 now=0, nb_bytes;
+	GF_Err e;
+
+	nb_bytes = ctx->nb_bytes_sent;
+	for (i=ctx->batch_sent; i<ctx->nb_batch; i++)
+		nb_bytes += ctx->dgrams[i].size;
+	if (ctx->rate && ctx->start_time)
+		now = gf_sys_clock_high_res() - ctx->start_time;
+
+	//gather packets with data, frame interface packets are sent through the regular path
+	while (ctx->nb_batch < ctx->mmsg) {
+		u32 pck_size;
+		const u8 *pck_data;
+		GF_FilterPacket *pck;
+		//check send rate for each packet, the first one was checked by caller
+		if (ctx->rate && ctx->nb_batch && (nb_bytes*8*1000000 > ctx->rate * now))
+			break;
+		pck = gf_filter_pid_get_packet(ctx->pid);
+		if (!pck) break;
+		pck_data = gf_filter_pck_get_data(pck, &pck_size);
+		if (!pck_data) break;
+		nb_bytes += pck_size;
+
+		gf_filter_pck_ref(&pck);
+		ctx->batch_pcks[ctx->nb_batch] = pck;
+		ctx->dgrams[ctx->nb_batch].data = (u8 *) pck_data;
+		ctx->dgrams[ctx->nb_batch].size = pck_size;
+		ctx->nb_batch++;
+		gf_filter_pid_drop_packet(ctx->pid);
+	}
+	if (!ctx->nb_batch) return GF_OK;
+
+	e = gf_sk_send_batch(ctx->socket, ctx->dgrams + ctx->batch_sent, ctx->nb_batch - ctx->batch_sent, &nb_sent);
+	for (i=0; i<nb_sent; i++) {
+		ctx->nb_bytes_sent += ctx->dgrams[ctx->batch_sent + i].size;
+	}
+	ctx->nb_pck_processed += nb_sent;
+	ctx->batch_sent += nb_sent;
+	//retry remaining packets at next call
+	if (e == GF_BUFFER_TOO_SMALL) return GF_OK;
+
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[SockOut] Write error: %s\n", gf_error_to_string(e) ));
+		//packets in error are discarded as done in regular path
+		for (i=ctx->batch_sent; i<ctx->nb_batch; i++) {
+			ctx->nb_bytes_sent += ctx->dgrams[i].size;
+			ctx->nb_pck_processed++;
+		}
+	}
+	sockout_reset_batch(ctx);
+	return GF_OK;
+}
+
 static GF_Err sockout_process(GF_Filter *filter)
 {
 	GF_Err e;
@@ -377,6 +462,16 @@ static GF_Err sockout_process(GF_Filter *filter)
 		return GF_OK;
 	}
 
+	//batch emission, not used when reordering or dropping packets
+	if (ctx->dgrams && !ctx->pckd.den && !ctx->pckr.den) {
+		sockout_send_batch(ctx);
+		//some packets are still pending (socket queue full), retry shortly since no new packet may trigger a call
+		if (ctx->nb_batch) {
+			gf_filter_ask_rt_reschedule(filter, 1000);
+			return GF_OK;
+		}
+	}
+
 	pck = gf_filter_pid_get_packet(ctx->pid);
 	if (!pck) {
 		if (gf_filter_pid_is_eos(ctx->pid)) {
@@ -533,6 +628,7 @@ static const GF_FilterArgs SockOutArgs[] =
 	{ OFFS(pckr), "reverse packet every N - see filter help", GF_PROP_FRACTION, "0/0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(pckd), "drop packet every N - see filter help", GF_PROP_FRACTION, "0/0", NULL, GF_FS_ARG_HINT_EXPERT},
 	{ OFFS(ttl), "multicast TTL", GF_PROP_UINT, "0", "0-127", GF_FS_ARG_HINT_EXPERT},
+	{ OFFS(mmsg), "number of UDP packets sent per system call (0 or 1 disables batch emission)", GF_PROP_UINT, "16", NULL, GF_FS_ARG_HINT_EXPERT},
 	{0}
 };
 
@@ -33,7 +33,7 @@
 typedef struct
 {
 	//opts
-	u32 och, osr, ofmt;
+	u32 och, osr, ofmt, quality;
 
 	//internal
 	GF_FilterPid *ipid, *opid;
@@ -53,6 +53,8 @@ typedef struct
 	Fixed speed;
 	GF_FilterPacket *in_pck;
 	Bool cfg_changed;
+	//mixer still outputs samples after end of stream
+	Bool flushing;
 } GF_ResampleCtx;
 
 
@@ -134,6 +136,7 @@ static GF_Err resample_initialize(GF_Filter *filter)
 	GF_ResampleCtx *ctx = gf_filter_get_udta(filter);
 	ctx->mixer = gf_mixer_new(NULL);
 	if (!ctx->mixer) return GF_OUT_OF_MEM;
+	gf_mixer_set_resample_quality(ctx->mixer, ctx->quality);
 
 	ctx->input_ai.callback = ctx;
 	ctx->input_ai.FetchFrame = resample_fetch_frame;
@@ -262,7 +265,7 @@ static GF_Err resample_process(GF_Filter *filter)
 
 			if (!ctx->in_pck) {
 				if (gf_filter_pid_is_eos(ctx->ipid)) {
-					if (ctx->passthrough || ctx->input_ai.is_eos) {
+					if (ctx->passthrough || (ctx->input_ai.is_eos && !ctx->flushing)) {
 						if (ctx->opid)
 							gf_filter_pid_set_eos(ctx->opid);
 						return GF_EOS;
@@ -319,6 +322,7 @@ static GF_Err resample_process(GF_Filter *filter)
 		written = gf_mixer_get_output(ctx->mixer, output, osize, 0);
 		if (!written) {
 			gf_filter_pck_discard(dstpck);
+			ctx->flushing = GF_FALSE;
 		} else {
 			u32 dur = written / bytes_per_samp;
 			if (written != osize) {
@@ -331,6 +335,8 @@ static GF_Err resample_process(GF_Filter *filter)
 
 			//out_cts is in output time scale ( = freq), increase by the amount of bytes/bps
 			ctx->out_cts_plus_one += dur;
+			//polyphase filter tail may need several flush calls
+			if (!ctx->in_pck) ctx->flushing = GF_TRUE;
 		}
 
 		//still some bytes to use from packet, do not discard
@@ -444,6 +450,11 @@ static const GF_FilterArgs ResamplerArgs[] =
 	{ OFFS(och), "desired number of output audio channels - 0 for auto", GF_PROP_UINT, "0", NULL, 0},
 	{ OFFS(osr), "desired sample rate of output audio - 0 for auto", GF_PROP_UINT, "0", NULL, 0},
 	{ OFFS(ofmt), "desired format of output audio - none for auto", GF_PROP_PCMFMT, "none", NULL, 0},
+	{ OFFS(quality), "resampling quality\n"
+	"- linear: linear interpolation between input samples\n"
+	"- low: polyphase FIR filter, 16 taps\n"
+	"- medium: polyphase FIR filter, 32 taps\n"
+	"- high: polyphase FIR filter, 64 taps", GF_PROP_UINT, "linear", "linear|low|medium|high", GF_FS_ARG_HINT_ADVANCED},
 	{0}
 };
 
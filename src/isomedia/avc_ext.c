@@ -398,6 +398,33 @@ static void nalu_merge_ps(GF_BitStream *ps_bs, Bool rewrite_start_codes, u32 nal
 }
 
 
+//checks if gf_isom_nalu_sample_rewrite would leave the payload untouched, and if so updates the SAP type as done by gf_isom_nalu_sample_rewrite
+Bool gf_isom_nalu_sample_is_untouched(GF_MediaBox *mdia, GF_ISOSample *sample, GF_MPEGVisualSampleEntryBox *entry)
+{
+	u32 track_num;
+	GF_ISOFile *file = mdia->mediaTrack->moov->mov;
+	GF_TrackReferenceTypeBox *scal = NULL;
+
+	if (!entry) return GF_FALSE;
+	if (mdia->mediaTrack->extractor_mode & (GF_ISOM_NALU_EXTRACT_INBAND_PS_FLAG|GF_ISOM_NALU_EXTRACT_ANNEXB_FLAG))
+		return GF_FALSE;
+	//layered or tiled content, samples are aggregated or extractors resolved
+	if (entry->svc_config || entry->mvc_config || entry->lhvc_config)
+		return GF_FALSE;
+	Track_FindRef(mdia->mediaTrack, GF_ISOM_REF_SCAL, &scal);
+	if (scal) return GF_FALSE;
+	track_num = 1 + gf_list_find(mdia->mediaTrack->moov->trackList, mdia->mediaTrack);
+	if ((gf_isom_get_reference_count(file, track_num, GF_ISOM_REF_SABT) > 0) || (gf_isom_get_reference_count(file, track_num, GF_ISOM_REF_TBAS) > 0))
+		return GF_FALSE;
+
+	if (sample->IsRAP < SAP_TYPE_2) {
+		if (mdia->information->sampleTable->no_sync_found || !sample->IsRAP) {
+			sample->IsRAP = is_sample_idr(mdia, sample, entry);
+		}
+	}
+	return GF_TRUE;
+}
+
 GF_Err gf_isom_nalu_sample_rewrite(GF_MediaBox *mdia, GF_ISOSample *sample, u32 sampleNumber, GF_MPEGVisualSampleEntryBox *entry)
 {
 	Bool is_hevc = GF_FALSE;
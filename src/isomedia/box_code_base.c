@@ -378,6 +378,7 @@ void ctts_box_del(GF_Box *s)
 {
 	GF_CompositionOffsetBox *ptr = (GF_CompositionOffsetBox *)s;
 	if (ptr->entries) gf_free(ptr->entries);
+	if (ptr->r_idx_first_sample) gf_free(ptr->r_idx_first_sample);
 	gf_free(ptr);
 }
 
@@ -3553,6 +3554,16 @@ void moof_box_del(GF_Box *s)
 	gf_list_del(ptr->TrackList);
 	if (ptr->PSSHs) gf_list_del(ptr->PSSHs);
 	if (ptr->mdat) gf_free(ptr->mdat);
+	if (ptr->data_refs) {
+		u32 i;
+		//fragment not written, release all payloads
+		for (i=0; i<ptr->nb_data_refs; i++) {
+			GF_FragmentDataRef *dref = &ptr->data_refs[i];
+			if (!dref->ref) gf_free(dref->data);
+			else if (ptr->mov && ptr->mov->on_block_ref) ptr->mov->on_block_ref(ptr->mov->on_block_out_usr_data, NULL, 0, dref->ref);
+		}
+		gf_free(ptr->data_refs);
+	}
 	gf_free(ptr);
 }
 
@@ -5224,6 +5235,7 @@ void stsc_box_del(GF_Box *s)
 	GF_SampleToChunkBox *ptr = (GF_SampleToChunkBox *)s;
 	if (ptr == NULL) return;
 	if (ptr->entries) gf_free(ptr->entries);
+	if (ptr->r_idx_first_sample) gf_free(ptr->r_idx_first_sample);
 	gf_free(ptr);
 }
 
@@ -5764,6 +5776,8 @@ void stts_box_del(GF_Box *s)
 {
 	GF_TimeToSampleBox *ptr = (GF_TimeToSampleBox *)s;
 	if (ptr->entries) gf_free(ptr->entries);
+	if (ptr->r_idx_first_sample) gf_free(ptr->r_idx_first_sample);
+	if (ptr->r_idx_dts) gf_free(ptr->r_idx_dts);
 	gf_free(ptr);
 }
 
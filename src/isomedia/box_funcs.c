@@ -1585,26 +1585,89 @@ void gf_isom_registry_disable(u32 boxCode, Bool disable)
 	}
 }
 
+#define BOX_REG_COUNT	(sizeof(box_registry) / sizeof(struct box_registry_entry))
+//size of the 4CC hash table, power of 2 and at least twice the registry size
+#define BOX_REG_HASH_SIZE	4096
+
+enum
+{
+	BOX_REG_PARENT_ANY = 1,
+	BOX_REG_PARENT_SAMPLE_ENTRY = 1<<1,
+	BOX_REG_PARENT_STSD = 1<<2,
+};
+
+//4CC hash table giving the first registry entry for a given 4CC, 0 if none
+static u16 box_reg_hash[BOX_REG_HASH_SIZE];
+//next registry entry with the same 4CC, 0 if none
+static u16 box_reg_next[BOX_REG_COUNT];
+//BOX_REG_PARENT_* flags precomputed from parents_4cc
+static u8 box_reg_parent_flags[BOX_REG_COUNT];
+
+static GFINLINE u32 box_reg_hash_slot(u32 box_4cc)
+{
+	return ((box_4cc * 2654435761U) >> 20) & (BOX_REG_HASH_SIZE-1);
+}
+
+//called once by gf_sys_init, before any box parsing
+void gf_isom_box_registry_init()
+{
+	u32 i;
+	//entries are inserted in reverse order so that chains are sorted by increasing registry index
+	for (i=BOX_REG_COUNT-1; i>0; i--) {
+		u32 slot = box_reg_hash_slot(box_registry[i].box_4cc);
+		const char *parents = box_registry[i].parents_4cc;
+		u8 flags = 0;
+		if (parents) {
+			if (strstr(parents, "*")) flags |= BOX_REG_PARENT_ANY;
+			if (strstr(parents, "sample_entry")) flags |= BOX_REG_PARENT_SAMPLE_ENTRY;
+			if (strstr(parents, "stsd")) flags |= BOX_REG_PARENT_STSD;
+		}
+		box_reg_parent_flags[i] = flags;
+
+		while (box_reg_hash[slot]) {
+			u32 idx = box_reg_hash[slot];
+			if (box_registry[idx].box_4cc == box_registry[i].box_4cc) break;
+			slot = (slot+1) & (BOX_REG_HASH_SIZE-1);
+		}
+		if (!box_reg_hash[slot] || (box_reg_hash[slot] > i)) {
+			box_reg_next[i] = box_reg_hash[slot];
+			box_reg_hash[slot] = i;
+		}
+	}
+}
+
+static u32 box_reg_first(u32 boxCode)
+{
+	u32 slot = box_reg_hash_slot(boxCode);
+	while (box_reg_hash[slot]) {
+		u32 idx = box_reg_hash[slot];
+		if (box_registry[idx].box_4cc == boxCode) return idx;
+		slot = (slot+1) & (BOX_REG_HASH_SIZE-1);
+	}
+	return 0;
+}
+
 static u32 get_box_reg_idx(u32 boxCode, u32 parent_type, u32 start_from)
 {
-	u32 i=0, count = gf_isom_get_num_supported_boxes();
+	u32 i;
 	const char *parent_name = parent_type ? gf_4cc_to_str(parent_type) : NULL;
 
 	if (!start_from) start_from = 1;
 
-	for (i=start_from; i<count; i++) {
+	//only walk registry entries with the same 4CC
+	for (i=box_reg_first(boxCode); i; i=box_reg_next[i]) {
 		u32 start_par_from;
-		if (box_registry[i].box_4cc != boxCode)
+		if (i < start_from)
 			continue;
 
 		if (!parent_type)
 			return i;
 		if (strstr(box_registry[i].parents_4cc, parent_name) != NULL)
 			return i;
-		if (strstr(box_registry[i].parents_4cc, "*") != NULL)
+		if (box_reg_parent_flags[i] & BOX_REG_PARENT_ANY)
 			return i;
 
-		if (strstr(box_registry[i].parents_4cc, "sample_entry") == NULL)
+		if (! (box_reg_parent_flags[i] & BOX_REG_PARENT_SAMPLE_ENTRY))
 			continue;
 
 		/*parent is a sample entry, check if the parent_type matches a sample entry box (eg its parent must be stsd)*/
@@ -1618,7 +1681,7 @@ static u32 get_box_reg_idx(u32 boxCode, u32 parent_type, u32 start_from)
 			u32 j = get_box_reg_idx(parent_type, 0, start_par_from);
 			if (!j) break;
 			//if parent registry has "stsd" as parent, this is a sample entry
-			if (box_registry[j].parents_4cc && (strstr(box_registry[j].parents_4cc, "stsd") != NULL))
+			if (box_reg_parent_flags[j] & BOX_REG_PARENT_STSD)
 				return i;
 			start_par_from = j+1;
 		}
@@ -28,9 +28,6 @@
 #include <gpac/thread.h>
 
 
-/*File Mapping object, read-only mode on complete files (no download)*/
-//#define GF_ISOM_DATA_FILE_MAPPING 0x02
-
 #ifndef GPAC_DISABLE_ISOM
 
 
@@ -47,11 +44,9 @@ void gf_isom_datamap_del(GF_DataMap *ptr)
 	case GF_ISOM_DATA_MEM:
 		gf_isom_fdm_del((GF_FileDataMap *)ptr);
 		break;
-#if 0
 	case GF_ISOM_DATA_FILE_MAPPING:
 		gf_isom_fmo_del((GF_FileMappingDataMap *)ptr);
 		break;
-#endif
 	default:
 		if (ptr->bs) gf_bs_del(ptr->bs);
 		gf_free(ptr);
@@ -278,10 +273,8 @@ u32 gf_isom_datamap_get_data(GF_DataMap *map, u8 *buffer, u32 bufferLength, u64
 	case GF_ISOM_DATA_MEM:
 		return gf_isom_fdm_get_data((GF_FileDataMap *)map, buffer, bufferLength, Offset);
 
-#if 0
 	case GF_ISOM_DATA_FILE_MAPPING:
 		return gf_isom_fmo_get_data((GF_FileMappingDataMap *)map, buffer, bufferLength, Offset);
-#endif
 
 	default:
 		return 0;
@@ -572,85 +565,66 @@ GF_Err FDM_AddData(GF_FileDataMap *ptr, char *data, u32 dataSize)
 #endif	/*GPAC_DISABLE_ISOM_WRITE*/
 
 
-#if 0 //file mapping disabled
+#if !defined(WIN32) && !defined(_WIN32_WCE) && !defined(__SYMBIAN32__) && !defined(GPAC_CONFIG_EMSCRIPTEN) && !defined(GPAC_DISABLE_FILE_MAPPING)
+#define GPAC_HAS_ISOM_FILE_MAPPING
+#endif
 
-#ifdef WIN32
+#ifdef GPAC_HAS_ISOM_FILE_MAPPING
 
-#include <windows.h>
-#include <winerror.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode)
 {
 	GF_FileMappingDataMap *tmp;
-	HANDLE fileH, fileMapH;
-#ifdef _WIN32_WCE
-	unsigned short sWPath[MAX_PATH];
-#endif
+	struct stat st;
+	void *map;
+	int fd;
 
 	//only in read only
 	if (mode != GF_ISOM_DATA_MAP_READ) return NULL;
-
-	GF_SAFEALLOC(tmp, GF_FileMappingDataMap);
-	if (!tmp) return NULL;
-
-	tmp->type = GF_ISOM_DATA_FILE_MAPPING;
-	tmp->mode = mode;
-	tmp->name = gf_strdup(sPath);
-
-	//
-	//	Open the file
-	//
-#ifdef _WIN32_WCE
-	//convert to WIDE
-	CE_CharToWide((char *)sPath, sWPath);
-
-	fileH = CreateFileForMapping(sWPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
-	                             (FILE_ATTRIBUTE_READONLY | FILE_FLAG_RANDOM_ACCESS), NULL );
-#else
-	fileH = CreateFile(sPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
-	                   (FILE_ATTRIBUTE_READONLY | FILE_FLAG_RANDOM_ACCESS), NULL );
-#endif
-
-
-	if (fileH == INVALID_HANDLE_VALUE) {
-		gf_free(tmp->name);
-		gf_free(tmp);
+	if (!sPath || !strncmp(sPath, "gmem://", 7) || !strncmp(sPath, "gfio://", 7)) return NULL;
+	if (!strnicmp(sPath, "file://", 7)) sPath += 7;
+
+	fd = open(sPath, O_RDONLY);
+	if (fd<0) return NULL;
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode) || !st.st_size
+		//cannot map the complete file in the address space
+		|| ((u64) st.st_size > (u64) (size_t) -1)
+	) {
+		close(fd);
 		return NULL;
 	}
-
-	tmp->file_size = GetFileSize(fileH, NULL);
-	if (tmp->file_size == 0xFFFFFFFF) {
-		CloseHandle(fileH);
-		gf_free(tmp->name);
-		gf_free(tmp);
+	map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	//the mapping stays valid once the descriptor is closed
+	close(fd);
+	if (map == MAP_FAILED) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[IsoMedia] Failed to map file %s in memory: %s\n", sPath, gf_errno_str(errno) ));
 		return NULL;
 	}
+#ifdef MADV_SEQUENTIAL
+	//samples are mostly read in file order, enable aggressive read-ahead
+	madvise(map, (size_t) st.st_size, MADV_SEQUENTIAL);
+#endif
 
-	//
-	//	Create the mapping
-	//
-	fileMapH = CreateFileMapping(fileH, NULL, PAGE_READONLY, 0, 0, NULL);
-	if (fileMapH == NULL) {
-		CloseHandle(fileH);
-		gf_free(tmp->name);
-		gf_free(tmp);
+	GF_SAFEALLOC(tmp, GF_FileMappingDataMap);
+	if (!tmp) {
+		munmap(map, (size_t) st.st_size);
 		return NULL;
 	}
-
-	tmp->byte_map = MapViewOfFile(fileMapH, FILE_MAP_READ, 0, 0, 0);
-	if (tmp->byte_map == NULL) {
-		CloseHandle(fileMapH);
-		CloseHandle(fileH);
-		gf_free(tmp->name);
-		gf_free(tmp);
+	tmp->type = GF_ISOM_DATA_FILE_MAPPING;
+	tmp->mode = mode;
+	tmp->name = gf_strdup(sPath);
+	tmp->file_size = (u64) st.st_size;
+	tmp->byte_map = (u8 *) map;
+	//box parsing is done through a bitstream on the mapped memory
+	tmp->bs = gf_bs_new(tmp->byte_map, tmp->file_size, GF_BITSTREAM_READ);
+	if (!tmp->bs) {
+		gf_isom_fmo_del(tmp);
 		return NULL;
 	}
-
-	CloseHandle(fileH);
-	CloseHandle(fileMapH);
-
-	//finaly open our bitstream (from buffer)
-	tmp->bs = gf_bs_new(tmp->byte_map, tmp->file_size, GF_BITSTREAM_READ);
 	return (GF_DataMap *)tmp;
 }
 
@@ -659,40 +633,49 @@ void gf_isom_fmo_del(GF_FileMappingDataMap *ptr)
 	if (!ptr || (ptr->type != GF_ISOM_DATA_FILE_MAPPING)) return;
 
 	if (ptr->bs) gf_bs_del(ptr->bs);
-	if (ptr->byte_map) UnmapViewOfFile(ptr->byte_map);
-	gf_free(ptr->name);
+	if (ptr->byte_map) munmap(ptr->byte_map, (size_t) ptr->file_size);
+	if (ptr->name) gf_free(ptr->name);
 	gf_free(ptr);
 }
 
-
 u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, u8 *buffer, u32 bufferLength, u64 fileOffset)
 {
 	//can we seek till that point ???
-	if (fileOffset > ptr->file_size) return 0;
+	if ((fileOffset > ptr->file_size) || (ptr->file_size - fileOffset < bufferLength)) return 0;
 
 	//we do only read operations, so trivial
 	memcpy(buffer, ptr->byte_map + fileOffset, bufferLength);
+	ptr->curPos = fileOffset + bufferLength;
 	return bufferLength;
 }
 
+const u8 *gf_isom_fmo_get_data_ref(GF_FileMappingDataMap *ptr, u32 size, u64 fileOffset)
+{
+	if ((fileOffset > ptr->file_size) || (ptr->file_size - fileOffset < size)) return NULL;
+	return ptr->byte_map + fileOffset;
+}
+
 #else
 
 GF_DataMap *gf_isom_fmo_new(const char *sPath, u8 mode)
 {
-	return gf_isom_fdm_new(sPath, mode);
+	return NULL;
 }
 
 void gf_isom_fmo_del(GF_FileMappingDataMap *ptr)
 {
-	gf_isom_fdm_del((GF_FileDataMap *)ptr);
 }
 
 u32 gf_isom_fmo_get_data(GF_FileMappingDataMap *ptr, u8 *buffer, u32 bufferLength, u64 fileOffset)
 {
-	return gf_isom_fdm_get_data((GF_FileDataMap *)ptr, buffer, bufferLength, fileOffset);
+	return 0;
+}
+
+const u8 *gf_isom_fmo_get_data_ref(GF_FileMappingDataMap *ptr, u32 size, u64 fileOffset)
+{
+	return NULL;
 }
 
-#endif //win32
-#endif //file mapping disabled
+#endif //GPAC_HAS_ISOM_FILE_MAPPING
 
 #endif /*GPAC_DISABLE_ISOM*/
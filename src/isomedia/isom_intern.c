@@ -390,6 +390,9 @@ static GF_Err gf_isom_parse_movie_boxes_internal(GF_ISOFile *mov, u32 *boxType,
 					if (trak->Media->information->sampleTable->sampleGroups) {
 						convert_compact_sample_groups(trak->Media->information->sampleTable->child_boxes, trak->Media->information->sampleTable->sampleGroups);
 					}
+					//tables are only appended to in read-only mode, use random access indexes
+					if (mov->openMode == GF_ISOM_OPEN_READ)
+						stbl_enable_read_index(trak->Media->information->sampleTable);
 				}
 			}
 
@@ -938,6 +941,17 @@ GF_Err gf_isom_set_write_callback(GF_ISOFile *mov,
 #endif
 }
 
+GF_Err gf_isom_set_write_ref_callback(GF_ISOFile *mov, GF_Err (*on_block_ref)(void *usr_data, u8 *block, u32 block_size, void *data_ref))
+{
+#if !defined(GPAC_DISABLE_ISOM_WRITE) && !defined(GPAC_DISABLE_ISOM_FRAGMENTS)
+	if (!mov->on_block_out) return GF_BAD_PARAM;
+	mov->on_block_ref = on_block_ref;
+	return GF_OK;
+#else
+	return GF_NOT_SUPPORTED;
+#endif
+}
+
 
 u64 gf_isom_get_mp4time()
 {
@@ -493,6 +493,41 @@ GF_Err gf_isom_open_progressive(const char *fileName, u64 start_range, u64 end_r
 	return gf_isom_open_progressive_ex(fileName, start_range, end_range, enable_frag_bounds, the_file, BytesMissing, NULL);
 }
 
+GF_EXPORT
+GF_Err gf_isom_enable_file_mapping(GF_ISOFile *movie)
+{
+	u32 i;
+	GF_DataMap *map;
+	if (!movie || !movie->movieFileMap || !movie->fileName) return GF_BAD_PARAM;
+	if (movie->movieFileMap->type == GF_ISOM_DATA_FILE_MAPPING) return GF_OK;
+	if ((movie->openMode != GF_ISOM_OPEN_READ) || (movie->movieFileMap->type != GF_ISOM_DATA_FILE) || ((GF_FileDataMap *)movie->movieFileMap)->blob)
+		return GF_NOT_SUPPORTED;
+
+	map = gf_isom_fmo_new(movie->fileName, GF_ISOM_DATA_MAP_READ);
+	if (!map) return GF_NOT_SUPPORTED;
+	//file opened on a byte range or size changed since parsing
+	if (gf_bs_get_size(movie->movieFileMap->bs) != ((GF_FileMappingDataMap *)map)->file_size) {
+		gf_isom_datamap_del(map);
+		return GF_NOT_SUPPORTED;
+	}
+	//resume parsing (fragments) at the same place
+	gf_bs_seek(map->bs, gf_bs_get_position(movie->movieFileMap->bs));
+	map->szName = movie->movieFileMap->szName;
+	movie->movieFileMap->szName = NULL;
+
+	//self-contained tracks use the movie file map as data handler
+	if (movie->moov) {
+		for (i=0; i<gf_list_count(movie->moov->trackList); i++) {
+			GF_TrackBox *trak = (GF_TrackBox *)gf_list_get(movie->moov->trackList, i);
+			if (trak->Media && trak->Media->information && (trak->Media->information->dataHandler == movie->movieFileMap))
+				trak->Media->information->dataHandler = map;
+		}
+	}
+	gf_isom_datamap_del(movie->movieFileMap);
+	movie->movieFileMap = map;
+	return GF_OK;
+}
+
 /**************************************************************
 					File Reading
 **************************************************************/
@@ -2023,6 +2058,66 @@ GF_ISOSample *gf_isom_get_sample_info(GF_ISOFile *the_file, u32 trackNumber, u32
 	return gf_isom_get_sample_info_ex(the_file, trackNumber, sampleNumber, sampleDescriptionIndex, data_offset, NULL);
 }
 
+GF_EXPORT
+GF_Err gf_isom_get_sample_data_ref(GF_ISOFile *the_file, u32 trackNumber, u32 sampleDescriptionIndex, u64 data_offset, GF_ISOSample *sample, const u8 **data)
+{
+	GF_Err e;
+	GF_TrackBox *trak;
+	GF_MediaBox *mdia;
+	GF_SampleEntryBox *entry;
+	u32 dataRefIndex;
+	const u8 *ptr;
+
+	if (!data || !sample) return GF_BAD_PARAM;
+	*data = NULL;
+	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	if (!trak) return GF_BAD_PARAM;
+	if (!the_file->movieFileMap || (the_file->movieFileMap->type != GF_ISOM_DATA_FILE_MAPPING))
+		return GF_NOT_SUPPORTED;
+	//sample offsets are not offsets in the mapped file, or payload needs padding
+	if (trak->moov->compressed_diff || the_file->read_byte_offset || the_file->bytes_removed || trak->padding_bytes)
+		return GF_NOT_SUPPORTED;
+	if (!sample->dataLength)
+		return GF_NOT_SUPPORTED;
+
+	mdia = trak->Media;
+	e = Media_GetSampleDesc(mdia, sampleDescriptionIndex, &entry, &dataRefIndex);
+	if (e) return e;
+	if (!entry) return GF_ISOM_INVALID_FILE;
+
+	//same as Media_GetSample in read mode, and only use self-contained data
+	if (!mdia->information->dataHandler) {
+		e = gf_isom_datamap_open(mdia, dataRefIndex, GF_FALSE);
+		if (e) return e;
+		mdia->information->dataEntryIndex = dataRefIndex;
+	}
+	if (mdia->information->dataHandler != the_file->movieFileMap)
+		return GF_NOT_SUPPORTED;
+
+	ptr = gf_isom_fmo_get_data_ref((GF_FileMappingDataMap *) the_file->movieFileMap, sample->dataLength, data_offset);
+	if (!ptr) return GF_IO_ERR;
+
+	//same rewrite rules as Media_GetSample
+	if (mdia->handler->handlerType == GF_ISOM_MEDIA_OD) {
+		if (!the_file->disable_odf_translate) return GF_NOT_SUPPORTED;
+	}
+	else if (gf_isom_is_nalu_based_entry(mdia, entry) && !gf_isom_is_encrypted_entry(entry->type)) {
+		GF_ISOSample ref_samp = *sample;
+		//SAP detection only reads the payload
+		ref_samp.data = (u8 *) ptr;
+		if (!gf_isom_nalu_sample_is_untouched(mdia, &ref_samp, (GF_MPEGVisualSampleEntryBox *)entry))
+			return GF_NOT_SUPPORTED;
+		sample->IsRAP = ref_samp.IsRAP;
+	}
+	else if (the_file->convert_streaming_text
+		&& ((mdia->handler->handlerType == GF_ISOM_MEDIA_TEXT) || (mdia->handler->handlerType == GF_ISOM_MEDIA_SCENE) || (mdia->handler->handlerType == GF_ISOM_MEDIA_SUBT))
+	) {
+		return GF_NOT_SUPPORTED;
+	}
+	*data = ptr;
+	return GF_OK;
+}
+
 
 //get sample dts
 GF_EXPORT
@@ -3065,6 +3160,9 @@ GF_Err gf_isom_purge_samples(GF_ISOFile *the_file, u32 trackNumber, u32 nb_sampl
 	trex = the_file->moov->mvex ? GetTrex(the_file->moov, gf_isom_get_track_id(the_file,trackNumber) ) : NULL;
 	if (!trex) return GF_BAD_PARAM;
 
+	//tables are edited, reset random access indexes
+	stbl_reset_read_index(trak->Media->information->sampleTable);
+
 	//first unpack chunk offsets and CTS
 	e = stbl_UnpackOffsets(trak->Media->information->sampleTable);
 	if (e) return e;
@@ -3108,6 +3206,8 @@ static void gf_isom_recreate_tables(GF_TrackBox *trak)
 	GF_Box *a;
 	GF_SampleTableBox *stbl = trak->Media->information->sampleTable;
 
+	stbl_reset_read_index(stbl);
+
 	if (stbl->ChunkOffset) {
 		if (stbl->ChunkOffset->type==GF_ISOM_BOX_TYPE_CO64) {
 			GF_ChunkLargeOffsetBox *co64 = (GF_ChunkLargeOffsetBox *)stbl->ChunkOffset;
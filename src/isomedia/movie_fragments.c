@@ -480,6 +480,72 @@ escape_size:
 	}
 }
 
+/*writes all payloads kept by reference, dispatching them through the callback when the bitstream allows it*/
+static GF_Err moof_write_data_refs(GF_ISOFile *movie, GF_MovieFragmentBox *moof, GF_BitStream *bs)
+{
+	u32 i;
+	GF_Err e = GF_OK;
+	for (i=0; i<moof->nb_data_refs; i++) {
+		GF_FragmentDataRef *dref = &moof->data_refs[i];
+		if (!dref->ref) {
+			gf_bs_write_data(bs, dref->data, dref->size);
+			gf_free(dref->data);
+		}
+		//not dispatching (memory bitstream or sidx rewrite pending), copy the payload
+		else if (e || gf_bs_forward_external(bs, dref->size)) {
+			gf_bs_write_data(bs, dref->data, dref->size);
+			movie->on_block_ref(movie->on_block_out_usr_data, NULL, 0, dref->ref);
+		} else {
+			e = movie->on_block_ref(movie->on_block_out_usr_data, dref->data, dref->size, dref->ref);
+		}
+	}
+	moof->nb_data_refs = 0;
+	moof->data_refs_size = 0;
+	return e;
+}
+
+/*stores payload in the current fragment by reference, or as a copy if no reference is given*/
+static GF_Err moof_add_data_ref(GF_MovieFragmentBox *moof, u8 *data, u32 size, void *data_ref)
+{
+	GF_FragmentDataRef *dref = moof->nb_data_refs ? &moof->data_refs[moof->nb_data_refs-1] : NULL;
+
+	//append to previous copy
+	if (!data_ref && dref && !dref->ref) {
+		dref->data = gf_realloc(dref->data, dref->size + size);
+		if (!dref->data) return GF_OUT_OF_MEM;
+		memcpy(dref->data + dref->size, data, size);
+		dref->size += size;
+		moof->data_refs_size += size;
+		return GF_OK;
+	}
+	if (moof->nb_data_refs == moof->alloc_data_refs) {
+		moof->alloc_data_refs = moof->alloc_data_refs ? 2*moof->alloc_data_refs : 50;
+		moof->data_refs = gf_realloc(moof->data_refs, sizeof(GF_FragmentDataRef) * moof->alloc_data_refs);
+		if (!moof->data_refs) return GF_OUT_OF_MEM;
+	}
+	dref = &moof->data_refs[moof->nb_data_refs];
+	dref->ref = data_ref;
+	if (data_ref) {
+		dref->data = data;
+	} else {
+		dref->data = gf_malloc(size);
+		if (!dref->data) return GF_OUT_OF_MEM;
+		memcpy(dref->data, data, size);
+	}
+	dref->size = size;
+	moof->nb_data_refs++;
+	moof->data_refs_size += size;
+	return GF_OK;
+}
+
+/*stops using references in the current fragment, writing pending payloads in the mdat bitstream*/
+static GF_Err moof_drop_data_refs(GF_ISOFile *movie)
+{
+	if (!movie->moof || !movie->moof->use_data_refs) return GF_OK;
+	movie->moof->use_data_refs = GF_FALSE;
+	return moof_write_data_refs(movie, movie->moof, movie->editFileMap->bs);
+}
+
 GF_EXPORT
 GF_Err gf_isom_set_fragment_option(GF_ISOFile *movie, GF_ISOTrackID TrackID, GF_ISOTrackFragmentOption Code, u32 Param)
 {
@@ -504,6 +570,8 @@ GF_Err gf_isom_set_fragment_option(GF_ISOFile *movie, GF_ISOTrackID TrackID, GF_
 		if (!traf) return GF_BAD_PARAM;
 		//don't cache only one sample ...
 		traf->DataCache = Param > 1 ? Param : 0;
+		//cached runs are written in the mdat bitstream when storing
+		if (traf->DataCache) return moof_drop_data_refs(movie);
 		break;
 	case GF_ISOM_TFHD_FORCE_MOOF_BASE_OFFSET:
 		movie->force_moof_base_offset = Param;
@@ -527,7 +595,7 @@ GF_Err gf_isom_set_fragment_option(GF_ISOFile *movie, GF_ISOTrackID TrackID, GF_
 			traf->force_new_trun = 1;
 			traf->interleave_id = Param;
 		}
-		break;
+		return moof_drop_data_refs(movie);
 	case GF_ISOM_TRAF_TRUNS_FIRST:
 		traf = gf_isom_get_traf(movie, TrackID);
 		if (!traf) return GF_BAD_PARAM;
@@ -1043,12 +1111,14 @@ static GF_Err StoreFragment(GF_ISOFile *movie, Bool load_mdat_only, s32 data_off
 
 		//we assume we never write large MDATs in fragment mode which should always be true
 		movie->moof->mdat_size = (u32) (pos - movie->moof->fragment_offset);
+		//payloads kept by reference are not in the bitstream
+		mdat_size = movie->moof->mdat_size + movie->moof->data_refs_size;
 
 		if (movie->segment_bs) {
 			e = gf_bs_seek(bs, 0);
 			if (e) return e;
 			/*write mdat size*/
-			gf_bs_write_u32(bs, (u32) movie->moof->mdat_size);
+			gf_bs_write_u32(bs, mdat_size);
 			/*and get internal buffer*/
 			e = gf_bs_seek(bs, movie->moof->mdat_size);
 			if (e) return e;
@@ -1061,7 +1131,7 @@ static GF_Err StoreFragment(GF_ISOFile *movie, Bool load_mdat_only, s32 data_off
 			e = gf_bs_seek(bs, frag_offset);
 			if (e) return e;
 			/*write mdat size*/
-			gf_bs_write_u32(bs, (u32) movie->moof->mdat_size);
+			gf_bs_write_u32(bs, mdat_size);
 
 			movie->moof->mdat = (char*)gf_malloc(sizeof(char) * movie->moof->mdat_size);
 			if (!movie->moof->mdat) return GF_OUT_OF_MEM;
@@ -1090,7 +1160,7 @@ static GF_Err StoreFragment(GF_ISOFile *movie, Bool load_mdat_only, s32 data_off
 		if (e) return e;
 		//we assume we never write large MDATs in fragment mode which should always be true
 		mdat_size = (u32) (moof_start - movie->moof->fragment_offset);
-		gf_bs_write_u32(bs, (u32) mdat_size);
+		gf_bs_write_u32(bs, mdat_size + movie->moof->data_refs_size);
 		gf_bs_write_u32(bs, GF_ISOM_BOX_TYPE_MDAT);
 		e = gf_bs_seek(bs, moof_start);
 		if (e) return e;
@@ -1218,6 +1288,11 @@ static GF_Err StoreFragment(GF_ISOFile *movie, Bool load_mdat_only, s32 data_off
 		gf_bs_write_data(bs, buffer, mdat_size);
 		gf_free(buffer);
 	}
+	//and payloads kept by reference
+	if (movie->moof->nb_data_refs) {
+		e = moof_write_data_refs(movie, movie->moof, bs);
+		if (e) return e;
+	}
 
 	if (bs != bs_orig) {
 		u64 frag_size = gf_bs_get_position(bs);
@@ -2443,6 +2518,12 @@ GF_Err gf_isom_start_fragment(GF_ISOFile *movie, GF_ISOStartFragmentFlags flags)
 	/*remember segment offset*/
 	movie->moof->fragment_offset = gf_bs_get_position(movie->editFileMap->bs);
 
+	/*payloads may be kept by reference if dispatched after the moof*/
+	if (moof_first && movie->on_block_out && movie->on_block_ref) {
+		movie->moof->use_data_refs = GF_TRUE;
+		movie->moof->mov = movie;
+	}
+
 	/*prepare MDAT*/
 	gf_bs_write_u32(movie->editFileMap->bs, 0);
 	gf_bs_write_u32(movie->editFileMap->bs, GF_ISOM_BOX_TYPE_MDAT);
@@ -2595,9 +2676,14 @@ u32 GetRunSize(GF_TrackFragmentRunBox *trun)
 	return size;
 }
 
-GF_EXPORT
-GF_Err gf_isom_fragment_add_sample(GF_ISOFile *movie, GF_ISOTrackID TrackID, const GF_ISOSample *sample, u32 DescIndex,
-                                   u32 Duration, u8 PaddingBits, u16 DegradationPriority, Bool redundant_coding)
+/*position of the next payload byte in the current fragment, including payloads kept by reference*/
+static u64 moof_get_data_pos(GF_ISOFile *movie)
+{
+	return gf_bs_get_position(movie->editFileMap->bs) + movie->moof->data_refs_size;
+}
+
+static GF_Err fragment_add_sample(GF_ISOFile *movie, GF_ISOTrackID TrackID, const GF_ISOSample *sample, u32 DescIndex,
+                                   u32 Duration, u8 PaddingBits, u16 DegradationPriority, Bool redundant_coding, void *data_ref)
 {
 	u32 count, buffer_size;
 	u8 *buffer;
@@ -2617,7 +2703,7 @@ GF_Err gf_isom_fragment_add_sample(GF_ISOFile *movie, GF_ISOTrackID TrackID, con
 	if (!traf->tfhd->sample_desc_index)
 		traf->tfhd->sample_desc_index = DescIndex ? DescIndex : traf->trex->def_sample_desc_index;
 
-	pos = gf_bs_get_position(movie->editFileMap->bs);
+	pos = moof_get_data_pos(movie);
 
 
 	//WARNING: we change stream description, create a new TRAF
@@ -2659,7 +2745,7 @@ GF_Err gf_isom_fragment_add_sample(GF_ISOFile *movie, GF_ISOTrackID TrackID, con
 		traf = traf_2;
 	}
 
-	pos = gf_bs_get_position(movie->editFileMap->bs);
+	pos = moof_get_data_pos(movie);
 	//check if we need a new trun entry
 	count = (traf->use_sample_interleave && traf->force_new_trun) ? 0 : gf_list_count(traf->TrackRuns);
 	if (count) {
@@ -2755,7 +2841,15 @@ GF_Err gf_isom_fragment_add_sample(GF_ISOFile *movie, GF_ISOTrackID TrackID, con
 	}
 
 	//finally write the data
-	if (sample->dataLength) {
+	if (sample->dataLength && movie->moof->use_data_refs) {
+		//rewritten OD frames are copied
+		GF_Err e = moof_add_data_ref(movie->moof, sample->data, sample->dataLength, od_sample ? NULL : data_ref);
+		if (e) {
+			if (od_sample) gf_isom_sample_del(&od_sample);
+			return e;
+		}
+		if (!od_sample) data_ref = NULL;
+	} else if (sample->dataLength) {
 		if (!traf->DataCache) {
 			if (!gf_bs_write_data(movie->editFileMap->bs, sample->data, sample->dataLength)) {
 				GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[iso fragment] Could not add a sample with a size of %u bytes (no DataCache)\n", sample->dataLength));
@@ -2771,6 +2865,8 @@ GF_Err gf_isom_fragment_add_sample(GF_ISOFile *movie, GF_ISOTrackID TrackID, con
 		}
 	}
 	if (od_sample) gf_isom_sample_del(&od_sample);
+	//payload copied, release reference
+	if (data_ref) movie->on_block_ref(movie->on_block_out_usr_data, NULL, 0, data_ref);
 
 	if (traf->trex->tfra) {
 		GF_RandomAccessEntry *raf;
@@ -2785,6 +2881,21 @@ GF_Err gf_isom_fragment_add_sample(GF_ISOFile *movie, GF_ISOTrackID TrackID, con
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_isom_fragment_add_sample(GF_ISOFile *movie, GF_ISOTrackID TrackID, const GF_ISOSample *sample, u32 DescIndex,
+                                   u32 Duration, u8 PaddingBits, u16 DegradationPriority, Bool redundant_coding)
+{
+	return fragment_add_sample(movie, TrackID, sample, DescIndex, Duration, PaddingBits, DegradationPriority, redundant_coding, NULL);
+}
+
+GF_EXPORT
+GF_Err gf_isom_fragment_add_sample_ref(GF_ISOFile *movie, GF_ISOTrackID TrackID, const GF_ISOSample *sample, u32 DescIndex,
+                                   u32 Duration, u8 PaddingBits, u16 DegradationPriority, Bool redundant_coding, void *data_ref)
+{
+	if (data_ref && !movie->on_block_ref) return GF_BAD_PARAM;
+	return fragment_add_sample(movie, TrackID, sample, DescIndex, Duration, PaddingBits, DegradationPriority, redundant_coding, data_ref);
+}
+
 GF_EXPORT
 GF_Err gf_isom_fragment_set_cenc_sai(GF_ISOFile *output, GF_ISOTrackID TrackID, u8 *sai_b, u32 sai_b_size, Bool use_subsamples, Bool use_saio_32bit, Bool use_multikey)
 {
@@ -2846,6 +2957,12 @@ GF_Err gf_isom_fragment_set_cenc_sai(GF_ISOFile *output, GF_ISOTrackID TrackID,
 
 GF_EXPORT
 GF_Err gf_isom_fragment_append_data(GF_ISOFile *movie, GF_ISOTrackID TrackID, u8 *data, u32 data_size, u8 PaddingBits)
+{
+	return gf_isom_fragment_append_data_ref(movie, TrackID, data, data_size, PaddingBits, NULL);
+}
+
+GF_EXPORT
+GF_Err gf_isom_fragment_append_data_ref(GF_ISOFile *movie, GF_ISOTrackID TrackID, u8 *data, u32 data_size, u8 PaddingBits, void *data_ref)
 {
 	u32 count;
 	u8 rap;
@@ -2864,6 +2981,7 @@ GF_Err gf_isom_fragment_append_data(GF_ISOFile *movie, GF_ISOTrackID TrackID, u8
 
 	trun = (GF_TrackFragmentRunBox *)gf_list_get(traf->TrackRuns, count-1);
 	if (!trun->nb_samples) return GF_BAD_PARAM;
+	if (data_ref && !movie->on_block_ref) return GF_BAD_PARAM;
 	ent = &trun->samples[trun->nb_samples-1];
 	ent->size += data_size;
 
@@ -2872,13 +2990,17 @@ GF_Err gf_isom_fragment_append_data(GF_ISOFile *movie, GF_ISOTrackID TrackID, u8
 	ent->flags = GF_ISOM_FORMAT_FRAG_FLAGS(PaddingBits, rap, degp);
 
 	//finally write the data
-	if (!traf->DataCache) {
+	if (movie->moof->use_data_refs) {
+		return moof_add_data_ref(movie->moof, data, data_size, data_ref);
+	} else if (!traf->DataCache) {
 		gf_bs_write_data(movie->editFileMap->bs, data, data_size);
 	} else if (trun->cache) {
 		gf_bs_write_data(trun->cache, data, data_size);
 	} else {
 		return GF_BAD_PARAM;
 	}
+	//payload copied, release reference
+	if (data_ref) movie->on_block_ref(movie->on_block_out_usr_data, NULL, 0, data_ref);
 	return GF_OK;
 }
 
@@ -27,6 +27,168 @@
 
 #ifndef GPAC_DISABLE_ISOM
 
+/*random access indexes for stts, ctts and stsc
+
+Each index stores the first sample number (and first DTS for stts) of each table entry, so that
+the entry holding a given sample or time is found by binary search rather than by walking the table
+from the last accessed entry. The result of the search is only used to position the regular read cache,
+so that lookups are otherwise unchanged.
+
+Indexes are built on first random access and only enabled for tables which are not edited. When fragments are
+merged, entries are appended and the sample count of the last entry may grow: indexed values of existing entries
+are still valid, and the index is simply extended from its last entry
+*/
+
+void stbl_enable_read_index(GF_SampleTableBox *stbl)
+{
+	if (!stbl) return;
+	if (stbl->TimeToSample) stbl->TimeToSample->r_idx_enabled = GF_TRUE;
+	if (stbl->CompositionOffset) stbl->CompositionOffset->r_idx_enabled = GF_TRUE;
+	if (stbl->SampleToChunk) stbl->SampleToChunk->r_idx_enabled = GF_TRUE;
+}
+
+void stbl_reset_read_index(GF_SampleTableBox *stbl)
+{
+	if (!stbl) return;
+	if (stbl->TimeToSample) stbl->TimeToSample->r_idx_nb = 0;
+	if (stbl->CompositionOffset) stbl->CompositionOffset->r_idx_nb = 0;
+	if (stbl->SampleToChunk) stbl->SampleToChunk->r_idx_nb = 0;
+}
+
+static Bool stbl_index_alloc(u32 **first_samples, u64 **dts, u32 *alloc_size, u32 nb_entries)
+{
+	if (*alloc_size >= nb_entries) return GF_TRUE;
+	*first_samples = gf_realloc(*first_samples, sizeof(u32) * nb_entries);
+	if (! *first_samples) return GF_FALSE;
+	if (dts) {
+		*dts = gf_realloc(*dts, sizeof(u64) * nb_entries);
+		if (! *dts) return GF_FALSE;
+	}
+	*alloc_size = nb_entries;
+	return GF_TRUE;
+}
+
+//returns the last entry starting at or before the given sample number
+static u32 stbl_index_find_sample(u32 *first_samples, u32 nb_entries, u32 sampleNumber)
+{
+	u32 low = 0, high = nb_entries;
+	while (high - low > 1) {
+		u32 mid = (low + high) / 2;
+		if (first_samples[mid] <= sampleNumber) low = mid;
+		else high = mid;
+	}
+	return low;
+}
+
+static Bool stts_update_index(GF_TimeToSampleBox *stts)
+{
+	u32 i;
+	u64 first_sample, dts;
+	if (!stts->r_idx_enabled || (stts->nb_entries < 2)) return GF_FALSE;
+	//table was reset
+	if (stts->r_idx_nb > stts->nb_entries) stts->r_idx_nb = 0;
+	if (stts->r_idx_nb == stts->nb_entries) return GF_TRUE;
+
+	if (!stbl_index_alloc(&stts->r_idx_first_sample, &stts->r_idx_dts, &stts->r_idx_alloc, stts->nb_entries)) {
+		stts->r_idx_enabled = GF_FALSE;
+		stts->r_idx_nb = stts->r_idx_alloc = 0;
+		return GF_FALSE;
+	}
+	i = stts->r_idx_nb;
+	if (i) {
+		first_sample = stts->r_idx_first_sample[i-1] + (u64) stts->entries[i-1].sampleCount;
+		dts = stts->r_idx_dts[i-1] + (u64) stts->entries[i-1].sampleCount * stts->entries[i-1].sampleDelta;
+	} else {
+		first_sample = 1;
+		dts = 0;
+	}
+	for (; i<stts->nb_entries; i++) {
+		//corrupted table, use regular walk
+		if (first_sample > 0xFFFFFFFFUL) {
+			stts->r_idx_enabled = GF_FALSE;
+			stts->r_idx_nb = 0;
+			return GF_FALSE;
+		}
+		stts->r_idx_first_sample[i] = (u32) first_sample;
+		stts->r_idx_dts[i] = dts;
+		first_sample += stts->entries[i].sampleCount;
+		dts += (u64) stts->entries[i].sampleCount * stts->entries[i].sampleDelta;
+	}
+	stts->r_idx_nb = stts->nb_entries;
+	return GF_TRUE;
+}
+
+static Bool ctts_update_index(GF_CompositionOffsetBox *ctts)
+{
+	u32 i;
+	u64 first_sample;
+	if (!ctts->r_idx_enabled || (ctts->nb_entries < 2)) return GF_FALSE;
+	if (ctts->r_idx_nb > ctts->nb_entries) ctts->r_idx_nb = 0;
+	if (ctts->r_idx_nb == ctts->nb_entries) return GF_TRUE;
+
+	if (!stbl_index_alloc(&ctts->r_idx_first_sample, NULL, &ctts->r_idx_alloc, ctts->nb_entries)) {
+		ctts->r_idx_enabled = GF_FALSE;
+		ctts->r_idx_nb = ctts->r_idx_alloc = 0;
+		return GF_FALSE;
+	}
+	i = ctts->r_idx_nb;
+	first_sample = i ? (ctts->r_idx_first_sample[i-1] + (u64) ctts->entries[i-1].sampleCount) : 1;
+	for (; i<ctts->nb_entries; i++) {
+		if (first_sample > 0xFFFFFFFFUL) {
+			ctts->r_idx_enabled = GF_FALSE;
+			ctts->r_idx_nb = 0;
+			return GF_FALSE;
+		}
+		ctts->r_idx_first_sample[i] = (u32) first_sample;
+		first_sample += ctts->entries[i].sampleCount;
+	}
+	ctts->r_idx_nb = ctts->nb_entries;
+	return GF_TRUE;
+}
+
+static Bool stsc_update_index(GF_SampleToChunkBox *stsc)
+{
+	u32 i;
+	u64 first_sample;
+	if (!stsc->r_idx_enabled || (stsc->nb_entries < 2)) return GF_FALSE;
+	if (stsc->r_idx_nb > stsc->nb_entries) stsc->r_idx_nb = 0;
+	if (stsc->r_idx_nb == stsc->nb_entries) return GF_TRUE;
+
+	if (!stbl_index_alloc(&stsc->r_idx_first_sample, NULL, &stsc->r_idx_alloc, stsc->nb_entries)) {
+		stsc->r_idx_enabled = GF_FALSE;
+		stsc->r_idx_nb = stsc->r_idx_alloc = 0;
+		return GF_FALSE;
+	}
+	i = stsc->r_idx_nb;
+	if (!i) {
+		stsc->r_idx_first_sample[0] = 1;
+		i = 1;
+	}
+	first_sample = stsc->r_idx_first_sample[i-1];
+	for (; i<stsc->nb_entries; i++) {
+		//number of chunks in previous entry, as computed by GetGhostNum for all entries but the last one
+		GF_StscEntry *ent = &stsc->entries[i-1];
+		u32 nb_chunks;
+		if (ent->nextChunk) {
+			nb_chunks = (ent->nextChunk > ent->firstChunk) ? (ent->nextChunk - ent->firstChunk) : 1;
+		} else if (stsc->entries[i].firstChunk >= ent->firstChunk) {
+			nb_chunks = stsc->entries[i].firstChunk - ent->firstChunk;
+		} else {
+			nb_chunks = 0xFFFFFFFF;
+		}
+		first_sample += (u64) nb_chunks * ent->samplesPerChunk;
+		//corrupted table, use regular walk
+		if ((nb_chunks == 0xFFFFFFFF) || (first_sample > 0xFFFFFFFFUL)) {
+			stsc->r_idx_enabled = GF_FALSE;
+			stsc->r_idx_nb = 0;
+			return GF_FALSE;
+		}
+		stsc->r_idx_first_sample[i] = (u32) first_sample;
+	}
+	stsc->r_idx_nb = stsc->nb_entries;
+	return GF_TRUE;
+}
+
 //Get the sample number
 GF_Err stbl_findEntryForTime(GF_SampleTableBox *stbl, u64 DTS, u8 useCTS, u32 *sampleNumber, u32 *prevSampleNumber)
 {
@@ -44,6 +206,26 @@ GF_Err stbl_findEntryForTime(GF_SampleTableBox *stbl, u64 DTS, u8 useCTS, u32 *s
 	if (!stbl->CompositionOffset) useCTS = 0;
 #endif
 
+	//move the cache to the last entry starting before the desired time if the time is not in the cached entry
+	if (stts_update_index(stbl->TimeToSample)) {
+		GF_TimeToSampleBox *stts = stbl->TimeToSample;
+		i = stts->r_currentEntryIndex;
+		if (!stts->r_FirstSampleInEntry || (i >= stts->r_idx_nb) || (DTS < stts->r_CurrentDTS)
+			|| ((i+1 < stts->r_idx_nb) && (stts->r_idx_dts[i+1] < DTS))
+		) {
+			u32 low = 0, high = stts->r_idx_nb;
+			//first entry starting strictly before DTS, in which or after which the sample is found
+			while (high - low > 1) {
+				u32 mid = (low + high) / 2;
+				if (stts->r_idx_dts[mid] < DTS) low = mid;
+				else high = mid;
+			}
+			stts->r_currentEntryIndex = low;
+			stts->r_FirstSampleInEntry = stts->r_idx_first_sample[low];
+			stts->r_CurrentDTS = stts->r_idx_dts[low];
+		}
+	}
+
 	//our cache
 	if (stbl->TimeToSample->r_FirstSampleInEntry &&
 	        (DTS >= stbl->TimeToSample->r_CurrentDTS) ) {
@@ -96,11 +278,17 @@ GF_Err stbl_findEntryForTime(GF_SampleTableBox *stbl, u64 DTS, u8 useCTS, u32 *s
 		{
 			CTSOffset = 0;
 		}
-		for (j=0; j<ent->sampleCount; j++) {
-			if (curDTS + CTSOffset >= DTS) goto entry_found;
-			curSampNum += 1;
-			curDTS += ent->sampleDelta;
+		//locate the sample in the entry, CTSOffset is always 0 here
+		if (ent->sampleCount && (curDTS + (u64) ent->sampleDelta * (ent->sampleCount - 1) >= DTS)) {
+			if ((curDTS < DTS) && ent->sampleDelta) {
+				j = (u32) ((DTS - curDTS + ent->sampleDelta - 1) / ent->sampleDelta);
+				curSampNum += j;
+				curDTS += (u64) j * ent->sampleDelta;
+			}
+			goto entry_found;
 		}
+		curSampNum += ent->sampleCount;
+		curDTS += (u64) ent->sampleCount * ent->sampleDelta;
 		//we're switching to the next entry, update the cache!
 		stbl->TimeToSample->r_CurrentDTS += (u64)ent->sampleCount * ent->sampleDelta;
 		stbl->TimeToSample->r_currentEntryIndex += 1;
@@ -155,7 +343,18 @@ GF_Err stbl_GetSampleCTS(GF_CompositionOffsetBox *ctts, u32 SampleNumber, s32 *C
 	//test on SampleNumber is done before
 	if (!ctts || !SampleNumber) return GF_BAD_PARAM;
 
-	if (ctts->r_FirstSampleInEntry && (ctts->r_FirstSampleInEntry < SampleNumber) ) {
+	if (ctts_update_index(ctts)) {
+		i = ctts->r_currentEntryIndex;
+		if (!ctts->r_FirstSampleInEntry || (i >= ctts->r_idx_nb) || (SampleNumber < ctts->r_FirstSampleInEntry)
+			|| ((i+1 < ctts->r_idx_nb) && (ctts->r_idx_first_sample[i+1] <= SampleNumber))
+		) {
+			i = stbl_index_find_sample(ctts->r_idx_first_sample, ctts->r_idx_nb, SampleNumber);
+			ctts->r_currentEntryIndex = i;
+			ctts->r_FirstSampleInEntry = ctts->r_idx_first_sample[i];
+		}
+	}
+
+	if (ctts->r_FirstSampleInEntry && (ctts->r_FirstSampleInEntry <= SampleNumber) ) {
 		i = ctts->r_currentEntryIndex;
 	} else {
 		ctts->r_FirstSampleInEntry = 1;
@@ -188,6 +387,18 @@ GF_Err stbl_GetSampleDTS_and_Duration(GF_TimeToSampleBox *stts, u32 SampleNumber
 	}
 	if (!stts || !SampleNumber) return GF_BAD_PARAM;
 
+	if (stts_update_index(stts)) {
+		i = stts->r_currentEntryIndex;
+		if (!stts->r_FirstSampleInEntry || (i >= stts->r_idx_nb) || (SampleNumber < stts->r_FirstSampleInEntry)
+			|| ((i+1 < stts->r_idx_nb) && (stts->r_idx_first_sample[i+1] <= SampleNumber))
+		) {
+			i = stbl_index_find_sample(stts->r_idx_first_sample, stts->r_idx_nb, SampleNumber);
+			stts->r_currentEntryIndex = i;
+			stts->r_FirstSampleInEntry = stts->r_idx_first_sample[i];
+			stts->r_CurrentDTS = stts->r_idx_dts[i];
+		}
+	}
+
 	ent = NULL;
 	//use our cache
 	count = stts->nb_entries;
@@ -432,6 +643,19 @@ GF_Err stbl_GetSampleInfos(GF_SampleTableBox *stbl, u32 sampleNumber, u64 *offse
 		return GF_OK;
 	}
 
+	if (stsc_update_index(stbl->SampleToChunk)) {
+		GF_SampleToChunkBox *stsc = stbl->SampleToChunk;
+		i = stsc->currentIndex;
+		if (!stsc->firstSampleInCurrentChunk || (i >= stsc->r_idx_nb) || (sampleNumber < stsc->firstSampleInCurrentChunk)
+			|| ((i+1 < stsc->r_idx_nb) && (stsc->r_idx_first_sample[i+1] <= sampleNumber))
+		) {
+			i = stbl_index_find_sample(stsc->r_idx_first_sample, stsc->r_idx_nb, sampleNumber);
+			stsc->currentIndex = i;
+			stsc->currentChunk = 1;
+			stsc->firstSampleInCurrentChunk = stsc->r_idx_first_sample[i];
+		}
+	}
+
 	//check our cache: if desired sample is at or above current cache entry, start from here
 	if (stbl->SampleToChunk->firstSampleInCurrentChunk &&
 	        (stbl->SampleToChunk->firstSampleInCurrentChunk <= sampleNumber)) {
@@ -4843,42 +4843,152 @@ u32 gf_media_nalu_next_start_code_bs(GF_BitStream *bs)
 	return gf_media_nalu_locate_start_code_bs(bs, 0);
 }
 
-GF_EXPORT
-u32 gf_media_nalu_next_start_code(const u8 *data, u32 data_len, u32 *sc_size)
+/*NAL start code and emulation prevention bytes scanning
+
+All these functions only have to look closely at positions where two consecutive zero bytes are found, the rest of the data
+is skipped (and copied if needed) in bulk. Locating the next pair of zero bytes is done using SSE2/AVX2/NEON when available, with
+a scalar fallback giving the exact same result*/
+
+#if defined(WIN32) && !defined(__GNUC__)
+# include <intrin.h>
+# define GPAC_HAS_SSE2
+# define GPAC_HAS_AVX2
+# define NALU_AVX2_TARGET
+#else
+# ifdef __SSE2__
+#  include <emmintrin.h>
+#  define GPAC_HAS_SSE2
+# endif
+# if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  include <immintrin.h>
+#  define GPAC_HAS_AVX2
+#  define NALU_AVX2_TARGET __attribute__((target("avx2")))
+# endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define GPAC_HAS_NEON
+#endif
+
+static GFINLINE u32 nalu_ctz(u32 mask)
 {
-	u32 avail = data_len;
-	const u8 *cur = data;
+#if defined(WIN32) && !defined(__GNUC__)
+	unsigned long idx;
+	_BitScanForward(&idx, mask);
+	return (u32) idx;
+#else
+	return (u32) __builtin_ctz(mask);
+#endif
+}
 
-	while (cur) {
-		u32 v, bpos;
-		u8 *next_zero = memchr(cur, 0, avail);
-		if (!next_zero) return data_len;
+typedef u32 (*nalu_zero_pair_fn)(const u8 *data, u32 pos, u32 size);
 
-		v = 0xffffff00;
-		bpos = (u32)(next_zero - data) + 1;
-		while (1) {
-			u8 cval;
-			if (bpos == (u32)data_len)
-				return data_len;
-
-			cval = data[bpos];
-			v = ((v << 8) & 0xFFFFFF00) | ((u32)cval);
-			bpos++;
-			if (v == 0x00000001) {
+//returns the first position >= pos of a pair of zero bytes, or size if not found
+static u32 nalu_find_zero_pair_c(const u8 *data, u32 pos, u32 size)
+{
+	while (pos + 1 < size) {
+		const u8 *zero = memchr(data + pos, 0, size - pos - 1);
+		if (!zero) return size;
+		pos = (u32) (zero - data);
+		if (!data[pos+1]) return pos;
+		pos += 2;
+	}
+	return size;
+}
+
+#ifdef GPAC_HAS_SSE2
+static u32 nalu_find_zero_pair_sse2(const u8 *data, u32 pos, u32 size)
+{
+	const __m128i zero = _mm_setzero_si128();
+	while (pos + 17 <= size) {
+		__m128i v1 = _mm_loadu_si128((const __m128i *) (data + pos));
+		__m128i v2 = _mm_loadu_si128((const __m128i *) (data + pos + 1));
+		u32 mask = (u32) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(v1, zero), _mm_cmpeq_epi8(v2, zero)));
+		if (mask) return pos + nalu_ctz(mask);
+		pos += 16;
+	}
+	return nalu_find_zero_pair_c(data, pos, size);
+}
+#endif
+
+#ifdef GPAC_HAS_AVX2
+NALU_AVX2_TARGET
+static u32 nalu_find_zero_pair_avx2(const u8 *data, u32 pos, u32 size)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	while (pos + 33 <= size) {
+		__m256i v1 = _mm256_loadu_si256((const __m256i *) (data + pos));
+		__m256i v2 = _mm256_loadu_si256((const __m256i *) (data + pos + 1));
+		u32 mask = (u32) _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(v1, zero), _mm256_cmpeq_epi8(v2, zero)));
+		if (mask) return pos + nalu_ctz(mask);
+		pos += 32;
+	}
+	return nalu_find_zero_pair_c(data, pos, size);
+}
+#endif
+
+#ifdef GPAC_HAS_NEON
+static u32 nalu_find_zero_pair_neon(const u8 *data, u32 pos, u32 size)
+{
+	while (pos + 17 <= size) {
+		uint8x16_t v1 = vld1q_u8(data + pos);
+		uint8x16_t v2 = vld1q_u8(data + pos + 1);
+		uint8x16_t pairs = vandq_u8(vceqq_u8(v1, vdupq_n_u8(0)), vceqq_u8(v2, vdupq_n_u8(0)));
+		uint64x2_t pairs64 = vreinterpretq_u64_u8(pairs);
+		if (vgetq_lane_u64(pairs64, 0) | vgetq_lane_u64(pairs64, 1)) {
+			//locate pair in block using scalar code
+			return nalu_find_zero_pair_c(data, pos, pos + 17);
+		}
+		pos += 16;
+	}
+	return nalu_find_zero_pair_c(data, pos, size);
+}
+#endif
+
+static nalu_zero_pair_fn nalu_get_zero_pair_fn()
+{
+	u32 cpu = gf_sys_get_cpu_features();
+#ifdef GPAC_HAS_AVX2
+	if (cpu & GF_CPU_AVX2) return nalu_find_zero_pair_avx2;
+#endif
+#ifdef GPAC_HAS_SSE2
+	if (cpu & GF_CPU_SSE2) return nalu_find_zero_pair_sse2;
+#endif
+#ifdef GPAC_HAS_NEON
+	if (cpu & GF_CPU_NEON) return nalu_find_zero_pair_neon;
+#endif
+	return nalu_find_zero_pair_c;
+}
+
+GF_EXPORT
+u32 gf_media_nalu_next_start_code(const u8 *data, u32 data_len, u32 *sc_size)
+{
+	u32 pos = 0;
+	nalu_zero_pair_fn find_zero_pair = nalu_get_zero_pair_fn();
+
+	while (pos < data_len) {
+		u32 run_end;
+		u32 run_start = find_zero_pair(data, pos, data_len);
+		if (run_start + 2 >= data_len)
+			return data_len;
+
+		//locate end of zero bytes run
+		run_end = run_start + 2;
+		while ((run_end < data_len) && !data[run_end])
+			run_end++;
+		if (run_end == data_len)
+			return data_len;
+
+		if (data[run_end] == 0x01) {
+			if (run_end - run_start >= 3) {
 				*sc_size = 4;
-				return bpos - 4;
+				return run_end - 3;
 			}
-			else if ((v & 0x00FFFFFF) == 0x00000001) {
-				*sc_size = 3;
-				return bpos - 3;
-			}
-			if (cval)
-				break;
+			*sc_size = 3;
+			return run_end - 2;
 		}
-		if (bpos >= data_len)
-			break;
-		cur = data + bpos;
-		avail = data_len - bpos;
+		pos = run_end + 1;
 	}
 	return data_len;
 }
@@ -4946,12 +5056,19 @@ static void avc_parse_hrd_parameters(GF_BitStream *bs, AVC_HRD *hrd)
 }
 
 /*returns the nal_size without emulation prevention bytes*/
+GF_EXPORT
 u32 gf_media_nalu_emulation_bytes_add_count(u8 *buffer, u32 nal_size)
 {
 	u32 i = 0, emulation_bytes_count = 0;
 	u8 num_zero = 0;
+	nalu_zero_pair_fn find_zero_pair = nalu_get_zero_pair_fn();
 
 	while (i < nal_size) {
+		//no pending zero, skip to next pair of zero bytes
+		if (!num_zero) {
+			i = find_zero_pair(buffer, i, nal_size);
+			if (i >= nal_size) break;
+		}
 		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
 		other than the following sequences shall not occur at any byte-aligned position:
 		\96 0x00000300
@@ -4977,12 +5094,23 @@ u32 gf_media_nalu_emulation_bytes_add_count(u8 *buffer, u32 nal_size)
 	return emulation_bytes_count;
 }
 
+GF_EXPORT
 u32 gf_media_nalu_add_emulation_bytes(const u8 *buffer_src, u8 *buffer_dst, u32 nal_size)
 {
 	u32 i = 0, emulation_bytes_count = 0;
 	u8 num_zero = 0;
+	nalu_zero_pair_fn find_zero_pair = nalu_get_zero_pair_fn();
 
 	while (i < nal_size) {
+		//no pending zero, copy up to next pair of zero bytes
+		if (!num_zero) {
+			u32 next = find_zero_pair(buffer_src, i, nal_size);
+			if (next > i) {
+				memmove(buffer_dst + i + emulation_bytes_count, buffer_src + i, next - i);
+				i = next;
+				if (i >= nal_size) break;
+			}
+		}
 		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
 		other than the following sequences shall not occur at any byte-aligned position:
 		0x00000300
@@ -5011,14 +5139,22 @@ u32 gf_media_nalu_add_emulation_bytes(const u8 *buffer_src, u8 *buffer_dst, u32
 }
 
 /*returns the nal_size without emulation prevention bytes*/
+GF_EXPORT
 u32 gf_media_nalu_emulation_bytes_remove_count(const u8 *buffer, u32 nal_size)
 {
 	u32 i = 0, emulation_bytes_count = 0;
 	u8 num_zero = 0;
+	nalu_zero_pair_fn find_zero_pair;
 	if (!buffer || !nal_size) return 0;
 
+	find_zero_pair = nalu_get_zero_pair_fn();
 	while (i < nal_size)
 	{
+		//no pending zero, skip to next pair of zero bytes
+		if (!num_zero) {
+			i = find_zero_pair(buffer, i, nal_size);
+			if (i >= nal_size) break;
+		}
 		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
 		  other than the following sequences shall not occur at any byte-aligned position:
 		  \96 0x00000300
@@ -5054,9 +5190,19 @@ u32 gf_media_nalu_remove_emulation_bytes(const u8 *buffer_src, u8 *buffer_dst, u
 {
 	u32 i = 0, emulation_bytes_count = 0;
 	u8 num_zero = 0;
+	nalu_zero_pair_fn find_zero_pair = nalu_get_zero_pair_fn();
 
 	while (i < nal_size)
 	{
+		//no pending zero, copy up to next pair of zero bytes
+		if (!num_zero) {
+			u32 next = find_zero_pair(buffer_src, i, nal_size);
+			if (next > i) {
+				memmove(buffer_dst + i - emulation_bytes_count, buffer_src + i, next - i);
+				i = next;
+				if (i >= nal_size) break;
+			}
+		}
 		/*ISO 14496-10: "Within the NAL unit, any four-byte sequence that starts with 0x000003
 		  other than the following sequences shall not occur at any byte-aligned position:
 		  0x00000300
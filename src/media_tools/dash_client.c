@@ -81,11 +81,16 @@ struct __dash_client
 	Bool is_m3u8, is_smooth;
 	Bool split_adaptation_set;
 	GF_DASHLowLatencyMode low_latency_mode;
+	//number of segments queued per group behind the one being fetched, signaled to dash_io for prefetch
+	u32 prefetch_segments;
 	//set when MPD downloading fails. Will resetup DASH live once MPD is sync again
 	Bool in_error;
 
 	u64 mpd_fetch_time;
 	GF_DASHInitialSelectionMode first_select_mode;
+	//manifest update parsing metrics, in microseconds
+	u32 nb_mpd_parsed;
+	u64 mpd_parse_time, mpd_parse_max_time;
 
 	/* MPD downloader*/
 	GF_DASHFileIOSession mpd_dnload;
@@ -2071,6 +2076,8 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 	Bool fetch_only = GF_FALSE;
 	u32 nb_group_unchanged = 0;
 	Bool has_reps_unchanged = GF_FALSE;
+	u32 nb_timeline_entries = 0;
+	u64 parse_start = 0, parse_time = 0;
 
 	//HLS: do not reload the playlist, directly update the reps
 	if (dash->is_m3u8 && !dash->m3u8_reload_master) {
@@ -2224,19 +2231,23 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 
 		/* It means we have to reparse the file ... */
 		/* parse the MPD */
-		mpd_parser = gf_xml_dom_new();
-		e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
-		if (e != GF_OK) {
-			gf_xml_dom_del(mpd_parser);
-			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in XML parsing %s\n", gf_error_to_string(e)));
-			return GF_NON_COMPLIANT_BITSTREAM;
-		}
+		parse_start = gf_sys_clock_high_res();
 		new_mpd = gf_mpd_new();
-		if (dash->is_smooth)
+		if (dash->is_smooth) {
+			mpd_parser = gf_xml_dom_new();
+			e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
+			if (e != GF_OK) {
+				gf_xml_dom_del(mpd_parser);
+				gf_mpd_del(new_mpd);
+				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in XML parsing %s\n", gf_error_to_string(e)));
+				return GF_NON_COMPLIANT_BITSTREAM;
+			}
 			e = gf_mpd_init_smooth_from_dom(gf_xml_dom_get_root(mpd_parser), new_mpd, purl);
-		else
-			e = gf_mpd_init_from_dom(gf_xml_dom_get_root(mpd_parser), new_mpd, purl);
-		gf_xml_dom_del(mpd_parser);
+			gf_xml_dom_del(mpd_parser);
+		} else {
+			e = gf_mpd_init_from_file(local_url, new_mpd, purl, &nb_timeline_entries);
+		}
+		parse_time = gf_sys_clock_high_res() - parse_start;
 		if (e) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in MPD creation %s\n", gf_error_to_string(e)));
 			gf_mpd_del(new_mpd);
@@ -3027,6 +3038,15 @@ exit:
 	dash->last_update_time = gf_sys_clock();
 	dash->mpd_fetch_time = fetch_time;
 
+	if (parse_start) {
+		dash->nb_mpd_parsed++;
+		dash->mpd_parse_time += parse_time;
+		if (dash->mpd_parse_max_time < parse_time) dash->mpd_parse_max_time = parse_time;
+		GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Manifest update parsed in "LLU" us (%d timeline entries), merged in "LLU" us - average parse time "LLU" us max "LLU" us over %d updates\n",
+			parse_time, nb_timeline_entries, gf_sys_clock_high_res() - parse_start - parse_time,
+			dash->mpd_parse_time / dash->nb_mpd_parsed, dash->mpd_parse_max_time, dash->nb_mpd_parsed));
+	}
+
 #ifndef GPAC_DISABLE_LOG
 	if (new_period) {
 		GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Manifest after update:\n"));
@@ -4908,7 +4928,7 @@ GF_Err gf_dash_setup_groups(GF_DashClient *dash)
 		if (group->cache_duration < dash->mpd->min_buffer_time)
 			group->cache_duration = dash->mpd->min_buffer_time;
 
-		group->max_cached_segments = (nb_dependent_rep+1);
+		group->max_cached_segments = (nb_dependent_rep+1) * (1 + dash->prefetch_segments);
 
 		if (!has_dependent_representations)
 			group->base_rep_index_plus_one = 0; // all representations in this group are independent
@@ -5047,8 +5067,8 @@ static GF_Err gf_dash_load_representation_sidx(GF_DASH_Group *group, GF_MPD_Repr
 		e = gf_blob_get(cache_name, &mem_address, &size, NULL);
 		if (e) return e;
 
+		//blob released once parsing is done
 		bs = gf_bs_new(mem_address, size, GF_BITSTREAM_READ);
-        gf_blob_release(cache_name);
 	} else {
 		f = gf_fopen(cache_name, "rb");
 		if (!f) return GF_IO_ERR;
@@ -5076,6 +5096,7 @@ static GF_Err gf_dash_load_representation_sidx(GF_DASH_Group *group, GF_MPD_Repr
 	}
 	gf_bs_del(bs);
 	if (f) gf_fclose(f);
+	else gf_blob_release(cache_name);
 	return e;
 }
 
@@ -5088,12 +5109,14 @@ static GF_Err dash_load_box_type(const char *cache_name, u32 offset, u32 *box_ty
 		u8 *mem_address;
 		e = gf_blob_get(cache_name, &mem_address, &size, NULL);
 		if (e) return e;
-        gf_blob_release(cache_name);
-		if (offset+8 > size)
+		if (offset+8 > size) {
+			gf_blob_release(cache_name);
 			return GF_IO_ERR;
+		}
 		mem_address += offset;
 		*box_size = GF_4CC(mem_address[0], mem_address[1], mem_address[2], mem_address[3]);
 		*box_type = GF_4CC(mem_address[4], mem_address[5], mem_address[6], mem_address[7]);
+		gf_blob_release(cache_name);
 	} else {
 		unsigned char data[4];
 		FILE *f = gf_fopen(cache_name, "rb");
@@ -6679,6 +6702,14 @@ llhls_rety:
 
 	base_group->nb_cached_segments++;
 
+	//segment is queued behind the one being fetched, let the user prefetch it
+	if (dash->prefetch_segments && remote_file && (base_group->nb_cached_segments>1)
+		&& !cache_entry->key_url && !(cache_entry->flags & SEG_FLAG_DISABLED)
+		&& dash->dash_io->prefetch_segment
+	) {
+		dash->dash_io->prefetch_segment(dash->dash_io, cache_entry->url, cache_entry->start_range, cache_entry->end_range, base_group->groups_idx);
+	}
+
 	/* download enhancement representation of this segment*/
 	if ((representation_index != group->max_complementary_rep_index) && rep->playback.enhancement_rep_index_plus_one) {
 		group->active_rep_index = rep->playback.enhancement_rep_index_plus_one - 1;
@@ -7752,26 +7783,45 @@ GF_Err gf_dash_open(GF_DashClient *dash, const char *manifest_url)
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] parsing %s manifest %s\n", dash->is_smooth ? "SmoothStreaming" : "DASH-MPD", local_url));
 
 		/* parse the MPD */
-		mpd_parser = gf_xml_dom_new();
-		e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
-
-		if (sep_cgi) sep_cgi[0] = '?';
-		if (sep_frag) sep_frag[0] = '#';
+		if (dash->is_smooth) {
+			mpd_parser = gf_xml_dom_new();
+			e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
 
-		if (e != GF_OK) {
-			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot connect service: MPD parsing problem %s\n", gf_xml_dom_get_error(mpd_parser) ));
-			gf_xml_dom_del(mpd_parser);
-			dash->dash_io->del(dash->dash_io, dash->mpd_dnload);
-			dash->mpd_dnload = NULL;
-			return GF_URL_ERROR;
-		}
+			if (sep_cgi) sep_cgi[0] = '?';
+			if (sep_frag) sep_frag[0] = '#';
 
-		if (dash->is_smooth) {
+			if (e != GF_OK) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot connect service: MPD parsing problem %s\n", gf_xml_dom_get_error(mpd_parser) ));
+				gf_xml_dom_del(mpd_parser);
+				dash->dash_io->del(dash->dash_io, dash->mpd_dnload);
+				dash->mpd_dnload = NULL;
+				return GF_URL_ERROR;
+			}
 			e = gf_mpd_init_smooth_from_dom(gf_xml_dom_get_root(mpd_parser), dash->mpd, manifest_url);
+			gf_xml_dom_del(mpd_parser);
 		} else {
-			e = gf_mpd_init_from_dom(gf_xml_dom_get_root(mpd_parser), dash->mpd, manifest_url);
+			u32 nb_timeline_entries = 0;
+			u64 parse_time;
+			char *mpd_path = (char *) local_url;
+			//local file path without query and fragment, but the manifest URL must be restored before parsing
+			if (sep_cgi || sep_frag) {
+				mpd_path = gf_strdup(local_url);
+				if (sep_cgi) sep_cgi[0] = '?';
+				if (sep_frag) sep_frag[0] = '#';
+			}
+			parse_time = gf_sys_clock_high_res();
+			e = gf_mpd_init_from_file(mpd_path, dash->mpd, manifest_url, &nb_timeline_entries);
+			parse_time = gf_sys_clock_high_res() - parse_time;
+			if (mpd_path != local_url) gf_free(mpd_path);
+
+			if (e != GF_OK) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot connect service: MPD parsing problem %s\n", gf_error_to_string(e)));
+				dash->dash_io->del(dash->dash_io, dash->mpd_dnload);
+				dash->mpd_dnload = NULL;
+				return GF_URL_ERROR;
+			}
+			GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DASH] Manifest parsed in "LLU" us (%d timeline entries)\n", parse_time, nb_timeline_entries));
 		}
-		gf_xml_dom_del(mpd_parser);
 
 		if (!e && dash->split_adaptation_set)
 			gf_mpd_split_adaptation_sets(dash->mpd);
@@ -9089,6 +9139,12 @@ void gf_dash_set_low_latency_mode(GF_DashClient *dash, GF_DASHLowLatencyMode low
 	dash->low_latency_mode = low_lat_mode;
 }
 
+GF_EXPORT
+void gf_dash_set_segment_prefetch(GF_DashClient *dash, u32 nb_segments)
+{
+	if (dash) dash->prefetch_segments = nb_segments;
+}
+
 
 GF_EXPORT
 void gf_dash_set_user_buffer(GF_DashClient *dash, u32 buffer_time_ms)
@@ -447,6 +447,23 @@ void gf_m2ts_mux_table_update_mpeg4(GF_M2TS_Mux_Stream *stream, u8 table_id, u16
 	/*MPEG-4 tables are input streams for the mux, the bitrate is updated when fetching AUs*/
 }
 
+static void gf_m2ts_stream_set_pck_header(GF_M2TS_Mux_Stream *stream)
+{
+	stream->pck_hdr[0] = 0x47;
+	stream->pck_hdr[1] = (stream->pid >> 8) & 0x1F;
+	stream->pck_hdr[2] = stream->pid & 0xFF;
+}
+
+/*writes TS packet header from the stream template (no error, no priority, no scrambling) and increments the CC*/
+static GFINLINE void gf_m2ts_write_pck_header(GF_M2TS_Mux_Stream *stream, u8 *packet, Bool payload_start, u8 adaptation_field_control)
+{
+	packet[0] = stream->pck_hdr[0];
+	packet[1] = stream->pck_hdr[1] | (payload_start ? 0x40 : 0);
+	packet[2] = stream->pck_hdr[2];
+	packet[3] = (adaptation_field_control << 4) | stream->continuity_counter;
+	stream->continuity_counter = (stream->continuity_counter + 1) & 0xF;
+}
+
 static u32 gf_m2ts_add_adaptation(GF_M2TS_Mux_Program *prog, GF_BitStream *bs, u16 pid,
                                   Bool has_pcr, u64 pcr_time,
                                   Bool is_rap,
@@ -512,7 +529,9 @@ static u32 gf_m2ts_add_adaptation(GF_M2TS_Mux_Program *prog, GF_BitStream *bs, u
 
 void gf_m2ts_mux_table_get_next_packet(GF_M2TS_Mux *mux, GF_M2TS_Mux_Stream *stream, char *packet)
 {
+#ifdef USE_AF_STUFFING
 	GF_BitStream *bs;
+#endif
 	GF_M2TS_Mux_Table *table;
 	GF_M2TS_Mux_Section *section;
 	u32 payload_length, payload_start;
@@ -533,18 +552,6 @@ void gf_m2ts_mux_table_get_next_packet(GF_M2TS_Mux *mux, GF_M2TS_Mux_Stream *str
 	section = stream->current_section;
 	assert(section);
 
-	bs = mux->pck_bs;
-	gf_bs_reassign_buffer(bs, packet, 188);
-
-	gf_bs_write_int(bs,	0x47, 8); // sync
-	gf_bs_write_int(bs,	0, 1);    // error indicator
-	if (stream->current_section_offset == 0) {
-		gf_bs_write_int(bs,	1, 1);    // payload start indicator
-	} else {
-		/* No section concatenation yet!!!*/
-		gf_bs_write_int(bs,	0, 1);    // payload start indicator
-	}
-
 	if (!stream->current_section_offset) payload_length = 183;
 	else payload_length = 184;
 
@@ -580,25 +587,26 @@ void gf_m2ts_mux_table_get_next_packet(GF_M2TS_Mux *mux, GF_M2TS_Mux_Stream *str
 		else stream->continuity_counter--;
 	}
 
-	gf_bs_write_int(bs,	0, 1);    /*priority indicator*/
-	gf_bs_write_int(bs,	stream->pid, 13); /*pid*/
-	gf_bs_write_int(bs,	0, 2);    /*scrambling indicator*/
-	gf_bs_write_int(bs,	adaptation_field_control, 2);    /*we do not use adaptation field for sections */
-	gf_bs_write_int(bs,	stream->continuity_counter, 4);   /*continuity counter*/
-
-	if (stream->continuity_counter < 15) stream->continuity_counter++;
-	else stream->continuity_counter=0;
+	/* No section concatenation yet, payload start is set at section start only*/
+	gf_m2ts_write_pck_header(stream, (u8 *) packet, stream->current_section_offset ? GF_FALSE : GF_TRUE, adaptation_field_control);
 
 #ifdef USE_AF_STUFFING
+	bs = mux->pck_bs;
+	gf_bs_reassign_buffer(bs, packet+4, 184);
 	if (adaptation_field_control != GF_M2TS_ADAPTATION_NONE)
 		gf_m2ts_add_adaptation(stream->program, bs, stream->pid, 0, 0, 0, padding_length, NULL, 0, GF_FALSE);
-#endif
 
 	/*pointer field*/
 	if (!stream->current_section_offset) {
 		/* no concatenations of sections in ts packets, so start address is 0 */
 		gf_bs_write_u8(bs, 0);
 	}
+#else
+	/*pointer field - no concatenations of sections in ts packets, so start address is 0 */
+	if (!stream->current_section_offset) {
+		packet[4] = 0;
+	}
+#endif
 
 	memcpy(packet+188-payload_start, section->data + stream->current_section_offset, payload_length);
 	stream->current_section_offset += payload_length;
@@ -1755,13 +1763,11 @@ u32 gf_m2ts_stream_add_pes_header(GF_BitStream *bs, GF_M2TS_Mux_Stream *stream)
 
 void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 {
-	GF_BitStream *bs;
+	GF_BitStream *bs = NULL;
 	Bool needs_pcr, first_pass;
 	u32 adaptation_field_control, payload_length, payload_to_copy, padding_length, hdr_len, pos, copy_next;
 
 	assert(stream->pid);
-	bs = stream->program->mux->pck_bs;
-	gf_bs_reassign_buffer(bs, packet, 188);
 
 	if (stream->pcr_only_mode) {
 		payload_length = 184 - 8;
@@ -1902,17 +1908,14 @@ void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 		else stream->continuity_counter--;
 	}
 
-	gf_bs_write_int(bs,	0x47, 8); // sync byte
-	gf_bs_write_int(bs,	0, 1);    // error indicator
-	gf_bs_write_int(bs,	hdr_len ? 1 : 0, 1); // start ind
-	gf_bs_write_int(bs,	0, 1);	  // transport priority
-	gf_bs_write_int(bs,	stream->pid, 13); // pid
-	gf_bs_write_int(bs,	0, 2);    // scrambling
-	gf_bs_write_int(bs,	adaptation_field_control, 2);    // we do not use adaptation field for sections
-	gf_bs_write_int(bs,	stream->continuity_counter, 4);   // continuity counter
+	gf_m2ts_write_pck_header(stream, (u8 *) packet, hdr_len ? GF_TRUE : GF_FALSE, adaptation_field_control);
+	pos = 4;
 
-	if (stream->continuity_counter < 15) stream->continuity_counter++;
-	else stream->continuity_counter=0;
+	//adaptation field and/or PES header, use bitstream - other packets only carry payload
+	if ((adaptation_field_control != GF_M2TS_ADAPTATION_NONE) || hdr_len) {
+		bs = stream->program->mux->pck_bs;
+		gf_bs_reassign_buffer(bs, packet+4, 184);
+	}
 
 	if (adaptation_field_control != GF_M2TS_ADAPTATION_NONE) {
 		Bool is_rap = GF_FALSE;
@@ -1972,7 +1975,8 @@ void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 		}
 	}
 
-	pos = (u32) gf_bs_get_position(bs);
+	if ((adaptation_field_control != GF_M2TS_ADAPTATION_NONE) || hdr_len)
+		pos += (u32) gf_bs_get_position(bs);
 
 	if (adaptation_field_control == GF_M2TS_ADAPTATION_ONLY) {
 		return;
@@ -2099,6 +2103,7 @@ GF_M2TS_Mux_Stream *gf_m2ts_stream_new(u32 pid) {
 	}
 	stream->pid = pid;
 	stream->process = gf_m2ts_stream_process_pes;
+	gf_m2ts_stream_set_pck_header(stream);
 
 	return stream;
 }
@@ -2875,19 +2880,24 @@ const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *
 {
 	GF_M2TS_Mux_Program *program;
 	GF_M2TS_Mux_Stream *stream, *stream_to_process;
-	GF_M2TS_Time time, max_time;
+	GF_M2TS_Time time, max_time, next_time;
 	u32 nb_streams, nb_streams_done;
 	u64 now_us;
 	char *ret;
 	u32 res, highest_priority;
 	Bool flush_all_pes = GF_FALSE;
 	Bool check_max_time = GF_FALSE;
+	//in fixed rate non real-time mode, a NULL packet run lasts until the earliest time of streams with data
+	Bool null_run = (muxer->fixed_rate && !muxer->real_time) ? GF_TRUE : GF_FALSE;
 
 	nb_streams = nb_streams_done = 0;
 	*status = GF_M2TS_STATE_IDLE;
 
 	muxer->sap_inserted = GF_FALSE;
 	muxer->last_pid = 0;
+	muxer->null_run_end.sec = muxer->null_run_end.nanosec = 0;
+	next_time.sec = 0xFFFFFFFF;
+	next_time.nanosec = 0;
 
 	now_us = gf_sys_clock_high_res();
 	if (muxer->real_time) {
@@ -2944,6 +2954,8 @@ const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *
 		}
 	}
 
+	if (flush_all_pes) null_run = GF_FALSE;
+
 	if (!flush_all_pes) {
 
 		/*compare PAT and PMT with current mux time
@@ -2962,6 +2974,8 @@ const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *
 			/*force sending the PAT regardless of other streams*/
 			goto send_pck;
 		}
+		if (res && gf_m2ts_time_less(&muxer->pat->time, &next_time))
+			next_time = muxer->pat->time;
 
 		/*SDT*/
 		if (muxer->sdt && !muxer->force_pat_pmt_state) {
@@ -2971,6 +2985,8 @@ const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *
 				stream_to_process = muxer->sdt;
 				goto send_pck;
 			}
+			if (res && gf_m2ts_time_less(&muxer->sdt->time, &next_time))
+				next_time = muxer->sdt->time;
 		}
 
 		/*PMT, for each program*/
@@ -2985,6 +3001,8 @@ const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *
 				/*force sending the PMT regardless of other streams*/
 				goto send_pck;
 			}
+			if (res && gf_m2ts_time_less(&program->pmt->time, &next_time))
+				next_time = program->pmt->time;
 			program = program->next;
 		}
 	}
@@ -3039,7 +3057,17 @@ const u8 *gf_m2ts_mux_process(GF_M2TS_Mux *muxer, GF_M2TSMuxState *status, u32 *
 				if (!flush_all_pes && muxer->force_pat)
 					return gf_m2ts_mux_process(muxer, status, usec_till_next);
 
-				if (res) {
+				if (!res) {
+					//stream waiting for data or pending data not schedulable yet (PCR only mode), its next time is unknown
+					if (!(stream->ifce->caps & GF_ESI_STREAM_IS_OVER) || stream->pck_first
+						|| (stream->curr_pck.data_len && (stream->pck_offset < stream->curr_pck.data_len))
+					) {
+						null_run = GF_FALSE;
+					}
+				} else {
+					if (gf_m2ts_time_less(&stream->time, &next_time))
+						next_time = stream->time;
+
 					/*always schedule the earliest data*/
 					if (gf_m2ts_time_less(&stream->time, &time)) {
 						highest_priority = res;
@@ -3087,6 +3115,8 @@ send_pck:
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MPEG2-TS Muxer] Inserting empty packet at %d:%09d\n", time.sec, time.nanosec));
 			ret = muxer->null_pck;
 			muxer->tot_pad_sent++;
+			if (null_run && (next_time.sec != 0xFFFFFFFF))
+				muxer->null_run_end = next_time;
 		}
 	} else {
 		if (stream_to_process->tables) {
@@ -3143,4 +3173,19 @@ send_pck:
 	return ret;
 }
 
+GF_EXPORT
+u32 gf_m2ts_mux_consume_null_packets(GF_M2TS_Mux *muxer, u32 max_packets)
+{
+	u32 nb_pck = 0;
+	//same as calling gf_m2ts_mux_process until the mux time reaches the next stream time
+	while ((nb_pck < max_packets) && gf_m2ts_time_less(&muxer->time, &muxer->null_run_end)) {
+		muxer->tot_pck_sent++;
+		muxer->tot_pad_sent++;
+		muxer->pck_sent_over_br_window++;
+		gf_m2ts_time_inc(&muxer->time, 1504/*188*8*/, muxer->bit_rate);
+		nb_pck++;
+	}
+	return nb_pck;
+}
+
 #endif /*GPAC_DISABLE_MPEG2TS_MUX*/
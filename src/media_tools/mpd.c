@@ -364,12 +364,45 @@ static void gf_mpd_parse_segment_base_generic(GF_MPD *mpd, GF_MPD_SegmentBase *s
 	}
 }
 
+static void gf_mpd_parse_segment_timeline_entry_att(GF_MPD_SegmentTimelineEntry *seg_tl_ent, const char *name, const char *value)
+{
+	if (!strcmp(name, "t"))
+		seg_tl_ent->start_time = gf_mpd_parse_long_int(value);
+	else if (!strcmp(name, "d"))
+		seg_tl_ent->duration = gf_mpd_parse_int(value);
+	else if (!strcmp(name, "r")) {
+		seg_tl_ent->repeat_count = gf_mpd_parse_int(value);
+		if (seg_tl_ent->repeat_count == (u32)-1)
+			seg_tl_ent->repeat_count--;
+	}
+}
+
+typedef struct
+{
+	GF_XMLNode *node;
+	GF_MPD_SegmentTimeline *timeline;
+} GF_MPD_LoadedTimeline;
+
 static GF_MPD_SegmentTimeline *gf_mpd_parse_segment_timeline(GF_MPD *mpd, GF_XMLNode *root)
 {
 	u32 i, j;
 	GF_XMLAttribute *att;
 	GF_XMLNode *child;
 	GF_MPD_SegmentTimeline *seg;
+
+	//timeline entries already created while loading the file
+	if (mpd->loaded_timelines) {
+		GF_MPD_LoadedTimeline *ltl;
+		i = 0;
+		while ((ltl = gf_list_enum(mpd->loaded_timelines, &i))) {
+			if (ltl->node != root) continue;
+			seg = ltl->timeline;
+			gf_list_rem(mpd->loaded_timelines, i-1);
+			gf_free(ltl);
+			return seg;
+		}
+	}
+
 	GF_SAFEALLOC(seg, GF_MPD_SegmentTimeline);
 	if (!seg) return NULL;
 	seg->entries = gf_list_new();
@@ -385,15 +418,7 @@ static GF_MPD_SegmentTimeline *gf_mpd_parse_segment_timeline(GF_MPD *mpd, GF_XML
 
 			j = 0;
 			while ( (att = gf_list_enum(child->attributes, &j)) ) {
-				if (!strcmp(att->name, "t"))
-					seg_tl_ent->start_time = gf_mpd_parse_long_int(att->value);
-				else if (!strcmp(att->name, "d"))
-					seg_tl_ent->duration = gf_mpd_parse_int(att->value);
-				else if (!strcmp(att->name, "r")) {
-					seg_tl_ent->repeat_count = gf_mpd_parse_int(att->value);
-					if (seg_tl_ent->repeat_count == (u32)-1)
-						seg_tl_ent->repeat_count--;
-				}
+				gf_mpd_parse_segment_timeline_entry_att(seg_tl_ent, att->name, att->value);
 			}
 		}
 	}
@@ -1463,6 +1488,188 @@ GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *default_b
 	return gf_mpd_complete_from_dom(root, mpd, default_base_url);
 }
 
+typedef struct
+{
+	GF_SAXParser *sax;
+	GF_List *stack;
+	GF_XMLNode *root;
+	GF_List *timelines;
+	//timeline receiving S elements, NULL if not in a SegmentTimeline element
+	GF_MPD_SegmentTimeline *timeline;
+	u32 timeline_depth;
+	//depth of nodes ignored in S elements
+	u32 skip_depth;
+	u32 nb_entries;
+	GF_Err e;
+} GF_MPD_Loader;
+
+static void mpd_loader_node_start(void *sax_cbck, const char *name, const char *ns, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	u32 i;
+	GF_XMLNode *node, *parent;
+	GF_MPD_Loader *ldr = (GF_MPD_Loader *)sax_cbck;
+
+	if (ldr->skip_depth) {
+		ldr->skip_depth++;
+		return;
+	}
+	if (ldr->root && !gf_list_count(ldr->stack)) {
+		gf_xml_sax_suspend(ldr->sax, GF_TRUE);
+		return;
+	}
+	parent = gf_list_last(ldr->stack);
+
+	//S elements are directly converted, without creating DOM nodes
+	if (ldr->timeline && (gf_list_count(ldr->stack) == ldr->timeline_depth) && !strcmp(name, "S")
+		&& ((!ns && !parent->ns) || (ns && parent->ns && !strcmp(ns, parent->ns)))
+	) {
+		GF_MPD_SegmentTimelineEntry *seg_tl_ent;
+		ldr->skip_depth = 1;
+		GF_SAFEALLOC(seg_tl_ent, GF_MPD_SegmentTimelineEntry);
+		if (!seg_tl_ent) {
+			ldr->e = GF_OUT_OF_MEM;
+			gf_xml_sax_suspend(ldr->sax, GF_TRUE);
+			return;
+		}
+		gf_list_add(ldr->timeline->entries, seg_tl_ent);
+		for (i=0; i<nb_attributes; i++) {
+			gf_mpd_parse_segment_timeline_entry_att(seg_tl_ent, attributes[i].name, attributes[i].value);
+		}
+		ldr->nb_entries++;
+		return;
+	}
+
+	GF_SAFEALLOC(node, GF_XMLNode);
+	if (!node) {
+		ldr->e = GF_OUT_OF_MEM;
+		gf_xml_sax_suspend(ldr->sax, GF_TRUE);
+		return;
+	}
+	node->attributes = gf_list_new();
+	node->content = gf_list_new();
+	node->name = gf_strdup(name);
+	if (ns) node->ns = gf_strdup(ns);
+	for (i=0; i<nb_attributes; i++) {
+		GF_XMLAttribute *att;
+		GF_SAFEALLOC(att, GF_XMLAttribute);
+		if (!att) {
+			ldr->e = GF_OUT_OF_MEM;
+			gf_xml_sax_suspend(ldr->sax, GF_TRUE);
+			break;
+		}
+		att->name = gf_strdup(attributes[i].name);
+		att->value = gf_strdup(attributes[i].value);
+		gf_list_add(node->attributes, att);
+	}
+	if (parent) gf_list_add(parent->content, node);
+	else ldr->root = node;
+	gf_list_add(ldr->stack, node);
+
+	//only timelines of segment templates and lists are parsed by the MPD loader, others are kept as DOM
+	if (!strcmp(name, "SegmentTimeline") && parent && (!strcmp(parent->name, "SegmentTemplate") || !strcmp(parent->name, "SegmentList"))) {
+		GF_MPD_LoadedTimeline *ltl;
+		GF_SAFEALLOC(ltl, GF_MPD_LoadedTimeline);
+		if (ltl) GF_SAFEALLOC(ltl->timeline, GF_MPD_SegmentTimeline);
+		if (!ltl || !ltl->timeline) {
+			if (ltl) gf_free(ltl);
+			ldr->e = GF_OUT_OF_MEM;
+			gf_xml_sax_suspend(ldr->sax, GF_TRUE);
+			return;
+		}
+		ltl->node = node;
+		ltl->timeline->entries = gf_list_new();
+		gf_list_add(ldr->timelines, ltl);
+		ldr->timeline = ltl->timeline;
+		ldr->timeline_depth = gf_list_count(ldr->stack);
+	}
+}
+
+static void mpd_loader_node_end(void *sax_cbck, const char *name, const char *ns)
+{
+	GF_XMLNode *last;
+	GF_MPD_Loader *ldr = (GF_MPD_Loader *)sax_cbck;
+
+	if (ldr->skip_depth) {
+		ldr->skip_depth--;
+		return;
+	}
+	last = gf_list_pop_back(ldr->stack);
+	if (!last || strcmp(last->name, name) || (!ns && last->ns) || (ns && !last->ns) || (ns && strcmp(last->ns, ns))) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Invalid node stack: closing node is %s but %s was expected\n", name, last ? last->name : "unknown"));
+		ldr->e = GF_NON_COMPLIANT_BITSTREAM;
+		gf_xml_sax_suspend(ldr->sax, GF_TRUE);
+		return;
+	}
+	if (ldr->timeline && (gf_list_count(ldr->stack) + 1 == ldr->timeline_depth)) {
+		ldr->timeline = NULL;
+		ldr->timeline_depth = 0;
+	}
+}
+
+static void mpd_loader_text_content(void *sax_cbck, const char *content, Bool is_cdata)
+{
+	GF_XMLNode *node, *last;
+	GF_MPD_Loader *ldr = (GF_MPD_Loader *)sax_cbck;
+
+	if (ldr->skip_depth) return;
+	last = gf_list_last(ldr->stack);
+	if (!last) return;
+	GF_SAFEALLOC(node, GF_XMLNode);
+	if (!node) {
+		ldr->e = GF_OUT_OF_MEM;
+		gf_xml_sax_suspend(ldr->sax, GF_TRUE);
+		return;
+	}
+	node->type = is_cdata ? GF_XML_CDATA_TYPE : GF_XML_TEXT_TYPE;
+	node->name = gf_strdup(content);
+	gf_list_add(last->content, node);
+}
+
+GF_EXPORT
+GF_Err gf_mpd_init_from_file(const char *file, GF_MPD *mpd, const char *default_base_url, u32 *nb_timeline_entries)
+{
+	GF_Err e;
+	GF_MPD_Loader ldr;
+	if (!file || !mpd) return GF_BAD_PARAM;
+
+	memset(&ldr, 0, sizeof(GF_MPD_Loader));
+	ldr.stack = gf_list_new();
+	ldr.timelines = gf_list_new();
+	ldr.sax = gf_xml_sax_new(mpd_loader_node_start, mpd_loader_node_end, mpd_loader_text_content, &ldr);
+	if (!ldr.stack || !ldr.timelines || !ldr.sax) {
+		e = GF_OUT_OF_MEM;
+	} else {
+		e = gf_xml_sax_parse_file(ldr.sax, file, NULL);
+		if (e>=0) e = ldr.e;
+		if (e<0) {
+			const char *err = gf_xml_sax_get_error(ldr.sax);
+			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Failed to parse %s: %s\n", file, (err && err[0]) ? err : gf_error_to_string(e)));
+		} else if (!ldr.root || gf_list_count(ldr.stack)) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Incomplete XML document %s\n", file));
+			e = GF_NON_COMPLIANT_BITSTREAM;
+		}
+	}
+
+	if (!e) {
+		mpd->loaded_timelines = ldr.timelines;
+		e = gf_mpd_init_from_dom(ldr.root, mpd, default_base_url);
+		mpd->loaded_timelines = NULL;
+	}
+	if (nb_timeline_entries) *nb_timeline_entries = ldr.nb_entries;
+
+	//timelines not attached to the MPD
+	while (gf_list_count(ldr.timelines)) {
+		GF_MPD_LoadedTimeline *ltl = gf_list_pop_back(ldr.timelines);
+		gf_mpd_segment_timeline_free(ltl->timeline);
+		gf_free(ltl);
+	}
+	gf_list_del(ldr.timelines);
+	gf_list_del(ldr.stack);
+	if (ldr.root) gf_xml_dom_node_del(ldr.root);
+	if (ldr.sax) gf_xml_sax_del(ldr.sax);
+	return e;
+}
+
 static GF_Err gf_m3u8_fill_mpd_struct(MasterPlaylist *pl, const char *m3u8_file, const char *src_base_url, const char *mpd_file, char *title, Double update_interval,
                                       char *mimeTypeForM3U8Segments, Bool do_import, Bool use_mpd_templates, Bool use_segment_timeline, Bool is_end, u32 max_dur, GF_MPD *mpd, Bool parse_sub_playlist)
 {
@@ -266,6 +266,76 @@ Bool gf_m2ts_crc32_check(u8 *data, u32 len)
 }
 
 
+/*section cache entry: copy of the last valid section received for a given section number, including its CRC.
+A section identical to its cache entry is a repeat of an already verified section and does not need CRC verification*/
+struct __m2ts_section_cache
+{
+	u8 *data;
+	u32 size;
+};
+
+static Bool gf_m2ts_section_cache_check(GF_M2TS_Table *t, u8 *data, u32 len, u32 sec_num)
+{
+	struct __m2ts_section_cache *sc;
+	if (sec_num >= t->section_cache_size) return GF_FALSE;
+	sc = &t->section_cache[sec_num];
+	if (!sc->data || (sc->size != len+4)) return GF_FALSE;
+	return memcmp(sc->data, data, len+4) ? GF_FALSE : GF_TRUE;
+}
+
+static void gf_m2ts_section_cache_store(GF_M2TS_Table *t, u8 *data, u32 len, u32 sec_num)
+{
+	u8 *cdata;
+	struct __m2ts_section_cache *sc;
+	if (sec_num >= t->section_cache_size) {
+		u32 new_size = MAX(sec_num+1, t->section_cache_size*2);
+		sc = gf_realloc(t->section_cache, sizeof(struct __m2ts_section_cache) * new_size);
+		if (!sc) return;
+		memset(sc + t->section_cache_size, 0, sizeof(struct __m2ts_section_cache) * (new_size - t->section_cache_size));
+		t->section_cache = sc;
+		t->section_cache_size = new_size;
+	}
+	sc = &t->section_cache[sec_num];
+	if (sc->size != len+4) {
+		cdata = gf_realloc(sc->data, len+4);
+		if (!cdata) return;
+		sc->data = cdata;
+		sc->size = len+4;
+	}
+	memcpy(sc->data, data, len+4);
+}
+
+static void gf_m2ts_section_cache_del(GF_M2TS_Table *t)
+{
+	u32 i;
+	for (i=0; i<t->section_cache_size; i++) {
+		if (t->section_cache[i].data) gf_free(t->section_cache[i].data);
+	}
+	if (t->section_cache) gf_free(t->section_cache);
+}
+
+/*restores sections skipped as exact repeats from the cache, in front of the section list*/
+static void gf_m2ts_section_cache_restore(GF_M2TS_Table *t, u32 section_start)
+{
+	u32 i;
+	for (i=0; i<t->nb_skipped_sections; i++) {
+		GF_M2TS_Section *section;
+		struct __m2ts_section_cache *sc = &t->section_cache[t->first_skipped_section + i];
+		GF_SAFEALLOC(section, GF_M2TS_Section);
+		if (!section) break;
+		section->data_size = sc->size - 4 - section_start;
+		section->data = (unsigned char*)gf_malloc(sizeof(unsigned char)*section->data_size);
+		if (!section->data) {
+			gf_free(section);
+			break;
+		}
+		memcpy(section->data, sc->data + section_start, sizeof(unsigned char)*section->data_size);
+		gf_list_insert(t->sections, section, i);
+	}
+	t->nb_skipped_sections = 0;
+	t->skipped_size = 0;
+}
+
 static GF_M2TS_SectionFilter *gf_m2ts_section_filter_new(gf_m2ts_section_callback process_section_callback, Bool process_individual)
 {
 	GF_M2TS_SectionFilter *sec;
@@ -295,6 +365,13 @@ static void gf_m2ts_reset_sections(GF_List *sections)
 	}
 }
 
+static void gf_m2ts_table_reset_sections(GF_M2TS_Table *t)
+{
+	gf_m2ts_reset_sections(t->sections);
+	t->nb_skipped_sections = 0;
+	t->skipped_size = 0;
+}
+
 static void gf_m2ts_section_filter_reset(GF_M2TS_SectionFilter *sf)
 {
 	if (sf->section) {
@@ -306,6 +383,7 @@ static void gf_m2ts_section_filter_reset(GF_M2TS_SectionFilter *sf)
 		sf->table = t->next;
 		gf_m2ts_reset_sections(t->sections);
 		gf_list_del(t->sections);
+		gf_m2ts_section_cache_del(t);
 		gf_free(t);
 	}
 	sf->cc = -1;
@@ -442,6 +520,7 @@ static void gf_m2ts_section_complete(GF_M2TS_Demuxer *ts, GF_M2TS_SectionFilter
 		GF_M2TS_Table *t, *prev_t;
 		unsigned char *data;
 		Bool section_valid = 0;
+		Bool exact_repeat = GF_FALSE;
 
 		status = 0;
 		/*parse header*/
@@ -512,14 +591,23 @@ static void gf_m2ts_section_complete(GF_M2TS_Demuxer *ts, GF_M2TS_SectionFilter
 			if (sec->length < 4) {
 				GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[MPEG-2 TS] corrupted section length %d less than CRC \n", sec->length));
 			} else {
+				Bool crc_ok;
 				/*remove crc32*/
 				sec->length -= 4;
-				if (gf_m2ts_crc32_check((char *)data, sec->length)) {
+				/*section identical to a verified one (carousel repeat), skip CRC computation*/
+				if (gf_m2ts_section_cache_check(t, data, sec->length, data[6])) {
+					crc_ok = GF_TRUE;
+					exact_repeat = GF_TRUE;
+				} else {
+					crc_ok = gf_m2ts_crc32_check((char *)data, sec->length);
+					if (crc_ok) gf_m2ts_section_cache_store(t, data, sec->length, data[6]);
+				}
+				if (crc_ok) {
 					s32 cur_sec_num;
 					t->version_number = (data[5] >> 1) & 0x1f;
 					if (t->last_section_number && t->section_number && (t->version_number != t->last_version_number)) {
 						GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[MPEG-2 TS] table transmission interrupted: previous table (v=%d) %d/%d sections - new table (v=%d) %d/%d sections\n", t->last_version_number, t->section_number, t->last_section_number, t->version_number, data[6] + 1, data[7] + 1) );
-						gf_m2ts_reset_sections(t->sections);
+						gf_m2ts_table_reset_sections(t);
 						t->section_number = 0;
 					}
 
@@ -552,15 +640,25 @@ static void gf_m2ts_section_complete(GF_M2TS_Demuxer *ts, GF_M2TS_SectionFilter
 		if (section_valid) {
 			GF_M2TS_Section *section;
 
-			GF_SAFEALLOC(section, GF_M2TS_Section);
-			if (!section) {
-				GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[MPEG-2 TS] Fail to create section\n"));
-				return;
+			/*exact repeat of a section of an already received table: as long as all sections of the table are exact repeats,
+			they are not copied and the table handlers only signal the repeat*/
+			if (exact_repeat && t->is_init && !gf_list_count(t->sections) && !(ses && (ses->flags & GF_M2TS_ES_SEND_REPEATED_SECTIONS))) {
+				if (!t->nb_skipped_sections) t->first_skipped_section = data[6];
+				t->nb_skipped_sections++;
+				t->skipped_size += sec->length - section_start;
+			} else {
+				if (t->nb_skipped_sections) gf_m2ts_section_cache_restore(t, section_start);
+
+				GF_SAFEALLOC(section, GF_M2TS_Section);
+				if (!section) {
+					GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[MPEG-2 TS] Fail to create section\n"));
+					return;
+				}
+				section->data_size = sec->length - section_start;
+				section->data = (unsigned char*)gf_malloc(sizeof(unsigned char)*section->data_size);
+				memcpy(section->data, sec->section + section_start, sizeof(unsigned char)*section->data_size);
+				gf_list_add(t->sections, section);
 			}
-			section->data_size = sec->length - section_start;
-			section->data = (unsigned char*)gf_malloc(sizeof(unsigned char)*section->data_size);
-			memcpy(section->data, sec->section + section_start, sizeof(unsigned char)*section->data_size);
-			gf_list_add(t->sections, section);
 
 			if (t->section_number == 1) {
 				status |= GF_M2TS_TABLE_START;
@@ -588,7 +686,7 @@ static void gf_m2ts_section_complete(GF_M2TS_Demuxer *ts, GF_M2TS_SectionFilter
 
 				status |= GF_M2TS_TABLE_END;
 
-				table_size = 0;
+				table_size = t->skipped_size;
 				for (i=0; i<gf_list_count(t->sections); i++) {
 					GF_M2TS_Section *a_sec = gf_list_get(t->sections, i);
 					table_size += a_sec->data_size;
@@ -612,24 +710,31 @@ static void gf_m2ts_section_complete(GF_M2TS_Demuxer *ts, GF_M2TS_SectionFilter
 
 			}
 
+			/*skipped sections are only signaled as such for a plain table repeat*/
+			if (t->nb_skipped_sections && (!(status & GF_M2TS_TABLE_REPEAT) || (status & GF_M2TS_TABLE_UPDATE))) {
+				gf_m2ts_section_cache_restore(t, section_start);
+			}
+
 			if (sec->process_individual) {
 				/*send each section of the table and not the aggregated table*/
 				if (sec->process_section)
 					sec->process_section(ts, ses, t->sections, t->table_id, t->ex_table_id, t->version_number, (u8) (t->last_section_number - 1), status);
 
-				gf_m2ts_reset_sections(t->sections);
+				gf_m2ts_table_reset_sections(t);
 			} else {
 				if (status&GF_M2TS_TABLE_END) {
 					if (sec->process_section)
 						sec->process_section(ts, ses, t->sections, t->table_id, t->ex_table_id, t->version_number, (u8) (t->last_section_number - 1), status);
 
-					gf_m2ts_reset_sections(t->sections);
+					gf_m2ts_table_reset_sections(t);
 				}
 			}
 
 		} else {
 			sec->cc = -1;
 			t->section_number = 0;
+			t->nb_skipped_sections = 0;
+			t->skipped_size = 0;
 		}
 	}
 	/*clean-up (including broken sections)*/
@@ -2145,6 +2250,16 @@ void gf_m2ts_flush_pes(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, Bool force_flush)
 	pes->rap = 0;
 }
 
+GF_EXPORT
+u8 *gf_m2ts_pes_swap_buffer(GF_M2TS_PES *pes, u8 *buffer, u32 alloc_size, u32 *detached_alloc_size)
+{
+	u8 *prev = pes->pck_data;
+	if (detached_alloc_size) *detached_alloc_size = pes->pck_alloc_len;
+	pes->pck_data = buffer;
+	pes->pck_alloc_len = buffer ? alloc_size : 0;
+	return prev;
+}
+
 static void gf_m2ts_process_pes(GF_M2TS_Demuxer *ts, GF_M2TS_PES *pes, GF_M2TS_Header *hdr, unsigned char *data, u32 data_size, GF_M2TS_AdaptationField *paf)
 {
 	u8 expect_cc;
@@ -2662,6 +2777,138 @@ static GF_Err gf_m2ts_process_packet(GF_M2TS_Demuxer *ts, unsigned char *data)
 	return GF_OK;
 }
 
+/*max number of PES streams with pending payloads in a burst*/
+#define GF_M2TS_BURST_MAX_PES	16
+
+typedef struct
+{
+	GF_M2TS_PES *pes;
+	/*pending payload size*/
+	u32 size;
+	/*CC of last pending packet*/
+	s32 cc;
+	/*write offset in PES buffer, only used at flush*/
+	u32 offset;
+} GF_M2TS_BurstRun;
+
+struct __m2ts_burst
+{
+	GF_M2TS_BurstRun runs[GF_M2TS_BURST_MAX_PES];
+	u32 nb_runs;
+	/*pending payloads in packet order and their run index*/
+	u8 **pcks;
+	u8 *pck_run;
+	u32 nb_pcks, alloc_pcks;
+};
+
+static void gf_m2ts_burst_flush(GF_M2TS_Demuxer *ts)
+{
+	u32 i;
+	struct __m2ts_burst *burst = ts->burst;
+
+	/*one reallocation per PES for the whole run*/
+	for (i=0; i<burst->nb_runs; i++) {
+		GF_M2TS_BurstRun *run = &burst->runs[i];
+		GF_M2TS_PES *pes = run->pes;
+		if (pes->pck_data_len + run->size > pes->pck_alloc_len) {
+			pes->pck_alloc_len = pes->pck_data_len + run->size;
+			pes->pck_data = (u8*)gf_realloc(pes->pck_data, pes->pck_alloc_len);
+		}
+		run->offset = pes->pck_data_len;
+	}
+	for (i=0; i<burst->nb_pcks; i++) {
+		GF_M2TS_BurstRun *run = &burst->runs[burst->pck_run[i]];
+		memcpy(run->pes->pck_data + run->offset, burst->pcks[i], 184);
+		run->offset += 184;
+	}
+	for (i=0; i<burst->nb_runs; i++) {
+		GF_M2TS_BurstRun *run = &burst->runs[i];
+		run->pes->pck_data_len += run->size;
+		run->pes->cc = run->cc;
+	}
+	burst->nb_runs = 0;
+	burst->nb_pcks = 0;
+}
+
+/*processes a set of aligned packets. Payload-only continuation packets of PES streams which neither start nor complete a PES
+and have no CC error carry no information other than their payload: they are only queued, and appended per PID on the next packet
+needing regular processing or at the end of the buffer. Since such packets do not modify any state visible to other PIDs, this
+is equivalent to regular processing*/
+static GF_Err gf_m2ts_process_burst(GF_M2TS_Demuxer *ts, u8 *data, u32 nb_pck, u32 pck_size)
+{
+	GF_Err e = GF_OK;
+	u32 i;
+	struct __m2ts_burst *burst = ts->burst;
+
+	if (!burst) {
+		GF_SAFEALLOC(burst, struct __m2ts_burst);
+		if (!burst) goto no_burst;
+		ts->burst = burst;
+	}
+	if (burst->alloc_pcks < nb_pck) {
+		burst->alloc_pcks = nb_pck;
+		burst->pcks = (u8 **)gf_realloc(burst->pcks, sizeof(u8 *) * nb_pck);
+		burst->pck_run = (u8 *)gf_realloc(burst->pck_run, sizeof(u8) * nb_pck);
+		if (!burst->pcks || !burst->pck_run) {
+			burst->alloc_pcks = 0;
+			goto no_burst;
+		}
+	}
+
+	for (i=0; i<nb_pck; i++, data += pck_size) {
+		GF_M2TS_PES *pes;
+		GF_M2TS_BurstRun *run;
+		u32 pid, j, cc;
+
+		/*sync, no error, no payload start, not scrambled, payload only*/
+		if ((data[0] != 0x47) || (data[1] & 0xC0) || ((data[3] & 0xF0) != 0x10))
+			goto slow;
+		pid = ((data[1]&0x1f) << 8) | data[2];
+		pes = (GF_M2TS_PES *) ts->ess[pid];
+		if (!pes || !(pes->flags & GF_M2TS_ES_IS_PES) || (pes->pid != pid) || !pes->reframe)
+			goto slow;
+
+		for (j=0; j<burst->nb_runs; j++) {
+			if (burst->runs[j].pes == pes) break;
+		}
+		run = &burst->runs[j];
+		if (j==burst->nb_runs) {
+			if ((j==GF_M2TS_BURST_MAX_PES) || !pes->pck_data_len || (pes->cc<0))
+				goto slow;
+			run->pes = pes;
+			run->size = 0;
+			run->cc = pes->cc;
+		}
+		cc = data[3] & 0xF;
+		if (cc != ((run->cc + 1) & 0xF))
+			goto slow;
+		/*last packet of PES, regular processing will flush it*/
+		if (pes->pes_len && (pes->pck_data_len + run->size + 184 >= pes->pes_len + 6))
+			goto slow;
+
+		if (j==burst->nb_runs) burst->nb_runs++;
+		run->cc = cc;
+		run->size += 184;
+		burst->pcks[burst->nb_pcks] = data + 4;
+		burst->pck_run[burst->nb_pcks] = j;
+		burst->nb_pcks++;
+		ts->pck_number++;
+		continue;
+
+slow:
+		if (burst->nb_pcks) gf_m2ts_burst_flush(ts);
+		e |= gf_m2ts_process_packet(ts, data);
+	}
+	if (burst->nb_pcks) gf_m2ts_burst_flush(ts);
+	return e;
+
+no_burst:
+	for (i=0; i<nb_pck; i++, data += pck_size) {
+		e |= gf_m2ts_process_packet(ts, data);
+	}
+	return e;
+}
+
 GF_EXPORT
 GF_Err gf_m2ts_process_data(GF_M2TS_Demuxer *ts, u8 *data, u32 data_size)
 {
@@ -2744,6 +2991,12 @@ GF_Err gf_m2ts_process_data(GF_M2TS_Demuxer *ts, u8 *data, u32 data_size)
 			return e;
 		}
 		/*process*/
+		if (ts->burst_mode && !ts->split_mode) {
+			u32 nb_pck = (data_size - pos) / pck_size;
+			e |= gf_m2ts_process_burst(ts, data + pos, nb_pck, pck_size);
+			pos += nb_pck * pck_size;
+			continue;
+		}
 		e |= gf_m2ts_process_packet(ts, (unsigned char *)data + pos);
 		pos += pck_size;
 	}
@@ -3045,6 +3298,11 @@ void gf_m2ts_demux_del(GF_M2TS_Demuxer *ts)
 		}
 	}
 	if (ts->buffer) gf_free(ts->buffer);
+	if (ts->burst) {
+		if (ts->burst->pcks) gf_free(ts->burst->pcks);
+		if (ts->burst->pck_run) gf_free(ts->burst->pck_run);
+		gf_free(ts->burst);
+	}
 	while (gf_list_count(ts->programs)) {
 		GF_M2TS_Program *p = (GF_M2TS_Program *)gf_list_last(ts->programs);
 		gf_list_rem_last(ts->programs);
@@ -30,9 +30,13 @@
 #include <gpac/network.h>
 #include <gpac/bitstream.h>
 #include <gpac/xml.h>
+#include <gpac/base_coding.h>
 #include <gpac/thread.h>
+#include <gpac/internal/reedsolomon.h>
 
 #define GF_ROUTE_SOCK_SIZE	0x80000
+//max size of a UDP datagram
+#define GF_ROUTE_MAX_DGRAM_SIZE	65535
 
 typedef struct
 {
@@ -60,6 +64,12 @@ typedef struct
 	u32 nb_cps;
 	u32 last_dispatched_tsi, last_dispatched_toi;
 	Bool tsi_init;
+	Bool has_src_flow;
+
+	//repair flow using Reed-Solomon FEC (RFC 5510), symbol size is 0 if no repair flow
+	u32 fec_symbol_size, fec_max_sbl;
+	//TSI of the protected source flow for LS carrying only a repair flow
+	u32 repair_src_tsi;
 } GF_ROUTELCTChannel;
 
 typedef enum
@@ -71,6 +81,12 @@ typedef enum
 	GF_LCT_OBJ_DISPATCHED,
 } GF_LCTObjectStatus;
 
+typedef struct
+{
+	u32 sbn, esi;
+	u32 pos;
+} GF_ROUTERepairSymbol;
+
 typedef struct
 {
 	u32 toi, tsi;
@@ -80,6 +96,16 @@ typedef struct
 	u32 nb_bytes, nb_recv_bytes, alloc_size;
 	u32 nb_frags, nb_alloc_frags, nb_recv_frags;
 	GF_LCTFragInfo *frags;
+	//FEC repair symbols
+	GF_ROUTELCTChannel *fec_rlct;
+	u32 fec_transport_length;
+	u8 *repair_data;
+	u32 repair_size, repair_alloc;
+	GF_ROUTERepairSymbol *repair_syms;
+	u32 nb_repair_syms, nb_alloc_repair_syms;
+	//one bit per (SBN, ESI) pair, 256 bits per source block
+	u8 *repair_map;
+	u32 repair_map_size;
 	GF_LCTObjectStatus status;
 	u32 download_time_ms;
 	u32 last_gather_time;
@@ -95,6 +121,8 @@ typedef struct
     
     GF_Blob blob;
 	void *udta;
+	//progressive dispatch to be done by main thread
+	Bool push_pending;
 } GF_LCTObject;
 
 
@@ -131,8 +159,42 @@ typedef struct
 	GF_List *route_sessions;
 	GF_ROUTETuneMode tune_mode;
 	void *udta;
+
+	//receive threads only: protects objects and sessions, completed objects waiting for dispatch and assigned thread
+	GF_Mutex *mx;
+	GF_List *done_objects;
+	struct __route_worker *worker;
 } GF_ROUTEService;
 
+typedef struct
+{
+	u64 nb_packets;
+	u64 total_bytes_recv;
+	u64 first_pck_time, last_pck_time;
+} GF_ROUTERecvStats;
+
+//receive thread, in charge of reception and object reassembly for a subset of the services
+typedef struct __route_worker
+{
+	GF_ROUTEDmx *routedmx;
+	GF_Thread *th;
+	//protects the service list
+	GF_Mutex *mx;
+	GF_List *services;
+	GF_SockGroup *active_sockets;
+	u32 nb_sockets;
+	volatile Bool sockets_dirty;
+	volatile Bool running;
+
+	GF_BitStream *bs;
+	u8 *buffer;
+	GF_SockDatagram *dgrams;
+	u8 *dgram_buffer;
+	u32 nb_dgrams;
+
+	GF_ROUTERecvStats stats;
+} GF_ROUTEWorker;
+
 struct __gf_routedmx {
 	const char *ip_ifce;
 	GF_Socket *atsc_sock;
@@ -141,6 +203,13 @@ struct __gf_routedmx {
 	u8 *unz_buffer;
 	u32 unz_buffer_size;
 
+	//batch reception of LCT packets
+	GF_SockDatagram *dgrams;
+	u8 *dgram_buffer;
+	u32 nb_dgrams;
+	//max datagram size, derived from socket buffer size
+	u32 dgram_size;
+
 	u32 reorder_timeout;
 	Bool force_reorder;
     Bool progressive_dispatch;
@@ -163,13 +232,16 @@ struct __gf_routedmx {
 
 	u32 debug_tsi;
 
-	u64 nb_packets;
-	u64 total_bytes_recv;
-	u64 first_pck_time, last_pck_time;
+	GF_ROUTERecvStats stats;
 
     //for now use a single mutex for all blob access
     GF_Mutex *blob_mx;
 
+	//receive threads
+	GF_ROUTEWorker *workers;
+	u32 nb_workers;
+	GF_Mutex *reservoir_mx;
+	u64 last_nb_packets;
 };
 
 static void gf_route_static_files_del(GF_List *files)
@@ -199,6 +271,9 @@ static void gf_route_lct_obj_del(GF_LCTObject *o)
 {
 	if (o->frags) gf_free(o->frags);
 	if (o->payload) gf_free(o->payload);
+	if (o->repair_data) gf_free(o->repair_data);
+	if (o->repair_syms) gf_free(o->repair_syms);
+	if (o->repair_map) gf_free(o->repair_map);
 	gf_free(o);
 }
 
@@ -219,15 +294,52 @@ static void gf_route_service_del(GF_ROUTEDmx *routedmx, GF_ROUTEService *s)
 		gf_route_lct_obj_del(o);
 	}
 	gf_list_del(s->objects);
+	if (s->done_objects) gf_list_del(s->done_objects);
+	if (s->mx) gf_mx_del(s->mx);
 	if (s->dst_ip) gf_free(s->dst_ip);
 	gf_free(s);
 }
 
+static void gf_route_dmx_del_workers(GF_ROUTEDmx *routedmx)
+{
+	u32 i;
+	for (i=0; i<routedmx->nb_workers; i++) {
+		GF_ROUTEWorker *w = &routedmx->workers[i];
+		w->running = GF_FALSE;
+		//waits for thread exit
+		if (w->th) gf_th_del(w->th);
+	}
+	for (i=0; i<routedmx->nb_workers; i++) {
+		GF_ROUTEWorker *w = &routedmx->workers[i];
+		if (w->active_sockets) gf_sk_group_del(w->active_sockets);
+		if (w->services) gf_list_del(w->services);
+		if (w->mx) gf_mx_del(w->mx);
+		if (w->bs) gf_bs_del(w->bs);
+		if (w->buffer) gf_free(w->buffer);
+		if (w->dgrams) gf_free(w->dgrams);
+		if (w->dgram_buffer) gf_free(w->dgram_buffer);
+	}
+	gf_free(routedmx->workers);
+	routedmx->workers = NULL;
+	routedmx->nb_workers = 0;
+	if (routedmx->services) {
+		GF_ROUTEService *s;
+		i=0;
+		while ((s = gf_list_enum(routedmx->services, &i))) {
+			s->worker = NULL;
+		}
+	}
+}
+
 GF_EXPORT
 void gf_route_dmx_del(GF_ROUTEDmx *routedmx)
 {
+	//stop receive threads before destroying services
+	if (routedmx->workers) gf_route_dmx_del_workers(routedmx);
 	if (routedmx->buffer) gf_free(routedmx->buffer);
 	if (routedmx->unz_buffer) gf_free(routedmx->unz_buffer);
+	if (routedmx->dgrams) gf_free(routedmx->dgrams);
+	if (routedmx->dgram_buffer) gf_free(routedmx->dgram_buffer);
 	if (routedmx->atsc_sock) gf_sk_del(routedmx->atsc_sock);
     if (routedmx->dom) gf_xml_dom_del(routedmx->dom);
     if (routedmx->blob_mx) gf_mx_del(routedmx->blob_mx);
@@ -246,6 +358,7 @@ void gf_route_dmx_del(GF_ROUTEDmx *routedmx)
 		}
 		gf_list_del(routedmx->object_reservoir);
 	}
+	if (routedmx->reservoir_mx) gf_mx_del(routedmx->reservoir_mx);
 	if (routedmx->bs) gf_bs_del(routedmx->bs);
 	gf_free(routedmx);
 }
@@ -289,8 +402,10 @@ static GF_ROUTEDmx *gf_route_dmx_new_internal(const char *ifce, u32 sock_buffer_
 
 	if (!sock_buffer_size) sock_buffer_size = GF_ROUTE_SOCK_SIZE;
 	routedmx->unz_buffer_size = sock_buffer_size;
-	//we store one UDP packet, or realloc to store LLS signaling so starting with 10k should be enough in most cases
-	routedmx->buffer_size = 10000;
+	//datagrams larger than the socket buffer cannot be received anyway
+	routedmx->dgram_size = MIN(sock_buffer_size, GF_ROUTE_MAX_DGRAM_SIZE);
+	//we store one UDP packet, or realloc to store LLS signaling
+	routedmx->buffer_size = routedmx->dgram_size;
 	routedmx->buffer = gf_malloc(routedmx->buffer_size);
 	if (!routedmx->buffer) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] Failed to allocate socket buffer\n"));
@@ -345,6 +460,11 @@ static void gf_route_register_service_sockets(GF_ROUTEDmx *routedmx, GF_ROUTESer
 {
     u32 i;
     GF_ROUTESession *rsess;
+	//sockets are owned by the receive thread, which updates its socket group from the service tune mode
+	if (s->worker) {
+		s->worker->sockets_dirty = GF_TRUE;
+		return;
+	}
     if (do_register) gf_sk_group_register(routedmx->active_sockets, s->sock);
     else gf_sk_group_unregister(routedmx->active_sockets, s->sock);
 
@@ -358,6 +478,27 @@ static void gf_route_register_service_sockets(GF_ROUTEDmx *routedmx, GF_ROUTESer
     }
 }
 
+static GF_Err gf_route_service_assign_worker(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, u32 idx)
+{
+	GF_ROUTEWorker *w = &routedmx->workers[idx % routedmx->nb_workers];
+	if (!s->mx) {
+		char szName[30];
+		sprintf(szName, "ROUTEService%d", s->service_id);
+		s->mx = gf_mx_new(szName);
+		if (!s->mx) return GF_OUT_OF_MEM;
+	}
+	if (!s->done_objects) {
+		s->done_objects = gf_list_new();
+		if (!s->done_objects) return GF_OUT_OF_MEM;
+	}
+	gf_mx_p(w->mx);
+	s->worker = w;
+	gf_list_add(w->services, s);
+	w->sockets_dirty = GF_TRUE;
+	gf_mx_v(w->mx);
+	return GF_OK;
+}
+
 static void gf_route_create_service(GF_ROUTEDmx *routedmx, const char *dst_ip, u32 dst_port, u32 service_id, u32 protocol)
 {
 	GF_ROUTEService *service;
@@ -391,6 +532,16 @@ static void gf_route_create_service(GF_ROUTEDmx *routedmx, const char *dst_ip, u
 
 	gf_list_add(routedmx->services, service);
 
+	if (routedmx->nb_workers) {
+		e = gf_route_service_assign_worker(routedmx, service, gf_list_count(routedmx->services)-1);
+		if (e) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] Failed to assign service %d to receive thread: %s\n", service_id, gf_error_to_string(e) ));
+			gf_list_del_item(routedmx->services, service);
+			gf_route_service_del(routedmx, service);
+			return;
+		}
+	}
+
 	if (routedmx->atsc_sock) {
 		if (routedmx->service_autotune==0xFFFFFFFF) service->tune_mode = GF_ROUTE_TUNE_ON;
 		else if (routedmx->service_autotune==0xFFFFFFFE) {
@@ -408,7 +559,7 @@ static void gf_route_create_service(GF_ROUTEDmx *routedmx, const char *dst_ip, u
 	} else {
 		service->tune_mode = GF_ROUTE_TUNE_ON;
 		routedmx->service_autotune = service_id;
-		gf_sk_group_register(routedmx->active_sockets, service->sock);
+		gf_route_register_service_sockets(routedmx, service, GF_TRUE);
 	}
 
 	if (routedmx->on_event) routedmx->on_event(routedmx->udta, GF_ROUTE_EVT_SERVICE_FOUND, service_id, NULL);
@@ -443,7 +594,9 @@ GF_Err gf_route_atsc3_tune_in(GF_ROUTEDmx *routedmx, u32 serviceID, Bool tune_al
 	routedmx->tune_all_sls = tune_all_sls;
 	i=0;
 	while ((s = gf_list_enum(routedmx->services, &i))) {
-		GF_ROUTETuneMode prev_mode = s->tune_mode;
+		GF_ROUTETuneMode prev_mode;
+		gf_mx_p(s->mx);
+		prev_mode = s->tune_mode;
 		if (s->service_id==serviceID) s->tune_mode = GF_ROUTE_TUNE_ON;
 		else if (serviceID==0xFFFFFFFF) s->tune_mode = GF_ROUTE_TUNE_ON;
 		else if ((s->tune_mode!=GF_ROUTE_TUNE_ON) && (serviceID==0xFFFFFFFE)) {
@@ -466,6 +619,7 @@ GF_Err gf_route_atsc3_tune_in(GF_ROUTEDmx *routedmx, u32 serviceID, Bool tune_al
 				gf_route_register_service_sockets(routedmx, s, GF_FALSE);
 			}
 		}
+		gf_mx_v(s->mx);
 	}
 	return GF_OK;
 }
@@ -487,6 +641,40 @@ GF_Err gf_route_set_allow_progressive_dispatch(GF_ROUTEDmx *routedmx, Bool allow
     return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_route_set_batch_size(GF_ROUTEDmx *routedmx, u32 nb_packets)
+{
+	u32 i;
+	u8 *dgram_buffer;
+	GF_SockDatagram *dgrams;
+	if (!routedmx) return GF_BAD_PARAM;
+	if (nb_packets<=1) nb_packets = 0;
+	if (nb_packets == routedmx->nb_dgrams) return GF_OK;
+
+	routedmx->nb_dgrams = 0;
+	if (!nb_packets) {
+		if (routedmx->dgrams) gf_free(routedmx->dgrams);
+		if (routedmx->dgram_buffer) gf_free(routedmx->dgram_buffer);
+		routedmx->dgrams = NULL;
+		routedmx->dgram_buffer = NULL;
+		return GF_OK;
+	}
+	dgrams = gf_realloc(routedmx->dgrams, sizeof(GF_SockDatagram) * nb_packets);
+	if (!dgrams) return GF_OUT_OF_MEM;
+	routedmx->dgrams = dgrams;
+	dgram_buffer = gf_realloc(routedmx->dgram_buffer, routedmx->dgram_size * nb_packets);
+	if (!dgram_buffer) return GF_OUT_OF_MEM;
+	routedmx->dgram_buffer = dgram_buffer;
+
+	//slots hold the largest datagram the socket can receive
+	for (i=0; i<nb_packets; i++) {
+		routedmx->dgrams[i].data = routedmx->dgram_buffer + i*routedmx->dgram_size;
+		routedmx->dgrams[i].size = routedmx->dgram_size;
+	}
+	routedmx->nb_dgrams = nb_packets;
+	return GF_OK;
+}
+
 static GF_Err gf_route_dmx_process_slt(GF_ROUTEDmx *routedmx, GF_XMLNode *root)
 {
 	GF_XMLNode *n;
@@ -570,6 +758,7 @@ static void gf_route_obj_to_reservoir(GF_ROUTEDmx *routedmx, GF_ROUTEService *s,
 		finfo.udta = obj->udta;
         routedmx->on_event(routedmx->udta, GF_ROUTE_EVT_FILE_DELETE, s->service_id, &finfo);
     }
+	gf_mx_p(s->mx);
 
 	//remove other objects
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d : moving object tsi %u toi %u to reservoir (status %s)\n", s->service_id, obj->tsi, obj->toi, get_lct_obj_status_name(obj->status) ));
@@ -604,10 +793,20 @@ static void gf_route_obj_to_reservoir(GF_ROUTEDmx *routedmx, GF_ROUTEService *s,
 	obj->prev_start_offset = 0;
 	obj->download_time_ms = 0;
 	obj->last_gather_time = 0;
+	obj->fec_rlct = NULL;
+	obj->fec_transport_length = 0;
+	obj->repair_size = 0;
+	obj->nb_repair_syms = 0;
+	if (obj->repair_map) memset(obj->repair_map, 0, obj->repair_map_size);
+	obj->push_pending = GF_FALSE;
 	obj->status = GF_LCT_OBJ_INIT;
 	gf_list_del_item(s->objects, obj);
-	gf_list_add(routedmx->object_reservoir, obj);
+	if (s->done_objects) gf_list_del_item(s->done_objects, obj);
+	gf_mx_v(s->mx);
 
+	gf_mx_p(routedmx->reservoir_mx);
+	gf_list_add(routedmx->object_reservoir, obj);
+	gf_mx_v(routedmx->reservoir_mx);
 }
 
 static GF_Err gf_route_dmx_push_object(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_LCTObject *obj, Bool final_push, Bool partial, Bool updated, u64 bytes_done)
@@ -637,6 +836,8 @@ static GF_Err gf_route_dmx_push_object(GF_ROUTEDmx *routedmx, GF_ROUTEService *s
         GF_ROUTEEventFileInfo finfo;
         memset(&finfo, 0, sizeof(GF_ROUTEEventFileInfo));
         finfo.filename = filepath;
+		//payload may be reallocated by a receive thread
+		gf_mx_p(routedmx->blob_mx);
 		obj->blob.data = obj->payload;
 		obj->blob.flags = 0;
 		if (final_push) {
@@ -649,7 +850,8 @@ static GF_Err gf_route_dmx_push_object(GF_ROUTEDmx *routedmx, GF_ROUTEService *s
 			obj->blob.flags = GF_BLOB_IN_TRANSFER;
 			obj->blob.size = (u32) bytes_done;
 		}
-		finfo.blob = &obj->blob;		
+		gf_mx_v(routedmx->blob_mx);
+		finfo.blob = &obj->blob;
         finfo.total_size = obj->total_length;
         finfo.tsi = obj->tsi;
         finfo.toi = obj->toi;
@@ -711,10 +913,285 @@ static GF_Err gf_route_dmx_process_object(GF_ROUTEDmx *routedmx, GF_ROUTEService
 	return gf_route_dmx_push_object(routedmx, s, obj, GF_TRUE, partial, updated, 0);
 }
 
-static GF_Err gf_route_service_flush_object(GF_ROUTEService *s, GF_LCTObject *obj)
+//checks if [start, end) is covered by received fragments, frag_idx is a cursor for increasing start values
+static Bool gf_route_obj_has_range(GF_LCTObject *obj, u32 start, u32 end, u32 *frag_idx)
+{
+	u32 i = *frag_idx;
+	while ((i<obj->nb_frags) && (obj->frags[i].offset + obj->frags[i].size <= start)) i++;
+	*frag_idx = i;
+	while ((i<obj->nb_frags) && (obj->frags[i].offset <= start)) {
+		u32 frag_end = obj->frags[i].offset + obj->frags[i].size;
+		if (frag_end >= end) return GF_TRUE;
+		start = frag_end;
+		i++;
+	}
+	return GF_FALSE;
+}
+
+//marks [offset, offset+size) as received, merging with existing fragments
+static GF_Err gf_route_obj_add_range(GF_LCTObject *obj, u32 offset, u32 size)
+{
+	u32 i, j, end = offset + size;
+
+	i=0;
+	while ((i<obj->nb_frags) && (obj->frags[i].offset + obj->frags[i].size < offset)) i++;
+	j=i;
+	while ((j<obj->nb_frags) && (obj->frags[j].offset <= end)) {
+		if (obj->frags[j].offset < offset) offset = obj->frags[j].offset;
+		if (obj->frags[j].offset + obj->frags[j].size > end) end = obj->frags[j].offset + obj->frags[j].size;
+		j++;
+	}
+	if (i==j) {
+		if (obj->nb_frags==obj->nb_alloc_frags) {
+			GF_LCTFragInfo *frags = gf_realloc(obj->frags, sizeof(GF_LCTFragInfo)*obj->nb_alloc_frags*2);
+			if (!frags) return GF_OUT_OF_MEM;
+			obj->frags = frags;
+			obj->nb_alloc_frags *= 2;
+		}
+		memmove(&obj->frags[i+1], &obj->frags[i], sizeof(GF_LCTFragInfo) * (obj->nb_frags - i));
+		obj->nb_frags++;
+	} else if (j>i+1) {
+		memmove(&obj->frags[i+1], &obj->frags[j], sizeof(GF_LCTFragInfo) * (obj->nb_frags - j));
+		obj->nb_frags -= j-i-1;
+	}
+	obj->frags[i].offset = offset;
+	obj->frags[i].size = end - offset;
+
+	obj->nb_bytes = 0;
+	for (i=0; i<obj->nb_frags; i++)
+		obj->nb_bytes += obj->frags[i].size;
+	return GF_OK;
+}
+
+static GF_Err gf_route_obj_add_repair(GF_ROUTEService *s, GF_LCTObject *obj, GF_ROUTELCTChannel *fec_rlct, u32 sbn, u32 esi, u8 *data, u32 size, u32 transport_length)
+{
+	u32 nb_syms, N, k, A_large, A_small, I, map_size;
+	u32 E = fec_rlct->fec_symbol_size;
+
+	if (!transport_length) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d TSI %u TOI %u repair packet without transport object length, ignoring\n", s->service_id, obj->tsi, obj->toi));
+		return GF_NON_COMPLIANT_BITSTREAM;
+	}
+	if (!obj->fec_transport_length) {
+		obj->fec_transport_length = transport_length;
+	} else if (obj->fec_transport_length != transport_length) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d TSI %u TOI %u mismatch in transport object length %u assigned, %u redeclared\n", s->service_id, obj->tsi, obj->toi, obj->fec_transport_length, transport_length));
+		return GF_NON_COMPLIANT_BITSTREAM;
+	}
+
+	//source block partitioning as in RFC 5052 section 9.1, must match gf_route_obj_fec_recover
+	nb_syms = (u32) (((u64) transport_length + E - 1) / E);
+	N = (nb_syms + fec_rlct->fec_max_sbl - 1) / fec_rlct->fec_max_sbl;
+	if (sbn >= N) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d TSI %u TOI %u repair symbol for source block %u but only %u blocks, ignoring\n", s->service_id, obj->tsi, obj->toi, sbn, N));
+		return GF_NON_COMPLIANT_BITSTREAM;
+	}
+	A_large = (nb_syms + N - 1) / N;
+	A_small = nb_syms / N;
+	I = nb_syms - A_small * N;
+	k = (sbn<I) ? A_large : A_small;
+	//repair ESIs start after the k source symbols of the block
+	if (esi < k) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d TSI %u TOI %u repair symbol ESI %u in source range of block %u (%u source symbols), ignoring\n", s->service_id, obj->tsi, obj->toi, esi, sbn, k));
+		return GF_NON_COMPLIANT_BITSTREAM;
+	}
+	obj->fec_rlct = fec_rlct;
+
+	//only grow the map up to the highest block seen
+	if ((u64) (sbn+1) * 32 > 0xFFFFFFFF) return GF_OUT_OF_MEM;
+	map_size = (sbn+1) * 32;
+	if (obj->repair_map_size < map_size) {
+		u8 *repair_map = gf_realloc(obj->repair_map, map_size);
+		if (!repair_map) return GF_OUT_OF_MEM;
+		memset(repair_map + obj->repair_map_size, 0, map_size - obj->repair_map_size);
+		obj->repair_map = repair_map;
+		obj->repair_map_size = map_size;
+	}
+
+	//G repair symbols of E bytes with consecutive ESIs, at most GF_RS_ERASURE_MAX_SYMBOLS - k per block
+	while ((size >= E) && (esi < GF_RS_ERASURE_MAX_SYMBOLS)) {
+		u32 bit = sbn*256 + esi;
+		if (! (obj->repair_map[bit/8] & (1 << (bit%8)))) {
+			GF_ROUTERepairSymbol *rs;
+			if (obj->nb_repair_syms==obj->nb_alloc_repair_syms) {
+				u32 nb_alloc = obj->nb_alloc_repair_syms ? 2*obj->nb_alloc_repair_syms : 32;
+				GF_ROUTERepairSymbol *syms = gf_realloc(obj->repair_syms, sizeof(GF_ROUTERepairSymbol)*nb_alloc);
+				if (!syms) return GF_OUT_OF_MEM;
+				obj->repair_syms = syms;
+				obj->nb_alloc_repair_syms = nb_alloc;
+			}
+			if ((u64) obj->repair_size + E > 0xFFFFFFFF) return GF_OUT_OF_MEM;
+			if (obj->repair_size + E > obj->repair_alloc) {
+				u32 alloc = MAX(2*obj->repair_alloc, obj->repair_size + E);
+				u8 *repair_data = gf_realloc(obj->repair_data, alloc);
+				if (!repair_data) return GF_OUT_OF_MEM;
+				obj->repair_data = repair_data;
+				obj->repair_alloc = alloc;
+			}
+			rs = &obj->repair_syms[obj->nb_repair_syms];
+			rs->sbn = sbn;
+			rs->esi = esi;
+			rs->pos = obj->repair_size;
+			memcpy(obj->repair_data + obj->repair_size, data, E);
+			obj->repair_size += E;
+			obj->nb_repair_syms++;
+			obj->repair_map[bit/8] |= 1 << (bit%8);
+		}
+		esi++;
+		data += E;
+		size -= E;
+	}
+	return GF_OK;
+}
+
+//checks if enough data is available to attempt FEC decoding
+static Bool gf_route_obj_fec_ready(GF_LCTObject *obj)
+{
+	u32 known;
+	if (!obj->nb_repair_syms || !obj->fec_transport_length) return GF_FALSE;
+	known = obj->nb_bytes + obj->repair_size;
+	//padding and source object size are known if source object size is known, otherwise they must be recovered
+	if (obj->total_length && (obj->total_length + 4 <= obj->fec_transport_length))
+		known += obj->fec_transport_length - obj->total_length;
+	return (known >= obj->fec_transport_length) ? GF_TRUE : GF_FALSE;
+}
+
+static Bool gf_route_obj_symbol_received(GF_LCTObject *obj, u32 sym_idx, u32 E, u32 L, u32 F, u32 *frag_idx)
+{
+	u32 start = sym_idx * E;
+	u32 end = start + E;
+	//padding, last 4 bytes and symbol padding are known if F is known
+	if (F) {
+		if (start >= F) return GF_TRUE;
+		if (end > F) end = F;
+	} else if (end > L) {
+		end = L;
+	}
+	return gf_route_obj_has_range(obj, start, end, frag_idx);
+}
+
+/*recovers lost source symbols using received repair symbols. The FEC transport object of length L is the object data, zero padding
+and the object size F on 4 bytes, split in source blocks as defined in RFC 5052. Returns GF_TRUE if some data was recovered*/
+static Bool gf_route_obj_fec_recover(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_LCTObject *obj)
+{
+	u32 i, b, E, L, F, nb_syms, N, A_large, A_small, I, first_sym, frag_idx, size;
+	u32 nb_decodable=0, nb_undecodable=0, nb_recovered=0;
+	u8 *src[GF_RS_ERASURE_MAX_SYMBOLS], *repair[GF_RS_ERASURE_MAX_SYMBOLS];
+	u8 present[GF_RS_ERASURE_MAX_SYMBOLS];
+	u32 repair_esi[GF_RS_ERASURE_MAX_SYMBOLS];
+	GF_ROUTELCTChannel *fec = obj->fec_rlct;
+
+	if (!fec || !obj->nb_repair_syms) return GF_FALSE;
+	E = fec->fec_symbol_size;
+	L = obj->fec_transport_length;
+	F = obj->total_length;
+	if (!E || (L<4) || (F && (F+4 > L))) return GF_FALSE;
+
+	nb_syms = (L + E - 1) / E;
+	N = (nb_syms + fec->fec_max_sbl - 1) / fec->fec_max_sbl;
+	A_large = (nb_syms + N - 1) / N;
+	A_small = nb_syms / N;
+	I = nb_syms - A_small * N;
+	if ((u64) nb_syms * E >= 0xFFFFFFFF) return GF_FALSE;
+	size = nb_syms * E;
+
+	//check which blocks can be decoded
+	frag_idx = 0;
+	first_sym = 0;
+	for (b=0; b<N; b++) {
+		u32 k = (b<I) ? A_large : A_small;
+		u32 nb_missing = 0, nb_rep = 0;
+		for (i=0; i<k; i++) {
+			if (!gf_route_obj_symbol_received(obj, first_sym+i, E, L, F, &frag_idx)) nb_missing++;
+		}
+		if (nb_missing) {
+			for (i=0; i<obj->nb_repair_syms; i++) {
+				if ((obj->repair_syms[i].sbn==b) && (obj->repair_syms[i].esi>=k)) nb_rep++;
+			}
+			if (nb_rep >= nb_missing) nb_decodable++;
+			else nb_undecodable++;
+		}
+		first_sym += k;
+	}
+	if (!nb_decodable) return GF_FALSE;
+	//object size unknown, it is only known once all blocks are recovered
+	if (!F && nb_undecodable) return GF_FALSE;
+
+	if (obj->alloc_size < size) {
+		u8 *payload = gf_realloc(obj->payload, size+1);
+		if (!payload) return GF_FALSE;
+		payload[size] = 0;
+		gf_mx_p(routedmx->blob_mx);
+		obj->payload = payload;
+		obj->alloc_size = size;
+		obj->blob.data = obj->payload;
+		gf_mx_v(routedmx->blob_mx);
+	}
+	memset(obj->payload + L, 0, size - L);
+	if (F) {
+		memset(obj->payload + F, 0, L - 4 - F);
+		obj->payload[L-4] = (F>>24) & 0xFF;
+		obj->payload[L-3] = (F>>16) & 0xFF;
+		obj->payload[L-2] = (F>>8) & 0xFF;
+		obj->payload[L-1] = F & 0xFF;
+	}
+
+	frag_idx = 0;
+	first_sym = 0;
+	for (b=0; b<N; b++) {
+		u32 nb_missing=0, nb_rep=0;
+		u32 k = (b<I) ? A_large : A_small;
+		u32 start = first_sym * E;
+		u32 end = (first_sym + k) * E;
+		first_sym += k;
+
+		for (i=0; i<k; i++) {
+			src[i] = obj->payload + start + i*E;
+			present[i] = gf_route_obj_symbol_received(obj, first_sym-k+i, E, L, F, &frag_idx) ? 1 : 0;
+			if (!present[i]) nb_missing++;
+		}
+		if (!nb_missing) continue;
+		for (i=0; i<obj->nb_repair_syms; i++) {
+			if (obj->repair_syms[i].sbn!=b) continue;
+			repair[nb_rep] = obj->repair_data + obj->repair_syms[i].pos;
+			repair_esi[nb_rep] = obj->repair_syms[i].esi;
+			nb_rep++;
+		}
+		if (gf_rs_erasure_decode(src, present, k, repair, repair_esi, nb_rep, E) != GF_OK)
+			continue;
+
+		nb_recovered++;
+		if (!F) continue;
+		if (start >= F) continue;
+		if (end > F) end = F;
+		if (gf_route_obj_add_range(obj, start, end - start) != GF_OK) return GF_FALSE;
+		//fragments were merged, reset cursor
+		frag_idx = 0;
+	}
+	if (!nb_recovered) return GF_FALSE;
+
+	if (!F) {
+		//all blocks recovered, get object size
+		F = ((u32) obj->payload[L-4])<<24 | ((u32) obj->payload[L-3])<<16 | ((u32) obj->payload[L-2])<<8 | obj->payload[L-1];
+		if (F+4 > L) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d TSI %u TOI %u wrong object size %u in FEC transport object of %u bytes\n", s->service_id, obj->tsi, obj->toi, F, L));
+			return GF_FALSE;
+		}
+		obj->total_length = F;
+		if (gf_route_obj_add_range(obj, 0, F) != GF_OK) return GF_FALSE;
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_ROUTE, ("[ROUTE] Service %d TSI %u TOI %u recovered %u source blocks out of %u using FEC (%u repair symbols received)\n", s->service_id, obj->tsi, obj->toi, nb_recovered, N, obj->nb_repair_syms));
+	return GF_TRUE;
+}
+
+static GF_Err gf_route_service_flush_object(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_LCTObject *obj)
 {
 	u32 i;
 	u64 start_offset = 0;
+	//last chance to recover missing data
+	if (obj->nb_repair_syms && (!obj->total_length || (obj->nb_bytes < obj->total_length)))
+		gf_route_obj_fec_recover(routedmx, s, obj);
+
 	obj->status = GF_LCT_OBJ_DONE;
 	for (i=0; i<obj->nb_frags; i++) {
 		if (start_offset != obj->frags[i].offset) {
@@ -730,6 +1207,41 @@ static GF_Err gf_route_service_flush_object(GF_ROUTEService *s, GF_LCTObject *ob
 	return GF_EOS;
 }
 
+static void gf_route_service_queue_object(GF_ROUTEService *s, GF_LCTObject *obj)
+{
+	if (gf_list_find(s->done_objects, obj)<0)
+		gf_list_add(s->done_objects, obj);
+}
+
+//forces dispatch of an incomplete object (flush set) or recycles it
+static void gf_route_service_force_dispatch(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_LCTObject *o, Bool flush)
+{
+	if (flush)
+		gf_route_service_flush_object(routedmx, s, o);
+
+	//in receive threads, objects are dispatched or recycled by the main thread
+	if (routedmx->nb_workers) {
+		if (!flush) o->status = GF_LCT_OBJ_DONE_ERR;
+		gf_route_service_queue_object(s, o);
+	} else if (flush) {
+		gf_route_dmx_process_object(routedmx, s, o);
+	} else {
+		gf_route_obj_to_reservoir(routedmx, s, o);
+	}
+}
+
+static GF_Err gf_route_service_object_done(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_LCTObject *obj)
+{
+	s->last_active_obj = NULL;
+	if (obj->rlct) {
+		obj->rlct->last_dispatched_tsi = obj->tsi;
+		obj->rlct->last_dispatched_toi = obj->toi;
+	} else {
+		s->last_dispatched_toi_on_tsi_zero = obj->toi;
+	}
+	return gf_route_service_flush_object(routedmx, s, obj);
+}
+
 static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, u32 tsi, u32 toi, u32 start_offset, char *data, u32 size, u32 total_len, Bool close_flag, Bool in_order, GF_ROUTELCTChannel *rlct, GF_LCTObject **gather_obj)
 {
 	Bool inserted, done;
@@ -760,6 +1272,9 @@ static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEServ
 			if ((obj->toi == toi) && (obj->tsi==tsi)) break;
 
 			if (!tsi && !obj->tsi && ((obj->toi&0xFFFFFF00) == (toi&0xFFFFFF00)) ) {
+				//previous version not yet processed by main thread, wait for next carousel
+				if (routedmx->nb_workers && (obj->status==GF_LCT_OBJ_DONE))
+					return GF_OK;
 				//change in version of bundle but same other flags: reuse this one
 				obj->nb_frags = obj->nb_recv_frags = 0;
 				obj->nb_bytes = obj->nb_recv_bytes = 0;
@@ -772,7 +1287,9 @@ static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEServ
 		}
 	}
 	if (!obj) {
+		gf_mx_p(routedmx->reservoir_mx);
 		obj = gf_list_pop_back(routedmx->object_reservoir);
+		gf_mx_v(routedmx->reservoir_mx);
 		if (!obj) {
 			GF_SAFEALLOC(obj, GF_LCTObject);
 			if (!obj) {
@@ -800,7 +1317,8 @@ static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEServ
 			}
 		}
 
-		if (!total_len) {
+		//objects started by a repair packet never have a total length
+		if (!total_len && size) {
 			GF_LOG(GF_LOG_INFO, GF_LOG_ROUTE, ("[ROUTE] Service %d object TSI %u TOI %u started without total-length assigned !\n", s->service_id, tsi, toi ));
 		} else {
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d starting object TSI %u TOI %u total-length %d\n", s->service_id, tsi, toi, total_len));
@@ -827,12 +1345,7 @@ static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEServ
 		//last object had EOS and not completed
 		if (s->last_active_obj && s->last_active_obj->closed_flag && (s->last_active_obj->status<GF_LCT_OBJ_DONE_ERR)) {
 			GF_LCTObject *o = s->last_active_obj;
-		 	if (o->tsi) {
-		 		gf_route_service_flush_object(s, o);
-				gf_route_dmx_process_object(routedmx, s, o);
-			} else {
-				gf_route_obj_to_reservoir(routedmx, s, o);
-			}
+			gf_route_service_force_dispatch(routedmx, s, o, o->tsi ? GF_TRUE : GF_FALSE);
 		}
 		//note that if not in order and no timeout, we wait forever !
 		else if (in_order || routedmx->reorder_timeout) {
@@ -857,12 +1370,7 @@ static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEServ
 					GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d object TSI %u TOI %u not completely received but in-order delivery signaled and new TOI %u - forcing dispatch\n", s->service_id, o->tsi, o->toi, toi ));
 				}
 
-				if (o->tsi && o->nb_frags) {
-		 			gf_route_service_flush_object(s, o);
-					gf_route_dmx_process_object(routedmx, s, o);
-				} else {
-					gf_route_obj_to_reservoir(routedmx, s, o);
-				}
+				gf_route_service_force_dispatch(routedmx, s, o, (o->tsi && (o->nb_frags || o->nb_repair_syms)) ? GF_TRUE : GF_FALSE);
 				new_count = gf_list_count(s->objects);
 				//objects purged
 				if (new_count<count) {
@@ -877,8 +1385,8 @@ static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEServ
 	assert(obj->toi == toi);
 	assert(obj->tsi == tsi);
 
-	//keep receiving if we are done with errors
-	if (obj->status >= GF_LCT_OBJ_DONE) {
+	//keep receiving if we are done with errors, unless the object is owned by the main thread
+	if ((obj->status >= GF_LCT_OBJ_DONE) || (routedmx->nb_workers && (obj->status == GF_LCT_OBJ_DONE_ERR))) {
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d object TSI %u TOI %u already received - skipping\n", s->service_id, tsi, toi ));
 		return GF_EOS;
 	}
@@ -886,6 +1394,25 @@ static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEServ
 
     if (!size) {
         goto check_done;
+    }
+	//grow payload before registering the fragment
+	if (start_offset + size > obj->alloc_size) {
+		u8 *payload;
+		u32 alloc_size = start_offset + size;
+		//use total size if available
+		if (alloc_size < obj->total_length)
+			alloc_size = obj->total_length;
+		//for signaling objects, we set byte after last to 0 to use string functions
+		if (!tsi)
+			alloc_size++;
+		payload = gf_realloc(obj->payload, alloc_size+1);
+		if (!payload) return GF_OUT_OF_MEM;
+		payload[alloc_size] = 0;
+        gf_mx_p(routedmx->blob_mx);
+		obj->payload = payload;
+		obj->alloc_size = alloc_size;
+        obj->blob.data = obj->payload;
+        gf_mx_v(routedmx->blob_mx);
     }
 	obj->nb_recv_bytes += size;
 
@@ -904,8 +1431,10 @@ static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEServ
 				return GF_NOT_SUPPORTED;
 			}
 			if (obj->nb_frags==obj->nb_alloc_frags) {
+				GF_LCTFragInfo *frags = gf_realloc(obj->frags, sizeof(GF_LCTFragInfo)*obj->nb_alloc_frags*2);
+				if (!frags) return GF_OUT_OF_MEM;
+				obj->frags = frags;
 				obj->nb_alloc_frags *= 2;
-				obj->frags = gf_realloc(obj->frags, sizeof(GF_LCTFragInfo)*obj->nb_alloc_frags);
 			}
 			memmove(&obj->frags[i+1], &obj->frags[i], sizeof(GF_LCTFragInfo) * (obj->nb_frags - i)  );
 			obj->frags[i].offset = start_offset;
@@ -930,8 +1459,10 @@ static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEServ
 
 	if (!inserted) {
 		if (obj->nb_frags==obj->nb_alloc_frags) {
+			GF_LCTFragInfo *frags = gf_realloc(obj->frags, sizeof(GF_LCTFragInfo)*obj->nb_alloc_frags*2);
+			if (!frags) return GF_OUT_OF_MEM;
+			obj->frags = frags;
 			obj->nb_alloc_frags *= 2;
-			obj->frags = gf_realloc(obj->frags, sizeof(GF_LCTFragInfo)*obj->nb_alloc_frags);
 		}
 		obj->frags[obj->nb_frags].offset = start_offset;
 		obj->frags[obj->nb_frags].size = size;
@@ -945,20 +1476,6 @@ static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEServ
 
 	assert(obj->toi == toi);
 	assert(obj->tsi == tsi);
-	if (start_offset + size > obj->alloc_size) {
-		obj->alloc_size = start_offset + size;
-		//use total size if available
-		if (obj->alloc_size < obj->total_length)
-			obj->alloc_size = obj->total_length;
-		//for signaling objects, we set byte after last to 0 to use string functions
-		if (!tsi)
-			obj->alloc_size++;
-        gf_mx_p(routedmx->blob_mx);
-		obj->payload = gf_realloc(obj->payload, obj->alloc_size+1);
-		obj->payload[obj->alloc_size] = 0;
-        obj->blob.data = obj->payload;
-        gf_mx_v(routedmx->blob_mx);
-    }
 	assert(obj->alloc_size >= start_offset + size);
 
 	memcpy(obj->payload + start_offset, data, size);
@@ -970,7 +1487,10 @@ static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEServ
     
     //not a file (uses templates->segment) and can push
     if (do_push && !obj->rlct_file && obj->rlct) {
-        gf_route_dmx_push_object(routedmx, s, obj, GF_FALSE, GF_TRUE, GF_FALSE, obj->frags[0].size);
+		if (routedmx->nb_workers)
+			obj->push_pending = GF_TRUE;
+		else
+			gf_route_dmx_push_object(routedmx, s, obj, GF_FALSE, GF_TRUE, GF_FALSE, obj->frags[0].size);
     } else {
         GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d TSI %u TOI %u: %d bytes inserted on non-first fragment (%d totals), cannot push\n", s->service_id, obj->tsi, obj->toi, size, obj->nb_frags));
     }
@@ -978,6 +1498,9 @@ static GF_Err gf_route_service_gather_object(GF_ROUTEDmx *routedmx, GF_ROUTEServ
 check_done:
 	//check if we are done
 	done = GF_FALSE;
+	if ((!obj->total_length || (obj->nb_bytes < obj->total_length)) && gf_route_obj_fec_ready(obj))
+		gf_route_obj_fec_recover(routedmx, s, obj);
+
 	if (obj->total_length) {
 		if (obj->nb_bytes >= obj->total_length) {
 			done = GF_TRUE;
@@ -990,14 +1513,27 @@ check_done:
 	}
 	if (!done) return GF_OK;
 
-	s->last_active_obj = NULL;
-	if (obj->rlct) {
-		obj->rlct->last_dispatched_tsi = obj->tsi;
-		obj->rlct->last_dispatched_toi = obj->toi;
-	} else {
-		s->last_dispatched_toi_on_tsi_zero = obj->toi;
-	}
-	return gf_route_service_flush_object(s, obj);
+	return gf_route_service_object_done(routedmx, s, obj);
+}
+
+static GF_Err gf_route_service_gather_repair(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, u32 tsi, u32 toi, u32 sbn, u32 esi, u8 *data, u32 size, u32 transport_length, Bool in_order, GF_ROUTELCTChannel *rlct, GF_ROUTELCTChannel *fec_rlct, GF_LCTObject **gather_obj)
+{
+	GF_Err e;
+	GF_LCTObject *obj;
+
+	//get object, without source data
+	e = gf_route_service_gather_object(routedmx, s, tsi, toi, 0, NULL, 0, 0, GF_FALSE, in_order, rlct, gather_obj);
+	obj = *gather_obj;
+	if (e || !obj) return e;
+
+	e = gf_route_obj_add_repair(s, obj, fec_rlct, sbn, esi, data, size, transport_length);
+	if (e) return GF_OK;
+
+	if (!gf_route_obj_fec_ready(obj)) return GF_OK;
+	if (!gf_route_obj_fec_recover(routedmx, s, obj)) return GF_OK;
+	if (obj->nb_bytes < obj->total_length) return GF_OK;
+
+	return gf_route_service_object_done(routedmx, s, obj);
 }
 
 static GF_Err gf_route_service_setup_dash(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, char *content, char *content_location)
@@ -1065,11 +1601,100 @@ static GF_Err gf_route_service_parse_mbms_enveloppe(GF_ROUTEDmx *routedmx, GF_RO
 	return GF_OK;
 }
 
+static void gf_route_service_setup_repair_flow(GF_ROUTEService *s, GF_ROUTELCTChannel *rlct, GF_XMLNode *rprf)
+{
+	GF_XMLAttribute *att;
+	GF_XMLNode *node, *fecp=NULL;
+	u32 i, len, oti_len=0, fec_id=6, E, B, m;
+	u8 oti[20];
+	char *oti_str=NULL;
+
+	i=0;
+	while ((att = gf_list_enum(rprf->attributes, &i))) {
+		if (!strcmp(att->name, "fecEncodingId")) fec_id = atoi(att->value);
+	}
+	i=0;
+	while ((node = gf_list_enum(rprf->content, &i))) {
+		if ((node->type == GF_XML_NODE_TYPE) && !strcmp(node->name, "FECParameters")) fecp = node;
+	}
+	if (!fecp) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d missing FECParameters in RprFlow of TSI %u, ignoring repair flow\n", s->service_id, rlct->tsi));
+		return;
+	}
+	i=0;
+	while ((att = gf_list_enum(fecp->attributes, &i))) {
+		if (!strcmp(att->name, "fecEncodingId")) fec_id = atoi(att->value);
+	}
+	i=0;
+	while ((node = gf_list_enum(fecp->content, &i))) {
+		if (node->type != GF_XML_NODE_TYPE) continue;
+		if (!strcmp(node->name, "FECOTI")) {
+			GF_XMLNode *cnode = gf_list_get(node->content, 0);
+			if (cnode && (cnode->type==GF_XML_TEXT_TYPE)) oti_str = cnode->name;
+		}
+		else if (!strcmp(node->name, "ProtectedObject")) {
+			u32 j=0;
+			while ((att = gf_list_enum(node->attributes, &j))) {
+				if (!strcmp(att->name, "tsi")) sscanf(att->value, "%u", &rlct->repair_src_tsi);
+			}
+		}
+	}
+	//protecting our own source flow
+	if (rlct->repair_src_tsi == rlct->tsi) rlct->repair_src_tsi = 0;
+
+	//6 is RaptorQ, the default in ATSC 3.0
+	if (fec_id != 5) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d TSI %u repair flow uses FEC encoding ID %u, only Reed-Solomon (5) is supported - ignoring repair flow\n", s->service_id, rlct->tsi, fec_id));
+		return;
+	}
+	if (!oti_str) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d TSI %u missing FECOTI in repair flow, ignoring\n", s->service_id, rlct->tsi));
+		return;
+	}
+	while (oti_str[0] && strchr(" \t\r\n", oti_str[0])) oti_str++;
+	len = (u32) strlen(oti_str);
+	while (len && strchr(" \t\r\n", oti_str[len-1])) len--;
+
+	//hexBinary, otherwise base64
+	for (i=0; i<len; i++) {
+		if (!isxdigit(oti_str[i])) break;
+	}
+	if ((i==len) && !(len%2) && (len/2 <= sizeof(oti))) {
+		for (i=0; i<len/2; i++) {
+			char szHex[3];
+			u32 v;
+			szHex[0] = oti_str[2*i];
+			szHex[1] = oti_str[2*i+1];
+			szHex[2] = 0;
+			sscanf(szHex, "%x", &v);
+			oti[i] = (u8) v;
+		}
+		oti_len = len/2;
+	} else {
+		oti_len = gf_base64_decode((u8 *) oti_str, len, oti, sizeof(oti));
+	}
+	//RFC 5510 FEC OTI: transfer length (48 bits), m, G, E (16 bits), B (16 bits), max_n (16 bits)
+	if (oti_len < 14) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d TSI %u invalid FECOTI %s, ignoring repair flow\n", s->service_id, rlct->tsi, oti_str));
+		return;
+	}
+	m = oti[6];
+	E = ((u32) oti[8])<<8 | oti[9];
+	B = ((u32) oti[10])<<8 | oti[11];
+	if ((m != 8) || !E || !B || (B >= GF_RS_ERASURE_MAX_SYMBOLS)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d TSI %u unsupported Reed-Solomon parameters m=%u E=%u B=%u, ignoring repair flow\n", s->service_id, rlct->tsi, m, E, B));
+		return;
+	}
+	rlct->fec_symbol_size = E;
+	rlct->fec_max_sbl = B;
+	GF_LOG(GF_LOG_INFO, GF_LOG_ROUTE, ("[ROUTE] Service %d TSI %u repair flow for TSI %u: Reed-Solomon symbol size %u max source block length %u\n", s->service_id, rlct->tsi, rlct->repair_src_tsi ? rlct->repair_src_tsi : rlct->tsi, E, B));
+}
+
 static GF_Err gf_route_service_setup_stsid(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, char *content, char *content_location)
 {
 	GF_Err e;
 	GF_XMLAttribute *att;
-	GF_XMLNode *rs, *ls, *srcf, *efdt, *node, *root;
+	GF_XMLNode *rs, *ls, *srcf, *rprf, *efdt, *node, *root;
 	u32 i, j, k, crc, nb_lct_channels=0;
 
 	crc = gf_crc_32(content, (u32) strlen(content) );
@@ -1122,7 +1747,10 @@ static GF_Err gf_route_service_setup_stsid(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 			gf_sk_set_buffer_size(rsess->sock, GF_FALSE, routedmx->unz_buffer_size);
 			//gf_sk_set_block_mode(rsess->sock, GF_TRUE);
 			s->secondary_sockets++;
-			if (s->tune_mode == GF_ROUTE_TUNE_ON) gf_sk_group_register(routedmx->active_sockets, rsess->sock);
+			if (s->tune_mode == GF_ROUTE_TUNE_ON) {
+				if (s->worker) s->worker->sockets_dirty = GF_TRUE;
+				else gf_sk_group_register(routedmx->active_sockets, rsess->sock);
+			}
 		}
 		gf_list_add(s->route_sessions, rsess);
 
@@ -1143,15 +1771,30 @@ static GF_Err gf_route_service_setup_stsid(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 				return GF_NON_COMPLIANT_BITSTREAM;
 			}
 			k=0;
-			srcf = NULL;
-			while ((srcf = gf_list_enum(ls->content, &k))) {
-				if ((srcf->type == GF_XML_NODE_TYPE) && !strcmp(srcf->name, "SrcFlow")) break;
-				srcf = NULL;
+			srcf = rprf = NULL;
+			while ((node = gf_list_enum(ls->content, &k))) {
+				if (node->type != GF_XML_NODE_TYPE) continue;
+				if (!strcmp(node->name, "SrcFlow")) srcf = node;
+				else if (!strcmp(node->name, "RprFlow")) rprf = node;
 			}
-			if (!srcf) {
+			if (!srcf && !rprf) {
 				GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] Service %d missing srcFlow in LS/ROUTE session\n", s->service_id));
 				return GF_NON_COMPLIANT_BITSTREAM;
 			}
+			//repair flow only, attached to the protected source flow
+			if (!srcf) {
+				GF_SAFEALLOC(rlct, GF_ROUTELCTChannel);
+				if (!rlct) return GF_OUT_OF_MEM;
+				rlct->tsi = tsi;
+				rlct->static_files = gf_list_new();
+				gf_route_service_setup_repair_flow(s, rlct, rprf);
+				if (!rlct->repair_src_tsi) {
+					GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d repair flow TSI %u without protected source TSI, ignoring\n", s->service_id, tsi));
+					rlct->fec_symbol_size = 0;
+				}
+				gf_list_add(rsess->channels, rlct);
+				continue;
+			}
 			//enum srcf for efdt
 			k=0;
 			efdt = NULL;
@@ -1259,6 +1902,12 @@ static GF_Err gf_route_service_setup_stsid(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 			rlct->static_files = static_files;
 			rlct->tsi = tsi;
 			rlct->toi_template = NULL;
+			rlct->has_src_flow = GF_TRUE;
+			if (rprf) {
+				gf_route_service_setup_repair_flow(s, rlct, rprf);
+				//repair flow in the same LS only protects its own source flow
+				rlct->repair_src_tsi = 0;
+			}
 			if (file_template) {
 				sep = strstr(file_template, "$TOI");
 				sep[0] = 0;
@@ -1453,7 +2102,10 @@ static GF_Err gf_route_dmx_process_service_signaling(GF_ROUTEDmx *routedmx, GF_R
 		else if (!strcmp(szContentType, "application/s-tsid") || !strcmp(szContentType, "application/route-s-tsid+xml")) {
 			if (!s->stsid_version || (stsid_version && (stsid_version+1 != s->stsid_version))) {
 				s->stsid_version = stsid_version+1;
+				//sessions are used by the receive thread
+				gf_mx_p(s->mx);
 				gf_route_service_setup_stsid(routedmx, s, payload, szContentLocation);
+				gf_mx_v(s->mx);
 			} else {
 				GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d same S-TSID version, ignoring\n",s->service_id));
 			}
@@ -1468,46 +2120,32 @@ static GF_Err gf_route_dmx_process_service_signaling(GF_ROUTEDmx *routedmx, GF_R
 }
 
 
-static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess)
+static GF_Err gf_route_dmx_process_lct(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_BitStream *bs, u8 *data, u32 nb_read)
 {
 	GF_Err e;
-	u32 nb_read, v, C, psi, S, O, H, /*Res, A,*/ B, hdr_len, cp, cc, tsi, toi, pos;
+	u32 v, C, psi, S, O, H, /*Res, A,*/ B, hdr_len, cp, cc, tsi, toi, pos;
 	u32 /*a_G=0, a_U=0,*/ a_S=0, a_M=0/*, a_A=0, a_H=0, a_D=0*/;
 	u64 tol_size=0;
 	Bool in_order = GF_TRUE;
 	u32 start_offset;
-	GF_ROUTELCTChannel *rlct=NULL;
+	GF_ROUTELCTChannel *rlct=NULL, *fec_rlct=NULL;
 	GF_LCTObject *gather_object=NULL;
 
-	if (route_sess) {
-		e = gf_sk_receive_no_select(route_sess->sock, routedmx->buffer, routedmx->buffer_size, &nb_read);
-	} else {
-		e = gf_sk_receive_no_select(s->sock, routedmx->buffer, routedmx->buffer_size, &nb_read);
-	}
-
-	if (e != GF_OK) return e;
-	assert(nb_read);
-
-	routedmx->nb_packets++;
-	routedmx->total_bytes_recv += nb_read;
-	routedmx->last_pck_time = gf_sys_clock_high_res();
-	if (!routedmx->first_pck_time) routedmx->first_pck_time = routedmx->last_pck_time;
-
-	e = gf_bs_reassign_buffer(routedmx->bs, routedmx->buffer, nb_read);
+	e = gf_bs_reassign_buffer(bs, data, nb_read);
 	if (e != GF_OK) return e;
 
 	//parse LCT header
-	v = gf_bs_read_int(routedmx->bs, 4);
-	C = gf_bs_read_int(routedmx->bs, 2);
-	psi = gf_bs_read_int(routedmx->bs, 2);
-	S = gf_bs_read_int(routedmx->bs, 1);
-	O = gf_bs_read_int(routedmx->bs, 2);
-	H = gf_bs_read_int(routedmx->bs, 1);
-	/*Res = */gf_bs_read_int(routedmx->bs, 2);
-	/*A = */gf_bs_read_int(routedmx->bs, 1);
-	B = gf_bs_read_int(routedmx->bs, 1);
-	hdr_len = gf_bs_read_int(routedmx->bs, 8);
-	cp = gf_bs_read_int(routedmx->bs, 8);
+	v = gf_bs_read_int(bs, 4);
+	C = gf_bs_read_int(bs, 2);
+	psi = gf_bs_read_int(bs, 2);
+	S = gf_bs_read_int(bs, 1);
+	O = gf_bs_read_int(bs, 2);
+	H = gf_bs_read_int(bs, 1);
+	/*Res = */gf_bs_read_int(bs, 2);
+	/*A = */gf_bs_read_int(bs, 1);
+	B = gf_bs_read_int(bs, 1);
+	hdr_len = gf_bs_read_int(bs, 8);
+	cp = gf_bs_read_int(bs, 8);
 
 	if (v!=1) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] Service %d : wrong LCT header version %d\n", s->service_id, v));
@@ -1538,19 +2176,19 @@ static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 		return GF_NON_COMPLIANT_BITSTREAM;
 	}
 
-	if (psi==0) {
-		GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d : FEC ROUTE not implemented\n", s->service_id));
-		return GF_NOT_SUPPORTED;
-	}
-
-	cc = gf_bs_read_u32(routedmx->bs);
-	tsi = gf_bs_read_u32(routedmx->bs);
-	toi = gf_bs_read_u32(routedmx->bs);
+	cc = gf_bs_read_u32(bs);
+	tsi = gf_bs_read_u32(bs);
+	toi = gf_bs_read_u32(bs);
 	hdr_len-=4;
 
 	//filter TSI if not 0 (service TSI) and debug mode set
 	if (routedmx->debug_tsi && tsi && (tsi!=routedmx->debug_tsi)) return GF_OK;
 
+	if ((psi==0) && !tsi) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d : repair packet on TSI 0 not supported, skipping packet (TOI %u)\n", s->service_id, toi));
+		return GF_OK;
+	}
+
 	//look for TSI 0 first
 	if (tsi!=0) {
 		Bool cp_found = GF_FALSE;
@@ -1580,7 +2218,36 @@ static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d : no session with TSI %u defined, skipping packet (TOI %u)\n", s->service_id, tsi, toi));
 			return GF_OK;
 		}
-		for (i=0; rlct && i<rlct->nb_cps; i++) {
+		//repair packet, fetch source flow and FEC parameters
+		if (psi==0) {
+			fec_rlct = rlct;
+			if (!fec_rlct->fec_symbol_size) {
+				GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d : no supported repair flow for TSI %u, skipping packet (TOI %u)\n", s->service_id, tsi, toi));
+				return GF_OK;
+			}
+			if (fec_rlct->repair_src_tsi) {
+				GF_ROUTESession *rsess;
+				tsi = fec_rlct->repair_src_tsi;
+				rlct = NULL;
+				i=0;
+				while (!rlct && (rsess = gf_list_enum(s->route_sessions, &i))) {
+					u32 j=0;
+					while ((rlct = gf_list_enum(rsess->channels, &j))) {
+						if ((rlct->tsi == tsi) && rlct->has_src_flow) break;
+					}
+				}
+				if (!rlct) {
+					GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d : no source flow with TSI %u for repair flow, skipping packet (TOI %u)\n", s->service_id, tsi, toi));
+					return GF_OK;
+				}
+			}
+			cp_found = GF_TRUE;
+		}
+		else if (!rlct->has_src_flow) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d : source packet on repair flow TSI %u, skipping packet (TOI %u)\n", s->service_id, tsi, toi));
+			return GF_OK;
+		}
+		for (i=0; rlct && !fec_rlct && i<rlct->nb_cps; i++) {
 			if (rlct->CPs[i].codepoint==cp) {
 				in_order = rlct->CPs[i].order;
 				cp_found = GF_TRUE;
@@ -1617,22 +2284,22 @@ static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 
 	//parse extensions
 	while (hdr_len) {
-		u8 hel=0, het = gf_bs_read_u8(routedmx->bs);
-		if (het<128) hel = gf_bs_read_u8(routedmx->bs);
+		u8 hel=0, het = gf_bs_read_u8(bs);
+		if (het<128) hel = gf_bs_read_u8(bs);
 
 		switch (het) {
 		case GF_LCT_EXT_FDT:
-			/*flute_version = */gf_bs_read_int(routedmx->bs, 4);
-			/*fdt_instance_id = */gf_bs_read_int(routedmx->bs, 20);
+			/*flute_version = */gf_bs_read_int(bs, 4);
+			/*fdt_instance_id = */gf_bs_read_int(bs, 20);
 			break;
 
 		case GF_LCT_EXT_CENC:
-			/*content_encodind = */gf_bs_read_int(routedmx->bs, 8);
-			/*reserved = */gf_bs_read_int(routedmx->bs, 16);
+			/*content_encodind = */gf_bs_read_int(bs, 8);
+			/*reserved = */gf_bs_read_int(bs, 16);
 			break;
 
 		case GF_LCT_EXT_TOL24:
-			tol_size = gf_bs_read_int(routedmx->bs, 24);
+			tol_size = gf_bs_read_int(bs, 24);
 			break;
 
 		case GF_LCT_EXT_TOL48:
@@ -1640,7 +2307,7 @@ static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 				GF_LOG(GF_LOG_WARNING, GF_LOG_ROUTE, ("[ROUTE] Service %d : wrong HEL %d for TOL48 LCT extension, expecting 2\n", s->service_id, hel));
 				continue;
 			}
-			tol_size = gf_bs_read_long_int(routedmx->bs, 48);
+			tol_size = gf_bs_read_long_int(bs, 48);
 			break;
 
 		default:
@@ -1655,14 +2322,27 @@ static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 		else hdr_len -= 1;
 	}
 
-	start_offset = gf_bs_read_u32(routedmx->bs);
-	pos = (u32) gf_bs_get_position(routedmx->bs);
+	//FEC payload ID for repair packets, start offset for source packets
+	start_offset = gf_bs_read_u32(bs);
+	pos = (u32) gf_bs_get_position(bs);
+	if (pos > nb_read) return GF_NON_COMPLIANT_BITSTREAM;
 
-	GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d : LCT packet TSI %u TOI %u size %d startOffset %u TOL "LLU"\n", s->service_id, tsi, toi, nb_read-pos, start_offset, tol_size));
+	if (fec_rlct) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d : LCT repair packet TSI %u TOI %u size %d SBN %u ESI %u TOL "LLU"\n", s->service_id, tsi, toi, nb_read-pos, start_offset>>8, start_offset & 0xFF, tol_size));
+
+		e = gf_route_service_gather_repair(routedmx, s, tsi, toi, start_offset>>8, start_offset & 0xFF, data + pos, nb_read-pos, (u32) tol_size, in_order, rlct, fec_rlct, &gather_object);
+	} else {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_ROUTE, ("[ROUTE] Service %d : LCT packet TSI %u TOI %u size %d startOffset %u TOL "LLU"\n", s->service_id, tsi, toi, nb_read-pos, start_offset, tol_size));
 
-	e = gf_route_service_gather_object(routedmx, s, tsi, toi, start_offset, routedmx->buffer + pos, nb_read-pos, (u32) tol_size, B, in_order, rlct, &gather_object);
+		e = gf_route_service_gather_object(routedmx, s, tsi, toi, start_offset, data + pos, nb_read-pos, (u32) tol_size, B, in_order, rlct, &gather_object);
+	}
 
-	if (e==GF_EOS) {
+	if ((e==GF_EOS) && routedmx->nb_workers) {
+		//dispatched by main thread
+		if (gather_object->status != GF_LCT_OBJ_DISPATCHED)
+			gf_route_service_queue_object(s, gather_object);
+	}
+	else if (e==GF_EOS) {
 		if (!tsi) {
 			if (gather_object->status==GF_LCT_OBJ_DONE_ERR) {
 				gf_route_obj_to_reservoir(routedmx, s, gather_object);
@@ -1681,6 +2361,72 @@ static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEServic
 	return GF_OK;
 }
 
+static void gf_route_recv_stats_update(GF_ROUTERecvStats *stats, u32 nb_read)
+{
+	stats->nb_packets++;
+	stats->total_bytes_recv += nb_read;
+	stats->last_pck_time = gf_sys_clock_high_res();
+	if (!stats->first_pck_time) stats->first_pck_time = stats->last_pck_time;
+}
+
+static GF_Err gf_route_dmx_process_service(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_ROUTESession *route_sess, GF_ROUTEWorker *w)
+{
+	GF_Err e;
+	u32 i, nb_read;
+	GF_Socket *sock = route_sess ? route_sess->sock : s->sock;
+	GF_ROUTERecvStats *stats = w ? &w->stats : &routedmx->stats;
+	GF_BitStream *bs = w ? w->bs : routedmx->bs;
+	GF_SockDatagram *dgrams = w ? w->dgrams : routedmx->dgrams;
+	u32 nb_dgrams = w ? w->nb_dgrams : routedmx->nb_dgrams;
+
+	if (!nb_dgrams) {
+		u8 *buffer = w ? w->buffer : routedmx->buffer;
+		u32 buffer_size = w ? routedmx->dgram_size : routedmx->buffer_size;
+		e = gf_sk_receive_no_select(sock, buffer, buffer_size, &nb_read);
+		if (e != GF_OK) return e;
+		assert(nb_read);
+		gf_route_recv_stats_update(stats, nb_read);
+		return gf_route_dmx_process_lct(routedmx, s, bs, buffer, nb_read);
+	}
+
+	//batch mode, packets are received in a dedicated buffer since the main buffer may be reallocated when processing signaling
+	e = gf_sk_receive_batch(sock, dgrams, nb_dgrams, &nb_read);
+	if (e != GF_OK) return e;
+	for (i=0; i<nb_read; i++) {
+		GF_Err lct_e;
+		if (!dgrams[i].read) continue;
+		gf_route_recv_stats_update(stats, dgrams[i].read);
+		//process all packets received, reporting the last error
+		lct_e = gf_route_dmx_process_lct(routedmx, s, bs, dgrams[i].data, dgrams[i].read);
+		if (lct_e) e = lct_e;
+	}
+	return e;
+}
+
+static GF_Err gf_route_dmx_process_service_sockets(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, GF_SockGroup *active_sockets, GF_ROUTEWorker *w)
+{
+	u32 j;
+	GF_Err e;
+	GF_ROUTESession *rsess;
+	if (s->tune_mode==GF_ROUTE_TUNE_OFF) return GF_OK;
+
+	if (gf_sk_group_sock_is_set(active_sockets, s->sock, GF_SK_SELECT_READ)) {
+		e = gf_route_dmx_process_service(routedmx, s, NULL, w);
+		if (e) return e;
+	}
+	if (s->tune_mode!=GF_ROUTE_TUNE_ON) return GF_OK;
+	if (!s->secondary_sockets) return GF_OK;
+
+	j=0;
+	while ((rsess = (GF_ROUTESession *)gf_list_enum(s->route_sessions, &j) )) {
+		if (gf_sk_group_sock_is_set(active_sockets, rsess->sock, GF_SK_SELECT_READ)) {
+			e = gf_route_dmx_process_service(routedmx, s, rsess, w);
+			if (e) return e;
+		}
+	}
+	return GF_OK;
+}
+
 static GF_Err gf_route_dmx_process_lls(GF_ROUTEDmx *routedmx)
 {
 	u32 read;
@@ -1694,10 +2440,7 @@ static GF_Err gf_route_dmx_process_lls(GF_ROUTEDmx *routedmx)
 	if (e)
 		return e;
 
-	routedmx->nb_packets++;
-	routedmx->total_bytes_recv += read;
-	routedmx->last_pck_time = gf_sys_clock_high_res();
-	if (!routedmx->first_pck_time) routedmx->first_pck_time = routedmx->last_pck_time;
+	gf_route_recv_stats_update(&routedmx->stats, read);
 
 	lls_table_id = routedmx->buffer[0];
 	lls_group_id = routedmx->buffer[1];
@@ -1765,12 +2508,108 @@ static GF_Err gf_route_dmx_process_lls(GF_ROUTEDmx *routedmx)
 	return GF_OK;
 }
 
+//dispatches objects completed by the receive thread, returns GF_TRUE if something was dispatched
+static Bool gf_route_dmx_dispatch_service(GF_ROUTEDmx *routedmx, GF_ROUTEService *s)
+{
+	Bool dispatched = GF_FALSE;
+	//objects are popped one at a time, since dispatching may remove other objects from the service
+	while (1) {
+		u32 i, bytes_done = 0;
+		GF_LCTObject *obj;
+
+		gf_mx_p(s->mx);
+		obj = gf_list_pop_front(s->done_objects);
+		if (obj) {
+			//object was reset by the receive thread after being queued
+			if (obj->status < GF_LCT_OBJ_DONE_ERR) {
+				gf_mx_v(s->mx);
+				continue;
+			}
+			//incomplete signaling or empty object, recycle
+			if ((!obj->tsi && (obj->status==GF_LCT_OBJ_DONE_ERR)) || (obj->tsi && !obj->nb_frags)) {
+				gf_route_obj_to_reservoir(routedmx, s, obj);
+				gf_mx_v(s->mx);
+				dispatched = GF_TRUE;
+				continue;
+			}
+			//signaling already processed
+			if (!obj->tsi && (obj->status==GF_LCT_OBJ_DISPATCHED)) {
+				gf_mx_v(s->mx);
+				continue;
+			}
+		} else {
+			//progressive dispatch of objects being received
+			i=0;
+			while ((obj = gf_list_enum(s->objects, &i))) {
+				if (!obj->push_pending) continue;
+				obj->push_pending = GF_FALSE;
+				if ((obj->status != GF_LCT_OBJ_RECEPTION) || !obj->nb_frags || obj->frags[0].offset) continue;
+				bytes_done = obj->frags[0].size;
+				break;
+			}
+		}
+		gf_mx_v(s->mx);
+		if (!obj) break;
+
+		dispatched = GF_TRUE;
+		//objects in done state are no longer modified by the receive thread, dispatch without holding the service lock
+		if (bytes_done) {
+			gf_route_dmx_push_object(routedmx, s, obj, GF_FALSE, GF_TRUE, GF_FALSE, bytes_done);
+		} else if (!obj->tsi) {
+			u32 v = obj->toi & 0xFF;
+			u32 a_S = (obj->toi & (1<<17)) ? 1 : 0;
+			u32 a_M = (obj->toi & (1<<18)) ? 1 : 0;
+			gf_route_dmx_process_service_signaling(routedmx, s, obj, 0, a_S ? v : 0, a_M ? v : 0);
+			gf_mx_p(s->mx);
+			obj->status = GF_LCT_OBJ_DISPATCHED;
+			gf_mx_v(s->mx);
+		} else {
+			gf_route_dmx_process_object(routedmx, s, obj);
+		}
+	}
+	return dispatched;
+}
+
+static GF_Err gf_route_dmx_process_threaded(GF_ROUTEDmx *routedmx)
+{
+	u32 i, count;
+	u64 nb_packets;
+	Bool has_data = GF_FALSE;
+
+	if (routedmx->atsc_sock) {
+		GF_Err e = gf_sk_group_select(routedmx->active_sockets, 10, GF_SK_SELECT_READ);
+		if (!e && gf_sk_group_sock_is_set(routedmx->active_sockets, routedmx->atsc_sock, GF_SK_SELECT_READ)) {
+			e = gf_route_dmx_process_lls(routedmx);
+			if (e && (e != GF_IP_NETWORK_EMPTY)) return e;
+			if (!e) has_data = GF_TRUE;
+		}
+	}
+
+	count = gf_list_count(routedmx->services);
+	for (i=0; i<count; i++) {
+		GF_ROUTEService *s = (GF_ROUTEService *)gf_list_get(routedmx->services, i);
+		if (gf_route_dmx_dispatch_service(routedmx, s))
+			has_data = GF_TRUE;
+	}
+
+	//report activity of receive threads
+	nb_packets = gf_route_dmx_get_nb_packets(routedmx);
+	if (nb_packets != routedmx->last_nb_packets) {
+		routedmx->last_nb_packets = nb_packets;
+		has_data = GF_TRUE;
+	}
+	return has_data ? GF_OK : GF_IP_NETWORK_EMPTY;
+}
+
 GF_EXPORT
 GF_Err gf_route_dmx_process(GF_ROUTEDmx *routedmx)
 {
 	u32 i, count;
 	GF_Err e;
 
+	if (routedmx->nb_workers)
+		return gf_route_dmx_process_threaded(routedmx);
+
 	//check all active sockets
 	e = gf_sk_group_select(routedmx->active_sockets, 10, GF_SK_SELECT_READ);
 	if (e) return e;
@@ -1784,27 +2623,168 @@ GF_Err gf_route_dmx_process(GF_ROUTEDmx *routedmx)
 
 	count = gf_list_count(routedmx->services);
 	for (i=0; i<count; i++) {
+		GF_ROUTEService *s = (GF_ROUTEService *)gf_list_get(routedmx->services, i);
+		e = gf_route_dmx_process_service_sockets(routedmx, s, routedmx->active_sockets, NULL);
+		if (e) return e;
+	}
+	return GF_OK;
+}
+
+static void gf_route_worker_register_sockets(GF_ROUTEWorker *w)
+{
+	u32 i;
+	GF_ROUTEService *s;
+	w->sockets_dirty = GF_FALSE;
+	w->nb_sockets = 0;
+	i=0;
+	while ((s = gf_list_enum(w->services, &i))) {
 		u32 j;
 		GF_ROUTESession *rsess;
-		GF_ROUTEService *s = (GF_ROUTEService *)gf_list_get(routedmx->services, i);
-		if (s->tune_mode==GF_ROUTE_TUNE_OFF) continue;
+		Bool do_register;
+		gf_mx_p(s->mx);
+		do_register = (s->tune_mode != GF_ROUTE_TUNE_OFF) ? GF_TRUE : GF_FALSE;
+		if (do_register) {
+			gf_sk_group_register(w->active_sockets, s->sock);
+			w->nb_sockets++;
+		} else {
+			gf_sk_group_unregister(w->active_sockets, s->sock);
+		}
+		j=0;
+		while ((rsess = gf_list_enum(s->route_sessions, &j))) {
+			if (!rsess->sock) continue;
+			if (do_register) {
+				gf_sk_group_register(w->active_sockets, rsess->sock);
+				w->nb_sockets++;
+			} else {
+				gf_sk_group_unregister(w->active_sockets, rsess->sock);
+			}
+		}
+		gf_mx_v(s->mx);
+	}
+}
 
-		if (gf_sk_group_sock_is_set(routedmx->active_sockets, s->sock, GF_SK_SELECT_READ)) {
-			e = gf_route_dmx_process_service(routedmx, s, NULL);
-			if (e) return e;
+static u32 gf_route_worker_run(void *par)
+{
+	GF_ROUTEWorker *w = (GF_ROUTEWorker *)par;
+	GF_ROUTEDmx *routedmx = w->routedmx;
+
+	while (w->running) {
+		u32 i;
+		GF_Err e;
+		GF_ROUTEService *s;
+
+		if (w->sockets_dirty) {
+			gf_mx_p(w->mx);
+			gf_route_worker_register_sockets(w);
+			gf_mx_v(w->mx);
 		}
-		if (s->tune_mode!=GF_ROUTE_TUNE_ON) continue;
-		if (!s->secondary_sockets) continue;
+		//batch reception size changed
+		if (w->nb_dgrams != routedmx->nb_dgrams) {
+			u32 nb_dgrams = routedmx->nb_dgrams;
+			w->nb_dgrams = 0;
+			if (nb_dgrams) {
+				GF_SockDatagram *dgrams = gf_realloc(w->dgrams, sizeof(GF_SockDatagram) * nb_dgrams);
+				u8 *dgram_buffer = dgrams ? gf_realloc(w->dgram_buffer, routedmx->dgram_size * nb_dgrams) : NULL;
+				if (dgrams) w->dgrams = dgrams;
+				if (dgram_buffer) {
+					w->dgram_buffer = dgram_buffer;
+					for (i=0; i<nb_dgrams; i++) {
+						w->dgrams[i].data = w->dgram_buffer + i*routedmx->dgram_size;
+						w->dgrams[i].size = routedmx->dgram_size;
+					}
+					w->nb_dgrams = nb_dgrams;
+				}
+			}
+		}
+		if (!w->nb_sockets) {
+			gf_sleep(1);
+			continue;
+		}
+		e = gf_sk_group_select(w->active_sockets, 10000, GF_SK_SELECT_READ);
+		if (e) continue;
+
+		gf_mx_p(w->mx);
+		i=0;
+		while ((s = gf_list_enum(w->services, &i))) {
+			gf_mx_p(s->mx);
+			gf_route_dmx_process_service_sockets(routedmx, s, w->active_sockets, w);
+			gf_mx_v(s->mx);
+		}
+		gf_mx_v(w->mx);
+	}
+	return 0;
+}
 
+static GF_Err gf_route_dmx_abort_workers(GF_ROUTEDmx *routedmx, GF_Err e)
+{
+	u32 i=0;
+	GF_ROUTEService *s;
+	gf_route_dmx_del_workers(routedmx);
+	//back to reception in main thread
+	while ((s = gf_list_enum(routedmx->services, &i))) {
+		if (s->tune_mode != GF_ROUTE_TUNE_OFF)
+			gf_route_register_service_sockets(routedmx, s, GF_TRUE);
+	}
+	return e;
+}
+
+GF_EXPORT
+GF_Err gf_route_set_receive_threads(GF_ROUTEDmx *routedmx, u32 nb_threads)
+{
+	u32 i, count;
+	GF_Err e;
+	if (!routedmx) return GF_BAD_PARAM;
+	if (!nb_threads) return GF_OK;
+	//cannot be changed once set
+	if (routedmx->nb_workers) return GF_BAD_PARAM;
+
+	routedmx->reservoir_mx = gf_mx_new("ROUTEReservoir");
+	routedmx->workers = gf_malloc(sizeof(GF_ROUTEWorker) * nb_threads);
+	if (!routedmx->reservoir_mx || !routedmx->workers) return GF_OUT_OF_MEM;
+	memset(routedmx->workers, 0, sizeof(GF_ROUTEWorker) * nb_threads);
+	routedmx->nb_workers = nb_threads;
+
+	for (i=0; i<nb_threads; i++) {
+		char szName[30];
+		GF_ROUTEWorker *w = &routedmx->workers[i];
+		w->routedmx = routedmx;
+		sprintf(szName, "ROUTEWorker%d", i+1);
+		w->th = gf_th_new(szName);
+		w->mx = gf_mx_new(szName);
+		w->services = gf_list_new();
+		w->active_sockets = gf_sk_group_new();
+		w->bs = gf_bs_new((char*)&e, 1, GF_BITSTREAM_READ);
+		w->buffer = gf_malloc(routedmx->dgram_size);
+		if (!w->th || !w->mx || !w->services || !w->active_sockets || !w->bs || !w->buffer)
+			return gf_route_dmx_abort_workers(routedmx, GF_OUT_OF_MEM);
+	}
+
+	//move existing services to receive threads
+	count = gf_list_count(routedmx->services);
+	for (i=0; i<count; i++) {
+		u32 j;
+		GF_ROUTESession *rsess;
+		GF_ROUTEService *s = gf_list_get(routedmx->services, i);
+		gf_sk_group_unregister(routedmx->active_sockets, s->sock);
 		j=0;
-		while ((rsess = (GF_ROUTESession *)gf_list_enum(s->route_sessions, &j) )) {
-			if (gf_sk_group_sock_is_set(routedmx->active_sockets, rsess->sock, GF_SK_SELECT_READ)) {
-				e = gf_route_dmx_process_service(routedmx, s, rsess);
-				if (e) return e;
-			}
+		while ((rsess = gf_list_enum(s->route_sessions, &j))) {
+			if (rsess->sock) gf_sk_group_unregister(routedmx->active_sockets, rsess->sock);
 		}
+		e = gf_route_service_assign_worker(routedmx, s, i);
+		if (e) return gf_route_dmx_abort_workers(routedmx, e);
+	}
 
+	for (i=0; i<nb_threads; i++) {
+		GF_ROUTEWorker *w = &routedmx->workers[i];
+		w->running = GF_TRUE;
+		e = gf_th_run(w->th, gf_route_worker_run, w);
+		if (e) {
+			GF_LOG(GF_LOG_ERROR, GF_LOG_ROUTE, ("[ROUTE] Failed to start receive thread: %s\n", gf_error_to_string(e) ));
+			w->running = GF_FALSE;
+			return gf_route_dmx_abort_workers(routedmx, e);
+		}
 	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_ROUTE, ("[ROUTE] Using %d receive threads\n", nb_threads));
 	return GF_OK;
 }
 
@@ -1827,8 +2807,12 @@ u32 gf_route_dmx_get_object_count(GF_ROUTEDmx *routedmx, u32 service_id)
 	u32 i=0;
 	GF_ROUTEService *s;
 	while ((s = gf_list_enum(routedmx->services, &i))) {
+		u32 count;
 		if (s->service_id != service_id) continue;
-		return gf_list_count(s->objects);
+		gf_mx_p(s->mx);
+		count = gf_list_count(s->objects);
+		gf_mx_v(s->mx);
+		return count;
 	}
 	return 0;
 }
@@ -1852,17 +2836,10 @@ void gf_route_dmx_print_objects(GF_ROUTEDmx *routedmx, u32 service_id)
 #endif
 
 
-static GF_Err gf_route_dmx_keep_or_remove_object_by_name(GF_ROUTEDmx *routedmx, u32 service_id, char *fileName, Bool purge_previous, Bool is_remove)
+static GF_Err gf_route_dmx_keep_or_remove_object_by_name_internal(GF_ROUTEDmx *routedmx, GF_ROUTEService *s, char *fileName, Bool purge_previous, Bool is_remove)
 {
 	u32 i=0;
-	GF_ROUTEService *s=NULL;
 	GF_LCTObject *obj = NULL;
-	while ((s = gf_list_enum(routedmx->services, &i))) {
-		if (s->service_id == service_id) break;
-		s = NULL;
-	}
-	if (!s) return GF_BAD_PARAM;
-	i=0;
 	while ((obj = gf_list_enum(s->objects, &i))) {
 		u32 toi;
 		if (obj->rlct && (sscanf(fileName, obj->rlct->toi_template, &toi) == 1)) {
@@ -1916,6 +2893,22 @@ static GF_Err gf_route_dmx_keep_or_remove_object_by_name(GF_ROUTEDmx *routedmx,
 	return GF_OK;
 }
 
+static GF_Err gf_route_dmx_keep_or_remove_object_by_name(GF_ROUTEDmx *routedmx, u32 service_id, char *fileName, Bool purge_previous, Bool is_remove)
+{
+	GF_Err e;
+	u32 i=0;
+	GF_ROUTEService *s=NULL;
+	while ((s = gf_list_enum(routedmx->services, &i))) {
+		if (s->service_id == service_id) break;
+		s = NULL;
+	}
+	if (!s) return GF_BAD_PARAM;
+	gf_mx_p(s->mx);
+	e = gf_route_dmx_keep_or_remove_object_by_name_internal(routedmx, s, fileName, purge_previous, is_remove);
+	gf_mx_v(s->mx);
+	return e;
+}
+
 GF_EXPORT
 GF_Err gf_route_dmx_force_keep_object_by_name(GF_ROUTEDmx *routedmx, u32 service_id, char *fileName)
 {
@@ -1940,6 +2933,7 @@ Bool gf_route_dmx_remove_first_object(GF_ROUTEDmx *routedmx, u32 service_id)
 	}
 	if (!s) return GF_FALSE;
 
+	gf_mx_p(s->mx);
 	i=0;
 	while ( (obj = gf_list_enum(s->objects, &i))) {
 		if (obj == s->last_active_obj) continue;
@@ -1947,15 +2941,17 @@ Bool gf_route_dmx_remove_first_object(GF_ROUTEDmx *routedmx, u32 service_id)
 		if (obj->status<=GF_LCT_OBJ_RECEPTION) break;
 
 		if (obj->force_keep)
-			return GF_FALSE;
+			break;
 
 		//keep static files active
 		if (obj->rlct_file)
 			continue;
 
 		gf_route_obj_to_reservoir(routedmx, s, obj);
+		gf_mx_v(s->mx);
 		return GF_TRUE;
 	}
+	gf_mx_v(s->mx);
 	return GF_FALSE;
 }
 
@@ -1971,6 +2967,7 @@ void gf_route_dmx_purge_objects(GF_ROUTEDmx *routedmx, u32 service_id)
 	}
 	if (!s) return;
 
+	gf_mx_p(s->mx);
 	i=0;
 	while ((obj = gf_list_enum(s->objects, &i))) {
 		//only purge non signaling objects
@@ -1984,6 +2981,7 @@ void gf_route_dmx_purge_objects(GF_ROUTEDmx *routedmx, u32 service_id)
 		//trash
 		gf_route_obj_to_reservoir(routedmx, s, obj);
 	}
+	gf_mx_v(s->mx);
 }
 
 GF_EXPORT
@@ -2015,25 +3013,52 @@ void *gf_route_dmx_get_service_udta(GF_ROUTEDmx *routedmx, u32 service_id)
 GF_EXPORT
 u64 gf_route_dmx_get_first_packet_time(GF_ROUTEDmx *routedmx)
 {
-	return routedmx ? routedmx->first_pck_time : 0;
+	u32 i;
+	u64 res;
+	if (!routedmx) return 0;
+	res = routedmx->stats.first_pck_time;
+	for (i=0; i<routedmx->nb_workers; i++) {
+		u64 t = routedmx->workers[i].stats.first_pck_time;
+		if (t && (!res || (t<res))) res = t;
+	}
+	return res;
 }
 
 GF_EXPORT
 u64 gf_route_dmx_get_last_packet_time(GF_ROUTEDmx *routedmx)
 {
-	return routedmx ? routedmx->last_pck_time : 0;
+	u32 i;
+	u64 res;
+	if (!routedmx) return 0;
+	res = routedmx->stats.last_pck_time;
+	for (i=0; i<routedmx->nb_workers; i++) {
+		if (routedmx->workers[i].stats.last_pck_time > res) res = routedmx->workers[i].stats.last_pck_time;
+	}
+	return res;
 }
 
 GF_EXPORT
 u64 gf_route_dmx_get_nb_packets(GF_ROUTEDmx *routedmx)
 {
-	return routedmx ? routedmx->nb_packets : 0;
+	u32 i;
+	u64 res;
+	if (!routedmx) return 0;
+	res = routedmx->stats.nb_packets;
+	for (i=0; i<routedmx->nb_workers; i++)
+		res += routedmx->workers[i].stats.nb_packets;
+	return res;
 }
 
 GF_EXPORT
 u64 gf_route_dmx_get_recv_bytes(GF_ROUTEDmx *routedmx)
 {
-	return routedmx ? routedmx->total_bytes_recv : 0;
+	u32 i;
+	u64 res;
+	if (!routedmx) return 0;
+	res = routedmx->stats.total_bytes_recv;
+	for (i=0; i<routedmx->nb_workers; i++)
+		res += routedmx->workers[i].stats.total_bytes_recv;
+	return res;
 }
 
 GF_EXPORT
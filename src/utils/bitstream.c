@@ -269,6 +269,21 @@ void gf_bs_prevent_dispatch(GF_BitStream *bs, Bool prevent_dispatch)
 	}
 }
 
+GF_EXPORT
+GF_Err gf_bs_forward_external(GF_BitStream *bs, u32 nb_bytes)
+{
+	if (!bs || !bs->on_block_out || bs->prevent_dispatch) return GF_BAD_PARAM;
+	if (!gf_bs_is_align(bs)) return GF_BAD_PARAM;
+
+	assert(bs->position >= bs->bytes_out);
+	if (bs->position > bs->bytes_out) {
+		bs->on_block_out(bs->usr_data, bs->original, (u32) (bs->position - bs->bytes_out));
+	}
+	bs->position += nb_bytes;
+	bs->bytes_out = bs->position;
+	return GF_OK;
+}
+
 static void bs_flush_write_cache(GF_BitStream *bs)
 {
 	if (bs->buffer_written) {
@@ -170,6 +170,10 @@ struct __DownloadedCacheEntryStruct
     GF_Blob cache_blob;
     GF_Blob *external_blob;
     Bool persistent;
+	/*entry pushed by a local cache provider, owned by the provider and never evicted*/
+	Bool local_provider;
+	/*last time the entry was created or matched by a session, used for LRU eviction of memory entries*/
+	u64 last_access;
 };
 
 Bool gf_cache_entry_persistent(const DownloadedCacheEntry entry)
@@ -466,6 +470,7 @@ DownloadedCacheEntry gf_cache_create_entry ( GF_DownloadManager * dm, const char
 	entry->deletableFilesOnDelete = GF_FALSE;
 	entry->write_session = NULL;
 	entry->sessions = gf_list_new();
+	entry->last_access = gf_sys_clock_high_res();
 
 	if (entry->memory_stored) {
 		entry->cache_filename = (char*)gf_malloc ( strlen ("gmem://") + 8 + strlen("@") + 16 + 1);
@@ -1015,6 +1020,106 @@ Bool gf_cache_is_deleted(const DownloadedCacheEntry entry)
     return GF_FALSE;
 }
 
+void gf_cache_entry_set_local_provider(const DownloadedCacheEntry entry)
+{
+	if (entry) entry->local_provider = GF_TRUE;
+}
+
+void gf_cache_entry_touch(const DownloadedCacheEntry entry)
+{
+	if (entry) entry->last_access = gf_sys_clock_high_res();
+}
+
+u64 gf_cache_entry_get_last_access(const DownloadedCacheEntry entry)
+{
+	return entry ? entry->last_access : 0;
+}
+
+GF_Mutex *gf_cache_get_blob_mutex(const DownloadedCacheEntry entry)
+{
+	return entry ? entry->cache_blob.mx : NULL;
+}
+
+u32 gf_cache_get_mem_usage(const DownloadedCacheEntry entry)
+{
+	if (!entry || !entry->memory_stored || entry->external_blob) return 0;
+	return entry->mem_allocated;
+}
+
+Bool gf_cache_can_evict(const DownloadedCacheEntry entry)
+{
+	if (!gf_cache_get_mem_usage(entry)) return GF_FALSE;
+	if (entry->persistent || entry->local_provider) return GF_FALSE;
+	if (entry->write_session || gf_list_count(entry->sessions)) return GF_FALSE;
+	if (entry->flags & (CORRUPTED|DELETED)) return GF_FALSE;
+	if (entry->cache_blob.flags & GF_BLOB_IN_TRANSFER) return GF_FALSE;
+	//blob data still used through gf_blob_get
+	if (entry->cache_blob.ref_count) return GF_FALSE;
+	return gf_cache_is_in_progress(entry) ? GF_FALSE : GF_TRUE;
+}
+
+GF_Err gf_cache_spill_to_disk(const DownloadedCacheEntry entry, const char *cache_directory)
+{
+	FILE *f;
+	u32 size;
+	char *name, *prop_name;
+	CHECK_ENTRY;
+	if (!cache_directory || !gf_cache_get_mem_usage(entry)) return GF_BAD_PARAM;
+
+	size = entry->written_in_cache;
+	//keep a different name than disk entries for the same URL
+	prop_name = gf_strdup(cache_file_prefix);
+	gf_dynstrcat(&prop_name, entry->hash, NULL);
+	gf_dynstrcat(&prop_name, "_mem", NULL);
+	gf_dynstrcat(&prop_name, default_cache_file_suffix, NULL);
+	name = gf_strdup(cache_directory);
+	gf_dynstrcat(&name, prop_name, NULL);
+	gf_dynstrcat(&prop_name, cache_file_info_suffix, NULL);
+	if (!name || !prop_name) {
+		if (name) gf_free(name);
+		if (prop_name) gf_free(prop_name);
+		return GF_OUT_OF_MEM;
+	}
+
+	f = gf_fopen(name, "wb");
+	if (!f || (gf_fwrite(entry->mem_storage, size, f) != size)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CACHE, ("[CACHE] Failed to move memory entry %s to %s\n", entry->url, name));
+		if (f) {
+			gf_fclose(f);
+			gf_file_delete(name);
+		}
+		gf_free(name);
+		gf_free(prop_name);
+		return GF_IO_ERR;
+	}
+	gf_fclose(f);
+
+	entry->properties = gf_cfg_force_new(cache_directory, prop_name);
+	gf_free(prop_name);
+
+	gf_mx_p(entry->cache_blob.mx);
+	gf_free(entry->mem_storage);
+	entry->mem_storage = NULL;
+	entry->mem_allocated = 0;
+	entry->cache_blob.data = NULL;
+	entry->cache_blob.size = 0;
+	gf_mx_v(entry->cache_blob.mx);
+
+	gf_free(entry->cache_filename);
+	entry->cache_filename = name;
+	entry->memory_stored = GF_FALSE;
+	entry->file_exists = GF_TRUE;
+	//spilled files only live as long as the download manager
+	entry->deletableFilesOnDelete = GF_TRUE;
+	entry->contentLength = entry->cacheSize = size;
+	gf_cache_set_etag_on_disk(entry, entry->serverETag);
+	gf_cache_set_last_modified_on_disk(entry, entry->serverLastModified);
+	gf_cache_flush_disk_cache(entry);
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CACHE, ("[CACHE] Moved memory entry %s (%d bytes) to %s\n", entry->url, size, entry->cache_filename));
+	return GF_OK;
+}
+
 Bool gf_cache_set_content(const DownloadedCacheEntry entry, GF_Blob *blob, Bool copy, GF_Mutex *mx)
 {
 	if (!entry || !entry->memory_stored) return GF_FALSE;
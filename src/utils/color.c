@@ -27,9 +27,23 @@
 #include <gpac/tools.h>
 #include <gpac/constants.h>
 #include <gpac/color.h>
+#include <gpac/thread.h>
 
 #ifndef GPAC_DISABLE_PLAYER
 
+//intrinsic code segfaults on 32 bit, need to check why
+#if defined(GPAC_64_BITS)
+# if defined(WIN32) && !defined(__GNUC__)
+#  include <intrin.h>
+#  define GPAC_HAS_SSE2
+# else
+#  ifdef __SSE2__
+#   include <emmintrin.h>
+#   define GPAC_HAS_SSE2
+#  endif
+# endif
+#endif
+
 static GF_Err color_write_nv12_10_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurface *vs_src, GF_Window *_src_wnd, Bool swap_up);
 static GF_Err color_write_yv12_10_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurface *vs_src, const GF_Window *_src_wnd, Bool swap_up);
 static GF_Err color_write_yuv422_10_to_yuv422(GF_VideoSurface *vs_dst, GF_VideoSurface *vs_src, GF_Window *_src_wnd, Bool swap_up);
@@ -80,6 +94,251 @@ static void yuv2rgb_init(void)
 	}
 }
 
+#ifdef GPAC_HAS_SSE2
+
+/*SIMD YUV -> RGBA conversion, giving the exact same results as the table-based code above
+
+each kernel converts one line and returns the number of pixels converted, remaining pixels being processed by the scalar code*/
+
+#define COL_MADD_COEFS(_a, _b)	_mm_set1_epi32( (s32) ( ((u32)(u16)(s16)(_b) << 16) | (u32)(u16)(s16)(_a) ) )
+
+//convert 8 pixels, y, u and v being 8 16-bit values in [0,255]
+static GFINLINE void yuv_to_rgba_8px_sse2(u8 *dst, __m128i y, __m128i u, __m128i v)
+{
+	__m128i yu, yv, vz, r_lo, r_hi, g_lo, g_hi, b_lo, b_hi, r, g, b, rg, ba;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i k_r = COL_MADD_COEFS(FIX_OUT(1.164), FIX_OUT(1.596));
+	const __m128i k_b = COL_MADD_COEFS(FIX_OUT(1.164), FIX_OUT(2.018));
+	const __m128i k_gu = COL_MADD_COEFS(FIX_OUT(1.164), -FIX_OUT(0.391));
+	const __m128i k_gv = COL_MADD_COEFS(-FIX_OUT(0.813), 0);
+
+	y = _mm_sub_epi16(y, _mm_set1_epi16(16));
+	u = _mm_sub_epi16(u, _mm_set1_epi16(128));
+	v = _mm_sub_epi16(v, _mm_set1_epi16(128));
+
+	yv = _mm_unpacklo_epi16(y, v);
+	r_lo = _mm_srai_epi32(_mm_madd_epi16(yv, k_r), SCALEBITS_OUT);
+	yv = _mm_unpackhi_epi16(y, v);
+	r_hi = _mm_srai_epi32(_mm_madd_epi16(yv, k_r), SCALEBITS_OUT);
+
+	yu = _mm_unpacklo_epi16(y, u);
+	vz = _mm_unpacklo_epi16(v, zero);
+	b_lo = _mm_srai_epi32(_mm_madd_epi16(yu, k_b), SCALEBITS_OUT);
+	g_lo = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu, k_gu), _mm_madd_epi16(vz, k_gv)), SCALEBITS_OUT);
+	yu = _mm_unpackhi_epi16(y, u);
+	vz = _mm_unpackhi_epi16(v, zero);
+	b_hi = _mm_srai_epi32(_mm_madd_epi16(yu, k_b), SCALEBITS_OUT);
+	g_hi = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu, k_gu), _mm_madd_epi16(vz, k_gv)), SCALEBITS_OUT);
+
+	//saturated packing performs col_clip
+	r = _mm_packus_epi16(_mm_packs_epi32(r_lo, r_hi), zero);
+	g = _mm_packus_epi16(_mm_packs_epi32(g_lo, g_hi), zero);
+	b = _mm_packus_epi16(_mm_packs_epi32(b_lo, b_hi), zero);
+
+	rg = _mm_unpacklo_epi8(r, g);
+	ba = _mm_unpacklo_epi8(b, _mm_set1_epi8((char)0xFF));
+	_mm_storeu_si128((__m128i *) dst, _mm_unpacklo_epi16(rg, ba));
+	_mm_storeu_si128((__m128i *) (dst+16), _mm_unpackhi_epi16(rg, ba));
+}
+
+//8 bit, chroma horizontally subsampled (420 and 422)
+static u32 yuv_row_to_rgba_sse2(u8 *dst, const u8 *y_src, const u8 *u_src, const u8 *v_src, u32 width)
+{
+	u32 x;
+	const __m128i zero = _mm_setzero_si128();
+	for (x=0; x+16<=width; x+=16) {
+		__m128i y = _mm_loadu_si128((const __m128i *) (y_src + x));
+		__m128i u = _mm_loadl_epi64((const __m128i *) (u_src + x/2));
+		__m128i v = _mm_loadl_epi64((const __m128i *) (v_src + x/2));
+		u = _mm_unpacklo_epi8(u, u);
+		v = _mm_unpacklo_epi8(v, v);
+		yuv_to_rgba_8px_sse2(dst + 4*x, _mm_unpacklo_epi8(y, zero), _mm_unpacklo_epi8(u, zero), _mm_unpacklo_epi8(v, zero));
+		yuv_to_rgba_8px_sse2(dst + 4*x + 32, _mm_unpackhi_epi8(y, zero), _mm_unpackhi_epi8(u, zero), _mm_unpackhi_epi8(v, zero));
+	}
+	return x;
+}
+
+//8 bit, full chroma (444)
+static u32 yuv444_row_to_rgba_sse2(u8 *dst, const u8 *y_src, const u8 *u_src, const u8 *v_src, u32 width)
+{
+	u32 x;
+	const __m128i zero = _mm_setzero_si128();
+	for (x=0; x+16<=width; x+=16) {
+		__m128i y = _mm_loadu_si128((const __m128i *) (y_src + x));
+		__m128i u = _mm_loadu_si128((const __m128i *) (u_src + x));
+		__m128i v = _mm_loadu_si128((const __m128i *) (v_src + x));
+		yuv_to_rgba_8px_sse2(dst + 4*x, _mm_unpacklo_epi8(y, zero), _mm_unpacklo_epi8(u, zero), _mm_unpacklo_epi8(v, zero));
+		yuv_to_rgba_8px_sse2(dst + 4*x + 32, _mm_unpackhi_epi8(y, zero), _mm_unpackhi_epi8(u, zero), _mm_unpackhi_epi8(v, zero));
+	}
+	return x;
+}
+
+//8 bit semi-planar (NV12/NV21), uv_src points to the interleaved chroma and swap_uv is set for NV21
+static u32 yuv_nv12_row_to_rgba_sse2(u8 *dst, const u8 *y_src, const u8 *uv_src, Bool swap_uv, u32 width)
+{
+	u32 x;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lo_mask = _mm_set1_epi16(0x00FF);
+	for (x=0; x+16<=width; x+=16) {
+		__m128i y = _mm_loadu_si128((const __m128i *) (y_src + x));
+		__m128i uv = _mm_loadu_si128((const __m128i *) (uv_src + x));
+		__m128i u = _mm_and_si128(uv, lo_mask);
+		__m128i v = _mm_srli_epi16(uv, 8);
+		if (swap_uv) {
+			__m128i t = u;
+			u = v;
+			v = t;
+		}
+		yuv_to_rgba_8px_sse2(dst + 4*x, _mm_unpacklo_epi8(y, zero), _mm_unpacklo_epi16(u, u), _mm_unpacklo_epi16(v, v));
+		yuv_to_rgba_8px_sse2(dst + 4*x + 32, _mm_unpackhi_epi8(y, zero), _mm_unpackhi_epi16(u, u), _mm_unpackhi_epi16(v, v));
+	}
+	return x;
+}
+
+//10 bit, chroma horizontally subsampled (420 and 422)
+static u32 yuv_10_row_to_rgba_sse2(u8 *dst, const u16 *y_src, const u16 *u_src, const u16 *v_src, u32 width)
+{
+	u32 x;
+	for (x=0; x+8<=width; x+=8) {
+		__m128i y = _mm_srli_epi16(_mm_loadu_si128((const __m128i *) (y_src + x)), 2);
+		__m128i u = _mm_srli_epi16(_mm_loadl_epi64((const __m128i *) (u_src + x/2)), 2);
+		__m128i v = _mm_srli_epi16(_mm_loadl_epi64((const __m128i *) (v_src + x/2)), 2);
+		yuv_to_rgba_8px_sse2(dst + 4*x, y, _mm_unpacklo_epi16(u, u), _mm_unpacklo_epi16(v, v));
+	}
+	return x;
+}
+
+//10 bit, full chroma (444)
+static u32 yuv444_10_row_to_rgba_sse2(u8 *dst, const u16 *y_src, const u16 *u_src, const u16 *v_src, u32 width)
+{
+	u32 x;
+	for (x=0; x+8<=width; x+=8) {
+		__m128i y = _mm_srli_epi16(_mm_loadu_si128((const __m128i *) (y_src + x)), 2);
+		__m128i u = _mm_srli_epi16(_mm_loadu_si128((const __m128i *) (u_src + x)), 2);
+		__m128i v = _mm_srli_epi16(_mm_loadu_si128((const __m128i *) (v_src + x)), 2);
+		yuv_to_rgba_8px_sse2(dst + 4*x, y, u, v);
+	}
+	return x;
+}
+
+//unscaled copy of RGBA line to RGBX or BGRX, only writing pixels with non-zero alpha
+static u32 copy_row_rgbx_sse2(u8 *src, u8 *dst, u32 width, Bool swap_rb)
+{
+	u32 x;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i a_mask = _mm_set1_epi32((s32) 0xFF000000);
+	const __m128i ag_mask = _mm_set1_epi32((s32) 0xFF00FF00);
+	const __m128i b_mask = _mm_set1_epi32(0x000000FF);
+	for (x=0; x+4<=width; x+=4) {
+		__m128i s = _mm_loadu_si128((const __m128i *) (src + 4*x));
+		__m128i d = _mm_loadu_si128((const __m128i *) (dst + 4*x));
+		__m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(s, a_mask), zero);
+		if (swap_rb) {
+			s = _mm_or_si128(_mm_and_si128(s, ag_mask),
+				_mm_or_si128(_mm_and_si128(_mm_srli_epi32(s, 16), b_mask), _mm_slli_epi32(_mm_and_si128(s, b_mask), 16)));
+		}
+		s = _mm_or_si128(s, a_mask);
+		d = _mm_or_si128(_mm_and_si128(transparent, d), _mm_andnot_si128(transparent, s));
+		_mm_storeu_si128((__m128i *) (dst + 4*x), d);
+	}
+	return x;
+}
+
+//blend 2 RGBA pixels (16-bit channels) of a line already in destination channel order, over 2 destination pixels
+//same arithmetic as the merge_row_* functions: mul255(a, b) is computed as ((a+1)*b)>>8 on 16 bits
+static GFINLINE __m128i merge_2px_sse2(__m128i s, __m128i d, __m128i alpha, Bool dst_alpha)
+{
+	__m128i a, a1, x, res;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i a_lanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+
+	//source alpha broadcast to all channels, a = mul255(a, alpha)
+	a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xFF), 0xFF);
+	a = _mm_srli_epi16(_mm_mullo_epi16(_mm_add_epi16(a, one), alpha), 8);
+	a1 = _mm_add_epi16(a, one);
+
+	//mul255(a, s - d) + d, the signed product being shifted back to 16 bits from its low and high words
+	x = _mm_sub_epi16(s, d);
+	res = _mm_or_si128(_mm_slli_epi16(_mm_mulhi_epi16(a1, x), 8), _mm_srli_epi16(_mm_mullo_epi16(a1, x), 8));
+	res = _mm_add_epi16(res, d);
+
+	if (!dst_alpha) {
+		res = _mm_or_si128(_mm_andnot_si128(a_lanes, res), _mm_and_si128(a_lanes, _mm_set1_epi16(0xFF)));
+	} else {
+		//mul255(a, a) + mul255(0xFF - a, 0xFF)
+		__m128i res_a = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(a1, a), 8),
+			_mm_srli_epi16(_mm_mullo_epi16(_mm_sub_epi16(_mm_set1_epi16(256), a), _mm_set1_epi16(0xFF)), 8));
+		__m128i src_px = _mm_or_si128(_mm_andnot_si128(a_lanes, s), _mm_and_si128(a_lanes, a));
+		__m128i d_transparent = _mm_cmpeq_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(d, 0xFF), 0xFF), zero);
+		res = _mm_or_si128(_mm_andnot_si128(a_lanes, res), _mm_and_si128(a_lanes, res_a));
+		//transparent destination, copy source pixel with its modulated alpha
+		res = _mm_or_si128(_mm_and_si128(d_transparent, src_px), _mm_andnot_si128(d_transparent, res));
+	}
+	//null alpha, destination unchanged
+	x = _mm_cmpeq_epi16(a, zero);
+	return _mm_or_si128(_mm_and_si128(x, d), _mm_andnot_si128(x, res));
+}
+
+//unscaled blend of RGBA line on RGBX/BGRX (dst_alpha not set) or RGBA/BGRA (dst_alpha set) line
+static u32 merge_row_rgbx_sse2(u8 *src, u8 *dst, u32 width, u8 alpha, Bool swap_rb, Bool dst_alpha)
+{
+	u32 x;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alpha_v = _mm_set1_epi16(alpha);
+	for (x=0; x+4<=width; x+=4) {
+		__m128i s = _mm_loadu_si128((const __m128i *) (src + 4*x));
+		__m128i d = _mm_loadu_si128((const __m128i *) (dst + 4*x));
+		__m128i s_lo = _mm_unpacklo_epi8(s, zero);
+		__m128i s_hi = _mm_unpackhi_epi8(s, zero);
+		if (swap_rb) {
+			s_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, _MM_SHUFFLE(3,0,1,2)), _MM_SHUFFLE(3,0,1,2));
+			s_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, _MM_SHUFFLE(3,0,1,2)), _MM_SHUFFLE(3,0,1,2));
+		}
+		s_lo = merge_2px_sse2(s_lo, _mm_unpacklo_epi8(d, zero), alpha_v, dst_alpha);
+		s_hi = merge_2px_sse2(s_hi, _mm_unpackhi_epi8(d, zero), alpha_v, dst_alpha);
+		_mm_storeu_si128((__m128i *) (dst + 4*x), _mm_packus_epi16(s_lo, s_hi));
+	}
+	return x;
+}
+
+//planar 8 bit line with horizontally subsampled chroma to packed 422 (YUYV and variants)
+//c0 and c1 are the first and second chroma planes in output order, luma_first is set for YUYV and YVYU
+static u32 yuv_row_to_packed_sse2(u8 *dst, const u8 *y_src, const u8 *c0_src, const u8 *c1_src, u32 width, Bool luma_first)
+{
+	u32 x;
+	for (x=0; x+16<=width; x+=16) {
+		__m128i y = _mm_loadu_si128((const __m128i *) (y_src + x));
+		__m128i c = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (c0_src + x/2)), _mm_loadl_epi64((const __m128i *) (c1_src + x/2)));
+		if (luma_first) {
+			_mm_storeu_si128((__m128i *) (dst + 2*x), _mm_unpacklo_epi8(y, c));
+			_mm_storeu_si128((__m128i *) (dst + 2*x + 16), _mm_unpackhi_epi8(y, c));
+		} else {
+			_mm_storeu_si128((__m128i *) (dst + 2*x), _mm_unpacklo_epi8(c, y));
+			_mm_storeu_si128((__m128i *) (dst + 2*x + 16), _mm_unpackhi_epi8(c, y));
+		}
+	}
+	return x;
+}
+
+//keep every other sample of a chroma line, for 444 to 420 repacking - returns number of output samples
+static u32 chroma_row_decimate_sse2(u8 *dst, const u8 *src, u32 width)
+{
+	u32 x;
+	const __m128i lo_mask = _mm_set1_epi16(0x00FF);
+	for (x=0; x+16<=width; x+=16) {
+		__m128i lo = _mm_and_si128(_mm_loadu_si128((const __m128i *) (src + 2*x)), lo_mask);
+		__m128i hi = _mm_and_si128(_mm_loadu_si128((const __m128i *) (src + 2*x + 16)), lo_mask);
+		_mm_storeu_si128((__m128i *) (dst + x), _mm_packus_epi16(lo, hi));
+	}
+	return x;
+}
+
+//runtime check, SIMD code can be disabled through -no-simd
+#define color_use_sse2()	(gf_sys_get_cpu_features() & GF_CPU_SSE2)
+
+#endif //GPAC_HAS_SSE2
+
 static void yuv_load_lines_planar(unsigned char *dst, s32 dststride, unsigned char *y_src, unsigned char *u_src, unsigned char * v_src, s32 y_stride, s32 uv_stride, s32 width, Bool dst_yuv)
 {
 	u32 hw, x;
@@ -113,7 +372,19 @@ static void yuv_load_lines_planar(unsigned char *dst, s32 dststride, unsigned ch
 		}
 		return;
 	}
-	for (x = 0; x < hw; x++) {
+	x = 0;
+#ifdef GPAC_HAS_SSE2
+	if (color_use_sse2()) {
+		u32 done = yuv_row_to_rgba_sse2(dst, y_src, u_src, v_src, width);
+		yuv_row_to_rgba_sse2(dst2, y_src2, u_src, v_src, width);
+		x = done/2;
+		y_src += done;
+		y_src2 += done;
+		dst += 4*done;
+		dst2 += 4*done;
+	}
+#endif
+	for (; x < hw; x++) {
 		s32 u, v;
 		s32 b_u, g_uv, r_v, rgb_y;
 
@@ -197,7 +468,23 @@ static void yuv422_load_lines_planar(unsigned char *dst, s32 dststride, unsigned
 		return;
 	}
 
-	for (x = 0; x < hw; x++) {
+	x = 0;
+#ifdef GPAC_HAS_SSE2
+	if (color_use_sse2()) {
+		u32 done = yuv_row_to_rgba_sse2(dst, y_src, u_src, v_src, width);
+		yuv_row_to_rgba_sse2(dst2, y_src2, u_src2, v_src2, width);
+		x = done/2;
+		y_src += done;
+		y_src2 += done;
+		u_src += done/2;
+		v_src += done/2;
+		u_src2 += done/2;
+		v_src2 += done/2;
+		dst += 4*done;
+		dst2 += 4*done;
+	}
+#endif
+	for (; x < hw; x++) {
 		s32 b_u, g_uv, r_v, rgb_y;
 
 		b_u = B_U[*u_src];
@@ -296,7 +583,23 @@ static void yuv444_load_lines_planar(unsigned char *dst, s32 dststride, unsigned
 		return;
 	}
 
-	for (x = 0; x < hw; x++) {
+	x = 0;
+#ifdef GPAC_HAS_SSE2
+	if (color_use_sse2()) {
+		u32 done = yuv444_row_to_rgba_sse2(dst, y_src, u_src, v_src, width);
+		yuv444_row_to_rgba_sse2(dst2, y_src2, u_src2, v_src2, width);
+		x = done/2;
+		y_src += done;
+		y_src2 += done;
+		u_src += done;
+		v_src += done;
+		u_src2 += done;
+		v_src2 += done;
+		dst += 4*done;
+		dst2 += 4*done;
+	}
+#endif
+	for (; x < hw; x++) {
 		s32 b_u, g_uv, r_v, rgb_y;
 
 
@@ -393,7 +696,19 @@ static void yuv_10_load_lines_planar(unsigned char *dst, s32 dststride, unsigned
 		}
 		return;
 	}
-	for (x = 0; x < hw; x++) {
+	x = 0;
+#ifdef GPAC_HAS_SSE2
+	if (color_use_sse2()) {
+		u32 done = yuv_10_row_to_rgba_sse2(dst, y_src, u_src, v_src, width);
+		yuv_10_row_to_rgba_sse2(dst2, y_src2, u_src, v_src, width);
+		x = done/2;
+		y_src += done;
+		y_src2 += done;
+		dst += 4*done;
+		dst2 += 4*done;
+	}
+#endif
+	for (; x < hw; x++) {
 		s32 u, v;
 		s32 b_u, g_uv, r_v, rgb_y;
 
@@ -480,7 +795,23 @@ static void yuv422_10_load_lines_planar(unsigned char *dst, s32 dststride, unsig
 		}
 		return;
 	}
-	for (x = 0; x < hw; x++) {
+	x = 0;
+#ifdef GPAC_HAS_SSE2
+	if (color_use_sse2()) {
+		u32 done = yuv_10_row_to_rgba_sse2(dst, y_src, u_src, v_src, width);
+		yuv_10_row_to_rgba_sse2(dst2, y_src2, u_src2, v_src2, width);
+		x = done/2;
+		y_src += done;
+		y_src2 += done;
+		u_src += done/2;
+		v_src += done/2;
+		u_src2 += done/2;
+		v_src2 += done/2;
+		dst += 4*done;
+		dst2 += 4*done;
+	}
+#endif
+	for (; x < hw; x++) {
 		s32 b_u, g_uv, r_v, rgb_y;
 
 		b_u = B_U[*u_src >> 2];
@@ -580,7 +911,23 @@ static void yuv444_10_load_lines_planar(unsigned char *dst, s32 dststride, unsig
 		}
 		return;
 	}
-	for (x = 0; x < hw; x++) {
+	x = 0;
+#ifdef GPAC_HAS_SSE2
+	if (color_use_sse2()) {
+		u32 done = yuv444_10_row_to_rgba_sse2(dst, y_src, u_src, v_src, width);
+		yuv444_10_row_to_rgba_sse2(dst2, y_src2, u_src2, v_src2, width);
+		x = done/2;
+		y_src += done;
+		y_src2 += done;
+		u_src += done;
+		v_src += done;
+		u_src2 += done;
+		v_src2 += done;
+		dst += 4*done;
+		dst2 += 4*done;
+	}
+#endif
+	for (; x < hw; x++) {
 		s32 b_u, g_uv, r_v, rgb_y;
 
 
@@ -890,6 +1237,14 @@ static void copy_row_bgrx(u8 *src, u32 src_w, u8 *dst, u32 dst_w, s32 h_inc, s32
 	u8 a=0, r=0, g=0, b=0;
 	s32 pos = 0x10000L;
 
+#ifdef GPAC_HAS_SSE2
+	if ((h_inc == 0x10000L) && (x_pitch == 4) && color_use_sse2()) {
+		u32 done = copy_row_rgbx_sse2(src, dst, dst_w, GF_TRUE);
+		src += 4*done;
+		dst += 4*done;
+		dst_w -= done;
+	}
+#endif
 	while (dst_w) {
 		while ( pos >= 0x10000L ) {
 			r = *src++;
@@ -941,6 +1296,14 @@ static void copy_row_rgbx(u8 *src, u32 src_w, u8 *dst, u32 dst_w, s32 h_inc, s32
 	u8 a=0, r=0, g=0, b=0;
 	s32 pos = 0x10000L;
 
+#ifdef GPAC_HAS_SSE2
+	if ((h_inc == 0x10000L) && (x_pitch == 4) && color_use_sse2()) {
+		u32 done = copy_row_rgbx_sse2(src, dst, dst_w, GF_FALSE);
+		src += 4*done;
+		dst += 4*done;
+		dst_w -= done;
+	}
+#endif
 	while ( dst_w) {
 		while ( pos >= 0x10000L ) {
 			r = *src++;
@@ -1191,6 +1554,14 @@ static void merge_row_bgrx(u8 *src, u32 src_w, u8 *dst, u32 dst_w, s32 h_inc, s3
 	s32 pos;
 
 	pos = 0x10000;
+#ifdef GPAC_HAS_SSE2
+	if ((h_inc == 0x10000L) && (x_pitch == 4) && color_use_sse2()) {
+		u32 done = merge_row_rgbx_sse2(src, dst, dst_w, alpha, GF_TRUE, GF_FALSE);
+		src += 4*done;
+		dst += 4*done;
+		dst_w -= done;
+	}
+#endif
 	while (dst_w) {
 		while ( pos >= 0x10000L ) {
 			r = *src++;
@@ -1227,6 +1598,14 @@ static void merge_row_rgbx(u8 *src, u32 src_w, u8 *dst, u32 dst_w, s32 h_inc, s3
 	s32 pos;
 
 	pos = 0x10000;
+#ifdef GPAC_HAS_SSE2
+	if ((h_inc == 0x10000L) && (x_pitch == 4) && color_use_sse2()) {
+		u32 done = merge_row_rgbx_sse2(src, dst, dst_w, alpha, GF_FALSE, GF_FALSE);
+		src += 4*done;
+		dst += 4*done;
+		dst_w -= done;
+	}
+#endif
 	while (dst_w) {
 		while ( pos >= 0x10000L ) {
 			r = *src++;
@@ -1262,6 +1641,14 @@ static void merge_row_bgra(u8 *src, u32 src_w, u8 *dst, u32 dst_w, s32 h_inc, s3
 	s32 pos;
 
 	pos = 0x10000;
+#ifdef GPAC_HAS_SSE2
+	if ((h_inc == 0x10000L) && (x_pitch == 4) && color_use_sse2()) {
+		u32 done = merge_row_rgbx_sse2(src, dst, dst_w, alpha, GF_TRUE, GF_TRUE);
+		src += 4*done;
+		dst += 4*done;
+		dst_w -= done;
+	}
+#endif
 	while (dst_w) {
 		while ( pos >= 0x10000L ) {
 			r = *src++;
@@ -1346,6 +1733,14 @@ static void merge_row_rgba(u8 *src, u32 src_w, u8 *dst, u32 dst_w, s32 h_inc, s3
 	u32 _a, _r, _g, _b, a=0, r=0, g=0, b=0;
 	s32 pos;
 	pos = 0x10000;
+#ifdef GPAC_HAS_SSE2
+	if ((h_inc == 0x10000L) && (x_pitch == 4) && color_use_sse2()) {
+		u32 done = merge_row_rgbx_sse2(src, dst, dst_w, alpha, GF_FALSE, GF_TRUE);
+		src += 4*done;
+		dst += 4*done;
+		dst_w -= done;
+	}
+#endif
 	while (dst_w) {
 		while ( pos >= 0x10000L ) {
 			r = *src++;
@@ -1740,7 +2135,21 @@ static void gf_yuv_load_lines_nv12_nv21(unsigned char *dst, s32 dststride, unsig
 		}
 		return;
 	}
-	for (x = 0; x < hw; x++) {
+	x = 0;
+#ifdef GPAC_HAS_SSE2
+	if (color_use_sse2()) {
+		u8 *uv_src = (u_src < v_src) ? u_src : v_src;
+		Bool swap_uv = (u_src < v_src) ? GF_FALSE : GF_TRUE;
+		u32 done = yuv_nv12_row_to_rgba_sse2(dst, y_src, uv_src, swap_uv, width);
+		yuv_nv12_row_to_rgba_sse2(dst2, y_src2, uv_src, swap_uv, width);
+		x = done/2;
+		y_src += done;
+		y_src2 += done;
+		dst += 4*done;
+		dst2 += 4*done;
+	}
+#endif
+	for (; x < hw; x++) {
 		s32 u, v;
 		s32 b_u, g_uv, r_v, rgb_y;
 
@@ -1831,157 +2240,494 @@ static Bool format_is_yuv(u32 in_pf)
 	}
 }
 
-GF_EXPORT
-GF_Err gf_stretch_bits(GF_VideoSurface *dst, GF_VideoSurface *src, GF_Window *dst_wnd, GF_Window *src_wnd, u8 alpha, Bool flip, GF_ColorKey *key, GF_ColorMatrix *cmat)
+/*rows of gf_stretch_bits are converted by slices of destination rows, possibly in parallel
+each slice uses its own line buffer and restarts the source row stepping from its first destination row*/
+typedef struct
+{
+	GF_VideoSurface *dst, *src;
+	GF_ColorMatrix *cmat;
+	GF_ColorKey *key;
+	copy_row_proto copy_row;
+	load_line_proto load_line;
+	u32 yuv_planar_type;
+	Bool flip, dst_yuv, no_memcpy, force_load_odd_yuv_lines;
+	u8 alpha, ka, kr, kg, kb, kl, kh;
+	s32 inc_x, inc_y, x_off, dst_x_pitch, src_row;
+	u32 src_w, dst_w, dst_w_size;
+	u8 *dst_bits;
+
+	//slice rows, relative to the first destination row
+	u32 first_row, nb_rows;
+	GF_Err e;
+} GF_StretchSlice;
+
+static GF_Err stretch_bits_slice(GF_StretchSlice *ctx)
 {
 	u8 *tmp, *rows;
-	u8 ka=0, kr=0, kg=0, kb=0, kl=0, kh=0;
-	s32 src_row;
-	u32 i, yuv_planar_type = 0;
-	Bool no_memcpy, dst_yuv = GF_FALSE;
-	Bool force_load_odd_yuv_lines = GF_FALSE;
+	u32 i;
 	Bool yuv_init = GF_FALSE;
-	Bool has_alpha = (alpha!=0xFF) ? GF_TRUE : GF_FALSE;
-	u32 dst_bpp, dst_w_size;
-	s32 pos_y, inc_y, inc_x, prev_row, x_off;
-	u32 src_w, src_h, dst_w, dst_h;
-	u8 *dst_bits = NULL, *dst_bits_prev = NULL, *dst_temp_bits = NULL;
-	s32 dst_x_pitch = dst->pitch_x;
-	copy_row_proto copy_row = NULL;
-	load_line_proto load_line = NULL;
-
-	if (cmat && (cmat->m[15] || cmat->m[16] || cmat->m[17] || (cmat->m[18]!=FIX_ONE) || cmat->m[19] )) has_alpha = GF_TRUE;
-	else if (key && (key->alpha<0xFF)) has_alpha = GF_TRUE;
+	s32 prev_row = -1;
+	u8 *dst_bits_prev = NULL;
+	GF_VideoSurface *src = ctx->src;
+	GF_VideoSurface *dst = ctx->dst;
+	GF_ColorMatrix *cmat = ctx->cmat;
+	GF_ColorKey *key = ctx->key;
+	copy_row_proto copy_row = ctx->copy_row;
+	load_line_proto load_line = ctx->load_line;
+	u32 yuv_planar_type = ctx->yuv_planar_type;
+	Bool flip = ctx->flip;
+	Bool dst_yuv = ctx->dst_yuv;
+	Bool no_memcpy = ctx->no_memcpy;
+	Bool force_load_odd_yuv_lines = ctx->force_load_odd_yuv_lines;
+	u8 alpha = ctx->alpha;
+	u8 ka = ctx->ka, kr = ctx->kr, kg = ctx->kg, kb = ctx->kb, kh = ctx->kh;
+#ifdef COLORKEY_MPEG4_STRICT
+	u8 kl = ctx->kl;
+#endif
+	s32 inc_x = ctx->inc_x;
+	s32 inc_y = ctx->inc_y;
+	s32 x_off = ctx->x_off;
+	s32 dst_x_pitch = ctx->dst_x_pitch;
+	u32 src_w = ctx->src_w;
+	u32 dst_w = ctx->dst_w;
+	u32 dst_w_size = ctx->dst_w_size;
+	u32 dst_h = ctx->nb_rows;
+	//position of the source row for the first row of the slice, normalized in the loop below
+	s32 pos_y = 0x10000 + ctx->first_row * inc_y;
+	s32 src_row = ctx->src_row;
+	u8 *dst_bits = ctx->dst_bits + ctx->first_row * dst->pitch_y;
 
-	//check if we have a dedicated copy/conv when no stretch nor blending (avoids line load while copying)
-	if ((alpha==0xFF) && !flip && !key && !cmat) {
-		Bool no_stretch = GF_FALSE;
-		Bool output_yuv = format_is_yuv(dst->pixel_format);
-		GF_Err e = GF_NOT_SUPPORTED;
+	tmp = (u8 *) gf_malloc(sizeof(u8) * src_w * (yuv_planar_type ? 8 : 4) );
+	if (!tmp) return GF_OUT_OF_MEM;
+	rows = tmp;
 
-		if (!dst_wnd) no_stretch = GF_TRUE;
-		else if (src_wnd) {
-			if (!dst_wnd->x && !dst_wnd->y && (dst_wnd->w==src_wnd->w) && (dst_wnd->h==src_wnd->h))
-				no_stretch = GF_TRUE;
-		} else {
-			if ((dst_wnd->w==src->width) && (dst_wnd->h==src->height))
-				no_stretch = GF_TRUE;
-		}
-		if (no_stretch && output_yuv) {
-			//check YUV10->8, YUV->YUV
-			switch (src->pixel_format) {
-			case GF_PIXEL_NV12_10:
-				e = color_write_nv12_10_to_yuv(dst, src, src_wnd, GF_FALSE);
-				break;
-			case GF_PIXEL_NV21_10:
-				e = color_write_nv12_10_to_yuv(dst, src, src_wnd, GF_TRUE);
-				break;
-			case GF_PIXEL_YUV_10:
-				e = color_write_yv12_10_to_yuv(dst, src, src_wnd, GF_FALSE);
-				break;
-			case GF_PIXEL_YUV422_10:
-				if (dst->pixel_format == GF_PIXEL_YUV422)
-					e = color_write_yuv422_10_to_yuv422(dst, src, src_wnd, GF_FALSE);
-				else if (dst->pixel_format == GF_PIXEL_YUV)
-					e = color_write_yuv422_10_to_yuv(dst, src, src_wnd, GF_FALSE);
-				else if (dst->pixel_format == GF_PIXEL_YVU)
-					e = color_write_yuv422_10_to_yuv(dst, src, src_wnd, GF_TRUE);
-				break;
-			case GF_PIXEL_YUV444_10:
-				if (dst->pixel_format == GF_PIXEL_YUV444)
-					e = color_write_yuv444_10_to_yuv444(dst, src, src_wnd, GF_FALSE);
-				else if (dst->pixel_format == GF_PIXEL_YUV)
-					e = color_write_yuv444_10_to_yuv(dst, src, src_wnd, GF_FALSE);
-				else if (dst->pixel_format == GF_PIXEL_YVU)
-					e = color_write_yuv444_10_to_yuv(dst, src, src_wnd, GF_TRUE);
-				break;
-			case GF_PIXEL_YUV:
-				e = color_write_yuv420_to_yuv(dst, src, src_wnd, GF_FALSE);
-				break;
-			case GF_PIXEL_YVU:
-				e = color_write_yuv420_to_yuv(dst, src, src_wnd, GF_TRUE);
-				break;
-			case GF_PIXEL_YUV422:
-				e = color_write_yuv422_to_yuv(dst, src, src_wnd, GF_FALSE);
-				break;
-			case GF_PIXEL_YUV444:
-				e = color_write_yuv444_to_yuv(dst, src, src_wnd, GF_FALSE);
-				break;
-			case GF_PIXEL_YUYV:
-			case GF_PIXEL_YVYU:
-			case GF_PIXEL_UYVY:
-			case GF_PIXEL_VYUY:
-				e = color_write_yvyu_to_yuv(dst, src, src_wnd, GF_FALSE);
-				break;
-			}
-		}
-		else if (no_stretch && !output_yuv) {
-			//check rgb->rgb copy
-			switch (dst->pixel_format) {
-			case GF_PIXEL_RGB:
-			case GF_PIXEL_RGBS:
-			case GF_PIXEL_BGR:
-				e = color_write_rgb_to_24(dst, src, src_wnd);
-				break;
-			case GF_PIXEL_RGBX:
-			case GF_PIXEL_XRGB:
-			case GF_PIXEL_RGBD:
-			case GF_PIXEL_RGBDS:
-			case GF_PIXEL_BGRX:
-			case GF_PIXEL_XBGR:
-				e = color_write_rgb_to_32(dst, src, src_wnd);
-				break;
-			default:
-				break;
-			}
+	while (dst_h) {
+		while ( pos_y >= 0x10000L ) {
+			src_row++;
+			pos_y -= 0x10000L;
 		}
-		if (e == GF_OK) return GF_OK;
-	}
-	
-	
-	switch (src->pixel_format) {
-	case GF_PIXEL_GREYSCALE:
-		load_line = load_line_grey;
-		break;
-	case GF_PIXEL_ALPHAGREY:
-		load_line = load_line_alpha_grey;
-		has_alpha = GF_TRUE;
-		break;
-	case GF_PIXEL_GREYALPHA:
-		load_line = load_line_grey_alpha;
-		has_alpha = GF_TRUE;
-		break;
-	case GF_PIXEL_RGB_555:
-		load_line = load_line_rgb_555;
-		break;
-	case GF_PIXEL_RGB_565:
-		load_line = load_line_rgb_565;
-		break;
-	case GF_PIXEL_RGB:
-	case GF_PIXEL_RGBS:
-		load_line = load_line_rgb_24;
-		break;
-	case GF_PIXEL_BGR:
-		load_line = load_line_bgr_24;
-		break;
-	case GF_PIXEL_ARGB:
-		has_alpha = GF_TRUE;
-		load_line = load_line_argb;
-		break;
-	case GF_PIXEL_BGRA:
-		has_alpha = GF_TRUE;
-		load_line = load_line_bgra;
-		break;
-	case GF_PIXEL_RGBA:
-	case GF_PIXEL_RGBAS:
-		has_alpha = GF_TRUE;
-	case GF_PIXEL_RGBX:
-		load_line = load_line_rgb_32;
-		break;
-	case GF_PIXEL_XRGB:
-		load_line = load_line_xrgb;
-		break;
-	case GF_PIXEL_BGRX:
+		/*new row, check if conversion is needed*/
+		if (prev_row != src_row) {
+			u32 the_row = src_row - 1;
+			if (yuv_planar_type) {
+				if (the_row % 2) {
+					if (!yuv_init || force_load_odd_yuv_lines) {
+						yuv_init = GF_TRUE;
+						the_row--;
+						if (flip) the_row = src->height - 2 - the_row;
+						if (yuv_planar_type == 1) {
+							load_line_yv12(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
+						}
+						else if (yuv_planar_type == 4) {
+							load_line_yuv422(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
+						}
+						else if (yuv_planar_type == 5) {
+							load_line_yuv444(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
+						}
+						else if (yuv_planar_type == 3) {
+							load_line_yv12_10((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
+						}
+						else if (yuv_planar_type == 6) {
+							load_line_yuv422_10((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
+						}
+						else if (yuv_planar_type == 7) {
+							load_line_yuv444_10((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
+						}
+						else if (yuv_planar_type == 8) {
+							load_line_nv21((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, dst_yuv);
+						}
+						else if (yuv_planar_type == 9) {
+							load_line_nv12((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, dst_yuv);
+						}
+						else {
+							load_line_yuva(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, (u8 *)src->a_ptr, dst_yuv);
+						}
+
+						if (cmat) {
+							for (i=0; i<2*src_w; i++) {
+								u32 idx = 4*i;
+								gf_cmx_apply_argb(cmat, (u8 *) &tmp[idx+3], (u8 *) &tmp[idx], (u8 *) &tmp[idx+1], (u8 *) &tmp[idx+2]);
+							}
+						}
+						if (key) {
+							for (i=0; i<2*src_w; i++) {
+								u32 idx = 4*i;
+								s32 thres, v;
+								v = tmp[idx]-kr;
+								thres = ABS(v);
+								v = tmp[idx+1]-kg;
+								thres += ABS(v);
+								v = tmp[idx+2]-kb;
+								thres += ABS(v);
+								thres/=3;
+#ifdef COLORKEY_MPEG4_STRICT
+								if (thres < kl) tmp[idx+3] = 0;
+								else if (thres <= kh) tmp[idx+3] = (thres-kl)*ka / (kh-kl);
+#else
+								if (thres < kh) tmp[idx+3] = 0;
+#endif
+								else tmp[idx+3] = ka;
+							}
+						}
+					}
+					rows = flip ? tmp : tmp + src_w * 4;
+				}
+				else {
+					if (flip) the_row = src->height - 2 - the_row;
+					if (yuv_planar_type == 1) {
+						load_line_yv12(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
+					}
+					else if (yuv_planar_type == 4) {
+						load_line_yuv422(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
+					}
+					else if (yuv_planar_type == 5) {
+						load_line_yuv444(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
+					}
+					else if (yuv_planar_type == 3) {
+						load_line_yv12_10((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
+					}
+					else if (yuv_planar_type == 6) {
+						load_line_yuv422_10((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
+					}
+					else if (yuv_planar_type == 7) {
+						load_line_yuv444_10((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
+					}
+					else if (yuv_planar_type == 8) {
+						load_line_nv21((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, dst_yuv);
+					}
+					else if (yuv_planar_type == 9) {
+						load_line_nv12((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, dst_yuv);
+					}
+					else {
+						load_line_yuva(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, (u8 *)src->a_ptr, dst_yuv);
+					}
+					yuv_init = GF_TRUE;
+					rows = flip ? tmp + src_w * 4 : tmp;
+
+					if (cmat) {
+						for (i=0; i<2*src_w; i++) {
+							u32 idx = 4*i;
+							gf_cmx_apply_argb(cmat, &tmp[idx+3], &tmp[idx], &tmp[idx+1], &tmp[idx+2]);
+						}
+					}
+					if (key) {
+						for (i=0; i<2*src_w; i++) {
+							u32 idx = 4*i;
+							s32 thres, v;
+							v = tmp[idx]-kr;
+							thres = ABS(v);
+							v = tmp[idx+1]-kg;
+							thres += ABS(v);
+							v = tmp[idx+2]-kb;
+							thres += ABS(v);
+							thres/=3;
+#ifdef COLORKEY_MPEG4_STRICT
+							if (thres < kl) tmp[idx+3] = 0;
+							else if (thres <= kh) tmp[idx+3] = (thres-kl)*ka / (kh-kl);
+#else
+							if (thres < kh) tmp[idx+3] = 0;
+#endif
+							else tmp[idx+3] = ka;
+						}
+					}
+				}
+			} else {
+				if (flip) the_row = src->height-1 - the_row;
+				load_line((u8*)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, dst_yuv);
+				rows = tmp;
+				if (cmat) {
+					for (i=0; i<src_w; i++) {
+						u32 idx = 4*i;
+						gf_cmx_apply_argb(cmat, &tmp[idx+3], &tmp[idx], &tmp[idx+1], &tmp[idx+2]);
+					}
+				}
+				if (key) {
+					for (i=0; i<src_w; i++) {
+						u32 idx = 4*i;
+						s32 thres, v;
+						v = tmp[idx]-kr;
+						thres = ABS(v);
+						v = tmp[idx+1]-kg;
+						thres += ABS(v);
+						v = tmp[idx+2]-kb;
+						thres += ABS(v);
+						thres/=3;
+#ifdef COLORKEY_MPEG4_STRICT
+						if (thres < kl) tmp[idx+3] = 0;
+						else if (thres <= kh) tmp[idx+3] = (thres-kl)*ka / (kh-kl);
+#else
+						if (thres < kh) tmp[idx+3] = 0;
+#endif
+						else tmp[idx+3] = ka;
+					}
+				}
+			}
+			copy_row(rows, src_w, dst_bits, dst_w, inc_x, dst_x_pitch, alpha, dst->pitch_y, dst->height);
+		}
+		/*do NOT use memcpy if the target buffer is not in systems memory*/
+		else if (no_memcpy) {
+			copy_row(rows, src_w, dst_bits, dst_w, inc_x, dst_x_pitch, alpha, dst->pitch_y, dst->height);
+		} else if (dst_bits && dst_bits_prev) {
+			memcpy(dst_bits, dst_bits_prev, dst_w_size);
+		}
+
+		pos_y += inc_y;
+		prev_row = src_row;
+
+		dst_bits_prev = dst_bits;
+		dst_bits += dst->pitch_y;
+		dst_h--;
+	}
+	gf_free(tmp);
+	return GF_OK;
+}
+
+/*extra slices are run by a process-wide pool of worker threads, created on first use and woken for each call
+the pool is used by one gf_stretch_bits call at a time, concurrent calls convert on their own thread*/
+typedef struct
+{
+	GF_Thread *th;
+	GF_Semaphore *run;
+	GF_StretchSlice *slice;
+	Bool exit;
+} GF_StretchWorker;
+
+static struct
+{
+	GF_Mutex *mx;
+	GF_StretchWorker *workers;
+	u32 nb_workers;
+	GF_StretchSlice *slices;
+	GF_Semaphore *done;
+} stretch_pool;
+
+static u32 stretch_bits_worker_run(void *par)
+{
+	GF_StretchWorker *w = (GF_StretchWorker *) par;
+	while (1) {
+		gf_sema_wait(w->run);
+		if (w->exit) break;
+		w->slice->e = stretch_bits_slice(w->slice);
+		gf_sema_notify(stretch_pool.done, 1);
+	}
+	return 0;
+}
+
+static void stretch_pool_del_workers()
+{
+	u32 i;
+	for (i=0; i<stretch_pool.nb_workers; i++) {
+		GF_StretchWorker *w = &stretch_pool.workers[i];
+		if (w->th) {
+			w->exit = GF_TRUE;
+			gf_sema_notify(w->run, 1);
+			gf_th_del(w->th);
+		}
+		if (w->run) gf_sema_del(w->run);
+	}
+	if (stretch_pool.workers) gf_free(stretch_pool.workers);
+	stretch_pool.workers = NULL;
+	stretch_pool.nb_workers = 0;
+	if (stretch_pool.slices) gf_free(stretch_pool.slices);
+	stretch_pool.slices = NULL;
+	if (stretch_pool.done) gf_sema_del(stretch_pool.done);
+	stretch_pool.done = NULL;
+}
+
+//must be called with the pool mutex held, returns the number of available workers
+static u32 stretch_pool_setup(u32 nb_workers)
+{
+	u32 i;
+	if (stretch_pool.nb_workers >= nb_workers) return stretch_pool.nb_workers;
+	stretch_pool_del_workers();
+
+	stretch_pool.workers = gf_malloc(sizeof(GF_StretchWorker) * nb_workers);
+	stretch_pool.slices = gf_malloc(sizeof(GF_StretchSlice) * (nb_workers+1));
+	stretch_pool.done = gf_sema_new(nb_workers, 0);
+	if (!stretch_pool.workers || !stretch_pool.slices || !stretch_pool.done) {
+		stretch_pool_del_workers();
+		return 0;
+	}
+	memset(stretch_pool.workers, 0, sizeof(GF_StretchWorker) * nb_workers);
+	stretch_pool.nb_workers = nb_workers;
+
+	for (i=0; i<nb_workers; i++) {
+		GF_StretchWorker *w = &stretch_pool.workers[i];
+		w->run = gf_sema_new(1, 0);
+		w->th = gf_th_new("StretchBits");
+		if (!w->run || !w->th || (gf_th_run(w->th, stretch_bits_worker_run, w) != GF_OK)) {
+			GF_LOG(GF_LOG_WARNING, GF_LOG_CORE, ("[Color] Failed to setup conversion thread, using single-threaded conversion\n"));
+			if (w->th) gf_th_del(w->th);
+			w->th = NULL;
+			stretch_pool.nb_workers = i+1;
+			stretch_pool_del_workers();
+			return 0;
+		}
+	}
+	return nb_workers;
+}
+
+void gf_stretch_bits_init()
+{
+	memset(&stretch_pool, 0, sizeof(stretch_pool));
+	stretch_pool.mx = gf_mx_new("StretchBits");
+}
+
+void gf_stretch_bits_cleanup()
+{
+	stretch_pool_del_workers();
+	if (stretch_pool.mx) gf_mx_del(stretch_pool.mx);
+	stretch_pool.mx = NULL;
+}
+
+//do not slice below this number of destination rows per slice
+#define STRETCH_MIN_SLICE_ROWS	64
+
+GF_EXPORT
+GF_Err gf_stretch_bits(GF_VideoSurface *dst, GF_VideoSurface *src, GF_Window *dst_wnd, GF_Window *src_wnd, u8 alpha, Bool flip, GF_ColorKey *key, GF_ColorMatrix *cmat)
+{
+	u32 i, nb_slices, first_row, yuv_planar_type = 0;
+	Bool dst_yuv = GF_FALSE;
+	Bool has_alpha = (alpha!=0xFF) ? GF_TRUE : GF_FALSE;
+	u32 dst_bpp;
+	u32 src_w, src_h, dst_w, dst_h;
+	s32 dst_x_pitch = dst->pitch_x;
+	copy_row_proto copy_row = NULL;
+	load_line_proto load_line = NULL;
+	GF_StretchSlice slice, *slices;
+
+	if (cmat && (cmat->m[15] || cmat->m[16] || cmat->m[17] || (cmat->m[18]!=FIX_ONE) || cmat->m[19] )) has_alpha = GF_TRUE;
+	else if (key && (key->alpha<0xFF)) has_alpha = GF_TRUE;
+
+	//check if we have a dedicated copy/conv when no stretch nor blending (avoids line load while copying)
+	if ((alpha==0xFF) && !flip && !key && !cmat) {
+		Bool no_stretch = GF_FALSE;
+		Bool output_yuv = format_is_yuv(dst->pixel_format);
+		GF_Err e = GF_NOT_SUPPORTED;
+
+		if (!dst_wnd) no_stretch = GF_TRUE;
+		else if (src_wnd) {
+			if (!dst_wnd->x && !dst_wnd->y && (dst_wnd->w==src_wnd->w) && (dst_wnd->h==src_wnd->h))
+				no_stretch = GF_TRUE;
+		} else {
+			if ((dst_wnd->w==src->width) && (dst_wnd->h==src->height))
+				no_stretch = GF_TRUE;
+		}
+		if (no_stretch && output_yuv) {
+			//check YUV10->8, YUV->YUV
+			switch (src->pixel_format) {
+			case GF_PIXEL_NV12_10:
+				e = color_write_nv12_10_to_yuv(dst, src, src_wnd, GF_FALSE);
+				break;
+			case GF_PIXEL_NV21_10:
+				e = color_write_nv12_10_to_yuv(dst, src, src_wnd, GF_TRUE);
+				break;
+			case GF_PIXEL_YUV_10:
+				e = color_write_yv12_10_to_yuv(dst, src, src_wnd, GF_FALSE);
+				break;
+			case GF_PIXEL_YUV422_10:
+				if (dst->pixel_format == GF_PIXEL_YUV422)
+					e = color_write_yuv422_10_to_yuv422(dst, src, src_wnd, GF_FALSE);
+				else if (dst->pixel_format == GF_PIXEL_YUV)
+					e = color_write_yuv422_10_to_yuv(dst, src, src_wnd, GF_FALSE);
+				else if (dst->pixel_format == GF_PIXEL_YVU)
+					e = color_write_yuv422_10_to_yuv(dst, src, src_wnd, GF_TRUE);
+				break;
+			case GF_PIXEL_YUV444_10:
+				if (dst->pixel_format == GF_PIXEL_YUV444)
+					e = color_write_yuv444_10_to_yuv444(dst, src, src_wnd, GF_FALSE);
+				else if (dst->pixel_format == GF_PIXEL_YUV)
+					e = color_write_yuv444_10_to_yuv(dst, src, src_wnd, GF_FALSE);
+				else if (dst->pixel_format == GF_PIXEL_YVU)
+					e = color_write_yuv444_10_to_yuv(dst, src, src_wnd, GF_TRUE);
+				break;
+			case GF_PIXEL_YUV:
+				e = color_write_yuv420_to_yuv(dst, src, src_wnd, GF_FALSE);
+				break;
+			case GF_PIXEL_YVU:
+				e = color_write_yuv420_to_yuv(dst, src, src_wnd, GF_TRUE);
+				break;
+			case GF_PIXEL_YUV422:
+				e = color_write_yuv422_to_yuv(dst, src, src_wnd, GF_FALSE);
+				break;
+			case GF_PIXEL_YUV444:
+				e = color_write_yuv444_to_yuv(dst, src, src_wnd, GF_FALSE);
+				break;
+			case GF_PIXEL_YUYV:
+			case GF_PIXEL_YVYU:
+			case GF_PIXEL_UYVY:
+			case GF_PIXEL_VYUY:
+				e = color_write_yvyu_to_yuv(dst, src, src_wnd, GF_FALSE);
+				break;
+			}
+		}
+		else if (no_stretch && !output_yuv) {
+			//check rgb->rgb copy
+			switch (dst->pixel_format) {
+			case GF_PIXEL_RGB:
+			case GF_PIXEL_RGBS:
+			case GF_PIXEL_BGR:
+				e = color_write_rgb_to_24(dst, src, src_wnd);
+				break;
+			case GF_PIXEL_RGBX:
+			case GF_PIXEL_XRGB:
+			case GF_PIXEL_RGBD:
+			case GF_PIXEL_RGBDS:
+			case GF_PIXEL_BGRX:
+			case GF_PIXEL_XBGR:
+				e = color_write_rgb_to_32(dst, src, src_wnd);
+				break;
+			default:
+				break;
+			}
+		}
+		if (e == GF_OK) return GF_OK;
+	}
+	
+	
+	switch (src->pixel_format) {
+	case GF_PIXEL_GREYSCALE:
+		load_line = load_line_grey;
+		break;
+	case GF_PIXEL_ALPHAGREY:
+		load_line = load_line_alpha_grey;
+		has_alpha = GF_TRUE;
+		break;
+	case GF_PIXEL_GREYALPHA:
+		load_line = load_line_grey_alpha;
+		has_alpha = GF_TRUE;
+		break;
+	case GF_PIXEL_RGB_555:
+		load_line = load_line_rgb_555;
+		break;
+	case GF_PIXEL_RGB_565:
+		load_line = load_line_rgb_565;
+		break;
+	case GF_PIXEL_RGB:
+	case GF_PIXEL_RGBS:
+		load_line = load_line_rgb_24;
+		break;
+	case GF_PIXEL_BGR:
+		load_line = load_line_bgr_24;
+		break;
+	case GF_PIXEL_ARGB:
+		has_alpha = GF_TRUE;
+		load_line = load_line_argb;
+		break;
+	case GF_PIXEL_BGRA:
+		has_alpha = GF_TRUE;
+		load_line = load_line_bgra;
+		break;
+	case GF_PIXEL_RGBA:
+	case GF_PIXEL_RGBAS:
+		has_alpha = GF_TRUE;
+	case GF_PIXEL_RGBX:
+		load_line = load_line_rgb_32;
+		break;
+	case GF_PIXEL_XRGB:
+		load_line = load_line_xrgb;
+		break;
+	case GF_PIXEL_BGRX:
 		load_line = load_line_bgrx;
 		break;
 	case GF_PIXEL_RGBDS:
@@ -2124,217 +2870,94 @@ GF_Err gf_stretch_bits(GF_VideoSurface *dst, GF_VideoSurface *src, GF_Window *ds
 		
 	if (yuv_planar_type && (src_w%2)) src_w++;
 
-	tmp = (u8 *) gf_malloc(sizeof(u8) * src_w * (yuv_planar_type ? 8 : 4) );
-	rows = tmp;
-
-	if ( (src_h / dst_h) * dst_h != src_h) force_load_odd_yuv_lines = GF_TRUE;
-
-	pos_y = 0x10000;
-	inc_y = (src_h << 16) / dst_h;
-	inc_x = (src_w << 16) / dst_w;
-	x_off = src_wnd ? src_wnd->x : 0;
-	src_row = src_wnd ? src_wnd->y : 0;
-
-	prev_row = -1;
-
-	dst_bits = (u8 *) dst->video_buffer;
-	if (dst_wnd) dst_bits += ((s32)dst_wnd->x) * dst_x_pitch + ((s32)dst_wnd->y) * dst->pitch_y;
-
-	dst_w_size = dst_bpp*dst_w;
+	memset(&slice, 0, sizeof(GF_StretchSlice));
+	slice.dst = dst;
+	slice.src = src;
+	slice.cmat = cmat;
+	slice.key = key;
+	slice.copy_row = copy_row;
+	slice.load_line = load_line;
+	slice.yuv_planar_type = yuv_planar_type;
+	slice.flip = flip;
+	slice.dst_yuv = dst_yuv;
+	slice.alpha = alpha;
+	slice.src_w = src_w;
+	slice.dst_w = dst_w;
+	slice.dst_x_pitch = dst_x_pitch;
+
+	if ( (src_h / dst_h) * dst_h != src_h) slice.force_load_odd_yuv_lines = GF_TRUE;
+
+	slice.inc_y = (src_h << 16) / dst_h;
+	slice.inc_x = (src_w << 16) / dst_w;
+	slice.x_off = src_wnd ? src_wnd->x : 0;
+	slice.src_row = src_wnd ? src_wnd->y : 0;
+
+	slice.dst_bits = (u8 *) dst->video_buffer;
+	if (dst_wnd) slice.dst_bits += ((s32)dst_wnd->x) * dst_x_pitch + ((s32)dst_wnd->y) * dst->pitch_y;
+
+	slice.dst_w_size = dst_bpp*dst_w;
 
 	if (key) {
-		ka = key->alpha;
-		kr = key->r;
-		kg = key->g;
-		kb = key->b;
-		kl = key->low;
-		kh = key->high;
-		if (kh==kl) kh++;
+		slice.ka = key->alpha;
+		slice.kr = key->r;
+		slice.kg = key->g;
+		slice.kb = key->b;
+		slice.kl = key->low;
+		slice.kh = key->high;
+		if (slice.kh==slice.kl) slice.kh++;
 	}
 
 	/*do NOT use memcpy if the target buffer is not in systems memory*/
-	no_memcpy = (has_alpha || dst->is_hardware_memory || (dst_bpp!=dst_x_pitch)) ? GF_TRUE : GF_FALSE;
+	slice.no_memcpy = (has_alpha || dst->is_hardware_memory || (dst_bpp!=dst_x_pitch)) ? GF_TRUE : GF_FALSE;
 
-	while (dst_h) {
-		while ( pos_y >= 0x10000L ) {
-			src_row++;
-			pos_y -= 0x10000L;
-		}
-		/*new row, check if conversion is needed*/
-		if (prev_row != src_row) {
-			u32 the_row = src_row - 1;
-			if (yuv_planar_type) {
-				if (the_row % 2) {
-					if (!yuv_init || force_load_odd_yuv_lines) {
-						yuv_init = GF_TRUE;
-						the_row--;
-						if (flip) the_row = src->height - 2 - the_row;
-						if (yuv_planar_type == 1) {
-							load_line_yv12(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
-						}
-						else if (yuv_planar_type == 4) {
-							load_line_yuv422(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
-						}
-						else if (yuv_planar_type == 5) {
-							load_line_yuv444(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
-						}
-						else if (yuv_planar_type == 3) {
-							load_line_yv12_10((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
-						}
-						else if (yuv_planar_type == 6) {
-							load_line_yuv422_10((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
-						}
-						else if (yuv_planar_type == 7) {
-							load_line_yuv444_10((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
-						}
-						else if (yuv_planar_type == 8) {
-							load_line_nv21((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, dst_yuv);
-						}
-						else if (yuv_planar_type == 9) {
-							load_line_nv12((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, dst_yuv);
-						}
-						else {
-							load_line_yuva(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, (u8 *)src->a_ptr, dst_yuv);
-						}
+	nb_slices = 1 + gf_opts_get_int("core", "cvt-threads");
+	if (nb_slices > dst_h / STRETCH_MIN_SLICE_ROWS) nb_slices = dst_h / STRETCH_MIN_SLICE_ROWS;
 
-						if (cmat) {
-							for (i=0; i<2*src_w; i++) {
-								u32 idx = 4*i;
-								gf_cmx_apply_argb(cmat, (u8 *) &tmp[idx+3], (u8 *) &tmp[idx], (u8 *) &tmp[idx+1], (u8 *) &tmp[idx+2]);
-							}
-						}
-						if (key) {
-							for (i=0; i<2*src_w; i++) {
-								u32 idx = 4*i;
-								s32 thres, v;
-								v = tmp[idx]-kr;
-								thres = ABS(v);
-								v = tmp[idx+1]-kg;
-								thres += ABS(v);
-								v = tmp[idx+2]-kb;
-								thres += ABS(v);
-								thres/=3;
-#ifdef COLORKEY_MPEG4_STRICT
-								if (thres < kl) tmp[idx+3] = 0;
-								else if (thres <= kh) tmp[idx+3] = (thres-kl)*ka / (kh-kl);
-#else
-								if (thres < kh) tmp[idx+3] = 0;
-#endif
-								else tmp[idx+3] = ka;
-							}
-						}
-					}
-					rows = flip ? tmp : tmp + src_w * 4;
-				}
-				else {
-					if (flip) the_row = src->height - 2 - the_row;
-					if (yuv_planar_type == 1) {
-						load_line_yv12(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
-					}
-					else if (yuv_planar_type == 4) {
-						load_line_yuv422(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
-					}
-					else if (yuv_planar_type == 5) {
-						load_line_yuv444(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
-					}
-					else if (yuv_planar_type == 3) {
-						load_line_yv12_10((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
-					}
-					else if (yuv_planar_type == 6) {
-						load_line_yuv422_10((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
-					}
-					else if (yuv_planar_type == 7) {
-						load_line_yuv444_10((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, dst_yuv);
-					}
-					else if (yuv_planar_type == 8) {
-						load_line_nv21((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, dst_yuv);
-					}
-					else if (yuv_planar_type == 9) {
-						load_line_nv12((char *)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, dst_yuv);
-					}
-					else {
-						load_line_yuva(src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, (u8 *)src->u_ptr, (u8 *)src->v_ptr, (u8 *)src->a_ptr, dst_yuv);
-					}
-					yuv_init = GF_TRUE;
-					rows = flip ? tmp + src_w * 4 : tmp;
+	if (nb_slices <= 1) {
+		slice.nb_rows = dst_h;
+		return stretch_bits_slice(&slice);
+	}
 
-					if (cmat) {
-						for (i=0; i<2*src_w; i++) {
-							u32 idx = 4*i;
-							gf_cmx_apply_argb(cmat, &tmp[idx+3], &tmp[idx], &tmp[idx+1], &tmp[idx+2]);
-						}
-					}
-					if (key) {
-						for (i=0; i<2*src_w; i++) {
-							u32 idx = 4*i;
-							s32 thres, v;
-							v = tmp[idx]-kr;
-							thres = ABS(v);
-							v = tmp[idx+1]-kg;
-							thres += ABS(v);
-							v = tmp[idx+2]-kb;
-							thres += ABS(v);
-							thres/=3;
-#ifdef COLORKEY_MPEG4_STRICT
-							if (thres < kl) tmp[idx+3] = 0;
-							else if (thres <= kh) tmp[idx+3] = (thres-kl)*ka / (kh-kl);
-#else
-							if (thres < kh) tmp[idx+3] = 0;
-#endif
-							else tmp[idx+3] = ka;
-						}
-					}
-				}
-			} else {
-				if (flip) the_row = src->height-1 - the_row;
-				load_line((u8*)src->video_buffer, x_off, the_row, src->pitch_y, src_w, src->height, tmp, dst_yuv);
-				rows = tmp;
-				if (cmat) {
-					for (i=0; i<src_w; i++) {
-						u32 idx = 4*i;
-						gf_cmx_apply_argb(cmat, &tmp[idx+3], &tmp[idx], &tmp[idx+1], &tmp[idx+2]);
-					}
-				}
-				if (key) {
-					for (i=0; i<src_w; i++) {
-						u32 idx = 4*i;
-						s32 thres, v;
-						v = tmp[idx]-kr;
-						thres = ABS(v);
-						v = tmp[idx+1]-kg;
-						thres += ABS(v);
-						v = tmp[idx+2]-kb;
-						thres += ABS(v);
-						thres/=3;
-#ifdef COLORKEY_MPEG4_STRICT
-						if (thres < kl) tmp[idx+3] = 0;
-						else if (thres <= kh) tmp[idx+3] = (thres-kl)*ka / (kh-kl);
-#else
-						if (thres < kh) tmp[idx+3] = 0;
-#endif
-						else tmp[idx+3] = ka;
-					}
-				}
-			}
-			copy_row(rows, src_w, dst_bits, dst_w, inc_x, dst_x_pitch, alpha, dst->pitch_y, dst->height);
-		}
-		/*do NOT use memcpy if the target buffer is not in systems memory*/
-		else if (no_memcpy) {
-			copy_row(rows, src_w, dst_bits, dst_w, inc_x, dst_x_pitch, alpha, dst->pitch_y, dst->height);
-		} else if (dst_bits && dst_bits_prev) {
-			memcpy(dst_bits, dst_bits_prev, dst_w_size);
-		}
+	//pool busy with another conversion, convert on the calling thread
+	if (!stretch_pool.mx || !gf_mx_try_lock(stretch_pool.mx)) {
+		slice.nb_rows = dst_h;
+		return stretch_bits_slice(&slice);
+	}
+	i = stretch_pool_setup(nb_slices-1);
+	if (!i) {
+		gf_mx_v(stretch_pool.mx);
+		slice.nb_rows = dst_h;
+		return stretch_bits_slice(&slice);
+	}
+	if (nb_slices > i+1) nb_slices = i+1;
 
-		pos_y += inc_y;
-		prev_row = src_row;
+	slices = stretch_pool.slices;
+	first_row = 0;
+	for (i=0; i<nb_slices; i++) {
+		u32 end_row = (i+1) * dst_h / nb_slices;
+		//never split repeated source rows across slices, so that output is the same as with a single slice
+		while ((end_row < dst_h) && (((end_row * slice.inc_y) >> 16) == (((end_row - 1) * slice.inc_y) >> 16)))
+			end_row++;
 
-		dst_bits_prev = dst_bits;
-		dst_bits += dst->pitch_y;
-		dst_h--;
+		slices[i] = slice;
+		slices[i].first_row = first_row;
+		slices[i].nb_rows = end_row - first_row;
+		first_row = end_row;
+		//first slice is run by the calling thread
+		if (!i) continue;
+		stretch_pool.workers[i-1].slice = &slices[i];
+		gf_sema_notify(stretch_pool.workers[i-1].run, 1);
 	}
-	if (dst_temp_bits) gf_free(dst_temp_bits);
-	gf_free(tmp);
-	return GF_OK;
+	slice.e = stretch_bits_slice(&slices[0]);
+
+	for (i=1; i<nb_slices; i++) {
+		gf_sema_wait(stretch_pool.done);
+	}
+	for (i=1; i<nb_slices; i++) {
+		if (slices[i].e) slice.e = slices[i].e;
+	}
+	gf_mx_v(stretch_pool.mx);
+	return slice.e;
 }
 
 #endif // GPAC_DISABLE_PLAYER
@@ -2539,19 +3162,6 @@ void gf_cmx_apply_fixed(GF_ColorMatrix *_this, Fixed *a, Fixed *r, Fixed *g, Fix
 #ifndef GPAC_DISABLE_PLAYER
 
 
-//intrinsic code segfaults on 32 bit, need to check why
-#if defined(GPAC_64_BITS)
-# if defined(WIN32) && !defined(__GNUC__)
-#  include <intrin.h>
-#  define GPAC_HAS_SSE2
-# else
-#  ifdef __SSE2__
-#   include <emmintrin.h>
-#   define GPAC_HAS_SSE2
-#  endif
-# endif
-#endif
-
 #ifdef GPAC_HAS_SSE2
 
 static GF_Err color_write_yv12_10_to_yuv_intrin(GF_VideoSurface *vs_dst, unsigned char *pY, unsigned char *pU, unsigned char*pV, u32 src_stride, u32 src_width, u32 src_height, const GF_Window *_src_wnd, Bool swap_uv)
@@ -3010,7 +3620,7 @@ static GF_Err color_write_yv12_10_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurfac
 #define GFINTCAST  (u32)
 #endif
 
-	if ( (w%32 == 0)
+	if ( color_use_sse2() && (w%32 == 0)
 	        && (GFINTCAST (vs_dst->video_buffer + vs_dst->pitch_y)%8 == 0)
 	        && (GFINTCAST (vs_dst->video_buffer + vs_dst->pitch_y * vs_dst->height + vs_dst->pitch_y/2)%8 == 0)
 	        && (GFINTCAST (pU + vs_src->pitch_y/2)%8 == 0)
@@ -3181,7 +3791,7 @@ static GF_Err color_write_yuv422_10_to_yuv422(GF_VideoSurface *vs_dst, GF_VideoS
 #define GFINTCAST  (u32)
 #endif
 
-	if ( (w%32 == 0)
+	if ( color_use_sse2() && (w%32 == 0)
 	        && (GFINTCAST (vs_dst->video_buffer + vs_dst->pitch_y)%8 == 0)
 	        && (GFINTCAST (vs_dst->video_buffer + vs_dst->pitch_y * vs_dst->height + vs_dst->pitch_y/2)%8 == 0)
 	        && (GFINTCAST (pU + vs_src->pitch_y/2)%8 == 0)
@@ -3263,7 +3873,7 @@ static GF_Err color_write_yuv444_10_to_yuv444(GF_VideoSurface *vs_dst, GF_VideoS
 #define GFINTCAST  (u32)
 #endif
 
-	if ( (w%32 == 0)
+	if ( color_use_sse2() && (w%32 == 0)
 	        && (GFINTCAST (vs_dst->video_buffer + vs_dst->pitch_y)%8 == 0)
 	        && (GFINTCAST (vs_dst->video_buffer + vs_dst->pitch_y * vs_dst->height + vs_dst->pitch_y)%8 == 0)
 	        && (GFINTCAST (pU + vs_src->pitch_y)%8 == 0)
@@ -3344,7 +3954,7 @@ static GF_Err color_write_yuv422_10_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurf
 #define GFINTCAST  (u32)
 #endif
 
-	if ((w % 32 == 0)
+	if (color_use_sse2() && (w % 32 == 0)
 		&& (GFINTCAST(vs_dst->video_buffer + vs_dst->pitch_y) % 8 == 0)
 		&& (GFINTCAST(vs_dst->video_buffer + vs_dst->pitch_y * vs_dst->height + vs_dst->pitch_y / 2) % 8 == 0)
 		&& (GFINTCAST(pU + vs_src->pitch_y / 2) % 8 == 0)
@@ -3436,7 +4046,7 @@ static GF_Err color_write_yuv444_10_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurf
 #define GFINTCAST  (u32)
 #endif
 
-	if ( (w % 32 == 0)
+	if ( color_use_sse2() && (w % 32 == 0)
 		&& (GFINTCAST(vs_dst->video_buffer + vs_dst->pitch_y) % 8 == 0)
 		&& (GFINTCAST(vs_dst->video_buffer + vs_dst->pitch_y * vs_dst->height + vs_dst->pitch_y) % 8 == 0)
 		&& (GFINTCAST(pU + vs_src->pitch_y) % 8 == 0)
@@ -3598,7 +4208,7 @@ static GF_Err color_write_yuv420_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurface
 		}
 	}
 	else if (vs_dst->pixel_format == GF_PIXEL_UYVY) {
-		u32 i, j;
+		u32 i, j, done = 0;
 		for (i = 0; i<h; i++) {
 			u8 *dst, *y, *u, *v;
 			y = pY + i*vs_src->pitch_y;
@@ -3606,7 +4216,16 @@ static GF_Err color_write_yuv420_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurface
 			v = pV + (i / 2) * vs_src->pitch_y / 2;
 			dst = (u8 *)vs_dst->video_buffer + i*vs_dst->pitch_y;
 
-			for (j = 0; j<w / 2; j++) {
+#ifdef GPAC_HAS_SSE2
+			if (color_use_sse2()) {
+				done = yuv_row_to_packed_sse2(dst, y, u, v, w, GF_FALSE);
+				dst += 2*done;
+				y += done;
+				u += done/2;
+				v += done/2;
+			}
+#endif
+			for (j = done/2; j<w / 2; j++) {
 				*dst = *u;
 				dst++;
 				u++;
@@ -3623,7 +4242,7 @@ static GF_Err color_write_yuv420_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurface
 		}
 	}
 	else if (vs_dst->pixel_format == GF_PIXEL_VYUY) {
-		u32 i, j;
+		u32 i, j, done = 0;
 		for (i = 0; i<h; i++) {
 			u8 *dst, *y, *u, *v;
 			y = pY + i*vs_src->pitch_y;
@@ -3631,7 +4250,16 @@ static GF_Err color_write_yuv420_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurface
 			v = pV + (i / 2) * vs_src->pitch_y / 2;
 			dst = (u8 *)vs_dst->video_buffer + i*vs_dst->pitch_y;
 
-			for (j = 0; j<w / 2; j++) {
+#ifdef GPAC_HAS_SSE2
+			if (color_use_sse2()) {
+				done = yuv_row_to_packed_sse2(dst, y, v, u, w, GF_FALSE);
+				dst += 2*done;
+				y += done;
+				u += done/2;
+				v += done/2;
+			}
+#endif
+			for (j = done/2; j<w / 2; j++) {
 				*dst = *v;
 				dst++;
 				v++;
@@ -3648,7 +4276,7 @@ static GF_Err color_write_yuv420_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurface
 		}
 	}
 	else if (vs_dst->pixel_format == GF_PIXEL_YUYV) {
-		u32 i, j;
+		u32 i, j, done = 0;
 		for (i = 0; i<h; i++) {
 			u8 *dst, *y, *u, *v;
 			y = pY + i*vs_src->pitch_y;
@@ -3656,7 +4284,16 @@ static GF_Err color_write_yuv420_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurface
 			v = pV + (i / 2) * vs_src->pitch_y / 2;
 			dst = (u8*)vs_dst->video_buffer + i*vs_dst->pitch_y;
 
-			for (j = 0; j<w / 2; j++) {
+#ifdef GPAC_HAS_SSE2
+			if (color_use_sse2()) {
+				done = yuv_row_to_packed_sse2(dst, y, u, v, w, GF_TRUE);
+				dst += 2*done;
+				y += done;
+				u += done/2;
+				v += done/2;
+			}
+#endif
+			for (j = done/2; j<w / 2; j++) {
 				*dst = *y;
 				dst++;
 				y++;
@@ -3673,7 +4310,7 @@ static GF_Err color_write_yuv420_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurface
 		}
 	}
 	else if (vs_dst->pixel_format == GF_PIXEL_YVYU) {
-		u32 i, j;
+		u32 i, j, done = 0;
 		for (i = 0; i<h; i++) {
 			u8 *dst, *y, *u, *v;
 			y = pY + i*vs_src->pitch_y;
@@ -3681,7 +4318,16 @@ static GF_Err color_write_yuv420_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurface
 			v = pV + (i / 2) * vs_src->pitch_y / 2;
 			dst = (u8*)vs_dst->video_buffer + i*vs_dst->pitch_y;
 
-			for (j = 0; j<w / 2; j++) {
+#ifdef GPAC_HAS_SSE2
+			if (color_use_sse2()) {
+				done = yuv_row_to_packed_sse2(dst, y, v, u, w, GF_TRUE);
+				dst += 2*done;
+				y += done;
+				u += done/2;
+				v += done/2;
+			}
+#endif
+			for (j = done/2; j<w / 2; j++) {
 				*dst = *y;
 				dst++;
 				y++;
@@ -3813,7 +4459,18 @@ static GF_Err color_write_yuv444_to_yuv(GF_VideoSurface *vs_dst, GF_VideoSurface
 			dst2 = (u8*)vs_dst->video_buffer + vs_dst->pitch_y * vs_dst->height + i* vs_dst->pitch_y / 2;
 			src3 = _src3 + 2 * i*vs_src->pitch_y;
 			dst3 = (u8*)vs_dst->video_buffer + 5 * vs_dst->pitch_y * vs_dst->height / 4 + i* vs_dst->pitch_y / 2;
-			for (j = 0; j<w / 2; j++) {
+			j = 0;
+#ifdef GPAC_HAS_SSE2
+			if (color_use_sse2()) {
+				j = chroma_row_decimate_sse2(dst2, src2, w / 2);
+				chroma_row_decimate_sse2(dst3, src3, w / 2);
+				dst2 += j;
+				src2 += 2*j;
+				dst3 += j;
+				src3 += 2*j;
+			}
+#endif
+			for (; j<w / 2; j++) {
 				*dst2 = *src2;
 				dst2++;
 				src2 += 2;
@@ -196,6 +196,8 @@ struct __gf_download_session
 	u64 start_time_utc;
 	Bool last_chunk_found;
 	Bool connection_close;
+	/*set once a response body has been fully read on a persistent HTTP/1.1 connection*/
+	Bool conn_reusable;
 	Bool is_range_continuation;
 	/*0: no cache reconfig before next GET request: 1: try to rematch the cache entry: 2: force to create a new cache entry (for byte-range cases)*/
 	u32 needs_cache_reconfig;
@@ -290,6 +292,11 @@ struct __gf_download_manager
 	u32 limit_data_rate, read_buf_size;
 	u64 max_cache_size;
 	Bool allow_broken_certificate;
+	/*memory cache budget in bytes (0: unlimited) and spill mode*/
+	u64 max_mem_cache;
+	Bool mem_cache_spill;
+	/*cache statistics, protected by cache_mx*/
+	u64 mem_cache_peak, cache_hits, cache_misses, cache_evictions, cache_spills;
 
 	GF_List *skip_proxy_servers;
 	GF_List *credentials;
@@ -308,8 +315,25 @@ struct __gf_download_manager
 
 	Bool (*local_cache_url_provider_cbk)(void *udta, char *url, Bool cache_destroy);
 	void *lc_udta;
+
+	/*idle keep-alive connections left by destroyed sessions, reused by new sessions to the same host*/
+	GF_List *idle_conns;
+	u32 max_idle_conns, idle_timeout;
 };
 
+/*idle HTTP/1.1 connection kept by the download manager*/
+typedef struct
+{
+	char *server_name;
+	u16 port;
+	Bool use_ssl;
+	GF_Socket *sock;
+#ifdef GPAC_HAS_SSL
+	SSL *ssl;
+#endif
+	u64 idle_since;
+} GF_DMIdleConnection;
+
 #ifdef GPAC_HAS_SSL
 
 static void init_prng (void)
@@ -1315,6 +1339,14 @@ static Bool gf_dm_can_handle_url(GF_DownloadManager *dm, const char *url)
 	return GF_FALSE;
 }
 
+void gf_cache_entry_set_local_provider(const DownloadedCacheEntry entry);
+void gf_cache_entry_touch(const DownloadedCacheEntry entry);
+u64 gf_cache_entry_get_last_access(const DownloadedCacheEntry entry);
+u32 gf_cache_get_mem_usage(const DownloadedCacheEntry entry);
+GF_Mutex *gf_cache_get_blob_mutex(const DownloadedCacheEntry entry);
+Bool gf_cache_can_evict(const DownloadedCacheEntry entry);
+GF_Err gf_cache_spill_to_disk(const DownloadedCacheEntry entry, const char *cache_directory);
+
 /*!
  * Finds an existing entry in the cache for a given URL
 \param sess The session configured with the URL
@@ -1339,6 +1371,7 @@ DownloadedCacheEntry gf_dm_find_cached_entry_by_url(GF_DownloadSession * sess)
 			if (sess->range_end != gf_cache_get_end_range(e)) continue;
 		}
 		/*OK that's ours*/
+		gf_cache_entry_touch(e);
 		gf_mx_v( sess->dm->cache_mx );
 		return e;
 	}
@@ -1365,6 +1398,63 @@ Bool gf_cache_set_content(const DownloadedCacheEntry entry, GF_Blob *blob, Bool
 Bool gf_cache_set_headers(const DownloadedCacheEntry entry, const char *headers);
 Bool gf_cache_set_downtime(const DownloadedCacheEntry entry, u32 download_time_ms);
 
+/*evicts least recently used memory entries not attached to any session until the memory budget is met*/
+static void gf_dm_cache_mem_check(GF_DownloadManager *dm)
+{
+	u32 i, count;
+	u64 mem_used = 0;
+	if (!dm || !dm->cache_entries) return;
+
+	gf_mx_p(dm->cache_mx);
+	count = gf_list_count(dm->cache_entries);
+	for (i=0; i<count; i++) {
+		mem_used += gf_cache_get_mem_usage(gf_list_get(dm->cache_entries, i));
+	}
+	if (mem_used > dm->mem_cache_peak) dm->mem_cache_peak = mem_used;
+
+	while (dm->max_mem_cache && (mem_used > dm->max_mem_cache)) {
+		u32 entry_size;
+		s32 lru_idx = -1;
+		u64 lru_time = 0;
+		GF_Mutex *blob_mx;
+		DownloadedCacheEntry entry;
+		for (i=0; i<count; i++) {
+			entry = gf_list_get(dm->cache_entries, i);
+			if (!gf_cache_can_evict(entry)) continue;
+			if ((lru_idx<0) || (gf_cache_entry_get_last_access(entry) < lru_time)) {
+				lru_idx = i;
+				lru_time = gf_cache_entry_get_last_access(entry);
+			}
+		}
+		//everything in use
+		if (lru_idx<0) break;
+
+		entry = gf_list_get(dm->cache_entries, lru_idx);
+		//hold the blob while evicting, and check again that no blob user showed up in between
+		blob_mx = gf_cache_get_blob_mutex(entry);
+		if (blob_mx) gf_mx_p(blob_mx);
+		if (!gf_cache_can_evict(entry)) {
+			if (blob_mx) gf_mx_v(blob_mx);
+			break;
+		}
+		entry_size = gf_cache_get_mem_usage(entry);
+		mem_used -= entry_size;
+		dm->cache_evictions++;
+		if (dm->mem_cache_spill && (gf_cache_spill_to_disk(entry, dm->cache_directory)==GF_OK)) {
+			dm->cache_spills++;
+			if (blob_mx) gf_mx_v(blob_mx);
+			continue;
+		}
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_CACHE, ("[CACHE] Evicting memory entry %s (%d bytes)\n", gf_cache_get_url(entry), entry_size));
+		gf_list_rem(dm->cache_entries, lru_idx);
+		count--;
+		gf_cache_entry_set_delete_files_when_deleted(entry);
+		gf_cache_delete_entry(entry);
+		if (blob_mx) gf_mx_v(blob_mx);
+	}
+	gf_mx_v(dm->cache_mx);
+}
+
 
 /**
  * Removes a cache entry from cache and performs a cleanup if possible.
@@ -1459,6 +1549,7 @@ static void gf_dm_configure_cache(GF_DownloadSession *sess)
 			entry = gf_cache_create_entry(sess->dm, sess->dm->cache_directory, sess->orig_url, sess->range_start, sess->range_end, (sess->flags&GF_NETIO_SESSION_MEMORY_CACHE) ? GF_TRUE : GF_FALSE, sess->dm->cache_mx);
 			gf_mx_p( sess->dm->cache_mx );
 			gf_list_add(sess->dm->cache_entries, entry);
+			sess->dm->cache_misses++;
 			gf_mx_v( sess->dm->cache_mx );
 			sess->is_range_continuation = GF_FALSE;
 		}
@@ -1498,6 +1589,9 @@ static void gf_dm_configure_cache(GF_DownloadSession *sess)
 		if ( (sess->allow_direct_reuse || sess->dm->allow_offline_cache) && !gf_cache_check_if_cache_file_is_corrupted(sess->cache_entry)
 		) {
 			sess->from_cache_only = GF_TRUE;
+			gf_mx_p(sess->dm->cache_mx);
+			sess->dm->cache_hits++;
+			gf_mx_v(sess->dm->cache_mx);
 			sess->connect_time = 0;
 			sess->status = GF_NETIO_CONNECTED;
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_HTTP, ("[HTTP] using existing cache entry\n"));
@@ -1742,6 +1836,122 @@ typedef enum
 	HTTP_RESET_CONN,
 } HTTPCloseType;
 
+static void gf_dm_idle_conn_del(GF_DMIdleConnection *conn)
+{
+#ifdef GPAC_HAS_SSL
+	if (conn->ssl) {
+		SSL_shutdown(conn->ssl);
+		SSL_free(conn->ssl);
+	}
+#endif
+	if (conn->sock) gf_sk_del(conn->sock);
+	if (conn->server_name) gf_free(conn->server_name);
+	gf_free(conn);
+}
+
+/*removes idle connections older than the idle timeout - must be called with cache_mx held*/
+static void gf_dm_idle_conn_purge(GF_DownloadManager *dm)
+{
+	u32 i;
+	u64 now = gf_sys_clock_high_res();
+	for (i=0; i<gf_list_count(dm->idle_conns); i++) {
+		GF_DMIdleConnection *conn = gf_list_get(dm->idle_conns, i);
+		if (now - conn->idle_since < (u64) dm->idle_timeout * 1000) continue;
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_HTTP, ("[HTTP] Closing idle connection to %s:%d\n", conn->server_name, conn->port));
+		gf_list_rem(dm->idle_conns, i);
+		i--;
+		gf_dm_idle_conn_del(conn);
+	}
+}
+
+/*moves the connection of a session being destroyed to the idle pool if it can carry another request*/
+static Bool gf_dm_park_connection(GF_DownloadSession *sess)
+{
+	GF_DMIdleConnection *conn;
+	GF_DownloadManager *dm = sess->dm;
+
+	if (!dm || !dm->max_idle_conns || !sess->sock || !sess->conn_reusable) return GF_FALSE;
+	if (sess->server_mode || sess->connection_close || (sess->proxy_enabled==1) || !sess->server_name) return GF_FALSE;
+	if ((sess->status != GF_NETIO_DISCONNECTED) && (sess->status != GF_NETIO_STATE_ERROR)) return GF_FALSE;
+#ifdef GPAC_HAS_HTTP2
+	if (sess->h2_sess) return GF_FALSE;
+#endif
+	//pending data or connection closed by peer
+	if (gf_sk_probe(sess->sock) != GF_IP_NETWORK_EMPTY) return GF_FALSE;
+
+	GF_SAFEALLOC(conn, GF_DMIdleConnection);
+	if (!conn) return GF_FALSE;
+	conn->server_name = gf_strdup(sess->server_name);
+	conn->port = sess->port;
+	conn->use_ssl = (sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) ? GF_TRUE : GF_FALSE;
+	conn->sock = sess->sock;
+#ifdef GPAC_HAS_SSL
+	conn->ssl = sess->ssl;
+	sess->ssl = NULL;
+#endif
+	conn->idle_since = gf_sys_clock_high_res();
+	sess->sock = NULL;
+	sess->conn_reusable = GF_FALSE;
+
+	gf_mx_p(dm->cache_mx);
+	gf_dm_idle_conn_purge(dm);
+	//drop oldest connection
+	if (gf_list_count(dm->idle_conns) >= dm->max_idle_conns) {
+		GF_DMIdleConnection *old = gf_list_pop_front(dm->idle_conns);
+		gf_dm_idle_conn_del(old);
+	}
+	gf_list_add(dm->idle_conns, conn);
+	gf_mx_v(dm->cache_mx);
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_HTTP, ("[HTTP] Keeping idle connection to %s:%d for reuse\n", conn->server_name, conn->port));
+	return GF_TRUE;
+}
+
+/*assigns an idle connection to the same host to the session, if any*/
+static Bool gf_dm_reuse_connection(GF_DownloadSession *sess)
+{
+	s32 i;
+	GF_DMIdleConnection *conn = NULL;
+	GF_DownloadManager *dm = sess->dm;
+	Bool use_ssl = (sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) ? GF_TRUE : GF_FALSE;
+
+	if (!dm || !dm->idle_conns || !sess->server_name) return GF_FALSE;
+	if (gf_opts_get_bool("core", "proxy-on")) return GF_FALSE;
+
+	gf_mx_p(dm->cache_mx);
+	gf_dm_idle_conn_purge(dm);
+	//most recently used first
+	for (i=(s32) gf_list_count(dm->idle_conns)-1; i>=0; i--) {
+		GF_DMIdleConnection *a_conn = gf_list_get(dm->idle_conns, i);
+		if (a_conn->port != sess->port) continue;
+		if (a_conn->use_ssl != use_ssl) continue;
+		if (strcmp(a_conn->server_name, sess->server_name)) continue;
+		gf_list_rem(dm->idle_conns, i);
+		//closed by server while idle
+		if (gf_sk_probe(a_conn->sock) != GF_IP_NETWORK_EMPTY) {
+			gf_dm_idle_conn_del(a_conn);
+			continue;
+		}
+		conn = a_conn;
+		break;
+	}
+	gf_mx_v(dm->cache_mx);
+	if (!conn) return GF_FALSE;
+
+	GF_LOG(GF_LOG_INFO, GF_LOG_HTTP, ("[HTTP] Reusing idle connection to %s:%d\n", conn->server_name, conn->port));
+	sess->sock = conn->sock;
+	conn->sock = NULL;
+#ifdef GPAC_HAS_SSL
+	sess->ssl = conn->ssl;
+	conn->ssl = NULL;
+#endif
+	gf_dm_idle_conn_del(conn);
+	sess->num_retry = SESSION_RETRY_COUNT;
+	sess->connect_time = 0;
+	sess->ssl_setup_time = 0;
+	return GF_TRUE;
+}
+
 static void gf_dm_disconnect(GF_DownloadSession *sess, HTTPCloseType close_type)
 {
 	assert( sess );
@@ -1769,6 +1979,7 @@ static void gf_dm_disconnect(GF_DownloadSession *sess, HTTPCloseType close_type)
 
 
 		if (do_close) {
+			sess->conn_reusable = GF_FALSE;
 #ifdef GPAC_HAS_HTTP2
 			if (sess->h2_sess) {
 				sess->h2_sess->do_shutdown = GF_TRUE;
@@ -1824,6 +2035,7 @@ void gf_dm_sess_del(GF_DownloadSession *sess)
 		gf_th_del(sess->th);
 		sess->th = NULL;
 	}
+	gf_dm_park_connection(sess);
 
 	if (sess->dm) {
 		gf_mx_p(sess->dm->cache_mx);
@@ -1857,7 +2069,6 @@ void gf_dm_sess_del(GF_DownloadSession *sess)
 		gf_free(sess->h2_upgrade_settings);
 #endif
 
-
 #ifdef GPAC_HAS_SSL
 	//in server mode SSL context is managed by caller
 	if (sess->ssl) {
@@ -2150,6 +2361,7 @@ GF_Err gf_dm_sess_setup_from_url(GF_DownloadSession *sess, const char *url, Bool
 
 	gf_dm_sess_clear_headers(sess);
 	sess->allow_direct_reuse = allow_direct_reuse;
+	sess->conn_reusable = GF_FALSE;
 	gf_dm_url_info_init(&info);
 
 	if (!sess->sock)
@@ -2796,6 +3008,18 @@ static void gf_dm_connect(GF_DownloadSession *sess)
 #endif
 
 
+	//resource can be served from cache, don't grab or open a connection
+	if (!sess->sock && sess->allow_direct_reuse) {
+		gf_dm_configure_cache(sess);
+		if (sess->from_cache_only) return;
+	}
+	if (!sess->sock && gf_dm_reuse_connection(sess)) {
+		sess->status = GF_NETIO_CONNECTED;
+		gf_dm_sess_notify_state(sess, GF_NETIO_CONNECTED, GF_OK);
+		gf_dm_configure_cache(sess);
+		return;
+	}
+
 	if (!sess->sock) {
 		sess->num_retry = 40;
 		sess->sock = gf_sk_new(GF_SOCK_TYPE_TCP);
@@ -3340,6 +3564,7 @@ GF_DownloadManager *gf_dm_new(GF_FilterSession *fsess)
 	dm->credentials = gf_list_new();
 	dm->skip_proxy_servers = gf_list_new();
 	dm->partial_downloads = gf_list_new();
+	dm->idle_conns = gf_list_new();
 	dm->cache_mx = gf_mx_new("download_manager_cache_mx");
 	dm->filter_session = fsess;
 	default_cache_dir = NULL;
@@ -3414,6 +3639,18 @@ retry_cache:
 	}
 	dm->allow_broken_certificate = gf_opts_get_bool("core", "broken-cert");
 
+	if (!gf_opts_get_key("core", "conn-pool")) {
+		dm->max_idle_conns = 8;
+	} else {
+		dm->max_idle_conns = gf_opts_get_int("core", "conn-pool");
+	}
+	dm->idle_timeout = gf_opts_get_int("core", "conn-idle");
+	if (!dm->idle_timeout) dm->idle_timeout = 4000;
+	opt = gf_opts_get_key("core", "cache-mem");
+	dm->max_mem_cache = 0;
+	if (opt) sscanf(opt, LLU, &dm->max_mem_cache);
+	dm->mem_cache_spill = gf_opts_get_bool("core", "cache-mem-spill");
+
 	gf_mx_v( dm->cache_mx );
 
 #ifdef GPAC_HAS_SSL
@@ -3463,6 +3700,13 @@ void gf_dm_del(GF_DownloadManager *dm)
 	}
 	gf_list_del(dm->sessions);
 	dm->sessions = NULL;
+
+	while (gf_list_count(dm->idle_conns)) {
+		GF_DMIdleConnection *conn = gf_list_pop_back(dm->idle_conns);
+		gf_dm_idle_conn_del(conn);
+	}
+	gf_list_del(dm->idle_conns);
+	dm->idle_conns = NULL;
 	assert( dm->skip_proxy_servers );
 	while (gf_list_count(dm->skip_proxy_servers)) {
 		char *serv = (char*)gf_list_get(dm->skip_proxy_servers, 0);
@@ -3782,7 +4026,12 @@ static void gf_dm_data_received(GF_DownloadSession *sess, u8 *payload, u32 paylo
 			gf_cache_close_write_cache(sess->cache_entry, sess, GF_TRUE);
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_HTTP,
 			       ("[CACHE] url %s saved as %s\n", gf_cache_get_url(sess->cache_entry), gf_cache_get_cache_filename(sess->cache_entry)));
+			gf_dm_cache_mem_check(sess->dm);
 		}
+#ifdef GPAC_HAS_HTTP2
+		if (!sess->h2_sess)
+#endif
+			sess->conn_reusable = GF_TRUE;
 
 		gf_dm_disconnect(sess, HTTP_NO_CLOSE);
 		par.msg_type = GF_NETIO_DATA_TRANSFERED;
@@ -5319,6 +5568,9 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 	{
 		sess->status = GF_NETIO_PARSE_REPLY;
 		assert(sess->cache_entry);
+		gf_mx_p(sess->dm->cache_mx);
+		sess->dm->cache_hits++;
+		gf_mx_v(sess->dm->cache_mx);
 		sess->total_size = gf_cache_get_cache_filesize(sess->cache_entry);
 
 		gf_dm_sess_notify_state(sess, GF_NETIO_PARSE_REPLY, GF_OK);
@@ -6176,12 +6428,40 @@ const DownloadedCacheEntry gf_dm_add_cache_entry(GF_DownloadManager *dm, const c
 	if (blob && ! (blob->flags & GF_BLOB_IN_TRANSFER))
 		gf_cache_set_range(the_entry, blob->size, start_range, end_range);
 
+	gf_cache_entry_set_local_provider(the_entry);
 	gf_cache_set_content(the_entry, blob, clone_memory ? GF_TRUE : GF_FALSE, dm->cache_mx);
 	gf_cache_set_downtime(the_entry, download_time_ms);
 	gf_mx_v(dm->cache_mx );
+	gf_dm_cache_mem_check(dm);
 	return the_entry;
 }
 
+GF_EXPORT
+GF_Err gf_dm_get_cache_stats(GF_DownloadManager *dm, GF_DMCacheStats *stats)
+{
+	u32 i, count;
+	if (!dm || !stats) return GF_BAD_PARAM;
+	memset(stats, 0, sizeof(GF_DMCacheStats));
+	gf_mx_p(dm->cache_mx);
+	count = gf_list_count(dm->cache_entries);
+	for (i=0; i<count; i++) {
+		u32 size = gf_cache_get_mem_usage(gf_list_get(dm->cache_entries, i));
+		if (!size) continue;
+		stats->mem_used += size;
+		stats->nb_mem_entries++;
+	}
+	if (stats->mem_used > dm->mem_cache_peak) dm->mem_cache_peak = stats->mem_used;
+	stats->mem_max = dm->max_mem_cache;
+	stats->mem_peak = dm->mem_cache_peak;
+	stats->nb_entries = count;
+	stats->hits = dm->cache_hits;
+	stats->misses = dm->cache_misses;
+	stats->evictions = dm->cache_evictions;
+	stats->spills = dm->cache_spills;
+	gf_mx_v(dm->cache_mx);
+	return GF_OK;
+}
+
 GF_EXPORT
 GF_Err gf_dm_force_headers(GF_DownloadManager *dm, const DownloadedCacheEntry entry, const char *headers)
 {
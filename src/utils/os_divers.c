@@ -997,6 +997,9 @@ GF_Err gf_sys_set_args(s32 argc, const char **argv)
 		if (gf_opts_get_bool("core", "rmt"))
 			gf_sys_enable_remotery(GF_TRUE, GF_FALSE);
 
+		if (gf_opts_get_bool("core", "no-simd"))
+			gf_sys_set_cpu_features(0);
+
 		if (gpac_quiet) {
 			if (gpac_quiet==2) gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
 			gf_set_progress_callback(NULL, progress_quiet);
@@ -1225,6 +1228,12 @@ Bool gf_sys_profiler_sampling_enabled()
 
 void gf_init_global_config(const char *profile);
 void gf_uninit_global_config(Bool discard_config);
+#ifndef GPAC_DISABLE_PLAYER
+void gf_stretch_bits_init();
+#endif
+#ifndef GPAC_DISABLE_ISOM
+void gf_isom_box_registry_init();
+#endif
 
 static GF_Config *gpac_lang_file = NULL;
 static const char *gpac_lang_code = NULL;
@@ -1369,6 +1378,13 @@ GF_Err gf_sys_init(GF_MemTrackerType mem_tracker_type, const char *profile)
 
 		logs_mx = gf_mx_new("Logs");
 
+#ifndef GPAC_DISABLE_PLAYER
+		gf_stretch_bits_init();
+#endif
+#ifndef GPAC_DISABLE_ISOM
+		gf_isom_box_registry_init();
+#endif
+
 		gf_rand_init(GF_FALSE);
 		
 		gf_init_global_config(profile);
@@ -1397,6 +1413,9 @@ void gf_sys_close()
 {
 	if (sys_init > 0) {
 		void gf_sys_cleanup_help();
+#ifndef GPAC_DISABLE_PLAYER
+		void gf_stretch_bits_cleanup();
+#endif
 
 		GF_Mutex *old_log_mx;
 		sys_init --;
@@ -1416,6 +1435,10 @@ void gf_sys_close()
 
 		gf_sys_enable_remotery(GF_FALSE, GF_TRUE);
 		
+#ifndef GPAC_DISABLE_PLAYER
+		gf_stretch_bits_cleanup();
+#endif
+
 		gf_uninit_global_config(gpac_discard_config);
 
 #ifndef GPAC_DISABLE_LOG
@@ -2014,6 +2037,80 @@ Bool gf_sys_get_rti(u32 refresh_time_ms, GF_SystemRTInfo *rti, u32 flags)
 	return res;
 }
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define GPAC_CPUID_X86
+static void gf_cpuid(u32 leaf, u32 subleaf, u32 regs[4])
+{
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+}
+static u64 gf_xgetbv()
+{
+	u32 eax, edx;
+	__asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((u64)edx << 32) | eax;
+}
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)) && !defined(_WIN32_WCE)
+#include <intrin.h>
+#define GPAC_CPUID_X86
+static void gf_cpuid(u32 leaf, u32 subleaf, u32 regs[4])
+{
+	__cpuidex((int *)regs, leaf, subleaf);
+}
+static u64 gf_xgetbv()
+{
+	return _xgetbv(0);
+}
+#endif
+
+static u32 cpu_features_detected = 0;
+static u32 cpu_features = 0;
+static Bool cpu_features_init = GF_FALSE;
+
+static void gf_sys_detect_cpu_features()
+{
+	u32 flags = 0;
+#if defined(GPAC_CPUID_X86)
+	u32 regs[4], max_leaf;
+	gf_cpuid(0, 0, regs);
+	max_leaf = regs[0];
+	if (max_leaf >= 1) {
+		gf_cpuid(1, 0, regs);
+		if (regs[3] & (1<<26)) flags |= GF_CPU_SSE2;
+		if (regs[2] & (1<<9)) flags |= GF_CPU_SSSE3;
+		if (regs[2] & (1<<19)) flags |= GF_CPU_SSE41;
+		if (regs[2] & (1<<25)) flags |= GF_CPU_AES;
+		if (regs[2] & (1<<1)) flags |= GF_CPU_PCLMUL;
+		//AVX2 requires OS support for YMM registers save
+		if ((regs[2] & (1<<27)) && (regs[2] & (1<<28)) && ((gf_xgetbv() & 0x6) == 0x6) && (max_leaf >= 7)) {
+			gf_cpuid(7, 0, regs);
+			if (regs[1] & (1<<5)) flags |= GF_CPU_AVX2;
+		}
+	}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__)
+	flags |= GF_CPU_NEON;
+#endif
+	cpu_features_detected = flags;
+	cpu_features = flags;
+	cpu_features_init = GF_TRUE;
+}
+
+GF_EXPORT
+u32 gf_sys_get_cpu_features()
+{
+	if (!cpu_features_init)
+		gf_sys_detect_cpu_features();
+	return cpu_features;
+}
+
+GF_EXPORT
+void gf_sys_set_cpu_features(u32 features)
+{
+	if (!cpu_features_init)
+		gf_sys_detect_cpu_features();
+	cpu_features = cpu_features_detected & features;
+}
+
 static char szCacheDir[GF_MAX_PATH];
 
 const char * gf_get_default_cache_directory_ex(Bool do_create)
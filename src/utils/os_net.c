@@ -23,6 +23,11 @@
  *
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+//for ppoll
+#define _GNU_SOURCE
+#endif
+
 #ifndef GPAC_DISABLE_CORE_TOOLS
 
 #if defined(WIN32) || defined(_WIN32_WCE)
@@ -131,6 +136,27 @@ static int wsa_init = 0;
 typedef s32 SOCKET;
 #define closesocket(v) close(v)
 
+/*epoll socket groups and poll-based waits on a single socket, not limited by FD_SETSIZE*/
+#if defined(__linux__) && !defined(GPAC_DISABLE_EPOLL)
+#define GPAC_HAS_EPOLL
+#include <sys/epoll.h>
+#include <poll.h>
+#endif
+
+/*zero-copy file to socket transfer*/
+#if defined(__linux__) && !defined(GPAC_DISABLE_SENDFILE)
+#define GPAC_HAS_SENDFILE
+#include <sys/sendfile.h>
+#include <signal.h>
+#endif
+
+/*batch datagram I/O*/
+#if defined(__linux__) && !defined(GPAC_DISABLE_MMSG)
+#define GPAC_HAS_MMSG
+/*max number of datagrams per system call*/
+#define GF_SOCK_MMSG_MAX	64
+#endif
+
 #endif /*WIN32||_WIN32_WCE*/
 
 
@@ -198,8 +224,79 @@ struct __tag_socket
 	u32 dest_addr_len;
 
 	u32 usec_wait;
+
+#ifdef GPAC_HAS_EPOLL
+	/*socket group this socket is registered with, and readiness cached from edge-triggered events*/
+	GF_SockGroup *group;
+	u32 ready;
+	/*socket descriptor is not yet (or no longer) registered with the group*/
+	Bool group_pending;
+#endif
 };
 
+#ifdef GPAC_HAS_EPOLL
+enum
+{
+	GF_SOCK_READY_READ = 1,
+	GF_SOCK_READY_WRITE = 1<<1,
+};
+static void gf_sk_group_clear_ready(GF_Socket *sock, u32 flags);
+static void gf_sk_group_remove(GF_SockGroup *sg, GF_Socket *sk);
+static void gf_sk_group_set_pending(GF_Socket *sock);
+
+//called when a read or write would block, the next edge will set the readiness again
+#define SK_CLEAR_READY(_sock, _flags)	if ((_sock)->group) gf_sk_group_clear_ready(_sock, _flags);
+//called before the socket descriptor is (re)created, the group will register the new descriptor at next select
+#define SK_GROUP_PENDING(_sock)	if ((_sock)->group) gf_sk_group_set_pending(_sock);
+#else
+#define SK_CLEAR_READY(_sock, _flags)
+#define SK_GROUP_PENDING(_sock)
+#endif
+
+/*waits for read and/or write readiness on the socket, returns the number of ready descriptors or SOCKET_ERROR as select() does*/
+static s32 gf_sk_wait(GF_Socket *sock, Bool check_read, Bool check_write, u32 sec, u32 usec, Bool *can_read, Bool *can_write)
+{
+	s32 ready;
+#ifdef GPAC_HAS_EPOLL
+	struct pollfd pfd;
+	struct timespec timeout;
+
+	pfd.fd = sock->socket;
+	pfd.events = 0;
+	pfd.revents = 0;
+	if (check_read) pfd.events |= POLLIN;
+	if (check_write) pfd.events |= POLLOUT;
+	timeout.tv_sec = sec + usec/1000000;
+	timeout.tv_nsec = (usec%1000000) * 1000;
+
+	ready = ppoll(&pfd, 1, &timeout, NULL);
+	if (ready<0) return SOCKET_ERROR;
+	//report hangup and errors as ready so that the next call fetches the error
+	if (pfd.revents & POLLNVAL) {
+		errno = EBADF;
+		return SOCKET_ERROR;
+	}
+	if (can_read) *can_read = (check_read && (pfd.revents & (POLLIN|POLLHUP|POLLERR))) ? GF_TRUE : GF_FALSE;
+	if (can_write) *can_write = (check_write && (pfd.revents & (POLLOUT|POLLHUP|POLLERR))) ? GF_TRUE : GF_FALSE;
+#else
+	struct timeval timeout;
+	fd_set RGroup, WGroup;
+
+	FD_ZERO(&RGroup);
+	FD_ZERO(&WGroup);
+	if (check_read) FD_SET(sock->socket, &RGroup);
+	if (check_write) FD_SET(sock->socket, &WGroup);
+	timeout.tv_sec = sec;
+	timeout.tv_usec = usec;
+
+	ready = select((int) sock->socket+1, check_read ? &RGroup : NULL, check_write ? &WGroup : NULL, NULL, &timeout);
+	if (ready == SOCKET_ERROR) return SOCKET_ERROR;
+	if (can_read) *can_read = (check_read && FD_ISSET(sock->socket, &RGroup)) ? GF_TRUE : GF_FALSE;
+	if (can_write) *can_write = (check_write && FD_ISSET(sock->socket, &WGroup)) ? GF_TRUE : GF_FALSE;
+#endif
+	return ready;
+}
+
 
 
 GF_EXPORT
@@ -470,6 +567,9 @@ GF_EXPORT
 void gf_sk_del(GF_Socket *sock)
 {
 	assert( sock );
+#ifdef GPAC_HAS_EPOLL
+	if (sock->group) gf_sk_group_remove(sock->group, sock);
+#endif
 	gf_sk_free(sock);
 #ifdef WIN32
 	wsa_init --;
@@ -523,6 +623,8 @@ GF_Err gf_sk_connect(GF_Socket *sock, const char *PeerName, u16 PortNumber, cons
 	struct hostent *Host = NULL;
 #endif
 
+	SK_GROUP_PENDING(sock)
+
 	if (sock->flags & GF_SOCK_IS_UN) {
 #ifdef GPAC_HAS_SOCK_UN
 		struct sockaddr_un server_add;
@@ -704,6 +806,7 @@ GF_Err gf_sk_bind(GF_Socket *sock, const char *local_ip, u16 port, const char *p
 	if (!sock || sock->socket) return GF_BAD_PARAM;
 	if (local_ip && !strcmp(local_ip, "127.0.0.1"))
 		local_ip = NULL;
+	SK_GROUP_PENDING(sock)
 
 	if (sock->flags & GF_SOCK_IS_UN) {
 #ifdef GPAC_HAS_SOCK_UN
@@ -909,8 +1012,7 @@ GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
 	Bool not_ready = GF_FALSE;
 #ifndef __SYMBIAN32__
 	int ready;
-	struct timeval timeout;
-	fd_set Group;
+	Bool can_write;
 #endif
 
 	//the socket must be bound or connected
@@ -919,13 +1021,8 @@ GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
 
 #ifndef __SYMBIAN32__
 	//can we write?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = sock->usec_wait;
-
 	//TODO CHECK IF THIS IS CORRECT
-	ready = select((int) sock->socket+1, NULL, &Group, NULL, &timeout);
+	ready = gf_sk_wait(sock, GF_FALSE, GF_TRUE, 0, sock->usec_wait, NULL, &can_write);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -937,7 +1034,7 @@ GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
 	}
 
 	//should never happen (to check: is writeability is guaranteed for not-connected sockets)
-	if (!ready || !FD_ISSET(sock->socket, &Group)) {
+	if (!ready || !can_write) {
 		not_ready = GF_TRUE;
 	}
 #endif
@@ -955,11 +1052,14 @@ GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
 			res = (s32) send(sock->socket, (char *) buffer+count, length - count, sflags);
 		}
 		if (res == SOCKET_ERROR) {
-			if (not_ready)
+			if (not_ready) {
+				SK_CLEAR_READY(sock, GF_SOCK_READY_WRITE)
 				return GF_IP_NETWORK_EMPTY;
+			}
 
 			switch (res = LASTSOCKERROR) {
 			case EAGAIN:
+				SK_CLEAR_READY(sock, GF_SOCK_READY_WRITE)
 				return GF_IP_SOCK_WOULD_BLOCK;
 #ifndef __SYMBIAN32__
 			case ENOTCONN:
@@ -986,13 +1086,97 @@ GF_Err gf_sk_send(GF_Socket *sock, const u8 *buffer, u32 length)
 	return GF_OK;
 }
 
+GF_EXPORT
+GF_Err gf_sk_send_file(GF_Socket *sock, FILE *file, u64 offset, u32 length, u32 *written)
+{
+#ifdef GPAC_HAS_SENDFILE
+	off_t f_offset;
+	u32 count;
+	int fd;
+	GF_Err e = GF_OK;
+	Bool pipe_pending = GF_FALSE;
+	sigset_t pipe_set, prev_set, pending_set;
+#endif
+	if (written) *written = 0;
+	//the socket must be connected
+	if (!sock || !sock->socket || !file)
+		return GF_BAD_PARAM;
+
+#ifdef GPAC_HAS_SENDFILE
+	//sendfile can only be used on TCP sockets and on files backed by a file descriptor
+	if ((sock->flags & GF_SOCK_IS_TCP) != GF_SOCK_IS_TCP) return GF_NOT_SUPPORTED;
+	if ((sock->flags & GF_SOCK_HAS_PEER) || gf_fileio_check(file)) return GF_NOT_SUPPORTED;
+	fd = fileno(file);
+	if (fd<0) return GF_NOT_SUPPORTED;
+
+	//sendfile has no MSG_NOSIGNAL equivalent, block SIGPIPE for this thread while sending
+	sigemptyset(&pipe_set);
+	sigaddset(&pipe_set, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &pipe_set, &prev_set);
+	sigemptyset(&pending_set);
+	if (!sigpending(&pending_set) && sigismember(&pending_set, SIGPIPE))
+		pipe_pending = GF_TRUE;
+
+	f_offset = (off_t) offset;
+	count = 0;
+	while (count < length) {
+		ssize_t res = sendfile(sock->socket, fd, &f_offset, length - count);
+		if (res<0) {
+			int err = LASTSOCKERROR;
+			if (err==EINTR) continue;
+			switch (err) {
+			case EAGAIN:
+				SK_CLEAR_READY(sock, GF_SOCK_READY_WRITE)
+				if (!count) e = GF_IP_SOCK_WOULD_BLOCK;
+				break;
+			case ENOTCONN:
+			case ECONNRESET:
+			case EPIPE:
+				GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[socket] sendfile failure: %s\n", gf_errno_str(err)));
+				e = GF_IP_CONNECTION_CLOSED;
+				break;
+			//file or socket type not handled by sendfile, only report if nothing was sent yet
+			case EINVAL:
+			case ENOSYS:
+			case EOPNOTSUPP:
+				if (!count) {
+					e = GF_NOT_SUPPORTED;
+					break;
+				}
+				//fallthrough
+			default:
+				GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] sendfile failure: %s\n", gf_errno_str(err)));
+				e = GF_IP_NETWORK_FAILURE;
+				break;
+			}
+			break;
+		}
+		//end of file reached (file being written or truncated)
+		if (!res) break;
+		count += (u32) res;
+	}
+
+	//discard any SIGPIPE raised by this call before restoring the signal mask
+	if (!pipe_pending) {
+		struct timespec no_wait = {0, 0};
+		sigemptyset(&pending_set);
+		if (!sigpending(&pending_set) && sigismember(&pending_set, SIGPIPE))
+			sigtimedwait(&pipe_set, NULL, &no_wait);
+	}
+	pthread_sigmask(SIG_SETMASK, &prev_set, NULL);
+
+	if (written) *written = count;
+	return e;
+#else
+	return GF_NOT_SUPPORTED;
+#endif
+}
+
 GF_Err gf_sk_select(GF_Socket *sock, u32 mode)
 {
 #ifndef __SYMBIAN32__
 	int ready;
-	struct timeval timeout;
-	fd_set RGroup;
-	fd_set WGroup;
+	Bool can_read, can_write;
 #endif
 
 	//the socket must be bound or connected
@@ -1001,17 +1185,8 @@ GF_Err gf_sk_select(GF_Socket *sock, u32 mode)
 
 #ifndef __SYMBIAN32__
 	//can we write?
-	FD_ZERO(&RGroup);
-	FD_ZERO(&WGroup);
-	if (mode != GF_SK_SELECT_WRITE)
-		FD_SET(sock->socket, &RGroup);
-	if (mode != GF_SK_SELECT_READ)
-		FD_SET(sock->socket, &WGroup);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = sock->usec_wait;
-
 	//TODO CHECK IF THIS IS CORRECT
-	ready = select((int) sock->socket+1, &RGroup, &WGroup, NULL, &timeout);
+	ready = gf_sk_wait(sock, (mode != GF_SK_SELECT_WRITE) ? GF_TRUE : GF_FALSE, (mode != GF_SK_SELECT_READ) ? GF_TRUE : GF_FALSE, 0, sock->usec_wait, &can_read, &can_write);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1025,9 +1200,9 @@ GF_Err gf_sk_select(GF_Socket *sock, u32 mode)
 	//should never happen (to check: is writeability is guaranteed for not-connected sockets)
 	if (!ready)
 		return GF_IP_SOCK_WOULD_BLOCK;
-	if ((mode != GF_SK_SELECT_WRITE) && !FD_ISSET(sock->socket, &RGroup))
+	if ((mode != GF_SK_SELECT_WRITE) && !can_read)
 		return GF_IP_SOCK_WOULD_BLOCK;
-	if ((mode != GF_SK_SELECT_READ) && !FD_ISSET(sock->socket, &WGroup))
+	if ((mode != GF_SK_SELECT_READ) && !can_write)
 		return GF_IP_SOCK_WOULD_BLOCK;
 	return GF_OK;
 #else
@@ -1081,6 +1256,7 @@ GF_Err gf_sk_setup_multicast(GF_Socket *sock, const char *multi_IPAdd, u16 Multi
 	u32 local_add_id;
 
 	if (!sock || sock->socket) return GF_BAD_PARAM;
+	SK_GROUP_PENDING(sock)
 
 	if (TTL > 255) TTL = 255;
 
@@ -1280,22 +1456,181 @@ GF_Err gf_sk_setup_multicast(GF_Socket *sock, const char *multi_IPAdd, u16 Multi
 struct __tag_sock_group
 {
 	GF_List *sockets;
+#ifdef GPAC_HAS_EPOLL
+	int epoll_fd;
+	struct epoll_event *events;
+	u32 alloc_events;
+	//number of sockets with cached read and write readiness
+	u32 nb_read_ready, nb_write_ready;
+	//number of sockets waiting for their descriptor to be registered
+	u32 nb_pending;
+	//descriptors of sockets with cached read readiness, checked once per select
+	struct pollfd *pfds;
+	u32 alloc_pfds;
+#else
 	fd_set rgroup, wgroup;
+#endif
 };
 
+#ifdef GPAC_HAS_EPOLL
+/*
+	sockets are registered once in edge-triggered mode. Since callers do not necessarily drain sockets,
+	readiness is cached in the socket when an event is received and only reset when a read or write on
+	the socket would block, which gives the same level semantics as select() to callers
+*/
+#define SK_GROUP_MIN_EVENTS	64
+
+static void gf_sk_group_set_ready(GF_Socket *sock, u32 flags)
+{
+	u32 new_flags = flags & ~sock->ready;
+	if (new_flags & GF_SOCK_READY_READ) sock->group->nb_read_ready++;
+	if (new_flags & GF_SOCK_READY_WRITE) sock->group->nb_write_ready++;
+	sock->ready |= flags;
+}
+
+static void gf_sk_group_clear_ready(GF_Socket *sock, u32 flags)
+{
+	u32 old_flags = flags & sock->ready;
+	if (old_flags & GF_SOCK_READY_READ) sock->group->nb_read_ready--;
+	if (old_flags & GF_SOCK_READY_WRITE) sock->group->nb_write_ready--;
+	sock->ready &= ~flags;
+}
+
+static Bool gf_sk_group_has_ready(GF_SockGroup *sg, GF_SockSelectMode mode)
+{
+	if ((mode!=GF_SK_SELECT_WRITE) && sg->nb_read_ready) return GF_TRUE;
+	if ((mode!=GF_SK_SELECT_READ) && sg->nb_write_ready) return GF_TRUE;
+	return GF_FALSE;
+}
+
+static void gf_sk_group_set_pending(GF_Socket *sock)
+{
+	gf_sk_group_clear_ready(sock, GF_SOCK_READY_READ|GF_SOCK_READY_WRITE);
+	if (sock->group_pending) return;
+	sock->group_pending = GF_TRUE;
+	sock->group->nb_pending++;
+}
+
+static Bool gf_sk_group_add_fd(GF_SockGroup *sg, GF_Socket *sk)
+{
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(struct epoll_event));
+	ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+	ev.data.ptr = sk;
+	if (epoll_ctl(sg->epoll_fd, EPOLL_CTL_ADD, sk->socket, &ev) < 0) {
+		//descriptor was not recreated
+		if (LASTSOCKERROR == EEXIST) return GF_TRUE;
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] failed to register socket to epoll: %s\n", gf_errno_str(LASTSOCKERROR) ));
+		return GF_FALSE;
+	}
+	return GF_TRUE;
+}
+
+//register descriptors created since the socket was added to the group - this is only done at setup time
+static void gf_sk_group_register_pending(GF_SockGroup *sg)
+{
+	GF_Socket *sock;
+	u32 i=0;
+	while ((sock = gf_list_enum(sg->sockets, &i))) {
+		if (!sock->group_pending || !sock->socket) continue;
+		sock->group_pending = GF_FALSE;
+		sg->nb_pending--;
+		gf_sk_group_add_fd(sg, sock);
+	}
+}
+
+/*data may have been consumed from sockets with cached read readiness without the read blocking (partial reads, TLS layer, accept),
+check them all at once with a non-blocking poll and clear the ones no longer readable*/
+static void gf_sk_group_check_read_ready(GF_SockGroup *sg)
+{
+	GF_Socket *sock;
+	u32 i=0, nb_fds=0;
+	s32 ready;
+	struct timespec timeout;
+
+	if (sg->alloc_pfds < sg->nb_read_ready) {
+		struct pollfd *pfds = gf_realloc(sg->pfds, sizeof(struct pollfd) * sg->nb_read_ready);
+		if (!pfds) return;
+		sg->pfds = pfds;
+		sg->alloc_pfds = sg->nb_read_ready;
+	}
+	while ((sock = gf_list_enum(sg->sockets, &i))) {
+		if (!(sock->ready & GF_SOCK_READY_READ)) continue;
+		if (nb_fds == sg->alloc_pfds) break;
+		sg->pfds[nb_fds].fd = sock->socket;
+		sg->pfds[nb_fds].events = POLLIN;
+		sg->pfds[nb_fds].revents = 0;
+		nb_fds++;
+	}
+	if (!nb_fds) return;
+
+	timeout.tv_sec = 0;
+	timeout.tv_nsec = 0;
+	ready = ppoll(sg->pfds, nb_fds, &timeout, NULL);
+	if (ready<0) return;
+
+	i=0;
+	nb_fds=0;
+	while ((sock = gf_list_enum(sg->sockets, &i))) {
+		if (!(sock->ready & GF_SOCK_READY_READ)) continue;
+		if (nb_fds == sg->alloc_pfds) break;
+		//hangup and errors are kept as ready, the next read will fetch the error
+		if (!sg->pfds[nb_fds].revents)
+			gf_sk_group_clear_ready(sock, GF_SOCK_READY_READ);
+		nb_fds++;
+	}
+}
+
+static void gf_sk_group_remove(GF_SockGroup *sg, GF_Socket *sk)
+{
+	gf_list_del_item(sg->sockets, sk);
+	if (sk->group != sg) return;
+	if (sk->socket && !sk->group_pending)
+		epoll_ctl(sg->epoll_fd, EPOLL_CTL_DEL, sk->socket, NULL);
+	if (sk->group_pending) sg->nb_pending--;
+	sk->group_pending = GF_FALSE;
+	gf_sk_group_clear_ready(sk, GF_SOCK_READY_READ|GF_SOCK_READY_WRITE);
+	sk->group = NULL;
+}
+#endif
+
 GF_SockGroup *gf_sk_group_new()
 {
 	GF_SockGroup *tmp;
 	GF_SAFEALLOC(tmp, GF_SockGroup);
 	if (!tmp) return NULL;
 	tmp->sockets = gf_list_new();
+#ifdef GPAC_HAS_EPOLL
+	tmp->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	tmp->alloc_events = SK_GROUP_MIN_EVENTS;
+	tmp->events = gf_malloc(sizeof(struct epoll_event) * tmp->alloc_events);
+	if ((tmp->epoll_fd<0) || !tmp->events || !tmp->sockets) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] failed to create epoll instance: %s\n", gf_errno_str(LASTSOCKERROR) ));
+		gf_sk_group_del(tmp);
+		return NULL;
+	}
+#else
 	FD_ZERO(&tmp->rgroup);
 	FD_ZERO(&tmp->wgroup);
+#endif
 	return tmp;
 }
 
 void gf_sk_group_del(GF_SockGroup *sg)
 {
+#ifdef GPAC_HAS_EPOLL
+	GF_Socket *sock;
+	u32 i=0;
+	while ((sock = gf_list_enum(sg->sockets, &i))) {
+		if (sock->group == sg) {
+			sock->group = NULL;
+			sock->ready = 0;
+		}
+	}
+	if (sg->epoll_fd>=0) close(sg->epoll_fd);
+	if (sg->events) gf_free(sg->events);
+	if (sg->pfds) gf_free(sg->pfds);
+#endif
 	gf_list_del(sg->sockets);
 	gf_free(sg);
 }
@@ -1303,29 +1638,66 @@ void gf_sk_group_del(GF_SockGroup *sg)
 void gf_sk_group_register(GF_SockGroup *sg, GF_Socket *sk)
 {
 	if (sg && sk) {
-		if (gf_list_find(sg->sockets, sk)<0)
+		if (gf_list_find(sg->sockets, sk)<0) {
+#ifdef GPAC_HAS_EPOLL
+			//readiness is cached in the socket, a socket can only be in one group
+			if (sk->group) gf_sk_group_remove(sk->group, sk);
+
+			sk->ready = 0;
+			sk->group_pending = GF_FALSE;
+			//socket not yet bound or connected, register at next select
+			if (!sk->socket) {
+				sk->group_pending = GF_TRUE;
+				sg->nb_pending++;
+			} else if (!gf_sk_group_add_fd(sg, sk)) {
+				return;
+			}
+			sk->group = sg;
+#endif
 			gf_list_add(sg->sockets, sk);
+		}
 	}
 }
 void gf_sk_group_unregister(GF_SockGroup *sg, GF_Socket *sk)
 {
 	if (sg && sk) {
+#ifdef GPAC_HAS_EPOLL
+		gf_sk_group_remove(sg, sk);
+#else
 		gf_list_del_item(sg->sockets, sk);
+#endif
 	}
 }
 
 GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mode)
 {
 	s32 ready;
+#ifdef GPAC_HAS_EPOLL
+	s32 i, timeout_ms;
+#else
 	u32 i=0;
 	struct timeval timeout;
 	u32 max_fd=0;
 	GF_Socket *sock;
 	fd_set *rgroup=NULL, *wgroup=NULL;
+#endif
 
 	if (!gf_list_count(sg->sockets))
 		return GF_IP_NETWORK_EMPTY;
 
+#ifdef GPAC_HAS_EPOLL
+	if (sg->nb_pending) gf_sk_group_register_pending(sg);
+
+	if ((mode!=GF_SK_SELECT_WRITE) && sg->nb_read_ready)
+		gf_sk_group_check_read_ready(sg);
+
+	//sockets left ready by the previous call, only collect pending events
+	if (gf_sk_group_has_ready(sg, mode)) timeout_ms = 0;
+	//epoll only has a millisecond resolution, round up so that sub-millisecond waits still block
+	else timeout_ms = (usec_wait + 999) / 1000;
+
+	ready = epoll_wait(sg->epoll_fd, sg->events, sg->alloc_events, timeout_ms);
+#else
 	FD_ZERO(&sg->rgroup);
 	FD_ZERO(&sg->wgroup);
 
@@ -1358,6 +1730,7 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mod
 		timeout.tv_usec = usec_wait;
 	}
 	ready = select((int) max_fd+1, rgroup, wgroup, NULL, &timeout);
+#endif
 
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
@@ -1375,6 +1748,29 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mod
 			return GF_IP_NETWORK_FAILURE;
 		}
 	}
+
+#ifdef GPAC_HAS_EPOLL
+	for (i=0; i<ready; i++) {
+		GF_Socket *sock = sg->events[i].data.ptr;
+		u32 evts = sg->events[i].events;
+		u32 flags = 0;
+		//hangup and errors are signaled as ready, the next read or write will fetch the error
+		if (evts & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) flags |= GF_SOCK_READY_READ;
+		if (evts & (EPOLLOUT | EPOLLHUP | EPOLLERR)) flags |= GF_SOCK_READY_WRITE;
+		if (sock->group == sg)
+			gf_sk_group_set_ready(sock, flags);
+	}
+	//more events may be pending, grow event array for next call
+	if ((u32) ready == sg->alloc_events) {
+		struct epoll_event *events = gf_realloc(sg->events, sizeof(struct epoll_event) * 2 * sg->alloc_events);
+		if (events) {
+			sg->events = events;
+			sg->alloc_events *= 2;
+		}
+	}
+	ready = gf_sk_group_has_ready(sg, mode) ? 1 : 0;
+#endif
+
 	if (!ready) {
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[socket] nothing to be read - ready %d\n", ready));
 		return GF_IP_NETWORK_EMPTY;
@@ -1385,10 +1781,20 @@ GF_Err gf_sk_group_select(GF_SockGroup *sg, u32 usec_wait, GF_SockSelectMode mod
 Bool gf_sk_group_sock_is_set(GF_SockGroup *sg, GF_Socket *sk, GF_SockSelectMode mode)
 {
 	if (sg && sk) {
+#ifdef GPAC_HAS_EPOLL
+		//readiness was checked by the last gf_sk_group_select
+		if (sk->group != sg)
+			return GF_FALSE;
+		if ((mode!=GF_SK_SELECT_WRITE) && (sk->ready & GF_SOCK_READY_READ))
+			return GF_TRUE;
+		if ((mode!=GF_SK_SELECT_READ) && (sk->ready & GF_SOCK_READY_WRITE))
+			return GF_TRUE;
+#else
 		if ((mode!=GF_SK_SELECT_WRITE) && FD_ISSET(sk->socket, &sg->rgroup))
 			return GF_TRUE;
 		if ((mode!=GF_SK_SELECT_READ) && FD_ISSET(sk->socket, &sg->wgroup))
 			return GF_TRUE;
+#endif
 	}
 	return GF_FALSE;
 }
@@ -1402,8 +1808,7 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 *By
 	s32 res;
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
+	Bool can_read;
 #endif
 
 	if (BytesRead) *BytesRead = 0;
@@ -1412,11 +1817,7 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 *By
 #ifndef __SYMBIAN32__
 	if (do_select) {
 		//can we read?
-		timeout.tv_sec = 0;
-		timeout.tv_usec = sock->usec_wait;
-		FD_ZERO(&Group);
-		FD_SET(sock->socket, &Group);
-		ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+		ready = gf_sk_wait(sock, GF_TRUE, GF_FALSE, 0, sock->usec_wait, &can_read, NULL);
 
 		if (ready == SOCKET_ERROR) {
 			switch (LASTSOCKERROR) {
@@ -1434,8 +1835,9 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 *By
 				return GF_IP_NETWORK_FAILURE;
 			}
 		}
-		if (!ready || !FD_ISSET(sock->socket, &Group)) {
+		if (!ready || !can_read) {
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[socket] nothing to be read - ready %d\n", ready));
+			SK_CLEAR_READY(sock, GF_SOCK_READY_READ)
 			return GF_IP_NETWORK_EMPTY;
 		}
 	}
@@ -1454,6 +1856,7 @@ GF_Err gf_sk_receive_internal(GF_Socket *sock, char *buffer, u32 length, u32 *By
 		res = LASTSOCKERROR;
 		switch (res) {
 		case EAGAIN:
+			SK_CLEAR_READY(sock, GF_SOCK_READY_READ)
 			return GF_IP_SOCK_WOULD_BLOCK;
 #ifndef __SYMBIAN32__
 		case EMSGSIZE:
@@ -1488,6 +1891,153 @@ GF_Err gf_sk_receive_no_select(GF_Socket *sock, u8 *buffer, u32 length, u32 *Byt
 	return gf_sk_receive_internal(sock, buffer, length, BytesRead, GF_FALSE);
 }
 
+GF_EXPORT
+GF_Err gf_sk_receive_batch(GF_Socket *sock, GF_SockDatagram *dgrams, u32 nb_dgrams, u32 *nb_received)
+{
+#ifdef GPAC_HAS_MMSG
+	struct mmsghdr msgs[GF_SOCK_MMSG_MAX];
+	struct iovec iovs[GF_SOCK_MMSG_MAX];
+	s32 i, res;
+#endif
+	GF_Err e;
+
+	if (nb_received) *nb_received = 0;
+	if (!sock || !sock->socket || !dgrams || !nb_dgrams) return GF_BAD_PARAM;
+
+#ifdef GPAC_HAS_MMSG
+	//datagram sockets only, stream sockets use regular reception
+	if (!(sock->flags & GF_SOCK_IS_TCP) && (nb_dgrams>1)) {
+		if (nb_dgrams > GF_SOCK_MMSG_MAX) nb_dgrams = GF_SOCK_MMSG_MAX;
+		memset(msgs, 0, sizeof(struct mmsghdr) * nb_dgrams);
+		for (i=0; i<(s32) nb_dgrams; i++) {
+			iovs[i].iov_base = dgrams[i].data;
+			iovs[i].iov_len = dgrams[i].size;
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			//all sources are written at the same place, we only keep the last one as done by recvfrom
+			if (sock->flags & GF_SOCK_HAS_PEER) {
+				msgs[i].msg_hdr.msg_name = &sock->dest_addr;
+				msgs[i].msg_hdr.msg_namelen = sizeof(sock->dest_addr);
+			}
+			dgrams[i].read = 0;
+		}
+		//wait for the first datagram only, as done by recv on blocking sockets
+		do {
+			res = recvmmsg(sock->socket, msgs, nb_dgrams, MSG_WAITFORONE, NULL);
+		} while ((res == SOCKET_ERROR) && (LASTSOCKERROR == EINTR));
+
+		if (res == SOCKET_ERROR) {
+			switch (LASTSOCKERROR) {
+			case EAGAIN:
+				SK_CLEAR_READY(sock, GF_SOCK_READY_READ)
+				return GF_IP_SOCK_WOULD_BLOCK;
+			case ENOTCONN:
+			case ECONNRESET:
+			case ECONNABORTED:
+				GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading: %s\n", gf_errno_str(LASTSOCKERROR)));
+				return GF_IP_CONNECTION_CLOSED;
+			default:
+				GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] error reading: %s\n", gf_errno_str(LASTSOCKERROR) ));
+				return GF_IP_NETWORK_FAILURE;
+			}
+		}
+		if (!res) return GF_IP_NETWORK_EMPTY;
+
+		for (i=0; i<res; i++) {
+			dgrams[i].read = msgs[i].msg_len;
+			if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+				GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[socket] datagram truncated to %d bytes, increase reception buffer size\n", dgrams[i].size));
+			}
+		}
+		if (sock->flags & GF_SOCK_HAS_PEER)
+			sock->dest_addr_len = msgs[res-1].msg_hdr.msg_namelen;
+
+		if (nb_received) *nb_received = res;
+		return GF_OK;
+	}
+#endif
+
+	//single datagram reception
+	e = gf_sk_receive_internal(sock, dgrams[0].data, dgrams[0].size, &dgrams[0].read, GF_FALSE);
+	if (!e && nb_received) *nb_received = 1;
+	return e;
+}
+
+GF_EXPORT
+GF_Err gf_sk_send_batch(GF_Socket *sock, const GF_SockDatagram *dgrams, u32 nb_dgrams, u32 *nb_sent)
+{
+	u32 count = 0;
+	GF_Err e = GF_OK;
+#ifdef GPAC_HAS_MMSG
+	struct mmsghdr msgs[GF_SOCK_MMSG_MAX];
+	struct iovec iovs[GF_SOCK_MMSG_MAX];
+#endif
+
+	if (nb_sent) *nb_sent = 0;
+	if (!sock || !sock->socket || (nb_dgrams && !dgrams)) return GF_BAD_PARAM;
+
+#ifdef GPAC_HAS_MMSG
+	//datagram sockets only, stream sockets use regular emission
+	if (!(sock->flags & GF_SOCK_IS_TCP)) {
+		while (count < nb_dgrams) {
+			s32 i, res;
+			u32 nb_msgs = nb_dgrams - count;
+			if (nb_msgs > GF_SOCK_MMSG_MAX) nb_msgs = GF_SOCK_MMSG_MAX;
+
+			memset(msgs, 0, sizeof(struct mmsghdr) * nb_msgs);
+			for (i=0; i<(s32) nb_msgs; i++) {
+				iovs[i].iov_base = (void *) dgrams[count+i].data;
+				iovs[i].iov_len = dgrams[count+i].size;
+				msgs[i].msg_hdr.msg_iov = &iovs[i];
+				msgs[i].msg_hdr.msg_iovlen = 1;
+				if (sock->flags & GF_SOCK_HAS_PEER) {
+					msgs[i].msg_hdr.msg_name = &sock->dest_addr;
+					msgs[i].msg_hdr.msg_namelen = sock->dest_addr_len;
+				}
+			}
+			res = sendmmsg(sock->socket, msgs, nb_msgs, MSG_NOSIGNAL);
+			if (res == SOCKET_ERROR) {
+				switch (LASTSOCKERROR) {
+				case EINTR:
+					continue;
+				case EAGAIN:
+					SK_CLEAR_READY(sock, GF_SOCK_READY_WRITE)
+					e = GF_IP_SOCK_WOULD_BLOCK;
+					break;
+				case ENOTCONN:
+				case ECONNRESET:
+				case EPIPE:
+					GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[socket] send failure: %s\n", gf_errno_str(LASTSOCKERROR)));
+					e = GF_IP_CONNECTION_CLOSED;
+					break;
+				case ENOBUFS:
+					GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[socket] send failure: %s\n", gf_errno_str(LASTSOCKERROR)));
+					e = GF_BUFFER_TOO_SMALL;
+					break;
+				default:
+					GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] send failure: %s\n", gf_errno_str(LASTSOCKERROR)));
+					e = GF_IP_NETWORK_FAILURE;
+					break;
+				}
+				break;
+			}
+			count += (u32) res;
+		}
+		if (nb_sent) *nb_sent = count;
+		return e;
+	}
+#endif
+
+	//one datagram per call
+	while (count < nb_dgrams) {
+		e = gf_sk_send(sock, dgrams[count].data, dgrams[count].size);
+		if (e) break;
+		count++;
+	}
+	if (nb_sent) *nb_sent = count;
+	return e;
+}
+
 GF_EXPORT
 GF_Err gf_sk_listen(GF_Socket *sock, u32 MaxConnection)
 {
@@ -1507,21 +2057,15 @@ GF_Err gf_sk_accept(GF_Socket *sock, GF_Socket **newConnection)
 	SOCKET sk;
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
+	Bool can_read;
 #endif
 	*newConnection = NULL;
 	if (!sock || !(sock->flags & GF_SOCK_IS_LISTENING) ) return GF_BAD_PARAM;
 
 #ifndef __SYMBIAN32__
 	//can we read?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = sock->usec_wait;
-
 	//TODO - check if this is correct
-	ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+	ready = gf_sk_wait(sock, GF_TRUE, GF_FALSE, 0, sock->usec_wait, &can_read, NULL);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1531,7 +2075,10 @@ GF_Err gf_sk_accept(GF_Socket *sock, GF_Socket **newConnection)
 			return GF_IP_NETWORK_FAILURE;
 		}
 	}
-	if (!ready || !FD_ISSET(sock->socket, &Group)) return GF_IP_NETWORK_EMPTY;
+	if (!ready || !can_read) {
+		SK_CLEAR_READY(sock, GF_SOCK_READY_READ)
+		return GF_IP_NETWORK_EMPTY;
+	}
 #endif
 
 #ifdef GPAC_HAS_IPV6
@@ -1546,6 +2093,7 @@ GF_Err gf_sk_accept(GF_Socket *sock, GF_Socket **newConnection)
 //		if (sock->flags & GF_SOCK_NON_BLOCKING) return GF_IP_NETWORK_FAILURE;
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
+			SK_CLEAR_READY(sock, GF_SOCK_READY_READ)
 			return GF_IP_SOCK_WOULD_BLOCK;
 		default:
 			GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] accept error: %s\n", gf_errno_str(LASTSOCKERROR)));
@@ -1557,6 +2105,11 @@ GF_Err gf_sk_accept(GF_Socket *sock, GF_Socket **newConnection)
 	(*newConnection)->socket = sk;
 	(*newConnection)->flags = sock->flags & ~GF_SOCK_IS_LISTENING;
 	(*newConnection)->usec_wait = sock->usec_wait;
+#ifdef GPAC_HAS_EPOLL
+	(*newConnection)->group = NULL;
+	(*newConnection)->ready = 0;
+	(*newConnection)->group_pending = GF_FALSE;
+#endif
 #ifdef GPAC_HAS_IPV6
 	memcpy( &(*newConnection)->dest_addr, &sock->dest_addr, client_address_size);
 	memset(&sock->dest_addr, 0, sizeof(struct sockaddr_in6));
@@ -1667,8 +2220,7 @@ GF_Err gf_sk_send_to(GF_Socket *sock, const char *buffer, u32 length, char *remo
 #endif
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
+	Bool can_write;
 #endif
 
 	//the socket must be bound or connected
@@ -1677,13 +2229,8 @@ GF_Err gf_sk_send_to(GF_Socket *sock, const char *buffer, u32 length, char *remo
 
 #ifndef __SYMBIAN32__
 	//can we write?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = sock->usec_wait;
-
 	//TODO - check if this is correct
-	ready = select((int) sock->socket+1, NULL, &Group, NULL, &timeout);
+	ready = gf_sk_wait(sock, GF_FALSE, GF_TRUE, 0, sock->usec_wait, NULL, &can_write);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1693,7 +2240,10 @@ GF_Err gf_sk_send_to(GF_Socket *sock, const char *buffer, u32 length, char *remo
 			return GF_IP_NETWORK_FAILURE;
 		}
 	}
-	if (!ready || !FD_ISSET(sock->socket, &Group)) return GF_IP_NETWORK_EMPTY;
+	if (!ready || !can_write) {
+		SK_CLEAR_READY(sock, GF_SOCK_READY_WRITE)
+		return GF_IP_NETWORK_EMPTY;
+	}
 #endif
 
 
@@ -1737,6 +2287,7 @@ GF_Err gf_sk_send_to(GF_Socket *sock, const char *buffer, u32 length, char *remo
 		if (res == SOCKET_ERROR) {
 			switch (LASTSOCKERROR) {
 			case EAGAIN:
+				SK_CLEAR_READY(sock, GF_SOCK_READY_WRITE)
 				return GF_IP_SOCK_WOULD_BLOCK;
 			default:
 				GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] sendto error: %s\n", gf_errno_str(LASTSOCKERROR)));
@@ -1754,8 +2305,7 @@ GF_Err gf_sk_probe(GF_Socket *sock)
 {
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
+	Bool can_read;
 #endif
 	s32 res;
 	u8 buffer[1];
@@ -1763,12 +2313,7 @@ GF_Err gf_sk_probe(GF_Socket *sock)
 
 #ifndef __SYMBIAN32__
 	//can we read?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = 0;
-	timeout.tv_usec = 100;
-
-	ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+	ready = gf_sk_wait(sock, GF_TRUE, GF_FALSE, 0, 100, &can_read, NULL);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1778,7 +2323,8 @@ GF_Err gf_sk_probe(GF_Socket *sock)
 			return GF_IP_CONNECTION_CLOSED;
 		}
 	}
-	if (!FD_ISSET(sock->socket, &Group)) {
+	if (!can_read) {
+		SK_CLEAR_READY(sock, GF_SOCK_READY_READ)
 		return GF_IP_NETWORK_EMPTY;
 	}
 #endif
@@ -1807,8 +2353,7 @@ GF_Err gf_sk_receive_wait(GF_Socket *sock, u8 *buffer, u32 length, u32 *BytesRea
 	s32 res;
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
+	Bool can_read;
 #endif
 
 	if (!sock || !sock->socket || !buffer || !BytesRead) return GF_BAD_PARAM;
@@ -1816,12 +2361,7 @@ GF_Err gf_sk_receive_wait(GF_Socket *sock, u8 *buffer, u32 length, u32 *BytesRea
 
 #ifndef __SYMBIAN32__
 	//can we read?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = Second;
-	timeout.tv_usec = sock->usec_wait;
-
-	ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+	ready = gf_sk_wait(sock, GF_TRUE, GF_FALSE, Second, sock->usec_wait, &can_read, NULL);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1831,7 +2371,8 @@ GF_Err gf_sk_receive_wait(GF_Socket *sock, u8 *buffer, u32 length, u32 *BytesRea
 			return GF_IP_NETWORK_FAILURE;
 		}
 	}
-	if (!FD_ISSET(sock->socket, &Group)) {
+	if (!can_read) {
+		SK_CLEAR_READY(sock, GF_SOCK_READY_READ)
 		return GF_IP_NETWORK_EMPTY;
 	}
 #endif
@@ -1840,6 +2381,7 @@ GF_Err gf_sk_receive_wait(GF_Socket *sock, u8 *buffer, u32 length, u32 *BytesRea
 	if (res == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
+			SK_CLEAR_READY(sock, GF_SOCK_READY_READ)
 			return GF_IP_SOCK_WOULD_BLOCK;
 		default:
 			GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[socket] recv error: %s\n", gf_errno_str(LASTSOCKERROR)));
@@ -1859,8 +2401,7 @@ GF_Err gf_sk_send_wait(GF_Socket *sock, const u8 *buffer, u32 length, u32 Second
 	s32 res;
 #ifndef __SYMBIAN32__
 	s32 ready;
-	struct timeval timeout;
-	fd_set Group;
+	Bool can_write;
 #endif
 
 	//the socket must be bound or connected
@@ -1868,13 +2409,8 @@ GF_Err gf_sk_send_wait(GF_Socket *sock, const u8 *buffer, u32 length, u32 Second
 
 #ifndef __SYMBIAN32__
 	//can we write?
-	FD_ZERO(&Group);
-	FD_SET(sock->socket, &Group);
-	timeout.tv_sec = Second;
-	timeout.tv_usec = sock->usec_wait;
-
 	//TODO - check if this is correct
-	ready = select((int) sock->socket+1, NULL, &Group, NULL, &timeout);
+	ready = gf_sk_wait(sock, GF_FALSE, GF_TRUE, Second, sock->usec_wait, NULL, &can_write);
 	if (ready == SOCKET_ERROR) {
 		switch (LASTSOCKERROR) {
 		case EAGAIN:
@@ -1885,7 +2421,8 @@ GF_Err gf_sk_send_wait(GF_Socket *sock, const u8 *buffer, u32 length, u32 Second
 		}
 	}
 	//should never happen (to check: is writeability is guaranteed for not-connected sockets)
-	if (!ready || !FD_ISSET(sock->socket, &Group)) {
+	if (!ready || !can_write) {
+		SK_CLEAR_READY(sock, GF_SOCK_READY_WRITE)
 		return GF_IP_NETWORK_EMPTY;
 	}
 #endif
@@ -1897,6 +2434,7 @@ GF_Err gf_sk_send_wait(GF_Socket *sock, const u8 *buffer, u32 length, u32 Second
 		if (res == SOCKET_ERROR) {
 			switch (LASTSOCKERROR) {
 			case EAGAIN:
+				SK_CLEAR_READY(sock, GF_SOCK_READY_WRITE)
 				return GF_IP_SOCK_WOULD_BLOCK;
 #ifndef __SYMBIAN32__
 			case ECONNRESET:
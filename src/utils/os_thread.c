@@ -23,6 +23,11 @@
  *
  */
 
+#if !defined(WIN32) && defined(__GNUC__) && (__GNUC__ >= 4) && !defined(_GNU_SOURCE)
+//for pthread_setaffinity_np
+#define _GNU_SOURCE
+#endif
+
 #ifndef GPAC_DISABLE_CORE_TOOLS
 
 #ifdef GPAC_CONFIG_ANDROID
@@ -401,6 +406,43 @@ void gf_th_set_priority(GF_Thread *t, s32 priority)
 #endif
 }
 
+GF_EXPORT
+GF_Err gf_th_set_affinity(GF_Thread *t, const u32 *cpus, u32 nb_cpus)
+{
+#if defined(WIN32) && !defined(_WIN32_WCE)
+	u32 i;
+	DWORD_PTR mask = 0;
+	if (!cpus || !nb_cpus) return GF_BAD_PARAM;
+	for (i=0; i<nb_cpus; i++) {
+		if (cpus[i] < 8*sizeof(DWORD_PTR))
+			mask |= ((DWORD_PTR)1) << cpus[i];
+	}
+	if (!mask) return GF_BAD_PARAM;
+	if (!SetThreadAffinityMask(t ? t->threadH : GetCurrentThread(), mask)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_MUTEX, ("[Thread] Couldn't set CPU affinity, error %d\n", GetLastError()));
+		return GF_IO_ERR;
+	}
+	return GF_OK;
+#elif defined(GPAC_CONFIG_LINUX) && !defined(GPAC_CONFIG_ANDROID)
+	u32 i;
+	cpu_set_t cpuset;
+	if (!cpus || !nb_cpus) return GF_BAD_PARAM;
+	CPU_ZERO(&cpuset);
+	for (i=0; i<nb_cpus; i++) {
+		if (cpus[i] < CPU_SETSIZE)
+			CPU_SET(cpus[i], &cpuset);
+	}
+	if (!CPU_COUNT(&cpuset)) return GF_BAD_PARAM;
+	if (pthread_setaffinity_np(t ? t->threadH : pthread_self(), sizeof(cpu_set_t), &cpuset)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_MUTEX, ("[Thread] Couldn't set CPU affinity for thread ID 0x%08x\n", gf_th_id()));
+		return GF_IO_ERR;
+	}
+	return GF_OK;
+#else
+	return GF_NOT_SUPPORTED;
+#endif
+}
+
 GF_EXPORT
 u32 gf_th_status(GF_Thread *t)
 {
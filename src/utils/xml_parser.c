@@ -46,19 +46,152 @@
 
 static GF_Err gf_xml_sax_parse_intern(GF_SAXParser *parser, char *current);
 
-static char *xml_translate_xml_string(char *str)
+/*markup scanning
+
+Text content and whitespace between elements are skipped in bulk up to the next '<', counting line breaks on the way.
+This is done using SSE2/AVX2/NEON when available, with a scalar fallback giving the exact same result*/
+
+#if defined(WIN32) && !defined(__GNUC__)
+# include <intrin.h>
+# define GPAC_HAS_SSE2
+# define GPAC_HAS_AVX2
+# define XML_AVX2_TARGET
+#else
+# ifdef __SSE2__
+#  include <emmintrin.h>
+#  define GPAC_HAS_SSE2
+# endif
+# if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  include <immintrin.h>
+#  define GPAC_HAS_AVX2
+#  define XML_AVX2_TARGET __attribute__((target("avx2")))
+# endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define GPAC_HAS_NEON
+#endif
+
+#if defined(GPAC_HAS_SSE2) || defined(GPAC_HAS_AVX2)
+static GFINLINE u32 xml_ctz(u32 mask)
 {
-	char *value;
-	u32 size, i, j;
-	if (!str || !strlen(str)) return NULL;
-	value = (char *)gf_malloc(sizeof(char) * 500);
-	size = 500;
-	i = j = 0;
-	while (str[i]) {
-		if (j+20 >= size) {
-			size += 500;
-			value = (char *)gf_realloc(value, sizeof(char)*size);
+#if defined(WIN32) && !defined(__GNUC__)
+	unsigned long idx;
+	_BitScanForward(&idx, mask);
+	return (u32) idx;
+#else
+	return (u32) __builtin_ctz(mask);
+#endif
+}
+
+static GFINLINE u32 xml_popcount(u32 mask)
+{
+	mask = mask - ((mask >> 1) & 0x55555555);
+	mask = (mask & 0x33333333) + ((mask >> 2) & 0x33333333);
+	return (((mask + (mask >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+#endif
+
+typedef u32 (*xml_scan_fn)(const char *buf, u32 pos, u32 size, u32 *nb_lines);
+
+//returns the position of the first '<' at or after pos, or size if not found. Line breaks before that position are added to nb_lines
+static u32 xml_scan_markup_c(const char *buf, u32 pos, u32 size, u32 *nb_lines)
+{
+	while (pos < size) {
+		char c = buf[pos];
+		if (c=='<') return pos;
+		if (c=='\n') (*nb_lines)++;
+		pos++;
+	}
+	return size;
+}
+
+#ifdef GPAC_HAS_SSE2
+static u32 xml_scan_markup_sse2(const char *buf, u32 pos, u32 size, u32 *nb_lines)
+{
+	const __m128i lt = _mm_set1_epi8('<');
+	const __m128i nl = _mm_set1_epi8('\n');
+	while (pos + 16 <= size) {
+		__m128i v = _mm_loadu_si128((const __m128i *) (buf + pos));
+		u32 lt_mask = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(v, lt));
+		u32 nl_mask = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(v, nl));
+		if (lt_mask) {
+			u32 idx = xml_ctz(lt_mask);
+			*nb_lines += xml_popcount(nl_mask & ((1<<idx) - 1));
+			return pos + idx;
 		}
+		*nb_lines += xml_popcount(nl_mask);
+		pos += 16;
+	}
+	return xml_scan_markup_c(buf, pos, size, nb_lines);
+}
+#endif
+
+#ifdef GPAC_HAS_AVX2
+XML_AVX2_TARGET
+static u32 xml_scan_markup_avx2(const char *buf, u32 pos, u32 size, u32 *nb_lines)
+{
+	const __m256i lt = _mm256_set1_epi8('<');
+	const __m256i nl = _mm256_set1_epi8('\n');
+	while (pos + 32 <= size) {
+		__m256i v = _mm256_loadu_si256((const __m256i *) (buf + pos));
+		u32 lt_mask = (u32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, lt));
+		u32 nl_mask = (u32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl));
+		if (lt_mask) {
+			u32 idx = xml_ctz(lt_mask);
+			if (idx) *nb_lines += xml_popcount(nl_mask & (0xFFFFFFFF >> (32 - idx)));
+			return pos + idx;
+		}
+		*nb_lines += xml_popcount(nl_mask);
+		pos += 32;
+	}
+	return xml_scan_markup_c(buf, pos, size, nb_lines);
+}
+#endif
+
+#ifdef GPAC_HAS_NEON
+static u32 xml_scan_markup_neon(const char *buf, u32 pos, u32 size, u32 *nb_lines)
+{
+	while (pos + 16 <= size) {
+		uint8x16_t v = vld1q_u8((const u8 *) buf + pos);
+		uint64x2_t lt64 = vreinterpretq_u64_u8(vceqq_u8(v, vdupq_n_u8('<')));
+		if (vgetq_lane_u64(lt64, 0) | vgetq_lane_u64(lt64, 1)) {
+			//locate markup in block using scalar code
+			return xml_scan_markup_c(buf, pos, pos + 16, nb_lines);
+		}
+		//one per line break, summed pairwise
+		uint64x2_t nl64 = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vshrq_n_u8(vceqq_u8(v, vdupq_n_u8('\n')), 7))));
+		*nb_lines += (u32) (vgetq_lane_u64(nl64, 0) + vgetq_lane_u64(nl64, 1));
+		pos += 16;
+	}
+	return xml_scan_markup_c(buf, pos, size, nb_lines);
+}
+#endif
+
+static xml_scan_fn xml_get_scan_markup_fn()
+{
+	u32 cpu = gf_sys_get_cpu_features();
+#ifdef GPAC_HAS_AVX2
+	if (cpu & GF_CPU_AVX2) return xml_scan_markup_avx2;
+#endif
+#ifdef GPAC_HAS_SSE2
+	if (cpu & GF_CPU_SSE2) return xml_scan_markup_sse2;
+#endif
+#ifdef GPAC_HAS_NEON
+	if (cpu & GF_CPU_NEON) return xml_scan_markup_neon;
+#endif
+	return xml_scan_markup_c;
+}
+
+//translates XML built-in and numeric entities in place, the translated string is never longer than the source one
+static void xml_translate_xml_string(char *str)
+{
+	u32 i, j;
+	char *amp = strchr(str, '&');
+	if (!amp) return;
+	i = j = (u32) (amp - str);
+	while (str[i]) {
 		if (str[i] == '&') {
 			if (str[i+1]=='#') {
 				char szChar[20], *end;
@@ -78,45 +211,47 @@ static char *xml_translate_xml_string(char *str)
 					sscanf(szChar, "&#%u;", &val);
 				wchar[0] = val;
 				srcp = wchar;
-				j += (u32) gf_utf8_wcstombs(&value[j], 20, &srcp);
+				j += (u32) gf_utf8_wcstombs(&str[j], 20, &srcp);
 			}
 			else if (!strnicmp(&str[i], "&amp;", sizeof(char)*5)) {
-				value[j] = '&';
+				str[j] = '&';
 				j++;
 				i+= 5;
 			}
 			else if (!strnicmp(&str[i], "&lt;", sizeof(char)*4)) {
-				value[j] = '<';
+				str[j] = '<';
 				j++;
 				i+= 4;
 			}
 			else if (!strnicmp(&str[i], "&gt;", sizeof(char)*4)) {
-				value[j] = '>';
+				str[j] = '>';
 				j++;
 				i+= 4;
 			}
 			else if (!strnicmp(&str[i], "&apos;", sizeof(char)*6)) {
-				value[j] = '\'';
+				str[j] = '\'';
 				j++;
 				i+= 6;
 			}
 			else if (!strnicmp(&str[i], "&quot;", sizeof(char)*6)) {
-				value[j] = '\"';
+				str[j] = '\"';
 				j++;
 				i+= 6;
 			} else {
-				value[j] = str[i];
+				str[j] = str[i];
 				j++;
 				i++;
 			}
 		} else {
-			value[j] = str[i];
-			j++;
-			i++;
+			//copy up to next entity in one go
+			char *next = strchr(str+i, '&');
+			u32 len = next ? (u32) (next - str) - i : (u32) strlen(str+i);
+			if (j<i) memmove(str+j, str+i, len);
+			i += len;
+			j += len;
 		}
 	}
-	value[j] = 0;
-	return value;
+	str[j] = 0;
 }
 
 
@@ -140,7 +275,6 @@ typedef struct
 {
 	u32 name_start, name_end;
 	u32 val_start, val_end;
-	Bool has_entities;
 } GF_XMLSaxAttribute;
 
 
@@ -190,6 +324,8 @@ struct _tag_sax_parser
 	GF_XMLAttribute *attrs;
 	GF_XMLSaxAttribute *sax_attrs;
 	u32 nb_attrs, nb_alloc_attrs;
+
+	xml_scan_fn scan_markup;
 };
 
 static GF_XMLSaxAttribute *xml_get_sax_attribute(GF_SAXParser *parser)
@@ -270,7 +406,6 @@ static void xml_sax_node_end(GF_SAXParser *parser, Bool had_children)
 
 static void xml_sax_node_start(GF_SAXParser *parser)
 {
-	Bool has_entities = GF_FALSE;
 	u32 i;
 	char c, *name;
 
@@ -285,11 +420,8 @@ static void xml_sax_node_start(GF_SAXParser *parser)
 		parser->attrs[i].value = parser->buffer + parser->sax_attrs[i].val_start - 1;
 		parser->buffer[parser->sax_attrs[i].val_end-1] = 0;
 
-		if (strchr(parser->attrs[i].value, '&')) {
-			parser->sax_attrs[i].has_entities = GF_TRUE;
-			has_entities = GF_TRUE;
-			parser->attrs[i].value = xml_translate_xml_string(parser->attrs[i].value);
-		}
+		//value is consumed after this call, translate in place
+		xml_translate_xml_string(parser->attrs[i].value);
 		/*store first char pos after current attrib for node peeking*/
 		parser->att_name_start = parser->sax_attrs[i].val_end;
 	}
@@ -307,14 +439,6 @@ static void xml_sax_node_start(GF_SAXParser *parser)
 	parser->att_name_start = 0;
 	parser->buffer[parser->elt_name_end - 1] = c;
 	parser->node_depth++;
-	if (has_entities) {
-		for (i=0; i<parser->nb_attrs; i++) {
-			if (parser->sax_attrs[i].has_entities) {
-				parser->sax_attrs[i].has_entities = GF_FALSE;
-				gf_free(parser->attrs[i].value);
-			}
-		}
-	}
 	parser->nb_attrs = 0;
 	xml_sax_swap(parser);
 	parser->text_start = parser->text_end = 0;
@@ -445,7 +569,6 @@ static Bool xml_sax_parse_attribute(GF_SAXParser *parser)
 				assert(att->name_end);
 				att->name_end --;
 			}
-			att->has_entities = GF_FALSE;
 
 			for (i=att->name_start; i<att->name_end; i++) {
 				char c = parser->buffer[i-1];
@@ -554,14 +677,10 @@ static void xml_sax_flush_text(GF_SAXParser *parser)
 
 	/*solve XML built-in entities*/
 	if (strchr(text, '&') && strchr(text, ';')) {
-		char *xml_text = xml_translate_xml_string(text);
-		if (xml_text) {
-			parser->sax_text_content(parser->sax_cbck, xml_text, (parser->sax_state==SAX_STATE_CDATA) ? GF_TRUE : GF_FALSE);
-			gf_free(xml_text);
-		}
-	} else {
-		parser->sax_text_content(parser->sax_cbck, text, (parser->sax_state==SAX_STATE_CDATA) ? GF_TRUE : GF_FALSE);
+		//text is consumed after this call, translate in place
+		xml_translate_xml_string(text);
 	}
+	parser->sax_text_content(parser->sax_cbck, text, (parser->sax_state==SAX_STATE_CDATA) ? GF_TRUE : GF_FALSE);
 	parser->buffer[parser->text_end-1] = c;
 	parser->text_start = parser->text_end = 0;
 }
@@ -748,14 +867,23 @@ restart:
 		case SAX_STATE_ELEMENT:
 			elt = NULL;
 			i=0;
-			while ((c = parser->buffer[parser->current_pos+i]) !='<') {
-				if ((parser->init_state==2) && (c ==']')) {
-					parser->sax_state = SAX_STATE_ATT_NAME;
-					parser->current_pos+=i+1;
-					goto restart;
+			if (parser->init_state==2) {
+				while ((c = parser->buffer[parser->current_pos+i]) !='<') {
+					if (c ==']') {
+						parser->sax_state = SAX_STATE_ATT_NAME;
+						parser->current_pos+=i+1;
+						goto restart;
+					}
+					i++;
+					if (c=='\n') parser->line++;
+
+					if (parser->current_pos+i==parser->line_size)
+						goto exit;
 				}
-				i++;
-				if (c=='\n') parser->line++;
+			} else {
+				u32 nb_lines = 0;
+				i = parser->scan_markup(parser->buffer, parser->current_pos, parser->line_size, &nb_lines) - parser->current_pos;
+				parser->line += nb_lines;
 
 				if (parser->current_pos+i==parser->line_size) {
 					if ((parser->line_size>=2*XML_INPUT_SIZE) && !parser->init_state)
@@ -776,7 +904,7 @@ restart:
 			cdata_sep = 0;
 			while (1) {
 				c = parser->buffer[parser->current_pos+1+i];
-				if (!strncmp(parser->buffer+parser->current_pos+1+i, "!--", 3)) {
+				if ((c=='!') && !strncmp(parser->buffer+parser->current_pos+1+i, "!--", 3)) {
 					parser->sax_state = SAX_STATE_COMMENT;
 					i += 3;
 					break;
@@ -851,7 +979,11 @@ restart:
 			assert(parser->elt_start_pos <= parser->file_pos + parser->current_pos);
 			parser->elt_start_pos = parser->file_pos + parser->current_pos;
 
-			if (!strncmp(elt, "!--", 3)) {
+			//regular element
+			if ((elt[0]!='!') && (elt[0]!='?')) {
+				goto node_found;
+			}
+			else if (!strncmp(elt, "!--", 3)) {
 				xml_sax_flush_text(parser);
 				parser->sax_state = SAX_STATE_COMMENT;
 				if (i>3) parser->current_pos -= (i-3);
@@ -868,6 +1000,7 @@ restart:
 			}
 			/*node found*/
 			else {
+node_found:
 				xml_sax_flush_text(parser);
 				if (parser->init_state) {
 					parser->init_state = 0;
@@ -1317,6 +1450,7 @@ GF_SAXParser *gf_xml_sax_new(gf_xml_sax_node_start on_node_start,
 	parser->sax_node_end = on_node_end;
 	parser->sax_text_content = on_text_content;
 	parser->sax_cbck = cbck;
+	parser->scan_markup = xml_get_scan_markup_fn();
 	return parser;
 }
 